@@ -24,17 +24,270 @@
 #include <pybind11/stl_bind.h>
 
 // C++11 includes
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace py = pybind11;
 
 PYBIND11_MAKE_OPAQUE(std::vector<xrt::xclbin::ip>);
 
+namespace {
+
+/*
+ * Blocking XRT calls are made without holding the GIL so that other
+ * Python threads, and the asyncio event loop, keep running while a
+ * kernel executes or a buffer is transferred.  Python objects must
+ * only be touched with the GIL held.
+ */
+
+// Event loop to use for an awaitable, the running loop by default
+py::object
+event_loop(py::object loop)
+{
+    if (!loop.is_none())
+        return loop;
+    // Raises RuntimeError if called outside of a coroutine
+    return py::module_::import("asyncio").attr("get_running_loop")();
+}
+
+// Executed on the event loop thread by call_soon_threadsafe
+void
+set_future_result(py::object future, ert_cmd_state state)
+{
+    // The awaiting task may have been cancelled
+    if (!future.attr("done")().cast<bool>())
+        future.attr("set_result")(state);
+}
+
+// XRT calls run callbacks in its own threads, possibly with XRT
+// locks held.  Taking the GIL there can deadlock with a Python thread
+// that holds the GIL and calls into XRT.  The callbacks therefore
+// only queue work for this dispatcher thread, which takes the GIL
+// and posts results to the event loops.
+class completion_dispatcher
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> work;  // called with the GIL held
+    std::thread thread;
+    bool stopped = false;
+
+    void
+    run()
+    {
+        std::unique_lock<std::mutex> lk(mutex);
+        while (true) {
+            cv.wait(lk, [this] { return stopped || !work.empty(); });
+            if (work.empty())
+                return;  // stopped and drained
+
+            auto fn = std::move(work.front());
+            work.pop_front();
+            lk.unlock();
+            {
+                py::gil_scoped_acquire gil;
+                fn();
+                fn = nullptr;
+            }
+            lk.lock();
+        }
+    }
+
+public:
+    ~completion_dispatcher()
+    {
+        // Not stopped if the interpreter did not run atexit handlers
+        if (thread.joinable())
+            thread.detach();
+    }
+
+    // Queue a function to be called with the GIL held.  Returns false
+    // after stop(), in which case the function is not called.  Does
+    // not require the GIL.
+    bool
+    post(std::function<void()> fn)
+    {
+        std::lock_guard<std::mutex> lk(mutex);
+        if (stopped)
+            return false;
+        if (!thread.joinable())
+            thread = std::thread([this] { run(); });
+        work.push_back(std::move(fn));
+        cv.notify_one();
+        return true;
+    }
+
+    // Drain queued work and stop the thread, called at interpreter
+    // exit with the GIL held
+    void
+    stop()
+    {
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            stopped = true;
+        }
+        cv.notify_one();
+        if (thread.joinable()) {
+            py::gil_scoped_release release;
+            thread.join();
+        }
+    }
+};
+
+completion_dispatcher&
+dispatcher()
+{
+    static completion_dispatcher instance;
+    return instance;
+}
+
+using loop_future = std::pair<py::object, py::object>; // (loop, future)
+
+// Drop Python objects from a thread that may not hold the GIL
+void
+release_in_dispatcher(std::shared_ptr<std::deque<loop_future>> objects)
+{
+    // Clear explicitly so the objects are released with the GIL held
+    // no matter which thread drops the last reference to the deque
+    if (dispatcher().post([objects] { objects->clear(); }))
+        return;
+
+    // Interpreter has shut down, leak the objects
+    for (auto& lf : *objects) {
+        lf.first.release();
+        lf.second.release();
+    }
+}
+
+// Futures of pending run.start_async() calls on one run object.
+// The futures are completed first in first out by a single callback
+// registered with the run before it is started the first time.
+struct run_futures
+{
+    std::mutex mutex;
+    std::deque<loop_future> pending;
+
+    // Owned by the callback of the run, so destroyed by whichever
+    // thread, XRT or Python, releases the run implementation
+    ~run_futures()
+    {
+        if (!pending.empty())
+            release_in_dispatcher(std::make_shared<std::deque<loop_future>>(std::move(pending)));
+    }
+
+    // Called by XRT when the run completes, in an XRT thread without
+    // the GIL.  Moving a py::object does not touch its reference count.
+    void
+    complete(ert_cmd_state state)
+    {
+        auto lf = std::make_shared<std::deque<loop_future>>();
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            if (pending.empty())
+                return;  // run was started with start()
+            lf->push_back(std::move(pending.front()));
+            pending.pop_front();
+        }
+
+        auto posted = dispatcher().post([lf, state] {
+            auto& loop_and_future = lf->front();
+            try {
+                loop_and_future.first.attr("call_soon_threadsafe")
+                    (py::cpp_function(&set_future_result), loop_and_future.second, state);
+            }
+            catch (py::error_already_set& ex) {
+                // loop is closed
+                ex.discard_as_unraisable(__func__);
+            }
+            lf->clear();
+        });
+
+        if (!posted)
+            release_in_dispatcher(lf);
+    }
+};
+
+// Return the futures of a run object, registering the completion
+// callback with the run if not already done.  Keyed by the run
+// implementation which is shared by copies of the xrt::run object.
+// The callback owns the futures, so they are released along with the
+// run implementation.
+std::shared_ptr<run_futures>
+get_run_futures(xrt::run& r)
+{
+    static std::mutex mutex;
+    static std::map<const void*, std::weak_ptr<run_futures>> runs;
+
+    // The futures are published only once the callback is registered,
+    // otherwise a concurrent start_async() could queue a future that
+    // no callback ever completes.  The callback may be called right
+    // away, it does not take this lock.
+    const void* key = r.get_handle().get();
+    std::lock_guard<std::mutex> lk(mutex);
+    auto itr = runs.find(key);
+    if (itr != runs.end()) {
+        if (auto futures = itr->second.lock())
+            return futures;
+    }
+
+    // Throws if the run was started with start() and is still running
+    auto futures = std::make_shared<run_futures>();
+    r.add_callback(ERT_CMD_STATE_COMPLETED,
+                   [futures](const void*, ert_cmd_state state, void*) {
+                       futures->complete(state);
+                   }, nullptr);
+
+    // Prune entries of destroyed runs
+    for (itr = runs.begin(); itr != runs.end();)
+        itr = itr->second.expired() ? runs.erase(itr) : std::next(itr);
+
+    runs[key] = futures;
+    return futures;
+}
+
+// Start a run and return an asyncio future that is completed with the
+// run state when the run completes
+py::object
+start_async(xrt::run& r, py::object loop)
+{
+    loop = event_loop(std::move(loop));
+    auto future = loop.attr("create_future")();
+    auto futures = get_run_futures(r);
+    {
+        std::lock_guard<std::mutex> lk(futures->mutex);
+        futures->pending.emplace_back(loop, future);
+    }
+
+    try {
+        py::gil_scoped_release release;
+        r.start();
+    }
+    catch (...) {
+        // Run did not start, so nothing completes the future
+        std::lock_guard<std::mutex> lk(futures->mutex);
+        futures->pending.pop_back();
+        throw;
+    }
+    return future;
+}
+
+} // namespace
+
 PYBIND11_MODULE(pyxrt, m) {
     m.doc() = "Pybind11 module for XRT";
 
+    // Stop the completion dispatcher while Python objects can still
+    // be released
+    py::module_::import("atexit").attr("register")(py::cpp_function([] { dispatcher().stop(); }));
+
 /*
  *
  * Constants and Enums
@@ -101,10 +354,10 @@ PYBIND11_MODULE(pyxrt, m) {
                       }))
         .def("load_xclbin", [](xrt::device& d, const std::string& xclbin) {
                                 return d.load_xclbin(xclbin);
-                            }, "Load an xclbin given the path to the device")
+                            }, py::call_guard<py::gil_scoped_release>(), "Load an xclbin given the path to the device")
         .def("load_xclbin", [](xrt::device& d, const xrt::xclbin& xclbin) {
                                 return d.load_xclbin(xclbin);
-                            }, "Load the xclbin to the device")
+                            }, py::call_guard<py::gil_scoped_release>(), "Load the xclbin to the device")
         .def("get_xclbin_uuid", &xrt::device::get_xclbin_uuid, "Return the UUID object representing the xclbin loaded on the device")
         .def("get_info", [] (xrt::device& d, xrt::info::device key) {
                              /* Convert the value to string since we can have only one return type for get_info() */
@@ -159,7 +412,10 @@ PYBIND11_MODULE(pyxrt, m) {
         .def(py::init<const xrt::kernel &>())
         .def("start", [](xrt::run& r){
                           r.start();
-                      }, "Start one execution of a run")
+                      }, py::call_guard<py::gil_scoped_release>(), "Start one execution of a run")
+        .def("start_async", &start_async, py::arg("loop") = py::none(),
+             "Start one execution of a run and return an asyncio future with the run state on completion. "
+             "The first start_async() must not be issued while the run is executing from start()")
         .def("set_arg", [](xrt::run& r, int i, xrt::bo& item){
                             r.set_arg(i, item);
                         }, "Set a specific kernel global argument for a run")
@@ -168,13 +424,30 @@ PYBIND11_MODULE(pyxrt, m) {
                         }, "Set a specific kernel scalar argument for this run")
         .def("wait", ([](xrt::run& r)  {
                            return r.wait(0);
-                      }), "Wait for the run to complete")
+                      }), py::call_guard<py::gil_scoped_release>(), "Wait for the run to complete")
         .def("wait", ([](xrt::run& r, unsigned int timeout_ms)  {
                           return r.wait(timeout_ms);
-                      }), "Wait for the specified milliseconds for the run to complete")
+                      }), py::call_guard<py::gil_scoped_release>(), "Wait for the specified milliseconds for the run to complete")
         .def("state", &xrt::run::state, "Check the current state of a run object")
         .def("add_callback", &xrt::run::add_callback, "Add a callback function for run state");
 
+    m.def("start_runs", [](std::vector<xrt::run> runs) {
+                            py::gil_scoped_release release;
+                            for (auto& r : runs)
+                                r.start();
+                        }, "Start a batch of runs with a single call");
+
+    m.def("wait_runs", [](std::vector<xrt::run> runs, unsigned int timeout_ms) {
+                           std::vector<ert_cmd_state> states;
+                           states.reserve(runs.size());
+                           py::gil_scoped_release release;
+                           for (auto& r : runs)
+                               states.push_back(r.wait(timeout_ms));
+                           return states;
+                       }, py::arg("runs"), py::arg("timeout_ms") = 0,
+          "Wait for a batch of runs to complete and return their states. "
+          "The timeout applies to each run in turn.");
+
     py::class_<xrt::kernel> pyker(m, "kernel", "Represents a set of instances matching a specified name");
 
     py::enum_<xrt::kernel::cu_access_mode>(pyker, "cu_access_mode", "Compute unit access mode")
@@ -209,7 +482,10 @@ PYBIND11_MODULE(pyxrt, m) {
                                  i++;
                              }
 
-                             r.start();
+                             {
+                                 py::gil_scoped_release release;
+                                 r.start();
+                             }
                              return r;
                          })
         .def("group_id", &xrt::kernel::group_id, "Get the memory bank group id of an kernel argument");
@@ -235,20 +511,55 @@ PYBIND11_MODULE(pyxrt, m) {
         .def(py::init<xrt::bo, size_t, size_t>(), "Create a sub-buffer of an existing buffer object of specifed size and offset in the existing buffer")
         .def("write", ([](xrt::bo &b, py::buffer pyb, size_t seek)  {
                            py::buffer_info info = pyb.request();
+                           py::gil_scoped_release release;
                            b.write(info.ptr, info.itemsize * info.size , seek);
                        }), "Write the provided data into the buffer object starting at specified offset")
         .def("read", ([](xrt::bo &b, size_t size, size_t skip) {
                           py::array_t<char> result = py::array_t<char>(size);
                           py::buffer_info bufinfo = result.request();
-                          b.read(bufinfo.ptr, size, skip);
+                          {
+                              py::gil_scoped_release release;
+                              b.read(bufinfo.ptr, size, skip);
+                          }
                           return result;
                       }), "Read from the buffer object requested number of bytes starting from specified offset")
+        .def("read_into", ([](xrt::bo &b, py::buffer pyb, size_t skip) {
+                               py::buffer_info info = pyb.request(true);
+                               if (info.readonly)
+                                   throw std::invalid_argument("read_into() requires a writable buffer");
+                               py::gil_scoped_release release;
+                               b.read(info.ptr, info.itemsize * info.size, skip);
+                           }), "Read from the buffer object into the provided writable buffer, starting from specified offset")
         .def("sync", ([](xrt::bo &b, xclBOSyncDirection dir, size_t size, size_t offset)  {
                           b.sync(dir, size, offset);
-                      }), "Synchronize (DMA or cache flush/invalidation) the buffer in the requested direction")
+                      }), py::call_guard<py::gil_scoped_release>(), "Synchronize (DMA or cache flush/invalidation) the buffer in the requested direction")
+        .def("sync_async", ([](xrt::bo &b, xclBOSyncDirection dir, size_t size, size_t offset, py::object loop)  {
+                                // There is no completion callback for a buffer transfer, so
+                                // the transfer is waited on by a thread of the loop executor
+                                loop = event_loop(std::move(loop));
+                                py::cpp_function sync([b, dir, size, offset]() {
+                                    py::gil_scoped_release release;
+                                    auto bo = b;
+                                    bo.sync(dir, size, offset);
+                                });
+                                return loop.attr("run_in_executor")(py::none(), sync);
+                            }), py::arg("dir"), py::arg("size"), py::arg("offset"), py::arg("loop") = py::none(),
+             "Synchronize the buffer in the requested direction and return an asyncio future that completes with the transfer")
         .def("map", ([](xrt::bo &b)  {
                          return py::memoryview::from_memory(b.map(), b.size());
                      }), "Create a byte accessible memory view of the buffer object")
+        .def("map_array", ([](py::object self, py::object dt)  {
+                               // The array is a view of the mapped buffer and keeps the
+                               // buffer object alive through its base object
+                               auto& b = self.cast<xrt::bo&>();
+                               auto dtype = dt.is_none() ? py::dtype::of<uint8_t>() : py::dtype::from_args(dt);
+                               auto itemsize = static_cast<size_t>(dtype.itemsize());
+                               if (!itemsize)
+                                   throw std::invalid_argument("map_array() requires a sized dtype");
+                               auto count = static_cast<py::ssize_t>(b.size() / itemsize);
+                               return py::array(dtype, {count}, {static_cast<py::ssize_t>(itemsize)}, b.map(), self);
+                           }), py::arg("dtype") = py::none(),
+             "Create a numpy array of the specified dtype that is a zero copy view of the mapped buffer object")
         .def("size", &xrt::bo::size, "Return the size of the buffer object")
         .def("address", &xrt::bo::address, "Return the device physical address of the buffer object");
 
@@ -326,10 +637,10 @@ py::class_<xrt::graph>(m, "graph")
     .def("run", &xrt::graph::run)
     .def("wait", ([](xrt::graph &g, uint64_t cycles)  {
                       g.wait(cycles);
-                  }))
+                  }), py::call_guard<py::gil_scoped_release>())
     .def("wait", ([](xrt::graph &g, std::chrono::milliseconds timeout_ms)  {
                       g.wait(timeout_ms);
-                  }))
+                  }), py::call_guard<py::gil_scoped_release>())
     .def("suspend", &xrt::graph::suspend)
     .def("resume", &xrt::graph::resume)
     .def("end", &xrt::graph::end);
@@ -8,6 +8,9 @@
 #include "core/include/xrt/xrt_bo.h"
 #include "core/common/config.h"
 #include "core/include/ert.h"
+#include "core/common/shim/buffer_handle.h"
+
+#include <vector>
 
 namespace xrt_core { namespace bo {
 
@@ -46,6 +49,20 @@ XRT_CORE_COMMON_EXPORT
 size_t
 alignment();
 
+// coalesce_ranges() - Sync ranges of a BO of bo_size sorted by offset
+// with overlapping and adjacent ranges combined and empty ranges
+// dropped.  Throws if a range is outside the BO.
+XRT_CORE_COMMON_EXPORT
+std::vector<xrt_core::buffer_handle::range>
+coalesce_ranges(std::vector<xrt::bo::sync_range> ranges, size_t bo_size);
+
+// sub_buffer_ranges() - Ranges of a sub-buffer at offset shifted to
+// the parent BO of parent_size.  Throws if a range is outside the
+// parent BO.
+XRT_CORE_COMMON_EXPORT
+std::vector<xrt_core::buffer_handle::range>
+sub_buffer_ranges(std::vector<xrt_core::buffer_handle::range> ranges, size_t offset, size_t parent_size);
+
 }} // namespace bo, xrt_core
 
 #endif
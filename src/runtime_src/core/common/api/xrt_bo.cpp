@@ -20,10 +20,13 @@
 #include "hw_context_int.h"
 #include "kernel_int.h"
 #include "xrt_mem.h"
+#include "core/common/config_reader.h"
 #include "core/common/device.h"
+#include "core/common/hugepage_pool.h"
 #include "core/common/memalign.h"
 #include "core/common/message.h"
 #include "core/common/query_requests.h"
+#include "core/common/suballocator.h"
 #include "core/common/system.h"
 #include "core/common/unistd.h"
 #include "core/common/xclbin_parser.h"
@@ -31,8 +34,10 @@
 #include "core/common/shim/buffer_handle.h"
 #include "core/common/shim/shared_handle.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -446,6 +451,13 @@ public:
     handle->sync(static_cast<xrt_core::buffer_handle::direction>(dir), sz, offset);
   }
 
+  // Ranges are sorted by offset and neither overlap nor touch
+  virtual void
+  sync_ranges(xclBOSyncDirection dir, const std::vector<xrt_core::buffer_handle::range>& ranges)
+  {
+    handle->sync_ranges(static_cast<xrt_core::buffer_handle::direction>(dir), ranges);
+  }
+
   virtual uint64_t
   get_address() const
   {
@@ -845,6 +857,13 @@ public:
     }
   }
 
+  void
+  sync_ranges(xclBOSyncDirection dir, const std::vector<xrt_core::buffer_handle::range>& ranges) override
+  {
+    for (const auto& r : ranges)
+      sync(dir, r.size, r.offset);
+  }
+
   void
   copy(const bo_impl* src, size_t sz, size_t src_offset, size_t dst_offset) override
   {
@@ -905,6 +924,12 @@ public:
     // sync through parent buffer, which handles nodma case also
     m_parent->sync(dir, sz, off);
   }
+
+  void
+  sync_ranges(xclBOSyncDirection dir, const std::vector<xrt_core::buffer_handle::range>& ranges) override
+  {
+    m_parent->sync_ranges(dir, xrt_core::bo::sub_buffer_ranges(ranges, m_offset, m_parent->get_size()));
+  }
 };
 
 // class buffer_xbuf - Wrapper for extern managed xclBufferHandle
@@ -940,6 +965,12 @@ public:
     throw xrt_core::error(std::errc::not_supported, "no sync of xcl managed BOs");
   }
 
+  void
+  sync_ranges(xclBOSyncDirection, const std::vector<xrt_core::buffer_handle::range>&) override
+  {
+    throw xrt_core::error(std::errc::not_supported, "no sync of xcl managed BOs");
+  }
+
   bool
   is_sub() const override
   {
@@ -987,14 +1018,60 @@ get_boh(xrtBufferHandle bhdl)
   return bo_cache.get_or_error(bhdl);
 }
 
+// NUMA policy for XRT allocated host memory of a buffer, the
+// per buffer override in flags takes precedence over xrt.ini
+static xrt_core::numa_policy
+get_numa_policy(xrtBufferFlags flags)
+{
+  switch (xcl_bo_flags{flags}.numa) {
+  case XRT_BO_NUMA_NONE:
+    return xrt_core::numa_policy::none;
+  case XRT_BO_NUMA_PREFERRED:
+    return xrt_core::numa_policy::preferred;
+  case XRT_BO_NUMA_BIND:
+    return xrt_core::numa_policy::bind;
+  default:
+    break;
+  }
+
+  static auto policy = [] {
+    auto value = xrt_core::config::get_host_mem_numa_policy();
+    if (value == "preferred")
+      return xrt_core::numa_policy::preferred;
+    if (value == "bind")
+      return xrt_core::numa_policy::bind;
+    if (value != "none")
+      xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT",
+                              "Unknown Runtime.host_mem_numa_policy '" + value + "', using 'none'");
+    return xrt_core::numa_policy::none;
+  }();
+  return policy;
+}
+
+// Host memory for a buffer, placed on the NUMA node of the device
+// to avoid DMA across sockets
+static xrt_core::aligned_ptr_type
+alloc_host_memory(const device_type& device, size_t sz, xrtBufferFlags flags)
+{
+  auto policy = get_numa_policy(flags);
+  auto node = (policy == xrt_core::numa_policy::none) ? -1 : device->get_numa_node();
+
+  // Large buffers are backed by huge pages when enabled in xrt.ini
+  if (auto hbuf = xrt_core::hugepage_pool::instance().alloc(sz, node, policy))
+    return hbuf;
+
+  return xrt_core::aligned_alloc(get_alignment(), sz, node, policy);
+}
+
 static std::unique_ptr<xrt_core::buffer_handle>
 alloc_bo(const device_type& device, void* userptr, size_t sz, xrtBufferFlags flags, xrtMemoryGroup grp)
 {
-  // Embed grp in flags
+  // Embed grp in flags, numa placement is not for the driver
   xcl_bo_flags xflags{flags};
   xcl_bo_flags xgrp{grp};
   xflags.bank = xgrp.bank;
   xflags.slot = xgrp.slot;
+  xflags.numa = 0;
 
   auto hwctx  = device.get_hwctx_handle();
   return hwctx
@@ -1005,11 +1082,12 @@ alloc_bo(const device_type& device, void* userptr, size_t sz, xrtBufferFlags fla
 static std::unique_ptr<xrt_core::buffer_handle>
 alloc_bo(const device_type& device, size_t sz, xrtBufferFlags flags, xrtMemoryGroup grp)
 {
-  // Embed grp in flags
+  // Embed grp in flags, numa placement is not for the driver
   xcl_bo_flags xflags{flags};
   xcl_bo_flags xgrp{grp};
   xflags.bank = xgrp.bank;
   xflags.slot = xgrp.slot;
+  xflags.numa = 0;
 
   try {
     auto hwctx  = device.get_hwctx_handle();
@@ -1053,6 +1131,13 @@ alloc_ubuf(const device_type& device, void* userptr, size_t sz, xrtBufferFlags f
   if (!is_aligned_ptr(userptr))
     throw xrt_core::error(EINVAL, "userptr is not aligned");
 
+  // User memory is placed only on explicit request for this buffer
+  if (xcl_bo_flags{flags}.numa != XRT_BO_NUMA_DEFAULT) {
+    auto policy = get_numa_policy(flags);
+    if (policy != xrt_core::numa_policy::none)
+      xrt_core::numa_bind(userptr, sz, device->get_numa_node(), policy);
+  }
+
   // driver pins and manages userptr
   auto handle = alloc_bo(device, userptr, sz, flags, grp);
   auto boh = std::make_shared<xrt::buffer_ubuf>(device, std::move(handle), sz, userptr);
@@ -1104,7 +1189,7 @@ alloc(const device_type& device, size_t sz, xrtBufferFlags flags, xrtMemoryGroup
       // which helps to remove the extra copy in sw_emu.
       return alloc_kbuf(device, sz, flags, grp);
     else
-      return alloc_hbuf(device, xrt_core::aligned_alloc(get_alignment(), sz), sz, flags, grp);
+      return alloc_hbuf(device, alloc_host_memory(device, sz, flags), sz, flags, grp);
 #endif
   case XCL_BO_FLAGS_CACHEABLE:
   case XCL_BO_FLAGS_SVM:
@@ -1268,6 +1353,45 @@ alignment()
   return ::get_alignment();
 }
 
+// Sort ranges by offset and combine overlapping and adjacent ranges.
+// Ranges separated by a gap are kept apart, syncing the gap would
+// overwrite data on the other side.  Empty ranges are dropped.
+std::vector<xrt_core::buffer_handle::range>
+coalesce_ranges(std::vector<xrt::bo::sync_range> ranges, size_t bo_size)
+{
+  for (const auto& r : ranges)
+    if (r.offset > bo_size || r.size > bo_size - r.offset)
+      throw xrt_core::error(-EINVAL, "Invalid offset and size when syncing buffer ranges");
+
+  std::sort(ranges.begin(), ranges.end(), [](const auto& a, const auto& b) {
+    return a.offset < b.offset;
+  });
+
+  std::vector<xrt_core::buffer_handle::range> combined;
+  for (const auto& r : ranges) {
+    if (!r.size)
+      continue;
+    if (!combined.empty() && r.offset <= combined.back().offset + combined.back().size) {
+      auto& last = combined.back();
+      last.size = std::max(last.size, r.offset + r.size - last.offset);
+      continue;
+    }
+    combined.push_back({r.size, r.offset});
+  }
+  return combined;
+}
+
+std::vector<xrt_core::buffer_handle::range>
+sub_buffer_ranges(std::vector<xrt_core::buffer_handle::range> ranges, size_t offset, size_t parent_size)
+{
+  for (auto& r : ranges) {
+    r.offset += offset;
+    if (r.offset > parent_size || r.size > parent_size - r.offset)
+      throw xrt_core::error(-EINVAL, "Invalid offset and size when syncing sub buffer");
+  }
+  return ranges;
+}
+
 }} // namespace bo, xrt_core
 
 
@@ -1432,6 +1556,21 @@ sync(xclBOSyncDirection dir, size_t size, size_t offset)
     });
 }
 
+void
+bo::
+sync(xclBOSyncDirection dir, const std::vector<sync_range>& ranges)
+{
+  auto combined = xrt_core::bo::coalesce_ranges(ranges, handle->get_size());
+  size_t bytes = 0;
+  for (const auto& r : combined)
+    bytes += r.size;
+
+  return xdp::native::profiling_wrapper_sync("xrt::bo::sync", dir, bytes,
+    [this, dir, &combined]{
+      handle->sync_ranges(dir, combined);
+    });
+}
+
 bo::async_handle
 bo::
 async(xclBOSyncDirection dir, size_t sz, size_t offset)
@@ -1528,6 +1667,136 @@ bo(const xrt::hw_context& hwctx, pid_type pid, xclBufferExportHandle ehdl)
   : xrt::bo::bo{alloc_import_from_pid(device_type{hwctx}, pid, ehdl)}
 {}
 
+// class bo_arena_impl - parent buffer and allocator of its sub buffers
+//
+// Shared by the arena and all sub buffers allocated from it, so that
+// a sub buffer can return its range after the arena object is gone.
+class bo_arena_impl
+{
+  xrt::bo m_parent;
+  mutable std::mutex m_mutex;
+  xrt_core::suballocator m_allocator;
+
+public:
+  bo_arena_impl(xrt::bo parent, size_t alignment)
+    : m_parent(std::move(parent))
+    , m_allocator(m_parent.size(), alignment)
+  {}
+
+  // Flags of the parent buffer, checked before it is allocated
+  static xrt::bo::flags
+  parent_flags(xrt::bo::flags flags)
+  {
+    if (flags == xrt::bo::flags::device_only)
+      throw xrt_core::error(EINVAL, "device only buffers cannot be sub allocated");
+    return flags;
+  }
+
+  size_t
+  alloc(size_t sz)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto offset = m_allocator.alloc(sz);
+    if (offset == xrt_core::suballocator::npos)
+      throw xrt_core::error(ENOMEM, "bo arena has no free range of " + std::to_string(sz) + " bytes");
+    return offset;
+  }
+
+  void
+  free(size_t offset)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_allocator.free(offset);
+  }
+
+  xrt_core::suballocator::stats
+  get_stats() const
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_allocator.get_stats();
+  }
+
+  const xrt::bo&
+  get_parent() const
+  {
+    return m_parent;
+  }
+};
+
+// class buffer_arena - sub buffer that returns its range to an arena
+class buffer_arena : public xrt::buffer_sub
+{
+  std::shared_ptr<bo_arena_impl> m_arena;
+  size_t m_offset;
+
+public:
+  buffer_arena(std::shared_ptr<bo_arena_impl> arena, size_t sz, size_t offset)
+    : xrt::buffer_sub(arena->get_parent().get_handle(), sz, offset)
+    , m_arena(std::move(arena))
+    , m_offset(offset)
+  {}
+
+  ~buffer_arena()
+  {
+    m_arena->free(m_offset);
+  }
+
+  buffer_arena(const buffer_arena&) = delete;
+  buffer_arena(buffer_arena&&) = delete;
+  buffer_arena& operator=(buffer_arena&) = delete;
+  buffer_arena& operator=(buffer_arena&&) = delete;
+};
+
+bo_arena::
+bo_arena(const xrt::device& device, size_t sz, xrt::bo::flags flags, xrt::memory_group grp, size_t alignment)
+  : detail::pimpl<bo_arena_impl>(std::make_shared<bo_arena_impl>(xrt::bo{device, sz, bo_arena_impl::parent_flags(flags), grp}, alignment))
+{}
+
+bo_arena::
+bo_arena(const xrt::hw_context& hwctx, size_t sz, xrt::bo::flags flags, xrt::memory_group grp, size_t alignment)
+  : detail::pimpl<bo_arena_impl>(std::make_shared<bo_arena_impl>(xrt::bo{hwctx, sz, bo_arena_impl::parent_flags(flags), grp}, alignment))
+{}
+
+xrt::bo
+bo_arena::
+alloc(size_t sz)
+{
+  return xdp::native::profiling_wrapper("xrt::ext::bo_arena::alloc", [this, sz]{
+    auto offset = handle->alloc(sz);
+    try {
+      return xrt::bo{std::make_shared<buffer_arena>(handle, sz, offset)};
+    }
+    catch (...) {
+      handle->free(offset);
+      throw;
+    }
+  });
+}
+
+xrt::bo
+bo_arena::
+get_parent() const
+{
+  return handle->get_parent();
+}
+
+bo_arena::stats
+bo_arena::
+get_stats() const
+{
+  auto st = handle->get_stats();
+  stats ret;
+  ret.capacity = st.capacity;
+  ret.allocations = st.allocations;
+  ret.failures = st.failures;
+  ret.bytes_requested = st.bytes_requested;
+  ret.bytes_in_use = st.bytes_in_use;
+  ret.bytes_free = st.bytes_free;
+  ret.free_ranges = st.free_ranges;
+  ret.largest_free = st.largest_free;
+  return ret;
+}
+
 } // xrt::ext
 
 #ifdef XRT_ENABLE_AIE
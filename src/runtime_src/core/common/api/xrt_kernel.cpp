@@ -1269,72 +1269,107 @@ public:
   { return arg.type; }
 };
 
-} // namespace
-
-namespace xrt {
-
-// struct kernel_impl - The internals of an xrtKernelHandle
+// struct kernel_descriptor - Immutable kernel meta data
 //
-// An single object of kernel_type can be shared with multiple
-// run handles.   The kernel object defines all kernel specific
-// meta data used to create a launch a run object (command)
+// The xclbin meta data a kernel object needs for a kernel name with
+// optional instance filter: compute units, control protocol, typed
+// and amended arguments, and register map size.  Building it walks
+// the xclbin meta data and is the same for every kernel object with
+// the same xclbin and name, so descriptors are cached process wide
+// by (xclbin uuid, name) and shared by all kernel objects and
+// hardware contexts that use the xclbin.  A kernel object only
+// adds its own compute unit contexts.
 //
-// The thread safe device compute unit context manager used by
-// ip_context is constructed by kernel_impl if necessary.  It is
-// shared ownership with other kernel impls, so while ctxmgr appears
-// unused by kernel_impl, the construction and ownership is vital.
-class kernel_impl
+// A cached descriptor lives as long as some kernel object uses it.
+struct kernel_descriptor
 {
-public:
   using property_type = xrt_core::xclbin::kernel_properties;
-  using kernel_type = property_type::kernel_type;
   using control_type = xrt::xclbin::ip::control_type;
-  using mailbox_type = property_type::mailbox_type;
-  using ipctx = std::shared_ptr<ip_context>;
-  using ctxmgr_type = xrt_core::context_mgr::device_context_mgr;
 
-private:
-  std::string name;                    // kernel name
-  std::shared_ptr<device_type> device; // shared ownership
-  std::shared_ptr<ctxmgr_type> ctxmgr; // device context mgr ownership
-  xrt::hw_context hwctx;               // context for hw resources if any (can be null)
-  xrt_core::hw_queue hwqueue;          // hwqueue for command submission (shared by all runs)
-  xrt::xclbin xclbin;                  // xclbin with this kernel
+  xrt::xclbin xclbin;                  // keeps meta data alive
+  std::string name;                    // kernel name, instances filtered
   xrt::xclbin::kernel xkernel;         // kernel xclbin metadata
+  const property_type& properties;     // kernel properties from XML meta
+  std::vector<xrt::xclbin::ip> cus;    // compute units matching name
+  control_type protocol;               // control protocol of cus
   std::vector<argument> args;          // kernel args sorted by argument index
-  std::vector<ipctx> ipctxs;           // CU context locks
-  const property_type& properties;     // Kernel properties from XML meta
-  std::bitset<max_cus> cumask;         // cumask for command execution
   size_t regmap_size = 0;              // CU register map size
   size_t fa_num_inputs = 0;            // Fast adapter number of inputs per meta data
   size_t fa_num_outputs = 0;           // Fast adapter number of outputs per meta data
   size_t fa_input_entry_bytes = 0;     // Fast adapter input desc bytes
   size_t fa_output_entry_bytes = 0;    // Fast adapter output desc bytes
-  size_t num_cumasks = 1;              // Required number of command cu masks
-  control_type protocol = control_type::none; // Default opcode
-  uint32_t uid;                        // Internal unique id for debug
 
-  // Open context of a specific compute unit.
-  //
-  // @cu:  compute unit to open
-  // @am:  access mode for the CU
-  // Return: shared ownership to the context in form of a shared_ptr
+  kernel_descriptor(xrt::xclbin xb, const std::string& nm)
+    : xclbin(std::move(xb))
+    , name(nm.substr(0,nm.find(":")))                          // filter instance names
+    , xkernel(get_kernel_or_error(xclbin, name))               // kernel meta data managed by xclbin
+    , properties(xrt_core::xclbin_int::get_properties(xkernel))// cache kernel properties
+    , cus(xkernel.get_cus(nm))                                 // xrt::xclbin::ip objects for matching nm
+    , protocol(get_ip_control(cus))
+  {
+    if (cus.empty())
+      throw std::runtime_error("No compute units matching '" + nm + "'");
+
+    for (const auto& cu : cus)
+      if (cu.get_control_type() == xrt::xclbin::ip::control_type::none)
+        throw xrt_core::error(ENOTSUP, "AP_CTRL_NONE is only supported by XRT native API xrt::ip");
+
+    // get kernel arguments from xclbin kernel meta data
+    // compute regmap size, convert to typed argument
+    for (auto& arg : xrt_core::xclbin_int::get_arginfo(xkernel)) {
+      regmap_size = std::max(regmap_size, (arg.offset + arg.size) / sizeof(uint32_t));
+      args.emplace_back(arg);
+    }
+
+    // amend args with computed data based on kernel protocol
+    amend_args();
+  }
+
+  kernel_descriptor(const kernel_descriptor&) = delete;
+  kernel_descriptor(kernel_descriptor&&) = delete;
+  kernel_descriptor& operator=(kernel_descriptor&) = delete;
+  kernel_descriptor& operator=(kernel_descriptor&&) = delete;
+
+  // get() - Cached descriptor for kernel name in xclbin
   //
-  // This function opens the compute unit in the slot associated with
-  // the hardware context from which the kernel was constructed.
-  void
-  open_cu_context(const xrt::xclbin::ip& cu)
+  // The descriptor is built outside the lock, if two threads build
+  // the same descriptor concurrently, the first one cached wins.
+  static std::shared_ptr<const kernel_descriptor>
+  get(const xrt::xclbin& xclbin, const std::string& nm)
   {
-    // try open the cu context.  This may throw if cu in slot cannot be acquired.
-    auto ctx = ip_context::open(hwctx, cu); // may throw
+    using key_type = std::pair<xrt::uuid, std::string>;
+    static std::mutex mutex;
+    static std::map<key_type, std::weak_ptr<const kernel_descriptor>> cache;
 
-    // success, record cuidx in kernel cumask
-    auto cuidx = ctx->get_cuidx();
-    ipctxs.push_back(std::move(ctx));
-    cumask.set(cuidx);
-    num_cumasks = std::max<size_t>(num_cumasks, (cuidx / cus_per_word) + 1);
+    key_type key{xclbin.get_uuid(), nm};
+    {
+      std::lock_guard<std::mutex> lk(mutex);
+      auto itr = cache.find(key);
+      if (itr != cache.end())
+        if (auto desc = itr->second.lock())
+          return desc;
+    }
+
+    std::shared_ptr<const kernel_descriptor> desc = std::make_shared<kernel_descriptor>(xclbin, nm);
+
+    std::lock_guard<std::mutex> lk(mutex);
+    auto& entry = cache[key];
+    if (auto cached = entry.lock())
+      return cached;
+    entry = desc;
+
+    // purge descriptors no longer used by any kernel object
+    for (auto itr = cache.begin(); itr != cache.end();) {
+      if (itr->second.expired())
+        itr = cache.erase(itr);
+      else
+        ++itr;
+    }
+
+    return desc;
   }
 
+private:
   // Compute data for FAST_ADAPTER descriptor use (see ert_fa.h)
   //
   // Compute argument descriptor entry offset and compute total
@@ -1396,6 +1431,95 @@ private:
       amend_ap_args();
   }
 
+  static control_type
+  get_ip_control(const std::vector<xrt::xclbin::ip>& ips)
+  {
+    if (ips.empty())
+      return control_type::none;
+
+    auto ctrl = ips[0].get_control_type();
+    for (size_t idx = 1; idx < ips.size(); ++idx) {
+      auto ctrlatidx = ips[idx].get_control_type();
+      if (ctrlatidx == ctrl)
+        continue;
+      if (ctrlatidx != control_type::chain && ctrlatidx != control_type::hs)
+        throw std::runtime_error("CU control protocol mismatch");
+      ctrl = control_type::hs; // mix of CHAIN and HS is recorded as AP_CTRL_HS
+    }
+
+    return ctrl;
+  }
+
+  static xrt::xclbin::kernel
+  get_kernel_or_error(const xrt::xclbin& xclbin, const std::string& nm)
+  {
+    if (auto krnl = xclbin.get_kernel(nm))
+      return krnl;
+
+    throw xrt_core::error("No such kernel '" + nm + "'");
+  }
+};
+
+} // namespace
+
+namespace xrt {
+
+// struct kernel_impl - The internals of an xrtKernelHandle
+//
+// An single object of kernel_type can be shared with multiple
+// run handles.   The kernel object defines all kernel specific
+// meta data used to create a launch a run object (command)
+//
+// The thread safe device compute unit context manager used by
+// ip_context is constructed by kernel_impl if necessary.  It is
+// shared ownership with other kernel impls, so while ctxmgr appears
+// unused by kernel_impl, the construction and ownership is vital.
+class kernel_impl
+{
+public:
+  using property_type = xrt_core::xclbin::kernel_properties;
+  using kernel_type = property_type::kernel_type;
+  using control_type = xrt::xclbin::ip::control_type;
+  using mailbox_type = property_type::mailbox_type;
+  using ipctx = std::shared_ptr<ip_context>;
+  using ctxmgr_type = xrt_core::context_mgr::device_context_mgr;
+
+private:
+  std::shared_ptr<device_type> device; // shared ownership
+  std::shared_ptr<ctxmgr_type> ctxmgr; // device context mgr ownership
+  xrt::hw_context hwctx;               // context for hw resources if any (can be null)
+  xrt_core::hw_queue hwqueue;          // hwqueue for command submission (shared by all runs)
+  xrt::xclbin xclbin;                  // xclbin with this kernel
+  std::shared_ptr<const kernel_descriptor> desc; // shared xclbin meta data
+  const std::string& name;             // kernel name
+  const std::vector<argument>& args;   // kernel args sorted by argument index
+  const property_type& properties;     // Kernel properties from XML meta
+  std::vector<ipctx> ipctxs;           // CU context locks
+  std::bitset<max_cus> cumask;         // cumask for command execution
+  size_t num_cumasks = 1;              // Required number of command cu masks
+  uint32_t uid;                        // Internal unique id for debug
+
+  // Open context of a specific compute unit.
+  //
+  // @cu:  compute unit to open
+  // @am:  access mode for the CU
+  // Return: shared ownership to the context in form of a shared_ptr
+  //
+  // This function opens the compute unit in the slot associated with
+  // the hardware context from which the kernel was constructed.
+  void
+  open_cu_context(const xrt::xclbin::ip& cu)
+  {
+    // try open the cu context.  This may throw if cu in slot cannot be acquired.
+    auto ctx = ip_context::open(hwctx, cu); // may throw
+
+    // success, record cuidx in kernel cumask
+    auto cuidx = ctx->get_cuidx();
+    ipctxs.push_back(std::move(ctx));
+    cumask.set(cuidx);
+    num_cumasks = std::max<size_t>(num_cumasks, (cuidx / cus_per_word) + 1);
+  }
+
   unsigned int
   get_cuidx_or_error(size_t offset, bool force=false) const
   {
@@ -1415,30 +1539,11 @@ private:
     return ipctx->get_cuidx();
   }
 
-  control_type
-  get_ip_control(const std::vector<xrt::xclbin::ip>& ips)
-  {
-    if (ips.empty())
-      return control_type::none;
-
-    auto ctrl = ips[0].get_control_type();
-    for (size_t idx = 1; idx < ips.size(); ++idx) {
-      auto ctrlatidx = ips[idx].get_control_type();
-      if (ctrlatidx == ctrl)
-        continue;
-      if (ctrlatidx != control_type::chain && ctrlatidx != control_type::hs)
-        throw std::runtime_error("CU control protocol mismatch");
-      ctrl = control_type::hs; // mix of CHAIN and HS is recorded as AP_CTRL_HS
-    }
-
-    return ctrl;
-  }
-
   void
   initialize_command_header(ert_start_kernel_cmd* kcmd)
   {
     kcmd->extra_cu_masks = num_cumasks - 1;  //  -1 for mandatory mask
-    kcmd->count = num_cumasks + regmap_size;
+    kcmd->count = num_cumasks + desc->regmap_size;
     kcmd->type = ERT_CU;
     kcmd->state = ERT_CMD_STATE_NEW;
 
@@ -1447,7 +1552,7 @@ private:
       kcmd->opcode = ERT_SK_START;
       break;
     case kernel_type::pl :
-      kcmd->opcode = (protocol == control_type::fa) ? ERT_START_FA : ERT_START_CU;
+      kcmd->opcode = (desc->protocol == control_type::fa) ? ERT_START_FA : ERT_START_CU;
       break;
     case kernel_type::dpu :
       kcmd->opcode = ERT_START_CU;
@@ -1460,12 +1565,12 @@ private:
   void
   initialize_fadesc(uint32_t* data)
   {
-    auto desc = reinterpret_cast<ert_fa_descriptor*>(data);
-    desc->status = ERT_FA_ISSUED; // somewhat misleading
-    desc->num_input_entries = fa_num_inputs;
-    desc->input_entry_bytes = fa_input_entry_bytes;
-    desc->num_output_entries = fa_num_outputs;
-    desc->output_entry_bytes = fa_output_entry_bytes;
+    auto fadesc = reinterpret_cast<ert_fa_descriptor*>(data);
+    fadesc->status = ERT_FA_ISSUED; // somewhat misleading
+    fadesc->num_input_entries = desc->fa_num_inputs;
+    fadesc->input_entry_bytes = desc->fa_input_entry_bytes;
+    fadesc->num_output_entries = desc->fa_num_outputs;
+    fadesc->output_entry_bytes = desc->fa_output_entry_bytes;
   }
 
   static uint32_t
@@ -1475,15 +1580,6 @@ private:
     return count++;
   }
 
-  static xrt::xclbin::kernel
-  get_kernel_or_error(const xrt::xclbin& xclbin, const std::string& nm)
-  {
-    if (auto krnl = xclbin.get_kernel(nm))
-      return krnl;
-
-    throw xrt_core::error("No such kernel '" + nm + "'");
-  }
-
 public:
   // kernel_type - constructor
   //
@@ -1495,14 +1591,15 @@ public:
   // The ctxmgr is not directly used by kernel_impl, but its
   // construction and shared ownership must be tied to the kernel_impl
   kernel_impl(std::shared_ptr<device_type> dev, xrt::hw_context ctx, const std::string& nm)
-    : name(nm.substr(0,nm.find(":")))                          // filter instance names
-    , device(std::move(dev))                                   // share ownership
+    : device(std::move(dev))                                   // share ownership
     , ctxmgr(xrt_core::context_mgr::create(device->core_device.get())) // owership tied to kernel_impl
     , hwctx(std::move(ctx))                                    // hw context
     , hwqueue(hwctx)                                           // hw queue
     , xclbin(hwctx.get_xclbin())                               // xclbin with kernel
-    , xkernel(get_kernel_or_error(xclbin, name))               // kernel meta data managed by xclbin
-    , properties(xrt_core::xclbin_int::get_properties(xkernel))// cache kernel properties
+    , desc(kernel_descriptor::get(xclbin, nm))                 // meta data shared with other kernels
+    , name(desc->name)
+    , args(desc->args)
+    , properties(desc->properties)
     , uid(create_uid())
   {
     XRT_DEBUGF("kernel_impl::kernel_impl(%d)\n" , uid);
@@ -1513,31 +1610,10 @@ public:
         xrt_core::hw_context_int::set_exclusive(hwctx);
     }
 
-    // Compare the matching CUs against the CU sort order to create cumask
-    const auto& kernel_cus = xkernel.get_cus(nm);  // xrt::xclbin::ip objects for matching nm
-    if (kernel_cus.empty())
-      throw std::runtime_error("No compute units matching '" + nm + "'");
-
-    // Initialize / open compute unit contexts
-    for (const auto& cu : kernel_cus) {
-      if (cu.get_control_type() == xrt::xclbin::ip::control_type::none)
-        throw xrt_core::error(ENOTSUP, "AP_CTRL_NONE is only supported by XRT native API xrt::ip");
-
+    // Initialize / open compute unit contexts, the matching CUs
+    // are compared against the CU sort order to create cumask
+    for (const auto& cu : desc->cus)
       open_cu_context(cu);
-    }
-
-    // set kernel protocol
-    protocol = get_ip_control(kernel_cus);
-
-    // get kernel arguments from xclbin kernel meta data
-    // compute regmap size, convert to typed argument
-    for (auto& arg : xrt_core::xclbin_int::get_arginfo(xkernel)) {
-      regmap_size = std::max(regmap_size, (arg.offset + arg.size) / sizeof(uint32_t));
-      args.emplace_back(arg);
-    }
-
-    // amend args with computed data based on kernel protocol
-    amend_args();
   }
 
   ~kernel_impl()
@@ -1623,7 +1699,7 @@ public:
   control_type
   get_ip_control_protocol() const
   {
-    return protocol;
+    return desc->protocol;
   }
 
   // Group id is the memory bank index where a global buffer
@@ -1741,7 +1817,7 @@ public:
   size_t
   get_regmap_size()
   {
-      return regmap_size;
+      return desc->regmap_size;
   }
 };
 
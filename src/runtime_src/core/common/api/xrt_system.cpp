@@ -7,8 +7,60 @@
 #define XRT_CORE_COMMON_SOURCE // in same dll as core_common
 #include "core/include/experimental/xrt_system.h"
 
+#include "core/common/error.h"
 #include "core/common/system.h"
 
+#include <algorithm>
+#include <future>
+#include <set>
+#include <string>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+static std::chrono::microseconds
+elapsed(clock_type::time_point start)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - start);
+}
+
+// Result of loading the xclbin on one device
+struct device_load
+{
+  xrt::hw_context context;
+  std::chrono::microseconds load {0};
+  std::chrono::microseconds context_time {0};
+  int error_code = 0;
+  std::string error;
+};
+
+static device_load
+load_device(xrt::device device, const xrt::xclbin& xclbin, xrt::hw_context::access_mode mode)
+{
+  device_load result;
+  try {
+    auto start = clock_type::now();
+    auto uuid = device.register_xclbin(xclbin);
+    result.load = elapsed(start);
+
+    start = clock_type::now();
+    result.context = xrt::hw_context{device, uuid, mode};
+    result.context_time = elapsed(start);
+  }
+  catch (const xrt_core::system_error& ex) {
+    result.error_code = ex.get_code();
+    result.error = ex.what();
+  }
+  catch (const std::exception& ex) {
+    result.error_code = EINVAL;
+    result.error = ex.what();
+  }
+  return result;
+}
+
+} // namespace
+
 namespace xrt { namespace system {
 
 unsigned int
@@ -17,7 +69,73 @@ enumerate_devices()
   return static_cast<unsigned int>(xrt_core::get_total_devices(true/*is_user*/).second);
 }
 
-}} // namespace ini,xrt
+std::vector<xrt::hw_context>
+load_xclbin(const std::vector<xrt::device>& devices, const xrt::xclbin& xclbin,
+            xrt::hw_context::access_mode mode, load_timing* timing)
+{
+  auto start = clock_type::now();
+
+  if (!xclbin)
+    throw xrt_core::error(EINVAL, "No xclbin specified");
+
+  std::set<const xrt_core::device*> unique;
+  for (const auto& device : devices) {
+    if (!device)
+      throw xrt_core::error(EINVAL, "Empty device specified");
+    if (!unique.insert(device.get_handle().get()).second)
+      throw xrt_core::error(EINVAL, "Device specified more than once");
+  }
+
+  // The xclbin metadata is built on first use and shared by all users
+  // of the xclbin object.  Build it here, before the devices start,
+  // rather than having all device threads wait on the first one.
+  xclbin.get_axlf();
+  xclbin.get_kernels();
+  auto prepare = elapsed(start);
+
+  std::vector<std::future<device_load>> futures;
+  futures.reserve(devices.size());
+  for (const auto& device : devices)
+    futures.push_back(std::async(std::launch::async, load_device, device,
+                                 std::cref(xclbin), mode));
+
+  std::vector<device_load> results;
+  results.reserve(devices.size());
+  for (auto& f : futures)
+    results.push_back(f.get());
+
+  std::string errors;
+  int error_code = 0;
+  for (size_t idx = 0; idx < results.size(); ++idx) {
+    if (results[idx].error.empty())
+      continue;
+    if (!error_code)
+      error_code = results[idx].error_code;
+    errors.append("\n  device[").append(std::to_string(idx)).append("]: ").append(results[idx].error);
+  }
+  if (error_code)
+    throw xrt_core::error(error_code, "Failed to load xclbin on devices:" + errors);
+
+  std::vector<xrt::hw_context> contexts;
+  contexts.reserve(results.size());
+  for (auto& result : results)
+    contexts.push_back(std::move(result.context));
+
+  if (timing) {
+    timing->prepare = prepare;
+    timing->load.clear();
+    timing->context.clear();
+    for (const auto& result : results) {
+      timing->load.push_back(result.load);
+      timing->context.push_back(result.context_time);
+    }
+    timing->total = elapsed(start);
+  }
+
+  return contexts;
+}
+
+}} // namespace system,xrt
 
 ////////////////////////////////////////////////////////////////
 // xrt_message C API implmentations (xrt_message.h)
@@ -770,12 +770,16 @@ class xclbin_full : public xclbin_impl
   // sections within this xclbin
   std::multimap<axlf_section_kind, std::vector<char>> m_axlf_sections;
 
+  // uncompressed image of an xclbin with compressed sections, created
+  // when first needed, which is typically when loading the xclbin
+  mutable std::vector<char> m_uncompressed_axlf;
+  mutable std::once_flag m_uncompress_flag;
+
   void
   emplace_section(const axlf_section_header* hdr, axlf_section_kind kind)
   {
-    auto section_data = reinterpret_cast<const char*>(m_top) + hdr->m_sectionOffset;
-    std::vector<char> data{section_data, section_data + hdr->m_sectionSize};
-    m_axlf_sections.emplace(kind , std::move(data));
+    // decompressed if compressed, only sections used by xrt::xclbin
+    m_axlf_sections.emplace(kind , xrt_core::xclbin::get_axlf_section_data(m_top, hdr));
   }
 
   void
@@ -909,7 +913,13 @@ public:
   const axlf*
   get_axlf() const override
   {
-    return m_top;
+    if (!xrt_core::xclbin::is_compressed(m_top))
+      return m_top;
+
+    std::call_once(m_uncompress_flag, [this] {
+      m_uncompressed_axlf = xrt_core::xclbin::get_uncompressed_axlf(m_top);
+    });
+    return reinterpret_cast<const axlf*>(m_uncompressed_axlf.data());
   }
 };
 
@@ -16,13 +16,17 @@
 
 #define XRT_CORE_COMMON_SOURCE
 #include "config_reader.h"
+#include "startup_profile.h"
 #include "message.h"
 #include "error.h"
 
+#include <atomic>
 #include <set>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <cstdlib>
+#include <vector>
 
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/ini_parser.hpp>
@@ -168,6 +172,7 @@ struct tree
 
   tree()
   {
+    xrt_core::startup::phase phase("read xrt.ini");
     auto ini_path = get_ini_path();
     if (!ini_path.empty())
       read(ini_path);
@@ -187,6 +192,80 @@ struct tree
   }
 };
 
+namespace snap {
+
+using xrt_core::config::snapshot;
+
+// Published snapshots are kept until the process exits since a reader
+// may still be using the one it loaded when a new one is published.
+// Snapshots are republished only by xrt::ini::set, so this is little.
+struct store
+{
+  std::mutex mutex;   // serializes publishers
+  std::atomic<const snapshot*> current {nullptr};
+  std::vector<std::unique_ptr<const snapshot>> published;
+};
+
+// Never destroyed so that the snapshot can be used during static
+// destruction
+static store&
+get_store()
+{
+  static auto s = new store;
+  return *s;
+}
+
+// Same lookup as the detail accessors, but without locking the key
+// since snapshot values can change
+static bool
+read_bool(const char* key, bool default_value)
+{
+  if (auto env = std::getenv(key))
+    return is_true(env);
+
+  try {
+    return tree::instance()->m_tree.get<bool>(key, default_value);
+  }
+  catch (const std::exception&) {
+    return default_value;
+  }
+}
+
+static unsigned int
+read_uint(const char* key, unsigned int default_value)
+{
+  try {
+    return tree::instance()->m_tree.get<unsigned int>(key, default_value);
+  }
+  catch (const std::exception&) {
+    return default_value;
+  }
+}
+
+static std::unique_ptr<const snapshot>
+resolve()
+{
+  auto s = std::make_unique<snapshot>();
+  s->cdma = read_bool("Runtime.cdma", true);
+  s->dataflow = read_bool("Runtime.dataflow", false);
+  s->rw_shared = read_bool("Runtime.rw_shared", false);
+  s->xrt_bo = read_bool("Runtime.xrt_bo", true);
+  s->verbosity = read_uint("Runtime.verbosity", 4); // NOLINT
+  return s;
+}
+
+// Must be called with store mutex locked
+static const snapshot*
+publish(store& st)
+{
+  st.published.push_back(resolve());
+  auto s = st.published.back().get();
+  st.current.store(s, std::memory_order_release);
+  return s;
+}
+
+} // snap
+
 }
 
 namespace xrt_core { namespace config {
@@ -266,15 +345,22 @@ set(const std::string& key, const std::string& value)
     throw xrt_core::error(-EINVAL,fmt.str());
   }
 
+  auto& st = snap::get_store();
+  std::lock_guard<std::mutex> lk(st.mutex);
   s_tree->m_tree.put(key, value);
+  snap::publish(st);
 }
 
 std::ostream&
 debug(std::ostream& ostr, const std::string& ini)
 {
   auto s_tree  = tree::instance();
-  if (!ini.empty())
+  if (!ini.empty()) {
+    auto& st = snap::get_store();
+    std::lock_guard<std::mutex> lk(st.mutex);
     s_tree->reread(ini);
+    snap::publish(st);
+  }
 
   for(auto& section : s_tree->m_tree) {
     ostr << "[" << section.first << "]\n";
@@ -287,4 +373,17 @@ debug(std::ostream& ostr, const std::string& ini)
 
 } // detail
 
+const snapshot&
+get_snapshot()
+{
+  auto& st = ::snap::get_store();
+  if (auto s = st.current.load(std::memory_order_acquire))
+    return *s;
+
+  std::lock_guard<std::mutex> lk(st.mutex);
+  if (auto s = st.current.load(std::memory_order_relaxed))
+    return *s;
+  return *::snap::publish(st);
+}
+
 }}
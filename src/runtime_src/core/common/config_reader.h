@@ -92,6 +92,38 @@ set(const std::string& key, const std::string& value);
 
 }
 
+/**
+ * struct snapshot - Typed values read on hot paths
+ *
+ * Resolved from xrt.ini and the environment the first time a value
+ * is needed, and again every time xrt::ini::set changes a key.  A
+ * published snapshot is never modified or freed, so readers get the
+ * current one with a single atomic load and then read plain fields
+ * without a lock, a tree walk, or a getenv.
+ *
+ * Unlike the statically cached accessors below, keys in the snapshot
+ * can be changed with xrt::ini::set after they have been used.  The
+ * change applies to operations that start after the set.
+ */
+struct snapshot
+{
+  bool cdma;                // Runtime.cdma
+  bool dataflow;            // Runtime.dataflow
+  bool rw_shared;           // Runtime.rw_shared
+  bool xrt_bo;              // Runtime.xrt_bo
+  unsigned int verbosity;   // Runtime.verbosity
+};
+
+/**
+ * get_snapshot() - Current configuration snapshot
+ *
+ * Lock free after the first call.  The returned reference stays
+ * valid for the life of the process.
+ */
+XRT_CORE_COMMON_EXPORT
+const snapshot&
+get_snapshot();
+
 /**
  * Public API.  Cached accessors.
  *
@@ -319,6 +351,26 @@ get_pl_deadlock_detection()
   return value;
 }
 
+/**
+ * Root directories of sysfs and devfs used by the PCIe Linux shim.
+ * Pointing these at a synthetic tree lets device scan, queries, and
+ * reports run without hardware.  Environment variables
+ * XRT_SYSFS_ROOT and XRT_DEVFS_ROOT take precedence.
+ */
+inline std::string
+get_sysfs_root()
+{
+  static std::string value = detail::get_string_value("Debug.sysfs_root", "/sys");
+  return value;
+}
+
+inline std::string
+get_devfs_root()
+{
+  static std::string value = detail::get_string_value("Debug.devfs_root", "/dev");
+  return value;
+}
+
 inline bool
 get_api_checks()
 {
@@ -343,9 +395,7 @@ get_logging()
 inline unsigned int
 get_verbosity()
 {
-  // NOLINTNEXTLINE
-  static unsigned int value = detail::get_uint_value("Runtime.verbosity",4);
-  return value;
+  return get_snapshot().verbosity;
 }
 
 inline unsigned int
@@ -525,13 +575,75 @@ get_ert_slotsize()
   return value;
 }
 
+/**
+ * NUMA placement of XRT allocated host memory for buffer objects
+ *  none:      default system policy, usually the node of the
+ *             allocating thread (default)
+ *  preferred: prefer the NUMA node of the device, fall back to other
+ *             nodes when the device node is out of memory
+ *  bind:      only use memory from the NUMA node of the device
+ * The policy can be overridden per buffer, see XRT_BO_NUMA_* in
+ * xrt_mem.h
+ */
+inline std::string
+get_host_mem_numa_policy()
+{
+  static std::string value = detail::get_string_value("Runtime.host_mem_numa_policy", "none");
+  return value;
+}
+
+/**
+ * Print wall time of XRT startup phases to stderr at exit, see
+ * startup_profile.h
+ */
 inline bool
-get_cdma()
+get_startup_report()
+{
+  static bool value = detail::get_bool_value("Runtime.startup_report", false);
+  return value;
+}
+
+/**
+ * Huge page backing of large XRT allocated host memory for buffer
+ * objects, see hugepage_pool.h
+ *  off:     regular pages
+ *  thp:     transparent huge pages
+ *  hugetlb: pages from the hugetlbfs reservation, falls back to
+ *           transparent huge pages when the reservation is exhausted
+ */
+inline std::string
+get_host_mem_hugepages()
+{
+  static std::string value = detail::get_string_value("Runtime.host_mem_hugepages", "off");
+  return value;
+}
+
+/**
+ * Smaller host memory allocations are not backed by huge pages
+ */
+inline unsigned int
+get_host_mem_hugepage_min_kb()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.host_mem_hugepage_min_kb", 2048);
+  return value;
+}
+
+/**
+ * Max size of freed huge page blocks kept for reuse
+ */
+inline unsigned int
+get_host_mem_hugepage_cache_mb()
 {
-  static bool value = detail::get_bool_value("Runtime.cdma",true);
+  static unsigned int value = detail::get_uint_value("Runtime.host_mem_hugepage_cache_mb", 256);
   return value;
 }
 
+inline bool
+get_cdma()
+{
+  return get_snapshot().cdma;
+}
+
 inline bool
 get_enable_pr()
 {
@@ -561,8 +673,13 @@ get_multiprocess()
 inline bool
 get_xrt_bo()
 {
-  static bool value = detail::get_bool_value("Runtime.xrt_bo", true);
-  return value;
+  return get_snapshot().xrt_bo;
+}
+
+inline bool
+get_dataflow()
+{
+  return get_snapshot().dataflow;
 }
 
 inline bool
@@ -643,8 +760,7 @@ get_sw_reset_kernels()
 inline bool
 get_rw_shared()
 {
-  static bool value = detail::get_bool_value("Runtime.rw_shared",false);
-  return value;
+  return get_snapshot().rw_shared;
 }
 
 /**
@@ -731,6 +847,19 @@ get_flag_sw_emu_kernel_debug()
   return value;
 }
 
+/**
+ * Direct sw_emu buffer transfers to device memory shared with the
+ * device process through its memory mapped backing file, rather than
+ * sending the data over the RPC socket.  Only buffers for which the
+ * device process reports a backing file are transferred this way.
+ */
+inline bool
+get_sw_emu_shared_memory()
+{
+  static bool value = detail::get_bool_value("Emulation.sw_emu_shared_memory", true);
+  return value;
+}
+
 // This flag is added to exit device offline status check loop forcibly.
 // By default, device offline status loop runs for 320 seconds.
 inline unsigned int
@@ -69,6 +69,24 @@ is_nodma() const
   return *m_nodma;
 }
 
+int
+device::
+get_numa_node() const
+{
+  std::lock_guard lk(m_mutex);
+  if (m_numa_node != boost::none)
+    return *m_numa_node;
+
+  try {
+    m_numa_node = xrt_core::device_query<xrt_core::query::numa_node>(this);
+  }
+  catch (const std::exception&) {
+    m_numa_node = -1;
+  }
+
+  return *m_numa_node;
+}
+
 uuid
 device::
 get_xclbin_uuid() const
@@ -181,6 +199,75 @@ get_xclbin(const uuid& xclbin_id) const
   return m_xclbin;
 }
 
+boost::any
+device::
+cached_query(const query::request& qr, query::key_type query_key) const
+{
+  std::unique_lock lk(m_query_cache_mutex);
+  auto itr = m_query_cache.find(query_key);
+  if (itr == m_query_cache.end()) {
+    lk.unlock();
+    return qr.get(this);
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  if (!itr->second.value.empty() && now < itr->second.expires)
+    return itr->second.value;
+
+  // Query the device without holding the lock.  The entry may be
+  // erased meanwhile, so look it up again.  Don't store the result
+  // if the cache was cleared meanwhile, it may predate an xclbin load
+  auto generation = m_query_cache_generation;
+  lk.unlock();
+  auto value = qr.get(this);
+  lk.lock();
+  itr = m_query_cache.find(query_key);
+  if (itr == m_query_cache.end() || generation != m_query_cache_generation)
+    return value;
+  itr->second.value = value;
+  itr->second.expires = now + itr->second.ttl;
+  return value;
+}
+
+void
+device::
+clear_query_cache() const
+{
+  if (!m_query_cache_enabled)
+    return;
+
+  std::lock_guard lk(m_query_cache_mutex);
+  ++m_query_cache_generation;
+  for (auto& entry : m_query_cache)
+    entry.second.value = boost::any();
+}
+
+void
+device::
+set_query_ttl(query::key_type query_key, std::chrono::milliseconds ttl) const
+{
+  std::lock_guard lk(m_query_cache_mutex);
+  if (ttl.count() == 0)
+    m_query_cache.erase(query_key);
+  else {
+    auto& entry = m_query_cache[query_key];
+    entry.ttl = ttl;
+    entry.value = boost::any();
+  }
+
+  // Queries bypass the cache when no key is cached
+  m_query_cache_enabled = !m_query_cache.empty();
+}
+
+std::chrono::milliseconds
+device::
+get_query_ttl(query::key_type query_key) const
+{
+  std::lock_guard lk(m_query_cache_mutex);
+  auto itr = m_query_cache.find(query_key);
+  return itr != m_query_cache.end() ? itr->second.ttl : std::chrono::milliseconds(0);
+}
+
 // Update cached xclbin data based on data queried from driver. This
 // function can be called by multiple threads. One entry point is
 // via register_axlf, another is through open_context.  For the latter,
@@ -191,6 +278,9 @@ void
 device::
 update_xclbin_info()
 {
+  // Cached query results may describe the previous xclbin
+  clear_query_cache();
+
   // Update cached slot xclbin uuid mapping
   std::lock_guard lk(m_mutex);
   try {
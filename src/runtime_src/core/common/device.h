@@ -17,7 +17,10 @@
 #include "core/include/xrt.h"
 #include "core/include/experimental/xrt_xclbin.h"
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <map>
@@ -194,11 +197,31 @@ public:
   bool
   is_nodma() const;
 
+  /**
+   * get_numa_node() - NUMA node closest to the device
+   *
+   * Return: NUMA node, or -1 if not known
+   *
+   * Cached for use when allocating host memory for buffers.
+   */
+  XRT_CORE_COMMON_EXPORT
+  int
+  get_numa_node() const;
+
  private:
   // Private look up function for concrete query::request
   virtual const query::request&
   lookup_query(query::key_type query_key) const = 0;
 
+  // Query through the result cache, see set_query_ttl()
+  XRT_CORE_COMMON_EXPORT
+  boost::any
+  cached_query(const query::request& qr, query::key_type query_key) const;
+
+  // Drop all cached query results
+  void
+  clear_query_cache() const;
+
 public:
   /**
    * query() - Query the device for specific property
@@ -211,6 +234,8 @@ public:
   query() const
   {
     auto& qr = lookup_query(QueryRequestType::key);
+    if (m_query_cache_enabled)
+      return cached_query(qr, QueryRequestType::key);
     return qr.get(this);
   }
 
@@ -229,6 +254,31 @@ public:
     return qr.get(this, std::forward<Args>(args)...);
   }
 
+  /**
+   * set_query_ttl() - Cache the result of a query request
+   *
+   * @query_key: Key of query request to cache
+   * @ttl: How long a result is reused before the device is queried
+   *  again, 0 disables caching of the key
+   *
+   * Caching is off by default.  It is meant for tools and monitors
+   * that repeatedly query slow changing properties, e.g. platform
+   * info and xclbin metadata, where each query costs one or more
+   * system calls.  Only queries without arguments are cached, and
+   * failed queries are not cached.  All cached results are dropped
+   * when an xclbin is loaded.
+   */
+  XRT_CORE_COMMON_EXPORT
+  void
+  set_query_ttl(query::key_type query_key, std::chrono::milliseconds ttl) const;
+
+  /**
+   * get_query_ttl() - TTL of a cached query request, 0 if not cached
+   */
+  XRT_CORE_COMMON_EXPORT
+  std::chrono::milliseconds
+  get_query_ttl(query::key_type query_key) const;
+
   /**
    * update() - Update a given property for this device
    *
@@ -466,6 +516,7 @@ public:
  private:
   id_type m_device_id;
   mutable boost::optional<bool> m_nodma = boost::none;
+  mutable boost::optional<int> m_numa_node = boost::none;
 
   using name2idx_type = std::map<std::string, cuidx_type>;
   std::map<slot_id, name2idx_type> m_cu2idx;  // slot -> cu name mapping to cuidx
@@ -473,6 +524,18 @@ public:
   xrt::xclbin m_xclbin;                       // currently loaded xclbin  (single-slot, default)
   xclbin_map m_xclbins;                       // currently loaded xclbins (multi-slot)
   mutable std::mutex m_mutex;
+
+  // Query results cached per set_query_ttl()
+  struct query_cache_entry
+  {
+    std::chrono::milliseconds ttl {0};
+    std::chrono::steady_clock::time_point expires;
+    boost::any value;
+  };
+  mutable std::map<query::key_type, query_cache_entry> m_query_cache;
+  mutable std::mutex m_query_cache_mutex;
+  mutable uint64_t m_query_cache_generation = 0; // bumped when cache is cleared
+  mutable std::atomic<bool> m_query_cache_enabled {false};
 };
 
 /**
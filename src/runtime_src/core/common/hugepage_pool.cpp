@@ -0,0 +1,264 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#define XRT_CORE_COMMON_SOURCE
+#include "hugepage_pool.h"
+
+#include "core/common/config_reader.h"
+#include "core/common/message.h"
+
+#include <string>
+
+#if defined(__linux__)
+# include <sys/mman.h>
+# ifndef MAP_HUGE_SHIFT
+#  define MAP_HUGE_SHIFT 26
+# endif
+# ifndef MAP_HUGE_2MB
+#  define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+# endif
+# ifndef MAP_HUGE_1GB
+#  define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+# endif
+#endif
+
+namespace {
+
+constexpr size_t gb = 1ULL << 30;
+
+// Classes are huge page multiples up to this size
+constexpr size_t linear_class_limit = 64 << 20;
+
+inline size_t
+round_up(size_t size, size_t align)
+{
+  return (size + align - 1) / align * align;
+}
+
+inline unsigned int
+msb(size_t value)
+{
+  unsigned int bit = 0;
+  while (value >>= 1)
+    ++bit;
+  return bit;
+}
+
+xrt_core::hugepage_pool::mode
+to_mode(const std::string& value)
+{
+  using mode = xrt_core::hugepage_pool::mode;
+  if (value == "off")
+    return mode::off;
+  if (value == "thp")
+    return mode::thp;
+  if (value == "hugetlb")
+    return mode::hugetlb;
+
+  xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT",
+                          "Unknown Runtime.host_mem_hugepages '" + value + "', using 'off'");
+  return mode::off;
+}
+
+} // namespace
+
+namespace xrt_core {
+
+hugepage_pool::
+hugepage_pool(mode m, size_t min_size, size_t cache_size)
+  : m_mode(m)
+  , m_min_size(min_size)
+  , m_cache_size(cache_size)
+{
+#if !defined(__linux__)
+  m_mode = mode::off;
+#endif
+}
+
+hugepage_pool::
+~hugepage_pool()
+{
+  trim();
+}
+
+size_t
+hugepage_pool::
+size_class(size_t size)
+{
+  auto sz = round_up(size, huge_page_size);
+  if (sz <= linear_class_limit)
+    return sz;
+
+  // Eight classes per power of two
+  return round_up(sz, size_t(1) << (msb(sz) - 3));
+}
+
+void*
+hugepage_pool::
+map(size_t size)
+{
+#if defined(__linux__)
+  constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  constexpr int prot = PROT_READ | PROT_WRITE;
+
+  if (m_mode == mode::hugetlb) {
+    if (size >= gb && !(size % gb)) {
+      auto addr = ::mmap(nullptr, size, prot, flags | MAP_HUGETLB | MAP_HUGE_1GB, -1, 0);
+      if (addr != MAP_FAILED)
+        return addr;
+    }
+
+    auto addr = ::mmap(nullptr, size, prot, flags | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+    if (addr != MAP_FAILED)
+      return addr;
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    ++m_stats.fallbacks;
+  }
+
+  // Transparent huge pages, the mapping must be huge page aligned
+  // for the kernel to back it with huge pages
+  auto raw = ::mmap(nullptr, size + huge_page_size, prot, flags, -1, 0);
+  if (raw == MAP_FAILED)
+    return nullptr;
+
+  auto start = reinterpret_cast<uintptr_t>(raw);
+  auto aligned = round_up(start, huge_page_size);
+  if (aligned > start)
+    ::munmap(raw, aligned - start);
+  if (auto tail = huge_page_size - (aligned - start))
+    ::munmap(reinterpret_cast<void*>(aligned + size), tail);
+
+  auto addr = reinterpret_cast<void*>(aligned);
+  ::madvise(addr, size, MADV_HUGEPAGE);
+  return addr;
+#else
+  return nullptr;
+#endif
+}
+
+void
+hugepage_pool::
+unmap(void* addr, size_t size)
+{
+#if defined(__linux__)
+  ::munmap(addr, size);
+#endif
+}
+
+aligned_ptr_type
+hugepage_pool::
+alloc(size_t size, int node, numa_policy policy)
+{
+  if (m_mode == mode::off || !size || size < m_min_size)
+    return {};
+
+  auto cls = size_class(size);
+  if (policy == numa_policy::none || node < 0) {
+    node = -1;
+    policy = numa_policy::none;
+  }
+
+  void* addr = nullptr;
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto itr = m_free.find({cls, node, policy});
+    if (itr != m_free.end() && !itr->second.empty()) {
+      addr = itr->second.back();
+      itr->second.pop_back();
+      m_stats.bytes_cached -= cls;
+      ++m_stats.hits;
+    }
+  }
+
+  if (!addr) {
+    // Map outside the lock, this is the slow path
+    addr = map(cls);
+    if (!addr)
+      return {};
+    numa_bind(addr, cls, node, policy);
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    ++m_stats.misses;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_in_use.emplace(addr, block{cls, size, node, policy});
+    m_stats.bytes_in_use += cls;
+    m_stats.bytes_requested += size;
+  }
+
+  aligned_ptr_deleter deleter;
+  deleter.release = &hugepage_pool::release;
+  deleter.ctx = this;
+  return aligned_ptr_type(addr, deleter);
+}
+
+void
+hugepage_pool::
+free(void* addr)
+{
+  std::unique_lock<std::mutex> lk(m_mutex);
+  auto itr = m_in_use.find(addr);
+  if (itr == m_in_use.end())
+    return;
+
+  auto blk = itr->second;
+  m_in_use.erase(itr);
+  m_stats.bytes_in_use -= blk.size;
+  m_stats.bytes_requested -= blk.requested;
+
+  if (m_stats.bytes_cached + blk.size <= m_cache_size) {
+    m_free[{blk.size, blk.node, blk.policy}].push_back(addr);
+    m_stats.bytes_cached += blk.size;
+    return;
+  }
+
+  lk.unlock();
+  unmap(addr, blk.size);
+}
+
+void
+hugepage_pool::
+release(void* ctx, void* addr)
+{
+  static_cast<hugepage_pool*>(ctx)->free(addr);
+}
+
+void
+hugepage_pool::
+trim()
+{
+  decltype(m_free) blocks;
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    blocks.swap(m_free);
+    m_stats.bytes_cached = 0;
+  }
+
+  for (auto& [key, addrs] : blocks)
+    for (auto addr : addrs)
+      unmap(addr, std::get<0>(key));
+}
+
+hugepage_pool::stats
+hugepage_pool::
+get_stats() const
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  return m_stats;
+}
+
+hugepage_pool&
+hugepage_pool::
+instance()
+{
+  // Never destroyed, buffers may be freed during static destruction
+  static auto pool = new hugepage_pool
+    (to_mode(config::get_host_mem_hugepages()),
+     static_cast<size_t>(config::get_host_mem_hugepage_min_kb()) << 10,
+     static_cast<size_t>(config::get_host_mem_hugepage_cache_mb()) << 20);
+  return *pool;
+}
+
+} // xrt_core
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrtcore_common_hugepage_pool_h_
+#define xrtcore_common_hugepage_pool_h_
+
+#include "core/common/config.h"
+#include "core/common/memalign.h"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace xrt_core {
+
+/**
+ * class hugepage_pool - host memory backed by huge pages
+ *
+ * Large host buffers backed by 4K pages pay for TLB misses on access
+ * and for pinning every page when used for DMA.  The pool maps
+ * memory in units of 2MB huge pages, either from the hugetlbfs
+ * reservation or as transparent huge pages, and caches freed blocks
+ * for reuse so that the cost of mapping and faulting in is paid once.
+ *
+ * Allocations are rounded up to a size class.  Classes are multiples
+ * of 2MB up to 64MB and eight classes per power of two above, so at
+ * most 12.5% of a large block is unused.  Freed blocks are kept on a
+ * free list per size class and NUMA node until the cache limit is
+ * reached, after which they are unmapped.
+ *
+ * With hugetlb, blocks of 1GB or more are mapped with 1GB pages when
+ * available.  If the hugetlbfs reservation is exhausted the pool
+ * falls back to transparent huge pages.
+ */
+class hugepage_pool
+{
+public:
+  enum class mode { off, thp, hugetlb };
+
+  /**
+   * struct stats - pool counters
+   *
+   * @hits:            allocations served from a cached block
+   * @misses:          allocations that mapped a new block
+   * @fallbacks:       hugetlb allocations that fell back to thp
+   * @bytes_requested: bytes requested by allocations in use
+   * @bytes_in_use:    bytes of blocks in use, per size class
+   * @bytes_cached:    bytes of free blocks kept for reuse
+   */
+  struct stats
+  {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t fallbacks = 0;
+    uint64_t bytes_requested = 0;
+    uint64_t bytes_in_use = 0;
+    uint64_t bytes_cached = 0;
+
+    // Fraction of the blocks in use lost to size class rounding
+    double
+    fragmentation() const
+    {
+      return bytes_in_use
+        ? 1.0 - static_cast<double>(bytes_requested) / bytes_in_use
+        : 0.0;
+    }
+  };
+
+  static constexpr size_t huge_page_size = 2 << 20;
+
+  /**
+   * hugepage_pool() - Create a pool
+   *
+   * @m:          Huge page backing, mode::off disables the pool
+   * @min_size:   Smaller allocations are not served by the pool
+   * @cache_size: Max bytes of freed blocks kept for reuse
+   */
+  XRT_CORE_COMMON_EXPORT
+  hugepage_pool(mode m, size_t min_size, size_t cache_size);
+
+  XRT_CORE_COMMON_EXPORT
+  ~hugepage_pool();
+
+  hugepage_pool(const hugepage_pool&) = delete;
+  hugepage_pool& operator=(const hugepage_pool&) = delete;
+
+  /**
+   * alloc() - Allocate host memory from the pool
+   *
+   * @size:   Bytes to allocate
+   * @node:   NUMA node for the memory, -1 for none
+   * @policy: NUMA placement policy
+   * Return:  Huge page aligned memory, or empty pointer if the pool is
+   *          off, @size is below the pool minimum, or mapping failed
+   *
+   * The returned pointer returns the memory to the pool when reset.
+   */
+  XRT_CORE_COMMON_EXPORT
+  aligned_ptr_type
+  alloc(size_t size, int node, numa_policy policy);
+
+  XRT_CORE_COMMON_EXPORT
+  stats
+  get_stats() const;
+
+  // Release all cached blocks
+  XRT_CORE_COMMON_EXPORT
+  void
+  trim();
+
+  // Size class of an allocation of @size bytes
+  XRT_CORE_COMMON_EXPORT
+  static size_t
+  size_class(size_t size);
+
+  // Process wide pool for buffer objects configured per xrt.ini
+  XRT_CORE_COMMON_EXPORT
+  static hugepage_pool&
+  instance();
+
+private:
+  struct block
+  {
+    size_t size;       // size class
+    size_t requested;  // bytes requested
+    int node;          // NUMA node, -1 for none
+    numa_policy policy;
+  };
+
+  // Freed blocks are reused only with the same size class and
+  // NUMA placement
+  using free_key = std::tuple<size_t, int, numa_policy>; // (class, node, policy)
+
+  void*
+  map(size_t size);
+
+  void
+  unmap(void* addr, size_t size);
+
+  void
+  free(void* addr);
+
+  static void
+  release(void* ctx, void* addr);
+
+  mode m_mode;
+  size_t m_min_size;
+  size_t m_cache_size;
+
+  mutable std::mutex m_mutex;
+  std::unordered_map<void*, block> m_in_use;
+  std::map<free_key, std::vector<void*>> m_free;
+  stats m_stats;
+};
+
+} // xrt_core
+
+#endif
@@ -17,9 +17,18 @@
 #ifndef xrtcore_memalign_h_
 #define xrtcore_memalign_h_
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <memory>
 #include <stdexcept>
+#include <vector>
+
+#if defined(__linux__)
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
 
 namespace xrt_core {
 
@@ -48,11 +57,22 @@ posix_memalign(void **memptr, size_t alignment, size_t size)
 
 struct aligned_ptr_deleter
 {
+  // Memory that is not from the C heap, e.g. from the huge page
+  // pool, is returned through release
+  void (*release)(void* ctx, void* ptr) = nullptr;
+  void* ctx = nullptr;
+
+  void operator() (void* ptr)
+  {
+    if (release)
+      release(ctx, ptr);
+    else
 #if defined(_WINDOWS)
-  void operator() (void* ptr)  { _aligned_free(ptr); }
+      _aligned_free(ptr);
 #else
-  void operator() (void* ptr)  { free(ptr); }
+      free(ptr);
 #endif
+  }
 };
 using aligned_ptr_type = std::unique_ptr<void, aligned_ptr_deleter>;
 inline aligned_ptr_type
@@ -69,6 +89,93 @@ aligned_alloc(size_t align, size_t size)
 #endif
 }
 
+// Placement of host memory relative to a NUMA node
+enum class numa_policy { none, preferred, bind };
+
+// numa_bind() - Apply a NUMA memory policy to host memory
+//
+// The policy is applied only to the whole pages inside the range,
+// pages shared with neighbouring memory are left alone.  Pages
+// already resident are migrated if possible.  Best effort, returns
+// false if the policy was not applied, e.g. no node, no whole page
+// in the range, or no kernel NUMA support.
+inline bool
+numa_bind(void* addr, size_t size, int node, numa_policy policy)
+{
+#if defined(__linux__)
+  if (node < 0 || policy == numa_policy::none || !addr || !size)
+    return false;
+
+  // mbind(2) through syscall to avoid a dependency on libnuma
+  constexpr int mpol_preferred = 1;
+  constexpr int mpol_bind = 2;
+  constexpr unsigned int mpol_mf_move = 1 << 1;
+  constexpr size_t bits = sizeof(unsigned long) * 8;
+
+  auto page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  auto begin = (reinterpret_cast<uintptr_t>(addr) + page - 1) & ~(page - 1);
+  auto end = (reinterpret_cast<uintptr_t>(addr) + size) & ~(page - 1);
+  if (begin >= end)
+    return false;
+
+  std::vector<unsigned long> mask(node / bits + 1, 0);
+  mask[node / bits] = 1UL << (node % bits);
+  auto mode = (policy == numa_policy::bind) ? mpol_bind : mpol_preferred;
+  return syscall(SYS_mbind, begin, end - begin, mode, mask.data(), mask.size() * bits + 1, mpol_mf_move) == 0;
+#else
+  return false;
+#endif
+}
+
+#if defined(__linux__)
+namespace detail {
+
+// Release of memory mapped by aligned_alloc() with a NUMA policy,
+// ctx is the length of the mapping
+inline void
+munmap_release(void* ctx, void* ptr)
+{
+  ::munmap(ptr, reinterpret_cast<uintptr_t>(ctx));
+}
+
+} // detail
+#endif
+
+// aligned_alloc() - Allocate aligned host memory placed per NUMA policy
+//
+// Memory with a policy is a dedicated anonymous mapping rather than
+// C heap memory, so the policy never applies to pages of other
+// allocations or splits heap mappings.  The pages are placed when
+// first touched.  Without a policy, or if the mapping fails, the
+// memory comes from the C heap.
+inline aligned_ptr_type
+aligned_alloc(size_t align, size_t size, int node, numa_policy policy)
+{
+#if defined(__linux__)
+  if (node >= 0 && policy != numa_policy::none && size && align && !(align & (align - 1))) {
+    auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    align = std::max(align, page);
+    auto length = (size + page - 1) & ~(page - 1);
+    auto mapped = length + align - page;
+    auto addr = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr != MAP_FAILED) {
+      // Trim the mapping to the aligned range
+      auto base = reinterpret_cast<uintptr_t>(addr);
+      auto start = (base + align - 1) & ~(align - 1);
+      if (start > base)
+        ::munmap(addr, start - base);
+      if (base + mapped > start + length)
+        ::munmap(reinterpret_cast<void*>(start + length), base + mapped - (start + length));
+
+      numa_bind(reinterpret_cast<void*>(start), length, node, policy);
+      return aligned_ptr_type(reinterpret_cast<void*>(start),
+                              aligned_ptr_deleter{&detail::munmap_release, reinterpret_cast<void*>(length)});
+    }
+  }
+#endif
+  return aligned_alloc(align, size);
+}
+
 } // xrt_core
 
 #endif
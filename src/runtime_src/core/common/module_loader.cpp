@@ -18,6 +18,7 @@
 
 #include "core/common/dlfcn.h"
 #include "core/common/config_reader.h"
+#include "core/common/startup_profile.h"
 
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
@@ -168,10 +169,15 @@ driver_plugin_paths()
   return ret;
 }
 
+// The shim is bound immediately, it is used right away and a missing
+// symbol is best reported when it is loaded.  Plugin modules and
+// driver plugins are bound lazily, most of their functions are never
+// called by short running applications and resolving them all adds
+// to startup time.
 static void*
-load_library(const std::string& path)
+load_library(const std::string& path, int binding)
 {
-  if (auto handle = xrt_core::dlopen(path.c_str(), RTLD_NOW | RTLD_GLOBAL))
+  if (auto handle = xrt_core::dlopen(path.c_str(), binding | RTLD_GLOBAL))
     return handle;
 
   throw std::runtime_error("Failed to open library '" + path + "'\n" + xrt_core::dlerror());
@@ -193,8 +199,9 @@ module_loader(const std::string& module_name,
     if (error_function()) 
       return;
 
+  startup::phase phase("load module " + module_name);
   auto path = module_path(module_name);
-  auto handle = load_library(path.string());
+  auto handle = load_library(path.string(), RTLD_LAZY);
 
   // Do the plugin specific functionality
   if (register_function)
@@ -211,17 +218,19 @@ module_loader(const std::string& module_name,
 shim_loader::
 shim_loader()
 {
+  startup::phase phase("load shim");
   auto path = shim_path();
-  load_library(path.string());
+  load_library(path.string(), RTLD_NOW);
 }
 
 driver_loader::
 driver_loader()
 {
+  startup::phase phase("load driver plugins");
   auto paths = driver_plugin_paths();
 
   for (const auto& p : paths)
-    load_library(p);
+    load_library(p, RTLD_LAZY);
 }
 
 } // xrt_core
@@ -295,6 +295,7 @@ enum class key_type
   xgq_scaling_enabled,
   xgq_scaling_power_override,
   xgq_scaling_temp_override,
+  numa_node,
   noop
 };
 
@@ -2711,6 +2712,17 @@ struct cpu_affinity : request
   get(const device*) const = 0;
 };
 
+// NUMA node of the device's PCIe root port, -1 if the platform
+// does not report one, e.g. a single node system
+struct numa_node : request
+{
+  using result_type = int32_t;
+  static const key_type key = key_type::numa_node;
+
+  virtual boost::any
+  get(const device*) const = 0;
+};
+
 struct shared_host_mem : request
 {
   using result_type = uint64_t;
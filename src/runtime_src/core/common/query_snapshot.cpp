@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#define XRT_CORE_COMMON_SOURCE
+#include "query_snapshot.h"
+
+namespace {
+
+// Requests whose result changes only when the platform is flashed
+// or an xclbin is loaded
+static constexpr xrt_core::query::key_type slow_changing_keys[] = {
+  xrt_core::query::key_type::pcie_vendor,
+  xrt_core::query::key_type::pcie_device,
+  xrt_core::query::key_type::pcie_subsystem_vendor,
+  xrt_core::query::key_type::pcie_subsystem_id,
+  xrt_core::query::key_type::pcie_bdf,
+  xrt_core::query::key_type::pcie_link_speed_max,
+  xrt_core::query::key_type::pcie_express_lane_width_max,
+  xrt_core::query::key_type::rom_vbnv,
+  xrt_core::query::key_type::rom_ddr_bank_size_gb,
+  xrt_core::query::key_type::rom_ddr_bank_count_max,
+  xrt_core::query::key_type::rom_fpga_name,
+  xrt_core::query::key_type::rom_uuid,
+  xrt_core::query::key_type::rom_time_since_epoch,
+  xrt_core::query::key_type::xclbin_uuid,
+  xrt_core::query::key_type::group_topology,
+  xrt_core::query::key_type::mem_topology_raw,
+  xrt_core::query::key_type::ip_layout_raw,
+  xrt_core::query::key_type::debug_ip_layout_raw,
+  xrt_core::query::key_type::clock_freq_topology_raw,
+  xrt_core::query::key_type::xmc_version,
+  xrt_core::query::key_type::xmc_board_name,
+  xrt_core::query::key_type::xmc_serial_num,
+  xrt_core::query::key_type::xmc_sc_version,
+  xrt_core::query::key_type::expected_sc_version,
+  xrt_core::query::key_type::dna_serial_num,
+  xrt_core::query::key_type::mac_contiguous_num,
+  xrt_core::query::key_type::mac_addr_first,
+  xrt_core::query::key_type::mac_addr_list,
+  xrt_core::query::key_type::oem_id,
+  xrt_core::query::key_type::is_mfg,
+  xrt_core::query::key_type::mfg_ver,
+  xrt_core::query::key_type::is_versal,
+  xrt_core::query::key_type::flash_type,
+  xrt_core::query::key_type::flash_size,
+  xrt_core::query::key_type::board_name,
+  xrt_core::query::key_type::interface_uuids,
+  xrt_core::query::key_type::logic_uuids,
+};
+
+} // namespace
+
+namespace xrt_core { namespace query {
+
+std::map<key_type, std::chrono::milliseconds>
+cache_slow_changing(const device* device, std::chrono::milliseconds ttl)
+{
+  std::map<key_type, std::chrono::milliseconds> previous;
+  for (auto key : slow_changing_keys) {
+    previous.emplace(key, device->get_query_ttl(key));
+    device->set_query_ttl(key, ttl);
+  }
+  return previous;
+}
+
+}} // query, xrt_core
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrt_core_common_query_snapshot_h_
+#define xrt_core_common_query_snapshot_h_
+
+#include "config.h"
+#include "device.h"
+#include "query_requests.h"
+
+#include <chrono>
+#include <exception>
+#include <map>
+#include <utility>
+
+namespace xrt_core { namespace query {
+
+/**
+ * cache_slow_changing() - Cache results of slow changing query requests
+ *
+ * @device: Device to enable query caching for
+ * @ttl: How long a cached result is used before the device is queried again
+ *
+ * Enables the device query cache (see device::set_query_ttl) for
+ * requests that only change when the platform is flashed or an
+ * xclbin is loaded: PCIe identity, platform ROM, xclbin metadata,
+ * and board and management controller info.  Dynamic values such
+ * as sensors, status, and error counters are never cached.
+ *
+ * Return: The previous TTL of each request, 0 if it was not cached
+ */
+XRT_CORE_COMMON_EXPORT
+std::map<key_type, std::chrono::milliseconds>
+cache_slow_changing(const device* device, std::chrono::milliseconds ttl);
+
+/**
+ * class slow_changing_cache - Scope of cache_slow_changing()
+ *
+ * Caches the slow changing requests of a device for the lifetime
+ * of the object, e.g. while a set of reports is generated.  When
+ * destroyed, the requests get back the TTLs they had before, so
+ * caching set up by an enclosing scope is kept.
+ */
+class slow_changing_cache
+{
+  const device* m_device;
+  std::map<key_type, std::chrono::milliseconds> m_previous_ttl;
+
+public:
+  slow_changing_cache(const device* device, std::chrono::milliseconds ttl)
+    : m_device(device)
+    , m_previous_ttl(cache_slow_changing(m_device, ttl))
+  {}
+
+  ~slow_changing_cache()
+  {
+    for (const auto& [key, ttl] : m_previous_ttl)
+      m_device->set_query_ttl(key, ttl);
+  }
+
+  slow_changing_cache(const slow_changing_cache&) = delete;
+  slow_changing_cache& operator=(const slow_changing_cache&) = delete;
+};
+
+/**
+ * class snapshot - query results of a device, each queried once
+ *
+ * A snapshot queries each request at most once and serves the
+ * result to any number of readers, e.g. all the reports generated
+ * for one device.  Requests can be fetched up front, or are fetched
+ * on first use.  A request that fails records its exception, which
+ * get() rethrows.
+ *
+ * A snapshot is not thread safe.
+ */
+class snapshot
+{
+  const device* m_device;
+  std::map<key_type, std::pair<boost::any, std::exception_ptr>> m_results;
+
+  template <typename QueryRequestType>
+  std::pair<boost::any, std::exception_ptr>&
+  fetch_one()
+  {
+    auto& result = m_results[QueryRequestType::key];
+    try {
+      result.first = m_device->query<QueryRequestType>();
+      result.second = nullptr;
+    }
+    catch (...) {
+      result.second = std::current_exception();
+    }
+    return result;
+  }
+
+public:
+  explicit
+  snapshot(const device* device)
+    : m_device(device)
+  {}
+
+  /**
+   * fetch() - Query a set of requests, replacing previous results
+   *
+   * The requests are queried one after the other, each costs what
+   * a device query costs.  Only repeated queries are saved.
+   */
+  template <typename ...QueryRequestTypes>
+  void
+  fetch()
+  {
+    (fetch_one<QueryRequestTypes>(), ...);
+  }
+
+  /**
+   * get() - Result of a request, fetched now if not in the snapshot
+   *
+   * Throws the exception of a failed request
+   */
+  template <typename QueryRequestType>
+  typename QueryRequestType::result_type
+  get()
+  {
+    auto itr = m_results.find(QueryRequestType::key);
+    auto& result = (itr != m_results.end()) ? itr->second : fetch_one<QueryRequestType>();
+    if (result.second)
+      std::rethrow_exception(result.second);
+    return boost::any_cast<typename QueryRequestType::result_type>(result.first);
+  }
+
+  /**
+   * get_default() - Result of a request, or default if the device
+   * does not support it, per xrt_core::device_query_default
+   */
+  template <typename QueryRequestType>
+  typename QueryRequestType::result_type
+  get_default(const typename QueryRequestType::result_type& default_value)
+  {
+    try {
+      return get<QueryRequestType>();
+    }
+    catch (const no_such_key&) {
+      return default_value;
+    }
+    catch (const sysfs_error&) {
+      return default_value;
+    }
+  }
+};
+
+}} // query, xrt_core
+
+#endif
@@ -126,7 +126,7 @@ init(xclDeviceHandle handle, const axlf* top)
   ecmd->cu_dma  = xrt_core::config::get_ert_cudma();
   ecmd->cu_isr  = xrt_core::config::get_ert_cuisr() && xclbin::get_cuisr(top);
   ecmd->cq_int  = xrt_core::config::get_ert_cqint();
-  ecmd->dataflow = xclbin::get_dataflow(top) || xrt_core::config::get_feature_toggle("Runtime.dataflow");
+  ecmd->dataflow = xclbin::get_dataflow(top) || xrt_core::config::get_dataflow();
   ecmd->rw_shared = xrt_core::config::get_rw_shared();
 
   // cu addr map
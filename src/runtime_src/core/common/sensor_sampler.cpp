@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#define XRT_CORE_COMMON_SOURCE
+#include "sensor_sampler.h"
+#include "core/common/time.h"
+
+#include <algorithm>
+#include <fcntl.h>
+
+#ifdef _WIN32
+# include <io.h>
+#else
+# include <unistd.h>
+#endif
+
+namespace {
+
+static int
+open_sensor(const std::string& path)
+{
+  if (path.empty())
+    return -1;
+#ifdef _WIN32
+  return ::_open(path.c_str(), _O_RDONLY);
+#else
+  return ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+}
+
+static void
+close_sensor(int fd)
+{
+  if (fd < 0)
+    return;
+#ifdef _WIN32
+  ::_close(fd);
+#else
+  ::close(fd);
+#endif
+}
+
+// Read the value of a sensor file from offset 0, 0 on any error
+static uint64_t
+read_sensor(int fd)
+{
+  if (fd < 0)
+    return 0;
+
+  char buf[32];
+#ifdef _WIN32
+  if (::_lseek(fd, 0, SEEK_SET) < 0)
+    return 0;
+  auto len = ::_read(fd, buf, sizeof(buf));
+#else
+  auto len = ::pread(fd, buf, sizeof(buf), 0);
+#endif
+  if (len <= 0)
+    return 0;
+
+  uint64_t value = 0;
+  for (decltype(len) i = 0; i < len && buf[i] >= '0' && buf[i] <= '9'; ++i)
+    value = value * 10 + (buf[i] - '0');
+  return value;
+}
+
+} // namespace
+
+namespace xrt_core {
+
+sensor_sampler::
+sensor_sampler(const std::vector<std::string>& paths,
+               std::chrono::microseconds interval,
+               size_t capacity)
+  : m_interval(interval)
+  , m_capacity(std::max<size_t>(capacity, 1))
+  , m_timestamps(m_capacity)
+  , m_values(m_capacity * paths.size())
+  , m_consume_timestamps(m_capacity)
+  , m_consume_values(m_capacity * paths.size())
+  , m_sample(paths.size())
+{
+  m_fds.reserve(paths.size());
+  for (const auto& path : paths)
+    m_fds.push_back(open_sensor(path));
+}
+
+sensor_sampler::
+~sensor_sampler()
+{
+  stop();
+  for (auto fd : m_fds)
+    close_sensor(fd);
+}
+
+void
+sensor_sampler::
+start()
+{
+  if (m_thread.joinable())
+    return;
+  m_stop = false;
+  m_thread = std::thread(&sensor_sampler::run, this);
+}
+
+void
+sensor_sampler::
+stop()
+{
+  if (!m_thread.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_stop = true;
+  }
+  m_stop_cv.notify_all();
+  m_thread.join();
+}
+
+void
+sensor_sampler::
+read(uint64_t* values) const
+{
+  for (size_t i = 0; i < m_fds.size(); ++i)
+    values[i] = read_sensor(m_fds[i]);
+}
+
+void
+sensor_sampler::
+run()
+{
+  const auto num = m_fds.size();
+  auto next = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lk(m_mutex);
+  while (!m_stop) {
+    lk.unlock();
+    auto timestamp = xrt_core::time_ns();
+    read(m_sample.data());
+    lk.lock();
+
+    auto slot = (m_head + m_count) % m_capacity;
+    if (m_count == m_capacity) {
+      m_head = (m_head + 1) % m_capacity;
+      ++m_dropped;
+    }
+    else {
+      ++m_count;
+    }
+    m_timestamps[slot] = timestamp;
+    std::copy(m_sample.begin(), m_sample.end(), m_values.begin() + slot * num);
+
+    // Fixed rate schedule; if sampling falls behind, skip the missed
+    // intervals rather than sampling back to back
+    next += m_interval;
+    auto now = std::chrono::steady_clock::now();
+    if (next < now)
+      next = now + m_interval;
+    m_stop_cv.wait_until(lk, next, [this] { return m_stop; });
+  }
+}
+
+size_t
+sensor_sampler::
+consume(const sample_callback& callback)
+{
+  // Copy the samples out of the ring so the sampling thread is not
+  // blocked while the callbacks run
+  std::lock_guard<std::mutex> clk(m_consume_mutex);
+  const auto num = m_fds.size();
+  size_t count = 0;
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    for (; count < m_count; ++count) {
+      auto slot = (m_head + count) % m_capacity;
+      m_consume_timestamps[count] = m_timestamps[slot];
+      std::copy_n(m_values.begin() + slot * num, num, m_consume_values.begin() + count * num);
+    }
+    m_head = (m_head + count) % m_capacity;
+    m_count = 0;
+  }
+
+  for (size_t i = 0; i < count; ++i)
+    callback(m_consume_timestamps[i], m_consume_values.data() + i * num);
+  return count;
+}
+
+} // xrt_core
@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrtcore_common_sensor_sampler_h_
+#define xrtcore_common_sensor_sampler_h_
+
+#include "core/common/config.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xrt_core {
+
+/**
+ * class sensor_sampler - periodic sampling of sysfs style sensor files
+ *
+ * A sensor file holds one unsigned decimal value, e.g. a sysfs hwmon
+ * or xmc attribute.  The sampler opens all files once and keeps the
+ * descriptors open, re-reading them from offset 0 on each sample
+ * with no allocation.  Files that cannot be opened or read sample as
+ * 0 so that the value for sensor i is always at index i.
+ *
+ * When started, a sampling thread reads all sensors at a fixed
+ * interval, independent of how long the reads take, and stores the
+ * samples in a ring preallocated for @capacity samples.  Consumers
+ * drain the ring with consume().  If the ring is full the oldest
+ * sample is overwritten and counted as dropped.
+ *
+ * The sampler takes plain file paths, so it can be pointed at a fake
+ * sysfs tree for testing.
+ */
+class sensor_sampler
+{
+public:
+  // Callback receiving one sample: timestamp per xrt_core::time_ns()
+  // and one value per sensor, in the order of the constructor paths
+  using sample_callback = std::function<void(uint64_t, const uint64_t*)>;
+
+  /**
+   * sensor_sampler() - Open sensor files
+   *
+   * @paths:    Sensor files to sample, empty strings are allowed
+   * @interval: Sampling interval of the sampling thread
+   * @capacity: Number of samples the ring can hold
+   */
+  XRT_CORE_COMMON_EXPORT
+  sensor_sampler(const std::vector<std::string>& paths,
+                 std::chrono::microseconds interval,
+                 size_t capacity);
+
+  XRT_CORE_COMMON_EXPORT
+  ~sensor_sampler();
+
+  sensor_sampler(const sensor_sampler&) = delete;
+  sensor_sampler& operator=(const sensor_sampler&) = delete;
+
+  /**
+   * start() - Start the sampling thread
+   */
+  XRT_CORE_COMMON_EXPORT
+  void
+  start();
+
+  /**
+   * stop() - Stop the sampling thread
+   *
+   * Samples already in the ring remain available to consume()
+   */
+  XRT_CORE_COMMON_EXPORT
+  void
+  stop();
+
+  /**
+   * read() - Read all sensors now, bypassing the ring
+   *
+   * @values: Array of num_sensors() values to fill in
+   *
+   * For one-shot readers such as xbutil.  Must not be called while
+   * the sampling thread is running.
+   */
+  XRT_CORE_COMMON_EXPORT
+  void
+  read(uint64_t* values) const;
+
+  /**
+   * consume() - Remove all samples from the ring, oldest first
+   *
+   * @callback: Called once per sample, outside of the ring lock
+   * Return:    Number of samples consumed
+   */
+  XRT_CORE_COMMON_EXPORT
+  size_t
+  consume(const sample_callback& callback);
+
+  size_t
+  num_sensors() const
+  {
+    return m_fds.size();
+  }
+
+  // Number of samples overwritten before they were consumed
+  uint64_t
+  dropped() const
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_dropped;
+  }
+
+private:
+  void
+  run();
+
+  std::vector<int> m_fds;
+  std::chrono::microseconds m_interval;
+
+  // Ring of m_capacity samples, each with a timestamp and
+  // num_sensors() values stored contiguously
+  size_t m_capacity;
+  std::vector<uint64_t> m_timestamps;
+  std::vector<uint64_t> m_values;
+  size_t m_head = 0;  // oldest sample
+  size_t m_count = 0; // samples in ring
+  uint64_t m_dropped = 0;
+  mutable std::mutex m_mutex;
+
+  // Scratch space for samples handed to consume() callbacks
+  std::vector<uint64_t> m_consume_timestamps;
+  std::vector<uint64_t> m_consume_values;
+  std::mutex m_consume_mutex;
+
+  // Values read by the sampling thread before they are stored in the ring
+  std::vector<uint64_t> m_sample;
+
+  std::thread m_thread;
+  std::condition_variable m_stop_cv;
+  bool m_stop = false;
+};
+
+} // xrt_core
+
+#endif
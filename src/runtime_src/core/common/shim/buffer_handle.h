@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <memory>
+#include <vector>
 
 namespace xrt_core {
 
@@ -30,6 +31,13 @@ public:
     device2host = XCL_BO_SYNC_BO_FROM_DEVICE,
   };
 
+  // range - part of a buffer
+  struct range
+  {
+    size_t size;
+    size_t offset;
+  };
+
   // properties - buffer details
   struct properties
   {
@@ -62,6 +70,17 @@ public:
   virtual void
   sync(direction, size_t size, size_t offset) = 0;
 
+  // Sync multiple ranges of a buffer to or from device.  The ranges
+  // are sorted by offset and neither overlap nor touch.  A shim
+  // whose driver can sync several ranges in one call overrides this,
+  // by default the ranges are synced one at a time.
+  virtual void
+  sync_ranges(direction dir, const std::vector<range>& ranges)
+  {
+    for (const auto& r : ranges)
+      sync(dir, r.size, r.offset);
+  }
+
   // Copy size bytes from src buffer at src offset into this
   // buffer at dst offset
   virtual void
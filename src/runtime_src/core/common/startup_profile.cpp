@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#define XRT_CORE_COMMON_SOURCE
+#include "core/common/startup_profile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+namespace {
+
+using time_point = xrt_core::startup::clock::time_point;
+
+struct profile
+{
+  struct entry
+  {
+    std::string name;
+    time_point start;
+    time_point end;
+  };
+
+  std::mutex mutex;
+  bool has_epoch = false;
+  time_point epoch;
+  std::vector<entry> phases;
+};
+
+// Never destroyed so that phases can be recorded and reported during
+// static destruction
+static profile&
+instance()
+{
+  static auto p = new profile;
+  return *p;
+}
+
+// Startup is expected to be done well before this, later phases, eg.
+// devices opened again and again, are not recorded
+constexpr size_t max_phases = 256;
+
+static uint64_t
+to_us(xrt_core::startup::clock::duration d)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+static void
+report_at_exit()
+{
+  xrt_core::startup::report(std::cerr);
+}
+
+}
+
+namespace xrt_core { namespace startup {
+
+void
+record(const std::string& name, clock::time_point start, clock::time_point end)
+{
+  auto& p = instance();
+  std::lock_guard lk(p.mutex);
+  if (p.phases.size() >= max_phases)
+    return;
+  if (!p.has_epoch || start < p.epoch) {
+    p.epoch = start;
+    p.has_epoch = true;
+  }
+  p.phases.push_back({name, start, end});
+}
+
+std::vector<phase_info>
+phases()
+{
+  auto& p = instance();
+  std::lock_guard lk(p.mutex);
+
+  std::vector<phase_info> ret;
+  ret.reserve(p.phases.size());
+  for (const auto& ph : p.phases)
+    ret.push_back({ph.name, to_us(ph.start - p.epoch), to_us(ph.end - ph.start)});
+
+  std::stable_sort(ret.begin(), ret.end(),
+                   [](const auto& a, const auto& b) { return a.start_us < b.start_us; });
+  return ret;
+}
+
+void
+report(std::ostream& ostr)
+{
+  auto ph = phases();
+  if (ph.empty())
+    return;
+
+  ostr << "[XRT] startup phases (ms)\n"
+       << std::setw(10) << "start" << std::setw(10) << "duration" << "  phase\n";
+  for (const auto& p : ph)
+    ostr << std::fixed << std::setprecision(3)
+         << std::setw(10) << p.start_us / 1000.0
+         << std::setw(10) << p.duration_us / 1000.0
+         << "  " << p.name << "\n";
+  ostr.flush();
+}
+
+void
+enable_report_at_exit()
+{
+  static std::once_flag flag;
+  std::call_once(flag, [] { std::atexit(report_at_exit); });
+}
+
+}} // startup, xrt_core
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrtcore_common_startup_profile_h_
+#define xrtcore_common_startup_profile_h_
+
+#include "core/common/config.h"
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace xrt_core { namespace startup {
+
+/**
+ * Startup profile - wall time spent in the phases of XRT startup
+ *
+ * Reading xrt.ini, loading the shim and driver plugins, scanning for
+ * devices, opening devices and loading plugin modules are recorded
+ * as they complete, with their start relative to the first recorded
+ * phase.  Phases may nest, eg. the device scan is part of loading
+ * the shim.
+ *
+ * With Runtime.startup_report=true in xrt.ini the phases are printed
+ * to stderr when the process exits.  Opening devices, which may happen
+ * again and again for the life of a process, is recorded only then.
+ */
+struct phase_info
+{
+  std::string name;
+  uint64_t start_us;     // since the first recorded phase started
+  uint64_t duration_us;
+};
+
+using clock = std::chrono::steady_clock;
+
+/**
+ * record() - Record a completed phase
+ *
+ * Thread safe, phases may complete concurrently.  Only the first
+ * phases of a process are recorded.
+ */
+XRT_CORE_COMMON_EXPORT
+void
+record(const std::string& name, clock::time_point start, clock::time_point end);
+
+/**
+ * phases() - Phases recorded so far, in start order
+ */
+XRT_CORE_COMMON_EXPORT
+std::vector<phase_info>
+phases();
+
+/**
+ * report() - Print phases recorded so far
+ */
+XRT_CORE_COMMON_EXPORT
+void
+report(std::ostream& ostr);
+
+/**
+ * enable_report_at_exit() - Print the report when the process exits
+ *
+ * Called once XRT is initialized if Runtime.startup_report is set.
+ */
+XRT_CORE_COMMON_EXPORT
+void
+enable_report_at_exit();
+
+/**
+ * class phase - Scoped recording of a phase
+ */
+class phase
+{
+  std::string m_name;
+  clock::time_point m_start;
+
+public:
+  explicit
+  phase(std::string name)
+    : m_name(std::move(name)), m_start(clock::now())
+  {}
+
+  ~phase()
+  {
+    record(m_name, m_start, clock::now());
+  }
+
+  phase(const phase&) = delete;
+  phase& operator=(const phase&) = delete;
+};
+
+}} // startup, xrt_core
+
+#endif
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#define XRT_CORE_COMMON_SOURCE
+#include "suballocator.h"
+
+#include "core/common/error.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <string>
+
+namespace {
+
+// Classes are alignment multiples up to this many units
+constexpr size_t linear_class_units = 64;
+
+inline unsigned int
+msb(size_t value)
+{
+  unsigned int bit = 0;
+  while (value >>= 1)
+    ++bit;
+  return bit;
+}
+
+inline size_t
+round_up(size_t size, size_t align)
+{
+  return (size + align - 1) / align * align;
+}
+
+} // namespace
+
+namespace xrt_core {
+
+suballocator::
+suballocator(size_t capacity, size_t alignment)
+  : m_alignment(alignment)
+{
+  if (!alignment || (alignment & (alignment - 1)))
+    throw xrt_core::error(EINVAL, "suballocator alignment must be a power of two");
+
+  capacity = capacity / alignment * alignment;
+  m_stats.capacity = capacity;
+  if (capacity)
+    insert_free(0, capacity);
+}
+
+size_t
+suballocator::
+size_class(size_t size) const
+{
+  auto sz = round_up(std::max<size_t>(size, 1), m_alignment);
+  if (sz <= linear_class_units * m_alignment)
+    return sz;
+
+  // Eight classes per power of two
+  return round_up(sz, size_t(1) << (msb(sz) - 3));
+}
+
+void
+suballocator::
+insert_free(size_t offset, size_t size)
+{
+  m_free.emplace(offset, size);
+  m_by_size.emplace(size, offset);
+  m_stats.bytes_free += size;
+}
+
+void
+suballocator::
+erase_free(std::map<size_t, size_t>::iterator itr)
+{
+  m_by_size.erase({itr->second, itr->first});
+  m_stats.bytes_free -= itr->second;
+  m_free.erase(itr);
+}
+
+size_t
+suballocator::
+alloc(size_t size)
+{
+  size = std::max<size_t>(size, 1);
+  if (size > m_stats.capacity) {
+    ++m_stats.failures;
+    return npos;
+  }
+
+  auto sz = size_class(size);
+
+  // Smallest free range that fits, lowest offset among equals.  A
+  // request that fits only without rounding to its class, eg. one
+  // for the whole space, takes just the aligned size.
+  auto fit = m_by_size.lower_bound({sz, 0});
+  if (fit == m_by_size.end()) {
+    sz = round_up(size, m_alignment);
+    fit = m_by_size.lower_bound({sz, 0});
+  }
+  if (fit == m_by_size.end()) {
+    ++m_stats.failures;
+    return npos;
+  }
+
+  auto offset = fit->second;
+  auto free_size = fit->first;
+  erase_free(m_free.find(offset));
+  if (free_size > sz)
+    insert_free(offset + sz, free_size - sz);
+
+  m_in_use.emplace(offset, range{sz, size});
+  ++m_stats.allocations;
+  m_stats.bytes_in_use += sz;
+  m_stats.bytes_requested += size;
+  return offset;
+}
+
+void
+suballocator::
+free(size_t offset)
+{
+  auto used = m_in_use.find(offset);
+  if (used == m_in_use.end())
+    throw xrt_core::error(EINVAL, "suballocator free of unknown offset " + std::to_string(offset));
+
+  auto size = used->second.size;
+  --m_stats.allocations;
+  m_stats.bytes_in_use -= size;
+  m_stats.bytes_requested -= used->second.requested;
+  m_in_use.erase(used);
+
+  // Merge with free neighbours
+  auto next = m_free.lower_bound(offset);
+  if (next != m_free.end() && next->first == offset + size) {
+    size += next->second;
+    erase_free(next);
+  }
+
+  auto prev = m_free.lower_bound(offset);
+  if (prev != m_free.begin()) {
+    --prev;
+    if (prev->first + prev->second == offset) {
+      offset = prev->first;
+      size += prev->second;
+      erase_free(prev);
+    }
+  }
+
+  insert_free(offset, size);
+}
+
+suballocator::stats
+suballocator::
+get_stats() const
+{
+  auto st = m_stats;
+  st.free_ranges = m_free.size();
+  st.largest_free = m_by_size.empty() ? 0 : m_by_size.rbegin()->first;
+  return st;
+}
+
+} // xrt_core
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrtcore_common_suballocator_h_
+#define xrtcore_common_suballocator_h_
+
+#include "core/common/config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+namespace xrt_core {
+
+/**
+ * class suballocator - allocator of ranges within a fixed size space
+ *
+ * Hands out aligned offsets into a space of fixed capacity, for
+ * example a large buffer object carved into sub buffers.
+ *
+ * Requests are rounded up to a size class.  Classes are multiples of
+ * the alignment up to 64 units and eight classes per power of two
+ * above, so at most 12.5% of a large range is unused.  A request
+ * takes the smallest free range that fits, splitting off the rest.
+ * A freed range is merged with its free neighbours so that the space
+ * does not fragment into ever smaller ranges.
+ *
+ * The class is not thread safe, callers serialize access.
+ */
+class suballocator
+{
+public:
+  /**
+   * struct stats - allocator counters
+   *
+   * @capacity:        size of the space
+   * @allocations:     ranges in use
+   * @failures:        requests that found no free range large enough
+   * @bytes_requested: bytes requested by ranges in use
+   * @bytes_in_use:    bytes of ranges in use, per size class
+   * @bytes_free:      bytes not in use
+   * @free_ranges:     number of free ranges
+   * @largest_free:    size of the largest free range
+   */
+  struct stats
+  {
+    uint64_t capacity = 0;
+    uint64_t allocations = 0;
+    uint64_t failures = 0;
+    uint64_t bytes_requested = 0;
+    uint64_t bytes_in_use = 0;
+    uint64_t bytes_free = 0;
+    uint64_t free_ranges = 0;
+    uint64_t largest_free = 0;
+
+    // Fraction of the ranges in use lost to size class rounding
+    double
+    internal_fragmentation() const
+    {
+      return bytes_in_use
+        ? 1.0 - static_cast<double>(bytes_requested) / bytes_in_use
+        : 0.0;
+    }
+
+    // Fraction of the free bytes not usable by one large request
+    double
+    external_fragmentation() const
+    {
+      return bytes_free
+        ? 1.0 - static_cast<double>(largest_free) / bytes_free
+        : 0.0;
+    }
+  };
+
+  static constexpr size_t npos = ~size_t(0);
+
+  /**
+   * suballocator() - Create an allocator
+   *
+   * @capacity:   Size of the space, rounded down to @alignment
+   * @alignment:  Alignment of all offsets, a power of two
+   */
+  XRT_CORE_COMMON_EXPORT
+  suballocator(size_t capacity, size_t alignment);
+
+  /**
+   * alloc() - Allocate a range
+   *
+   * @size:   Bytes to allocate
+   * Return:  Offset of the range, or npos if no free range fits
+   */
+  XRT_CORE_COMMON_EXPORT
+  size_t
+  alloc(size_t size);
+
+  /**
+   * free() - Return a range
+   *
+   * @offset: Offset returned by alloc()
+   *
+   * Throws if @offset is not an allocated range.
+   */
+  XRT_CORE_COMMON_EXPORT
+  void
+  free(size_t offset);
+
+  XRT_CORE_COMMON_EXPORT
+  stats
+  get_stats() const;
+
+  // Size class of an allocation of @size bytes
+  XRT_CORE_COMMON_EXPORT
+  size_t
+  size_class(size_t size) const;
+
+  size_t
+  get_alignment() const
+  {
+    return m_alignment;
+  }
+
+private:
+  struct range
+  {
+    size_t size;       // size class
+    size_t requested;  // bytes requested
+  };
+
+  void
+  insert_free(size_t offset, size_t size);
+
+  void
+  erase_free(std::map<size_t, size_t>::iterator itr);
+
+  size_t m_alignment;
+  stats m_stats;
+
+  std::map<size_t, size_t> m_free;                 // offset -> size
+  std::set<std::pair<size_t, size_t>> m_by_size;   // (size, offset) of free ranges
+  std::unordered_map<size_t, range> m_in_use;      // offset -> range
+};
+
+} // xrt_core
+
+#endif
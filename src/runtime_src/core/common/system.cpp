@@ -5,6 +5,8 @@
 #include "system.h"
 #include "device.h"
 #include "module_loader.h"
+#include "config_reader.h"
+#include "startup_profile.h"
 #include "gen/version.h"
 
 
@@ -12,6 +14,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 
 namespace {
 
@@ -69,6 +72,9 @@ load_shim()
   // could have constructor body that is executed after the base
   // class is constructed.
   static xrt_core::shim_loader shim;
+
+  if (xrt_core::config::get_startup_report())
+    xrt_core::startup::enable_report_at_exit();
 }
 
 inline system&
@@ -122,7 +128,11 @@ get_userpf_device(device::id_type id)
 {
   // Construct device by calling xclOpen, the returned
   // device is cached and unmanaged
-  auto device = instance().get_userpf_device(id);
+  auto& sys = instance();
+  std::optional<startup::phase> phase;
+  if (config::get_startup_report())
+    phase.emplace("open device " + std::to_string(id));
+  auto device = sys.get_userpf_device(id);
 
   if (!device)
     throw std::runtime_error("Could not open device with index '"+ std::to_string(id) + "'");
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Test of the BO sync range helpers in xrt_core::bo.
+//
+// % bo_range_test --run_test=test_bo_range
+//
+// The test checks how the ranges passed to xrt::bo::sync are combined
+// before they reach the shim, and how sub-buffer ranges are shifted to
+// the parent BO.  No device is needed.
+#include <boost/test/unit_test.hpp>
+
+#include "core/common/api/bo.h"
+
+#include <cstdint>
+#include <exception>
+#include <vector>
+
+namespace {
+
+using range = xrt_core::buffer_handle::range;
+
+constexpr size_t bo_size = 4096;
+
+static bool
+equal(const std::vector<range>& actual, const std::vector<range>& expected)
+{
+  if (actual.size() != expected.size())
+    return false;
+  for (size_t idx = 0; idx < actual.size(); ++idx)
+    if (actual[idx].size != expected[idx].size || actual[idx].offset != expected[idx].offset)
+      return false;
+  return true;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE ( test_bo_range )
+
+BOOST_AUTO_TEST_CASE( test_overlapping )
+{
+  // {size, offset}, unsorted with one range inside another
+  auto combined = xrt_core::bo::coalesce_ranges({{100, 200}, {100, 0}, {150, 50}, {10, 60}}, bo_size);
+  BOOST_CHECK(equal(combined, {{300, 0}}));
+}
+
+BOOST_AUTO_TEST_CASE( test_adjacent )
+{
+  auto combined = xrt_core::bo::coalesce_ranges({{64, 64}, {64, 0}, {64, 128}}, bo_size);
+  BOOST_CHECK(equal(combined, {{192, 0}}));
+}
+
+BOOST_AUTO_TEST_CASE( test_gapped )
+{
+  // The gap must not be synced, it may hold data of the other side
+  auto combined = xrt_core::bo::coalesce_ranges({{64, 1024}, {64, 0}, {64, 65}}, bo_size);
+  BOOST_CHECK(equal(combined, {{64, 0}, {64, 65}, {64, 1024}}));
+}
+
+BOOST_AUTO_TEST_CASE( test_empty )
+{
+  BOOST_CHECK(xrt_core::bo::coalesce_ranges({}, bo_size).empty());
+  BOOST_CHECK(xrt_core::bo::coalesce_ranges({{0, 0}, {0, bo_size}}, bo_size).empty());
+
+  // Empty ranges neither bridge a gap nor start a range of their own
+  auto combined = xrt_core::bo::coalesce_ranges({{0, 64}, {32, 0}, {32, 96}}, bo_size);
+  BOOST_CHECK(equal(combined, {{32, 0}, {32, 96}}));
+}
+
+BOOST_AUTO_TEST_CASE( test_out_of_range )
+{
+  auto combined = xrt_core::bo::coalesce_ranges({{bo_size, 0}}, bo_size);
+  BOOST_CHECK(equal(combined, {{bo_size, 0}}));
+
+  BOOST_CHECK_THROW(xrt_core::bo::coalesce_ranges({{bo_size + 1, 0}}, bo_size), std::exception);
+  BOOST_CHECK_THROW(xrt_core::bo::coalesce_ranges({{1, bo_size}}, bo_size), std::exception);
+  BOOST_CHECK_THROW(xrt_core::bo::coalesce_ranges({{0, bo_size + 1}}, bo_size), std::exception);
+
+  // Offset plus size wrapping around is caught too
+  BOOST_CHECK_THROW(xrt_core::bo::coalesce_ranges({{SIZE_MAX, 1}}, bo_size), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE( test_sub_buffer )
+{
+  constexpr size_t offset = 1024;
+
+  auto shifted = xrt_core::bo::sub_buffer_ranges({{64, 0}, {64, 128}}, offset, bo_size);
+  BOOST_CHECK(equal(shifted, {{64, offset}, {64, offset + 128}}));
+
+  shifted = xrt_core::bo::sub_buffer_ranges({{bo_size - offset, 0}}, offset, bo_size);
+  BOOST_CHECK(equal(shifted, {{bo_size - offset, offset}}));
+
+  BOOST_CHECK_THROW(xrt_core::bo::sub_buffer_ranges({{bo_size - offset + 1, 0}}, offset, bo_size), std::exception);
+  BOOST_CHECK_THROW(xrt_core::bo::sub_buffer_ranges({{1, bo_size - offset}}, offset, bo_size), std::exception);
+  BOOST_CHECK_THROW(xrt_core::bo::sub_buffer_ranges({{SIZE_MAX, 0}}, offset, bo_size), std::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Test of the xrt_core::config snapshot.
+//
+// % config_snapshot_test --run_test=test_config_snapshot
+//
+// The test changes snapshot keys with xrt::ini::set, while reader
+// threads keep loading the snapshot, and checks that each set
+// publishes a new snapshot and leaves earlier ones intact.  Values
+// are checked relative to the first snapshot so that an xrt.ini next
+// to the test does not matter.
+#include <boost/test/unit_test.hpp>
+
+#include "core/common/config_reader.h"
+#include "core/include/experimental/xrt_ini.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+static std::string
+to_string(bool value)
+{
+  return value ? "true" : "false";
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE ( test_config_snapshot )
+
+BOOST_AUTO_TEST_CASE( test_republish )
+{
+  using xrt_core::config::get_snapshot;
+
+  const auto& first = get_snapshot();
+  BOOST_CHECK(&first == &get_snapshot());
+  BOOST_CHECK_EQUAL(first.cdma, xrt_core::config::get_cdma());
+
+  auto cdma = first.cdma;
+  auto verbosity = first.verbosity;
+
+  // Readers keep loading the snapshot while it is republished, each
+  // snapshot they see must be a consistent one
+  std::atomic<bool> stop{false};
+  std::atomic<bool> torn{false};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i)
+    readers.emplace_back([&] {
+      while (!stop) {
+        const auto& s = get_snapshot();
+        if (s.verbosity != verbosity && s.verbosity != verbosity + 1)
+          torn = true;
+      }
+    });
+
+  for (int i = 0; i < 1000; ++i) {
+    xrt::ini::set("Runtime.verbosity", std::to_string(verbosity + (i % 2)));
+    xrt::ini::set("Runtime.cdma", to_string(i % 2 ? cdma : !cdma));
+  }
+  stop = true;
+  for (auto& t : readers)
+    t.join();
+  BOOST_CHECK(!torn);
+
+  // Last set restored cdma and left verbosity incremented
+  const auto& last = get_snapshot();
+  BOOST_CHECK(&last != &first);
+  BOOST_CHECK_EQUAL(last.cdma, cdma);
+  BOOST_CHECK_EQUAL(last.verbosity, verbosity + 1);
+  BOOST_CHECK_EQUAL(xrt_core::config::get_verbosity(), verbosity + 1);
+
+  // Earlier snapshot is unchanged
+  BOOST_CHECK_EQUAL(first.cdma, cdma);
+  BOOST_CHECK_EQUAL(first.verbosity, verbosity);
+}
+
+BOOST_AUTO_TEST_CASE( test_locked_key )
+{
+  // Keys outside the snapshot are still locked once they are used
+  xrt_core::config::get_ert();
+  BOOST_CHECK_THROW(xrt::ini::set("Runtime.ert", "false"), std::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
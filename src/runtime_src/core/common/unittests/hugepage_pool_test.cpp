@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Test of xrt_core::hugepage_pool with transparent huge pages.
+//
+// % hugepage_pool_test --run_test=test_hugepage_pool
+//
+// The test checks size classes, alignment, reuse of freed blocks,
+// the cache limit, and the pool counters.  Transparent huge pages
+// need no reservation, so the test runs on any Linux host even if
+// the kernel ends up backing the memory with regular pages.
+#include <boost/test/unit_test.hpp>
+
+#include "core/common/hugepage_pool.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+constexpr size_t mb = 1 << 20;
+
+using pool_type = xrt_core::hugepage_pool;
+using xrt_core::numa_policy;
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE ( test_hugepage_pool )
+
+BOOST_AUTO_TEST_CASE( test_size_class )
+{
+  BOOST_CHECK_EQUAL(pool_type::size_class(1), 2 * mb);
+  BOOST_CHECK_EQUAL(pool_type::size_class(2 * mb), 2 * mb);
+  BOOST_CHECK_EQUAL(pool_type::size_class(3 * mb), 4 * mb);
+  BOOST_CHECK_EQUAL(pool_type::size_class(64 * mb), 64 * mb);
+  BOOST_CHECK_EQUAL(pool_type::size_class(65 * mb), 72 * mb);
+  BOOST_CHECK_EQUAL(pool_type::size_class(129 * mb), 144 * mb);
+}
+
+BOOST_AUTO_TEST_CASE( test_fall_through )
+{
+  // Disabled pool and small allocations fall through
+  pool_type off(pool_type::mode::off, 0, 16 * mb);
+  BOOST_CHECK(!off.alloc(4 * mb, -1, numa_policy::none));
+
+  pool_type pool(pool_type::mode::thp, 2 * mb, 0);
+  BOOST_CHECK(!pool.alloc(4096, -1, numa_policy::none));
+}
+
+BOOST_AUTO_TEST_CASE( test_reuse )
+{
+  pool_type pool(pool_type::mode::thp, 2 * mb, 8 * mb);
+
+  void* first = nullptr;
+  {
+    auto buf = pool.alloc(3 * mb, -1, numa_policy::none);
+    BOOST_REQUIRE(buf != nullptr);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(buf.get()) % pool_type::huge_page_size, 0);
+    std::memset(buf.get(), 0xa5, 4 * mb);
+    first = buf.get();
+
+    auto stats = pool.get_stats();
+    BOOST_CHECK_EQUAL(stats.misses, 1);
+    BOOST_CHECK_EQUAL(stats.hits, 0);
+    BOOST_CHECK_EQUAL(stats.bytes_in_use, 4 * mb);
+    BOOST_CHECK_EQUAL(stats.bytes_requested, 3 * mb);
+    BOOST_CHECK_EQUAL(stats.fragmentation(), 0.25);
+  }
+
+  auto stats = pool.get_stats();
+  BOOST_CHECK_EQUAL(stats.bytes_in_use, 0);
+  BOOST_CHECK_EQUAL(stats.bytes_cached, 4 * mb);
+
+  {
+    // Same size class reuses the cached block
+    auto buf = pool.alloc(4 * mb, -1, numa_policy::none);
+    BOOST_CHECK_EQUAL(buf.get(), first);
+    BOOST_CHECK_EQUAL(pool.get_stats().hits, 1);
+
+    // Exceeds the cache limit when freed together with buf
+    auto big = pool.alloc(6 * mb, -1, numa_policy::none);
+    BOOST_REQUIRE(big != nullptr);
+    BOOST_CHECK_NE(big.get(), buf.get());
+  }
+
+  stats = pool.get_stats();
+  BOOST_CHECK_EQUAL(stats.bytes_in_use, 0);
+  BOOST_CHECK_LE(stats.bytes_cached, 8 * mb);
+
+  pool.trim();
+  BOOST_CHECK_EQUAL(pool.get_stats().bytes_cached, 0);
+}
+
+BOOST_AUTO_TEST_CASE( test_reuse_numa_policy )
+{
+  // A cached block is reused only with the NUMA placement it was
+  // mapped with
+  pool_type pool(pool_type::mode::thp, 2 * mb, 8 * mb);
+
+  void* first = nullptr;
+  {
+    auto buf = pool.alloc(2 * mb, 0, numa_policy::preferred);
+    BOOST_REQUIRE(buf != nullptr);
+    first = buf.get();
+  }
+
+  {
+    auto none = pool.alloc(2 * mb, -1, numa_policy::none);
+    BOOST_REQUIRE(none != nullptr);
+    BOOST_CHECK_NE(none.get(), first);
+
+    auto bind = pool.alloc(2 * mb, 0, numa_policy::bind);
+    BOOST_REQUIRE(bind != nullptr);
+    BOOST_CHECK_NE(bind.get(), first);
+
+    auto preferred = pool.alloc(2 * mb, 0, numa_policy::preferred);
+    BOOST_CHECK_EQUAL(preferred.get(), first);
+  }
+
+  // No node means no placement, whatever the policy
+  {
+    auto buf = pool.alloc(2 * mb, -1, numa_policy::bind);
+    BOOST_REQUIRE(buf != nullptr);
+    BOOST_CHECK_EQUAL(pool.get_stats().hits, 2);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
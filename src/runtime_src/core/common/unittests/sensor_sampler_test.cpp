@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Test of xrt_core::sensor_sampler against a fake sysfs tree.
+//
+// % sensor_sampler_test --run_test=test_sensor_sampler
+//
+// The test creates a temporary directory with sensor files, samples
+// them while the values change, and checks values, sensor order,
+// missing files and ring overflow.
+#include <boost/test/unit_test.hpp>
+
+#include "core/common/sensor_sampler.h"
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+static void
+write_sensor(const std::string& path, uint64_t value)
+{
+  // sysfs attributes are newline terminated
+  std::ofstream ofs(path, std::ios::trunc);
+  ofs << value << "\n";
+}
+
+// Temporary directory with sensor files, some of them missing
+struct fake_sysfs
+{
+  std::string root;
+  std::vector<std::string> paths;
+
+  fake_sysfs()
+  {
+    char dir_template[] = "/tmp/sensor_sampler_XXXXXX";
+    auto dir = mkdtemp(dir_template);
+    BOOST_REQUIRE(dir != nullptr);
+    root = dir;
+
+    paths = {
+      root + "/xmc_12v_aux_curr",
+      root + "/xmc_12v_aux_vol",
+      root + "/missing",
+      "",
+      root + "/xmc_fan_rpm"
+    };
+    write_sensor(paths[0], 1200);
+    write_sensor(paths[1], 12100);
+    write_sensor(paths[4], 4500);
+  }
+
+  ~fake_sysfs()
+  {
+    for (auto& path : paths)
+      if (!path.empty())
+        unlink(path.c_str());
+    rmdir(root.c_str());
+  }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE ( test_sensor_sampler )
+
+BOOST_FIXTURE_TEST_CASE( test_sample, fake_sysfs )
+{
+  xrt_core::sensor_sampler sampler(paths, std::chrono::milliseconds(1), 1024);
+  BOOST_CHECK_EQUAL(sampler.num_sensors(), paths.size());
+
+  std::vector<uint64_t> values(paths.size());
+  sampler.read(values.data());
+  std::vector<uint64_t> expected = {1200, 12100, 0, 0, 4500};
+  BOOST_CHECK_EQUAL_COLLECTIONS(values.begin(), values.end(), expected.begin(), expected.end());
+
+  sampler.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  // Same length, then shorter, value; the file is rewritten in place
+  write_sensor(paths[0], 1300);
+  write_sensor(paths[4], 900);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  sampler.stop();
+
+  uint64_t last = 0;
+  bool changed = false;
+  auto count = sampler.consume([&](uint64_t timestamp, const uint64_t* sample) {
+    BOOST_CHECK_GE(timestamp, last);
+    last = timestamp;
+    BOOST_CHECK_EQUAL(sample[1], 12100);
+    BOOST_CHECK_EQUAL(sample[2], 0);
+    BOOST_CHECK_EQUAL(sample[3], 0);
+    if (sample[0] == 1300 && sample[4] == 900)
+      changed = true;
+    else
+      BOOST_CHECK(sample[0] == 1200 || sample[0] == 1300);
+  });
+  BOOST_CHECK_GT(count, 10);
+  BOOST_CHECK(changed);
+  BOOST_CHECK_EQUAL(sampler.dropped(), 0);
+  BOOST_CHECK_EQUAL(sampler.consume([](uint64_t, const uint64_t*) {}), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE( test_overflow, fake_sysfs )
+{
+  // Ring overflow keeps the newest samples
+  xrt_core::sensor_sampler sampler(paths, std::chrono::milliseconds(1), 4);
+  sampler.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  sampler.stop();
+  auto count = sampler.consume([](uint64_t, const uint64_t*) {});
+  BOOST_CHECK_EQUAL(count, 4);
+  BOOST_CHECK_GT(sampler.dropped(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Test of xrt_core::suballocator.
+//
+// % suballocator_test --run_test=test_suballocator
+//
+// The test checks size classes, alignment, best fit, merging of
+// freed ranges, the counters, and finally runs a random mix of
+// allocations and frees against a shadow map that detects overlap.
+#include <boost/test/unit_test.hpp>
+
+#include "core/common/suballocator.h"
+
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t kb = 1 << 10;
+constexpr size_t mb = 1 << 20;
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE ( test_suballocator )
+
+BOOST_AUTO_TEST_CASE( test_classes )
+{
+  xrt_core::suballocator sa(64 * mb, 4 * kb);
+  BOOST_CHECK_EQUAL(sa.size_class(0), 4 * kb);
+  BOOST_CHECK_EQUAL(sa.size_class(1), 4 * kb);
+  BOOST_CHECK_EQUAL(sa.size_class(4 * kb), 4 * kb);
+  BOOST_CHECK_EQUAL(sa.size_class(5 * kb), 8 * kb);
+  BOOST_CHECK_EQUAL(sa.size_class(256 * kb), 256 * kb);
+  BOOST_CHECK_EQUAL(sa.size_class(257 * kb), 288 * kb);
+
+  // Alignment must be a power of two
+  BOOST_CHECK_THROW(xrt_core::suballocator(mb, 3000), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE( test_fit_and_merge )
+{
+  xrt_core::suballocator sa(mb, 4 * kb);
+
+  auto a = sa.alloc(100);
+  auto b = sa.alloc(8 * kb);
+  auto c = sa.alloc(4 * kb);
+  BOOST_CHECK_EQUAL(a, 0);
+  BOOST_CHECK_EQUAL(b, 4 * kb);
+  BOOST_CHECK_EQUAL(c, 12 * kb);
+
+  // Freeing b leaves an 8K hole, a 4K request takes it over the tail
+  sa.free(b);
+  auto d = sa.alloc(4 * kb);
+  BOOST_CHECK_EQUAL(d, b);
+
+  auto st = sa.get_stats();
+  BOOST_CHECK_EQUAL(st.allocations, 3);
+  BOOST_CHECK_EQUAL(st.bytes_in_use, 12 * kb);
+  BOOST_CHECK_EQUAL(st.bytes_requested, 100 + 8 * kb);
+  BOOST_CHECK_EQUAL(st.free_ranges, 2);
+  BOOST_CHECK_GT(st.internal_fragmentation(), 0.0);
+  BOOST_CHECK_GT(st.external_fragmentation(), 0.0);
+
+  // Freeing everything merges back into one range
+  sa.free(a);
+  sa.free(c);
+  sa.free(d);
+  st = sa.get_stats();
+  BOOST_CHECK_EQUAL(st.allocations, 0);
+  BOOST_CHECK_EQUAL(st.bytes_in_use, 0);
+  BOOST_CHECK_EQUAL(st.bytes_requested, 0);
+  BOOST_CHECK_EQUAL(st.free_ranges, 1);
+  BOOST_CHECK_EQUAL(st.largest_free, mb);
+  BOOST_CHECK_EQUAL(st.bytes_free, mb);
+
+  // The whole space can be allocated even if its size class is larger
+  BOOST_CHECK_EQUAL(sa.alloc(mb), 0);
+  BOOST_CHECK_EQUAL(sa.alloc(1), xrt_core::suballocator::npos);
+  BOOST_CHECK_EQUAL(sa.get_stats().failures, 1);
+
+  // Free of an unknown offset
+  BOOST_CHECK_THROW(sa.free(4 * kb), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE( test_random )
+{
+  constexpr size_t capacity = 64 * mb;
+  constexpr size_t align = 64;
+  xrt_core::suballocator sa(capacity, align);
+
+  std::mt19937 rng(42);
+  std::map<size_t, size_t> live; // offset -> size
+  for (int i = 0; i < 20000; ++i) {
+    if (!live.empty() && (rng() % 3 == 0)) {
+      auto itr = live.begin();
+      std::advance(itr, rng() % live.size());
+      sa.free(itr->first);
+      live.erase(itr);
+      continue;
+    }
+
+    size_t size = (rng() % 4) ? rng() % (16 * kb) : rng() % (2 * mb);
+    auto offset = sa.alloc(size);
+    if (offset == xrt_core::suballocator::npos)
+      continue;
+
+    BOOST_REQUIRE_EQUAL(offset % align, 0);
+    BOOST_REQUIRE_LE(offset + size, capacity);
+    auto next = live.lower_bound(offset);
+    if (next != live.end())
+      BOOST_REQUIRE_LE(offset + size, next->first);
+    if (next != live.begin()) {
+      auto prev = std::prev(next);
+      BOOST_REQUIRE_LE(prev->first + prev->second, offset);
+    }
+    live.emplace(offset, size);
+  }
+
+  for (const auto& r : live)
+    sa.free(r.first);
+
+  auto st = sa.get_stats();
+  BOOST_CHECK_EQUAL(st.free_ranges, 1);
+  BOOST_CHECK_EQUAL(st.bytes_free, capacity);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,217 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Test of compressed xclbin sections in xrt_core::xclbin.
+//
+// % xclbin_compression_test --run_test=test_xclbin_compression
+//
+// The test creates an in memory axlf image with a zlib compressed
+// section, a section stored with a COMPRESSION_NONE header, and a
+// raw section.  It checks the section data retrieved from the image
+// and the uncompressed image given to drivers.
+#include <boost/test/unit_test.hpp>
+
+#include "core/common/xclbin_parser.h"
+#include "core/include/xclbin.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+static std::vector<char>
+make_payload(size_t size, unsigned int seed)
+{
+  std::vector<char> data(size);
+  for (size_t idx = 0; idx < size; ++idx)
+    data[idx] = static_cast<char>((idx / 64) % 2 ? 0 : (idx * seed) >> 3);
+  return data;
+}
+
+static std::vector<char>
+wrap(const std::vector<char>& data, uint32_t algorithm)
+{
+  axlf_compressed_section csec = {};
+  std::memcpy(csec.m_magic, AXLF_COMPRESSED_SECTION_MAGIC, sizeof(csec.m_magic));
+  csec.m_algorithm = algorithm;
+  csec.m_size = data.size();
+
+  std::vector<char> stored(reinterpret_cast<const char*>(&csec),
+                           reinterpret_cast<const char*>(&csec) + sizeof(csec));
+  if (algorithm == COMPRESSION_NONE) {
+    stored.insert(stored.end(), data.begin(), data.end());
+    return stored;
+  }
+
+  uLongf size = compressBound(data.size());
+  stored.resize(sizeof(csec) + size);
+  auto ret = compress(reinterpret_cast<Bytef*>(stored.data() + sizeof(csec)), &size,
+                      reinterpret_cast<const Bytef*>(data.data()), data.size());
+  if (ret != Z_OK)
+    throw std::runtime_error("compress failed");
+  stored.resize(sizeof(csec) + size);
+  return stored;
+}
+
+// Image of the stored sections, 8 byte aligned
+static std::vector<char>
+make_axlf(const std::vector<std::pair<axlf_section_kind, std::vector<char>>>& sections,
+          bool compressed = true)
+{
+  auto header_size = sizeof(axlf) + (sections.size() - 1) * sizeof(axlf_section_header);
+  std::vector<char> image(header_size, 0);
+  auto top = reinterpret_cast<axlf*>(image.data());
+  std::memcpy(top->m_magic, "xclbin2", 8);
+  top->m_signature_length = -1;
+  top->m_header.m_numSections = static_cast<uint32_t>(sections.size());
+  top->m_header.m_actionMask = compressed ? AM_COMPRESSED_SECTIONS : 0;
+
+  for (size_t idx = 0; idx < sections.size(); ++idx) {
+    image.resize((image.size() + 7) & ~size_t(7), 0);
+    top = reinterpret_cast<axlf*>(image.data());
+    top->m_sections[idx].m_sectionKind = sections[idx].first;
+    top->m_sections[idx].m_sectionOffset = image.size();
+    top->m_sections[idx].m_sectionSize = sections[idx].second.size();
+    image.insert(image.end(), sections[idx].second.begin(), sections[idx].second.end());
+  }
+
+  reinterpret_cast<axlf*>(image.data())->m_header.m_length = image.size();
+  return image;
+}
+
+// Image with a zlib compressed BITSTREAM, a COMPRESSION_NONE PDI,
+// and a raw OVERLAY section
+struct compressed_image
+{
+  std::vector<char> bitstream = make_payload(3 << 20, 7);
+  std::vector<char> pdi = make_payload(1021, 13);
+  std::vector<char> overlay = make_payload(513, 31);
+  std::vector<char> image = make_axlf({
+    {BITSTREAM, wrap(bitstream, COMPRESSION_ZLIB)},
+    {PDI, wrap(pdi, COMPRESSION_NONE)},
+    {OVERLAY, overlay}
+  });
+
+  const axlf*
+  top() const
+  {
+    return reinterpret_cast<const axlf*>(image.data());
+  }
+
+  // Check sections of an uncompressed image against the payloads
+  void
+  check_uncompressed(const axlf* utop) const
+  {
+    BOOST_CHECK(!xrt_core::xclbin::is_compressed(utop));
+    BOOST_CHECK_EQUAL(utop->m_header.m_numSections, 3);
+
+    std::vector<std::pair<axlf_section_kind, const std::vector<char>*>> expected = {
+      {BITSTREAM, &bitstream}, {PDI, &pdi}, {OVERLAY, &overlay}
+    };
+    for (auto& [kind, data] : expected) {
+      auto hdr = xrt_core::xclbin::get_axlf_section(utop, kind);
+      BOOST_REQUIRE(hdr != nullptr);
+      BOOST_CHECK_EQUAL(hdr->m_sectionOffset % 8, 0);
+      BOOST_REQUIRE_EQUAL(hdr->m_sectionSize, data->size());
+      auto begin = reinterpret_cast<const char*>(utop) + hdr->m_sectionOffset;
+      BOOST_CHECK(std::equal(begin, begin + hdr->m_sectionSize, data->begin()));
+    }
+  }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE ( test_xclbin_compression )
+
+BOOST_FIXTURE_TEST_CASE( test_section_data, compressed_image )
+{
+  BOOST_CHECK(xrt_core::xclbin::is_compressed(top()));
+  BOOST_CHECK_LT(image.size(), bitstream.size() / 2);
+
+  auto hdr = xrt_core::xclbin::get_axlf_section(top(), BITSTREAM);
+  BOOST_REQUIRE(hdr != nullptr);
+  BOOST_CHECK(xrt_core::xclbin::get_axlf_section_data(top(), hdr) == bitstream);
+
+  hdr = xrt_core::xclbin::get_axlf_section(top(), PDI);
+  BOOST_REQUIRE(hdr != nullptr);
+  BOOST_CHECK(xrt_core::xclbin::get_axlf_section_data(top(), hdr) == pdi);
+
+  hdr = xrt_core::xclbin::get_axlf_section(top(), OVERLAY);
+  BOOST_REQUIRE(hdr != nullptr);
+  BOOST_CHECK(xrt_core::xclbin::get_axlf_section_data(top(), hdr) == overlay);
+}
+
+BOOST_FIXTURE_TEST_CASE( test_uncompressed_axlf, compressed_image )
+{
+  // Image given to drivers
+  auto uncompressed = xrt_core::xclbin::get_uncompressed_axlf(top());
+  auto utop = reinterpret_cast<const axlf*>(uncompressed.data());
+  BOOST_CHECK_EQUAL(utop->m_header.m_length, uncompressed.size());
+  check_uncompressed(utop);
+}
+
+BOOST_FIXTURE_TEST_CASE( test_uncompressed_axlf_buffer, compressed_image )
+{
+  // Compressed image is expanded into the caller's buffer
+  std::vector<char> buffer;
+  auto utop = xrt_core::xclbin::get_uncompressed_axlf(top(), buffer);
+  BOOST_CHECK(reinterpret_cast<const char*>(utop) == buffer.data());
+  BOOST_CHECK_EQUAL(utop->m_header.m_length, buffer.size());
+  check_uncompressed(utop);
+
+  // Image without compressed sections is returned as is
+  std::vector<char> plain;
+  auto image2 = make_axlf({{OVERLAY, overlay}}, false);
+  auto top2 = reinterpret_cast<const axlf*>(image2.data());
+  BOOST_CHECK(xrt_core::xclbin::get_uncompressed_axlf(top2, plain) == top2);
+  BOOST_CHECK(plain.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE( test_corrupt_section, compressed_image )
+{
+  auto hdr = xrt_core::xclbin::get_axlf_section(top(), BITSTREAM);
+  BOOST_REQUIRE(hdr != nullptr);
+  image[hdr->m_sectionOffset + sizeof(axlf_compressed_section) + 16] ^= 0x5a;
+  image[hdr->m_sectionOffset + sizeof(axlf_compressed_section) + 17] ^= 0xa5;
+  BOOST_CHECK_THROW(xrt_core::xclbin::get_axlf_section_data(top(), hdr), std::exception);
+}
+
+BOOST_FIXTURE_TEST_CASE( test_malformed_section, compressed_image )
+{
+  auto top = reinterpret_cast<axlf*>(image.data());
+
+  // Section offset outside the image is caught before its compressed
+  // section header is read
+  auto offset = top->m_sections[0].m_sectionOffset;
+  top->m_sections[0].m_sectionOffset = image.size() + 4096;
+  BOOST_CHECK_THROW(xrt_core::xclbin::get_axlf_section_data(top, &top->m_sections[0]), std::exception);
+  BOOST_CHECK_THROW(xrt_core::xclbin::get_uncompressed_axlf(top), std::exception);
+  top->m_sections[0].m_sectionOffset = offset;
+
+  // Stored uncompressed sizes that cannot be right
+  auto csec = reinterpret_cast<axlf_compressed_section*>(image.data() + offset);
+  auto size = csec->m_size;
+  csec->m_size = UINT64_MAX - 16;
+  BOOST_CHECK_THROW(xrt_core::xclbin::get_axlf_section_data(top, &top->m_sections[0]), std::exception);
+  BOOST_CHECK_THROW(xrt_core::xclbin::get_uncompressed_axlf(top), std::exception);
+  csec->m_size = size;
+
+  auto pdi = reinterpret_cast<axlf_compressed_section*>(image.data() + top->m_sections[1].m_sectionOffset);
+  pdi->m_size += 1;
+  BOOST_CHECK_THROW(xrt_core::xclbin::get_uncompressed_axlf(top), std::exception);
+  pdi->m_size -= 1;
+
+  // Section headers past the end of the image
+  top->m_header.m_numSections = 1 << 20;
+  BOOST_CHECK_THROW(xrt_core::xclbin::get_uncompressed_axlf(top), std::exception);
+  top->m_header.m_numSections = 3;
+
+  BOOST_CHECK_NO_THROW(xrt_core::xclbin::get_uncompressed_axlf(top));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
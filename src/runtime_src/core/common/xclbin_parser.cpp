@@ -30,6 +30,10 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
 
+#ifndef _WIN32
+# include <zlib.h>
+#endif
+
 // This is xclbin parser. Update this file if xclbin format has changed.
 #ifdef _WIN32
 #pragma warning ( disable : 4996 )
@@ -388,10 +392,183 @@ merge_args(std::vector<xrt_core::xclbin::kernel_argument>& args)
 }
 
 
+static void
+validate_section(const axlf* top, const axlf_section_header* hdr)
+{
+  auto length = top->m_header.m_length;
+  if (hdr->m_sectionOffset > length || hdr->m_sectionSize > length - hdr->m_sectionOffset)
+    throw std::runtime_error("xclbin section is outside of the xclbin image");
+}
+
+// Compressed section header of a section, nullptr if not compressed.
+// The section is validated before its data is looked at.
+static const axlf_compressed_section*
+get_compressed_section(const axlf* top, const axlf_section_header* hdr)
+{
+  if (!(top->m_header.m_actionMask & AM_COMPRESSED_SECTIONS))
+    return nullptr;
+
+  validate_section(top, hdr);
+  if (hdr->m_sectionSize < sizeof(axlf_compressed_section))
+    return nullptr;
+
+  auto data = reinterpret_cast<const char*>(top) + hdr->m_sectionOffset;
+  auto csec = reinterpret_cast<const axlf_compressed_section*>(data);
+  if (std::memcmp(csec->m_magic, AXLF_COMPRESSED_SECTION_MAGIC, sizeof(csec->m_magic)) != 0)
+    return nullptr;
+
+  return csec;
+}
+
+// Uncompressed size of section data.  The size stored in a compressed
+// section is not trusted, deflate expands data at most 1032 times, a
+// larger size cannot be valid.
+static uint64_t
+get_section_size(const axlf* top, const axlf_section_header* hdr)
+{
+  auto csec = get_compressed_section(top, hdr);
+  if (!csec)
+    return hdr->m_sectionSize;
+
+  constexpr uint64_t max_ratio = 1032;
+  auto src_size = hdr->m_sectionSize - sizeof(axlf_compressed_section);
+  if (csec->m_algorithm == COMPRESSION_NONE ? csec->m_size != src_size : csec->m_size / max_ratio > src_size)
+    throw std::runtime_error("xclbin compressed section size is invalid");
+
+  return csec->m_size;
+}
+
+// Copy or decompress section data into dst of uncompressed size
+static void
+copy_section_data(const axlf* top, const axlf_section_header* hdr, char* dst)
+{
+  validate_section(top, hdr);
+  auto data = reinterpret_cast<const char*>(top) + hdr->m_sectionOffset;
+  auto csec = get_compressed_section(top, hdr);
+  if (!csec) {
+    std::copy(data, data + hdr->m_sectionSize, dst);
+    return;
+  }
+
+  auto src = data + sizeof(axlf_compressed_section);
+  auto src_size = hdr->m_sectionSize - sizeof(axlf_compressed_section);
+  switch (csec->m_algorithm) {
+  case COMPRESSION_NONE:
+    if (src_size != csec->m_size)
+      throw std::runtime_error("xclbin section size mismatch");
+    std::copy(src, src + src_size, dst);
+    return;
+  case COMPRESSION_ZLIB: {
+#ifndef _WIN32
+    z_stream strm = {};
+    if (inflateInit(&strm) != Z_OK)
+      throw std::runtime_error("failed to initialize zlib");
+
+    // zlib sizes are 32 bits, feed input and output in chunks
+    constexpr uint64_t chunk = 1ULL << 30;
+    uint64_t src_left = src_size;
+    uint64_t dst_left = csec->m_size;
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(src));
+    strm.next_out = reinterpret_cast<Bytef*>(dst);
+    int ret = Z_OK;
+    while (ret == Z_OK) {
+      if (!strm.avail_in && src_left) {
+        strm.avail_in = static_cast<uInt>(std::min(src_left, chunk));
+        src_left -= strm.avail_in;
+      }
+      if (!strm.avail_out && dst_left) {
+        strm.avail_out = static_cast<uInt>(std::min(dst_left, chunk));
+        dst_left -= strm.avail_out;
+      }
+      ret = inflate(&strm, Z_NO_FLUSH);
+      if (ret == Z_BUF_ERROR && (strm.avail_in || src_left) && (strm.avail_out || dst_left))
+        ret = Z_OK;   // more input or output space to feed
+    }
+    auto size_ok = (strm.avail_out == 0 && dst_left == 0);
+    inflateEnd(&strm);
+    if (ret != Z_STREAM_END || !size_ok)
+      throw std::runtime_error("failed to decompress xclbin section (" + std::to_string(ret) + ")");
+    return;
+#else
+    throw std::runtime_error("compressed xclbin sections are not supported on this platform");
+#endif
+  }
+  default:
+    throw std::runtime_error("unknown xclbin section compression: " + std::to_string(csec->m_algorithm));
+  }
+}
+
 } // namespace
 
 namespace xrt_core { namespace xclbin {
 
+bool
+is_compressed(const axlf* top)
+{
+  return (top->m_header.m_actionMask & AM_COMPRESSED_SECTIONS) != 0;
+}
+
+std::vector<char>
+get_axlf_section_data(const axlf* top, const axlf_section_header* hdr)
+{
+  std::vector<char> data(get_section_size(top, hdr));
+  copy_section_data(top, hdr, data.data());
+  return data;
+}
+
+std::vector<char>
+get_uncompressed_axlf(const axlf* top)
+{
+  auto num_sections = top->m_header.m_numSections;
+  uint64_t header_size = sizeof(axlf) + (num_sections ? num_sections - 1 : 0) * uint64_t(sizeof(axlf_section_header));
+  if (header_size > top->m_header.m_length)
+    throw std::runtime_error("xclbin section headers are outside of the xclbin image");
+
+  // Sections are laid out in order of their headers, 8 byte aligned
+  auto align = [](uint64_t offset) { return (offset + 7) & ~uint64_t(7); };
+  const uint64_t max_length = std::vector<char>().max_size() & ~uint64_t(7);
+  uint64_t length = header_size;
+  for (uint32_t idx = 0; idx < num_sections; ++idx) {
+    auto size = get_section_size(top, &top->m_sections[idx]);
+    length = align(length);
+    if (size > max_length - length)
+      throw std::runtime_error("uncompressed xclbin image is too large");
+    length += size;
+  }
+
+  std::vector<char> image(length, 0);
+  auto data = image.data();
+  std::copy(reinterpret_cast<const char*>(top), reinterpret_cast<const char*>(top) + header_size, data);
+
+  auto uncompressed = reinterpret_cast<axlf*>(data);
+  uncompressed->m_header.m_actionMask &= ~AM_COMPRESSED_SECTIONS;
+  uncompressed->m_header.m_length = length;
+  uncompressed->m_signature_length = -1;
+
+  uint64_t offset = header_size;
+  for (uint32_t idx = 0; idx < num_sections; ++idx) {
+    auto hdr = &top->m_sections[idx];
+    auto size = get_section_size(top, hdr);
+    offset = align(offset);
+    copy_section_data(top, hdr, data + offset);
+    uncompressed->m_sections[idx].m_sectionOffset = offset;
+    uncompressed->m_sections[idx].m_sectionSize = size;
+    offset += size;
+  }
+
+  return image;
+}
+
+const axlf*
+get_uncompressed_axlf(const axlf* top, std::vector<char>& buffer)
+{
+  if (!is_compressed(top))
+    return top;
+
+  buffer = get_uncompressed_axlf(top);
+  return reinterpret_cast<const axlf*>(buffer.data());
+}
+
 const axlf_section_header*
 get_axlf_section(const axlf* top, axlf_section_kind kind)
 {
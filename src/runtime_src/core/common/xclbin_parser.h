@@ -145,12 +145,73 @@ struct aie_partition_obj
  * @kind: section kind to retrieve
  *
  * This function treats group sections conditionally based on
- * xrt.ini settings
+ * xrt.ini settings.  The section data of a compressed axlf is
+ * stored compressed, so a raw axlf from the application must first
+ * be passed through get_uncompressed_axlf().
  */
 XRT_CORE_COMMON_EXPORT
 const axlf_section_header*
 get_axlf_section(const axlf* top, axlf_section_kind kind);
 
+/**
+ * is_compressed() - Check if sections of an axlf may be compressed
+ *
+ * @top: axlf to check
+ * Return: true if the axlf header marks compressed sections
+ *
+ * Section data of a compressed axlf must be retrieved with
+ * get_axlf_section_data(), the section header m_sectionSize is the
+ * size of the stored, possibly compressed, data.
+ */
+XRT_CORE_COMMON_EXPORT
+bool
+is_compressed(const axlf* top);
+
+/**
+ * get_axlf_section_data() - Uncompressed data of an axlf section
+ *
+ * @top: axlf containing the section
+ * @hdr: section header of @top, e.g. from get_axlf_section()
+ * Return: copy of the section data, decompressed if compressed
+ *
+ * Compressed data is decompressed directly into the returned buffer,
+ * only the section being retrieved is decompressed.
+ */
+XRT_CORE_COMMON_EXPORT
+std::vector<char>
+get_axlf_section_data(const axlf* top, const axlf_section_header* hdr);
+
+/**
+ * get_uncompressed_axlf() - Copy of an axlf with all sections uncompressed
+ *
+ * @top: axlf with compressed sections
+ * Return: axlf image with the same sections, all uncompressed
+ *
+ * This is the image given to drivers, which do not support compressed
+ * sections.  Any signature of @top does not apply to the uncompressed
+ * image, which is returned unsigned.  Throws if a section lies outside
+ * of @top or its stored uncompressed size cannot be valid.
+ */
+XRT_CORE_COMMON_EXPORT
+std::vector<char>
+get_uncompressed_axlf(const axlf* top);
+
+/**
+ * get_uncompressed_axlf() - Uncompressed axlf for legacy entry points
+ *
+ * @top: axlf as passed by the caller, possibly compressed
+ * @buffer: storage for the uncompressed image
+ * Return: @top if it has no compressed sections, otherwise the
+ *  uncompressed image in @buffer
+ *
+ * Entry points that take a raw axlf from the application, such as
+ * xclLoadXclBin(), use the returned image for the driver and for
+ * parsing with get_axlf_section().
+ */
+XRT_CORE_COMMON_EXPORT
+const axlf*
+get_uncompressed_axlf(const axlf* top, std::vector<char>& buffer);
+
 /**
  * Get specific binary section of the axlf structure
  *
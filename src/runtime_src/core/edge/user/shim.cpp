@@ -2181,6 +2181,10 @@ xclLoadXclBinImpl(xclDeviceHandle handle, const xclBin *buffer, bool meta)
   return xdp::hal::profiling_wrapper("xclLoadXclbin", [handle, buffer, meta] {
 
   try {
+    // Drivers and the shim do not support compressed sections
+    std::vector<char> uncompressed;
+    auto top = xrt_core::xclbin::get_uncompressed_axlf(buffer, uncompressed);
+
     bool checkDrmFD = xrt_core::config::get_enable_flat() ? false : true;
     ZYNQ::shim *drv = ZYNQ::shim::handleCheck(handle, checkDrmFD);
 
@@ -2194,7 +2198,7 @@ xclLoadXclBinImpl(xclDeviceHandle handle, const xclBin *buffer, bool meta)
 
     int ret;
     if (!meta) {
-      ret = drv ? drv->xclLoadXclBin(buffer) : -ENODEV;
+      ret = drv ? drv->xclLoadXclBin(top) : -ENODEV;
       if (ret) {
         printf("Load Xclbin Failed\n");
 
@@ -2203,7 +2207,7 @@ xclLoadXclBinImpl(xclDeviceHandle handle, const xclBin *buffer, bool meta)
     }
     auto core_device = xrt_core::get_userpf_device(handle);
 
-    core_device->register_axlf(buffer);
+    core_device->register_axlf(top);
 
 #ifdef XRT_ENABLE_AIE
     auto data = core_device->get_axlf_section(AIE_METADATA);
@@ -2212,22 +2216,22 @@ xclLoadXclBinImpl(xclDeviceHandle handle, const xclBin *buffer, bool meta)
 #endif
 
     /* If PDI is the only section, return here */
-    if (xrt_core::xclbin::is_pdi_only(buffer))
+    if (xrt_core::xclbin::is_pdi_only(top))
         return 0;
 
     // Skipping if only loading xclbin metadata
     if (!meta) {
-      ret = xrt_core::scheduler::init(handle, buffer);
+      ret = xrt_core::scheduler::init(handle, top);
       if (ret) {
 	printf("Scheduler init failed\n");
 	return ret;
       }
-      ret = drv->mapKernelControl(xrt_core::xclbin::get_cus_pair(buffer));
+      ret = drv->mapKernelControl(xrt_core::xclbin::get_cus_pair(top));
       if (ret) {
 	printf("Map CUs Failed\n");
 	return ret;
       }
-      ret = drv->mapKernelControl(xrt_core::xclbin::get_dbg_ips_pair(buffer));
+      ret = drv->mapKernelControl(xrt_core::xclbin::get_dbg_ips_pair(top));
       if (ret) {
 	printf("Map Debug IPs Failed\n");
 	return ret;
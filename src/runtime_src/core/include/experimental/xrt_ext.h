@@ -116,6 +116,144 @@ public:
   bo(const xrt::hw_context& hwctx, pid_type pid, xclBufferExportHandle ehdl);
 };
 
+/**
+ * class bo_arena - Sub buffers allocated from one large buffer object
+ *
+ * An arena allocates one parent buffer object in a memory bank up
+ * front and hands out sub buffers of it, so that many small buffers
+ * cost neither a driver allocation nor a map each.
+ *
+ * Sizes are rounded up to a size class, multiples of the alignment
+ * up to 64 units and eight classes per power of two above.  Freed
+ * ranges are merged with free neighbours.  A sub buffer returns its
+ * range to the arena when its last reference goes away, and keeps
+ * the arena's parent buffer alive until then.
+ *
+ * The arena is thread safe.  Sub buffers are ordinary xrt::bo sub
+ * buffers, they can be synced, mapped, and used as kernel arguments.
+ */
+class bo_arena_impl;
+class bo_arena : public detail::pimpl<bo_arena_impl>
+{
+public:
+  /**
+   * struct stats - arena usage
+   *
+   * @capacity:        size of the parent buffer
+   * @allocations:     sub buffers in use
+   * @failures:        allocations that found no free range large enough
+   * @bytes_requested: bytes requested by sub buffers in use
+   * @bytes_in_use:    bytes of sub buffers in use, per size class
+   * @bytes_free:      bytes not in use
+   * @free_ranges:     number of free ranges
+   * @largest_free:    size of the largest free range
+   */
+  struct stats
+  {
+    uint64_t capacity = 0;
+    uint64_t allocations = 0;
+    uint64_t failures = 0;
+    uint64_t bytes_requested = 0;
+    uint64_t bytes_in_use = 0;
+    uint64_t bytes_free = 0;
+    uint64_t free_ranges = 0;
+    uint64_t largest_free = 0;
+
+    // Fraction of the bytes in use lost to size class rounding
+    double
+    internal_fragmentation() const
+    {
+      return bytes_in_use
+        ? 1.0 - static_cast<double>(bytes_requested) / bytes_in_use
+        : 0.0;
+    }
+
+    // Fraction of the free bytes not usable by one large allocation
+    double
+    external_fragmentation() const
+    {
+      return bytes_free
+        ? 1.0 - static_cast<double>(largest_free) / bytes_free
+        : 0.0;
+    }
+  };
+
+  /**
+   * Default alignment of sub buffers, a page.  This satisfies
+   * kernel argument and DMA alignment on all platforms.
+   */
+  static constexpr size_t default_alignment = 4096;
+
+  /**
+   * bo_arena() - Constructor for empty arena
+   */
+  bo_arena() = default;
+
+  /**
+   * bo_arena() - Constructor for arena on a device
+   *
+   * @param device
+   *  The device on which to allocate the parent buffer
+   * @param sz
+   *  Size of the parent buffer
+   * @param flags
+   *  Flags of the parent buffer, device_only is not supported
+   * @param grp
+   *  Memory bank of the parent buffer
+   * @param alignment
+   *  Alignment of sub buffers within the parent, a power of two
+   */
+  XRT_API_EXPORT
+  bo_arena(const xrt::device& device, size_t sz, xrt::bo::flags flags, xrt::memory_group grp,
+           size_t alignment = default_alignment);
+
+  /**
+   * bo_arena() - Constructor for arena in a hardware context
+   *
+   * @param hwctx
+   *  The hardware context in which to allocate the parent buffer
+   * @param sz
+   *  Size of the parent buffer
+   * @param flags
+   *  Flags of the parent buffer, device_only is not supported
+   * @param grp
+   *  Memory bank of the parent buffer
+   * @param alignment
+   *  Alignment of sub buffers within the parent, a power of two
+   */
+  XRT_API_EXPORT
+  bo_arena(const xrt::hw_context& hwctx, size_t sz, xrt::bo::flags flags, xrt::memory_group grp,
+           size_t alignment = default_alignment);
+
+  /**
+   * alloc() - Allocate a sub buffer
+   *
+   * @param sz
+   *  Size of the sub buffer
+   * @return
+   *  Sub buffer of the parent buffer
+   *
+   * Throws if the arena has no free range large enough.
+   */
+  XRT_API_EXPORT
+  xrt::bo
+  alloc(size_t sz);
+
+  /**
+   * get_parent() - The parent buffer of all sub buffers
+   */
+  XRT_API_EXPORT
+  xrt::bo
+  get_parent() const;
+
+  /**
+   * get_stats() - Current usage of the arena
+   */
+  XRT_API_EXPORT
+  stats
+  get_stats() const;
+};
+
 } // xrt::ext
 
 #else
@@ -9,6 +9,11 @@
 #include "xrt.h"
 
 #ifdef __cplusplus
+# include "experimental/xrt_xclbin.h"
+# include "xrt/xrt_device.h"
+# include "xrt/xrt_hw_context.h"
+# include <chrono>
+# include <vector>
 
 /*!
  * @namespace xrt::system
@@ -28,6 +33,55 @@ XCL_DRIVER_DLLESPEC
 unsigned int
 enumerate_devices();
 
+/**
+ * struct load_timing - Wall time of the phases of load_xclbin()
+ *
+ * @prepare:  xclbin metadata built, once for all devices
+ * @load:     xclbin registered with or loaded on each device
+ * @context:  hardware context created on each device
+ * @total:    whole call
+ *
+ * Per device times are in the order of the devices passed to
+ * load_xclbin().  Devices are loaded concurrently, so @total is
+ * close to @prepare plus the slowest device rather than the sum.
+ */
+struct load_timing
+{
+  std::chrono::microseconds prepare {0};
+  std::vector<std::chrono::microseconds> load;
+  std::vector<std::chrono::microseconds> context;
+  std::chrono::microseconds total {0};
+};
+
+/**
+ * load_xclbin() - Load an xclbin on multiple devices concurrently
+ *
+ * @param devices
+ *  Devices to load the xclbin on, each device at most once
+ * @param xclbin
+ *  The xclbin to load
+ * @param mode
+ *  Access mode of the hardware contexts
+ * @param timing
+ *  Optional phase timing of the load
+ * @return
+ *  One hardware context per device in the order of @devices
+ *
+ * The xclbin metadata (memory topology, compute units, kernels) is
+ * built once from @xclbin and shared by all devices.  Each device
+ * then registers the xclbin and creates its hardware context on its
+ * own thread, so the driver work of the devices overlaps.
+ *
+ * Throws if the xclbin could not be loaded on any one device, after
+ * all devices are done.  The exception lists each failed device.
+ * Contexts created on the other devices are released.
+ */
+XCL_DRIVER_DLLESPEC
+std::vector<xrt::hw_context>
+load_xclbin(const std::vector<xrt::device>& devices, const xrt::xclbin& xclbin,
+            xrt::hw_context::access_mode mode = xrt::hw_context::access_mode::shared,
+            load_timing* timing = nullptr);
+
 }}
 
 #endif // __cplusplus
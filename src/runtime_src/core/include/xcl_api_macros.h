@@ -18,9 +18,28 @@
 //Initialize Messages
 #include "xcl_macros.h"
 
+// Shims built with XCL_EMU_RPC_CHANNEL own an rpc_channel (mRpcChannel)
+// for the socket.  Once the device has accepted pipelined calls, RPCs
+// on sock go through the channel and the socket mutex is not held for
+// the round trip.  Calls on other sockets (aiesim) still take the mutex
+// before using the shared message buffers.
+#ifdef XCL_EMU_RPC_CHANNEL
+#define RPC_PIPELINED() (mRpcChannel && mRpcChannel->pipelined())
+#define RPC_SET_FEATURES() c_msg.set_rpc_features(xclemulation::rpc_channel::features());
+#define RPC_ENABLE_FEATURES() if (mRpcChannel) mRpcChannel->enable(r_msg.rpc_features());
+#define RPC_PIPELINED_CALL(func_name) \
+    if (!mRpcChannel->call(func_name##_n, c_msg, r_msg)) { if (mLogStream.is_open()) mLogStream << __func__ << "\n pipelined RPC call failed, so exit the application now!"; exit(0); }
+#else
+#define RPC_PIPELINED() false
+#define RPC_SET_FEATURES()
+#define RPC_ENABLE_FEATURES()
+#define RPC_PIPELINED_CALL(func_name)
+#endif
+
 #define SCOPE_GUARD_MUTEX() \
 if ( sock->server_started == false ) { if (mLogStream.is_open()) mLogStream << __func__ << "\n socket communication is not possible now!"; exit(0);  } \
-std::lock_guard<std::mutex> socketlk{mtx}; 
+std::unique_lock<std::mutex> socketlk{mtx,std::defer_lock}; \
+if (!RPC_PIPELINED()) socketlk.lock();
 
 #define RPC_PROLOGUE(func_name) \
     auto _s_inst = sock;  \
@@ -31,6 +50,8 @@ std::lock_guard<std::mutex> socketlk{mtx};
 #if GOOGLE_PROTOBUF_VERSION < 3006001
 // Use the deprecated 32 bit version of the size
 #define SERIALIZE_AND_SEND_MSG(func_name)                               \
+  if (RPC_PIPELINED() && _s_inst == sock) { RPC_PIPELINED_CALL(func_name) } else { \
+    if (!socketlk.owns_lock()) socketlk.lock();                         \
     auto c_len = c_msg.ByteSize();                                      \
     buf_size = alloc_void(c_len);                                       \
     auto socket_call_status = -1;                                       \
@@ -52,10 +73,13 @@ std::lock_guard<std::mutex> socketlk{mtx};
     buf_size = alloc_void(ri_msg.size());                               \
     socket_call_status = _s_inst->sk_read(buf,ri_msg.size());           \
     if (socket_call_status != -1) { rv = r_msg.ParseFromArray(buf,ri_msg.size()); } \
-    if (true != rv) { if (mLogStream.is_open()) mLogStream << __func__ << "\n ParseFromArray failed, sk_read failed for alloc_void, so exit- the application now!!!"; exit(0); }
+    if (true != rv) { if (mLogStream.is_open()) mLogStream << __func__ << "\n ParseFromArray failed, sk_read failed for alloc_void, so exit- the application now!!!"; exit(0); } \
+  }
 #else
 // More recent protoc handles 64 bit size objects and the 32 bit version is deprecated
 #define SERIALIZE_AND_SEND_MSG(func_name)                               \
+  if (RPC_PIPELINED() && _s_inst == sock) { RPC_PIPELINED_CALL(func_name) } else { \
+    if (!socketlk.owns_lock()) socketlk.lock();                         \
     auto c_len = c_msg.ByteSizeLong();                                  \
     buf_size = alloc_void(c_len);                                       \
     bool rv = c_msg.SerializeToArray(buf,c_len);                        \
@@ -76,7 +100,8 @@ std::lock_guard<std::mutex> socketlk{mtx};
     buf_size = alloc_void(ri_msg.size());                               \
     _s_inst->sk_read(buf,ri_msg.size());                                \
     rv = r_msg.ParseFromArray(buf,ri_msg.size());                       \
-    assert(true == rv);
+    assert(true == rv);                                                 \
+  }
 #endif
 
 #define xclSetEnvironment_SET_PROTOMESSAGE() \
@@ -86,8 +111,10 @@ std::lock_guard<std::mutex> socketlk{mtx};
     namevalpair->set_name(i.first); \
     namevalpair->set_value(i.second); \
   }\
+  RPC_SET_FEATURES()
 
 #define xclSetEnvironment_SET_PROTO_RESPONSE() \
+    RPC_ENABLE_FEATURES() \
     ack = r_msg.ack()
 
 
@@ -115,8 +142,10 @@ std::lock_guard<std::mutex> socketlk{mtx};
     xclLoadBitstream_call_ddrbank* ddrbank = c_msg.add_ddrbanks(); \
     ddrbank->set_size(bankSize); \
   }\
+  RPC_SET_FEATURES()
 
 #define xclLoadBitstream_SET_PROTO_RESPONSE() \
+    RPC_ENABLE_FEATURES() \
     ack = r_msg.ack()
 
 
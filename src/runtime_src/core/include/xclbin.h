@@ -206,7 +206,13 @@ extern "C" {
     };
 
     enum ACTION_MASK {
-      AM_LOAD_AIE = 0x1                     /* Indicates to the driver to load the AIE PID section */
+      AM_LOAD_AIE = 0x1,                    /* Indicates to the driver to load the AIE PID section */
+      AM_COMPRESSED_SECTIONS = 0x2          /* One or more sections are compressed, see axlf_compressed_section */
+    };
+
+    enum COMPRESSION_ALGORITHM {
+      COMPRESSION_NONE = 0,                 /* Payload is stored as is */
+      COMPRESSION_ZLIB = 1                  /* Payload is a zlib (deflate) stream */
     };
 
     struct axlf_section_header {
@@ -252,6 +258,24 @@ extern "C" {
 
     typedef struct axlf xclBin;
 
+    /*
+     * Header of a compressed section payload.  Only present when the
+     * axlf header action mask has AM_COMPRESSED_SECTIONS, in which case
+     * a section is compressed if its data starts with this header.  The
+     * section header m_sectionSize is the size of the stored data
+     * including this header.  Drivers are always given an image with
+     * all sections uncompressed.
+     */
+    #define AXLF_COMPRESSED_SECTION_MAGIC "xclbinz"
+    struct axlf_compressed_section {
+        char m_magic[8];                    /* "xclbinz\0" */
+        uint32_t m_algorithm;               /* enum COMPRESSION_ALGORITHM */
+        uint32_t m_reserved;                /* Initialized to zero */
+        uint64_t m_size;                    /* Size of the uncompressed section data */
+        /* Compressed data follows */
+    };
+    XCLBIN_STATIC_ASSERT(sizeof(struct axlf_compressed_section) == 24, "axlf_compressed_section structure no longer is 24 bytes in size");
+
     /**** BEGIN : Xilinx internal section *****/
 
     /* bitstream information */
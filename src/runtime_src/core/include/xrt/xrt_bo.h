@@ -11,6 +11,7 @@
 
 #ifdef __cplusplus
 # include <memory>
+# include <vector>
 #endif
 
 /**
@@ -568,6 +569,38 @@ public:
     sync(dir, size(), 0);
   }
 
+  /**
+   * struct sync_range - Range of buffer content to synchronize
+   *
+   * @size:   Size of data to synchronize
+   * @offset: Offset within the BO
+   */
+  struct sync_range
+  {
+    size_t size;
+    size_t offset;
+  };
+
+  /**
+   * sync() - Synchronize multiple ranges of buffer content with device side
+   *
+   * @param dir
+   *  To device or from device
+   * @param ranges
+   *  Ranges of the BO to synchronize, in any order
+   *
+   * Overlapping and adjacent ranges are combined so that each byte
+   * is transferred once.  If the driver supports it, the combined
+   * ranges are synchronized with one driver call, otherwise with one
+   * call per combined range.  Ranges are not merged across gaps
+   * since that would overwrite data on the other side.
+   *
+   * Throws if any range is outside the BO, before anything is synced.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  sync(xclBOSyncDirection dir, const std::vector<sync_range>& ranges);
+
   /**
    * map() - Map the host side buffer into application
    *
@@ -74,7 +74,8 @@ struct xcl_bo_flags
 
       // extension
       uint32_t access : 2;  // [33-32]
-      uint32_t unused : 30; // [63-34]
+      uint32_t numa   : 2;  // [35-34]
+      uint32_t unused : 28; // [63-36]
     };
   };
 };
@@ -102,6 +103,17 @@ struct xcl_bo_flags
 #define XRT_BO_ACCESS_SHARED 1
 #define XRT_BO_ACCESS_EXPORTED 2
 
+/**
+ * NUMA placement of XRT allocated host memory (numa extension bits)
+ *
+ * Overrides Runtime.host_mem_numa_policy in xrt.ini for one buffer.
+ * The placement is relative to the NUMA node of the device.
+ */
+#define XRT_BO_NUMA_DEFAULT 0
+#define XRT_BO_NUMA_NONE 1
+#define XRT_BO_NUMA_PREFERRED 2
+#define XRT_BO_NUMA_BIND 3
+
 /**
  * XRT Native BO flags
  *
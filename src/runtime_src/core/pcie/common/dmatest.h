@@ -138,7 +138,10 @@ namespace xcldev {
 
             for (long long i = 0; i < count; i++) {
                 // This can throw and callers of DMARunner are supposed to catch this.
-                xrt_core::aligned_ptr_type buf = xrt_core::aligned_alloc(xrt_core::getpagesize(), mSize);
+                // Host buffers on the NUMA node of the device
+                xrt_core::aligned_ptr_type buf = xrt_core::aligned_alloc(xrt_core::getpagesize(), mSize,
+                                                                         mHandle->get_numa_node(),
+                                                                         xrt_core::numa_policy::preferred);
                 auto bo = mhwCtxHandle->alloc_bo(buf.get(), mSize, mFlags);
                 if (!bo)
                     break;
@@ -0,0 +1,171 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Stress benchmark for the emulation device memory manager.
+//
+// % memorymanager_bench [--ops n] [--live n] [--size n] [--max-alloc n]
+//                       [--seed n]
+//
+// The harness runs a random mix of allocations and frees against one
+// memory manager, keeping up to --live buffers allocated, and reports
+// throughput and fragmentation.  Every allocation is checked against
+// the live set for overlap and range, and once all buffers are freed
+// the manager must be back to one free block.  The program returns
+// non zero on any inconsistency, which makes it usable as a
+// regression test.
+#include "memorymanager.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+static void
+usage()
+{
+  std::cout << "usage: memorymanager_bench [options]\n"
+            << " [--ops <n>]        number of alloc/free operations (default 1000000)\n"
+            << " [--live <n>]       max number of live allocations (default 10000)\n"
+            << " [--size <n>]       size of managed memory in MB (default 16384)\n"
+            << " [--max-alloc <n>]  max allocation size in KB (default 1024)\n"
+            << " [--seed <n>]       random seed (default 1)\n";
+}
+
+static int
+run(int argc, char** argv)
+{
+  uint64_t ops = 1000000;
+  uint64_t live = 10000;
+  uint64_t mem_size = 16384ull << 20;
+  uint64_t max_alloc = 1024ull << 10;
+  unsigned seed = 1;
+  const unsigned alignment = 4096;
+  const uint64_t mem_start = 0x400000000ull;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  for (size_t i = 0; i < args.size(); ++i) {
+    const auto& arg = args[i];
+    if (arg == "--help" || arg == "-h") {
+      usage();
+      return 0;
+    }
+    if (i + 1 == args.size())
+      throw std::runtime_error("missing value for option: " + arg);
+
+    const auto& val = args[++i];
+    if (arg == "--ops")
+      ops = std::stoull(val);
+    else if (arg == "--live")
+      live = std::stoull(val);
+    else if (arg == "--size")
+      mem_size = std::stoull(val) << 20;
+    else if (arg == "--max-alloc")
+      max_alloc = std::stoull(val) << 10;
+    else if (arg == "--seed")
+      seed = std::stoul(val);
+    else
+      throw std::runtime_error("unknown option: " + arg);
+  }
+
+  if (!live || !max_alloc)
+    throw std::runtime_error("--live and --max-alloc must be non zero");
+
+  std::string tag("bench");
+  xclemulation::MemoryManager mm(mem_size, mem_start, alignment, tag);
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<uint64_t> size_dist(1, max_alloc);
+
+  // Live allocations, address -> size, used to verify the manager
+  std::map<uint64_t, uint64_t> bufs;
+  std::vector<uint64_t> addrs;
+  int errors = 0;
+  double worst_fragmentation = 0.0;
+  std::chrono::duration<double> elapsed(0);
+
+  for (uint64_t op = 0; op < ops; ++op) {
+    // Fill up to half of --live, then alloc and free at random
+    bool do_alloc = addrs.size() < live / 2 || (addrs.size() < live && (rng() & 1));
+    if (do_alloc) {
+      size_t size = size_dist(rng);
+      auto start = std::chrono::steady_clock::now();
+      auto addr = mm.alloc(size);
+      elapsed += std::chrono::steady_clock::now() - start;
+      if (addr == xclemulation::MemoryManager::mNull)
+        continue;
+
+      if (addr < mem_start || addr + size > mem_start + mem_size || addr % alignment) {
+        std::cerr << "bad allocation 0x" << std::hex << addr << std::dec << "\n";
+        ++errors;
+      }
+      auto next = bufs.lower_bound(addr);
+      if ((next != bufs.end() && addr + size > next->first)
+          || (next != bufs.begin() && std::prev(next)->first + std::prev(next)->second > addr)) {
+        std::cerr << "overlapping allocation 0x" << std::hex << addr << std::dec << "\n";
+        ++errors;
+      }
+      bufs[addr] = size;
+      addrs.push_back(addr);
+    }
+    else {
+      auto idx = rng() % addrs.size();
+      auto addr = addrs[idx];
+      addrs[idx] = addrs.back();
+      addrs.pop_back();
+      if (mm.lookup(addr).second != bufs[addr]) {
+        std::cerr << "lookup mismatch 0x" << std::hex << addr << std::dec << "\n";
+        ++errors;
+      }
+      auto start = std::chrono::steady_clock::now();
+      mm.free(addr);
+      elapsed += std::chrono::steady_clock::now() - start;
+      bufs.erase(addr);
+    }
+
+    // getStats() is constant time, sample outside the timed region
+    worst_fragmentation = std::max(worst_fragmentation, mm.getStats().fragmentation());
+  }
+
+  auto stats = mm.getStats();
+  worst_fragmentation = std::max(worst_fragmentation, stats.fragmentation());
+  std::cout << std::fixed << std::setprecision(3)
+            << "operations:        " << ops << "\n"
+            << "allocations:       " << stats.allocCount << " (" << stats.allocFailCount << " failed)\n"
+            << "frees:             " << stats.freeCount << "\n"
+            << "live buffers:      " << stats.busyBlocks << "\n"
+            << "free blocks:       " << stats.freeBlocks << "\n"
+            << "fragmentation:     " << stats.fragmentation() << " (worst " << worst_fragmentation << ")\n"
+            << "time:              " << elapsed.count() << " s\n"
+            << "ops/sec:           " << std::setprecision(0) << (elapsed.count() > 0.0 ? ops / elapsed.count() : 0.0) << "\n";
+
+  for (auto addr : addrs)
+    mm.free(addr);
+
+  stats = mm.getStats();
+  if (stats.busyBlocks || stats.freeBlocks != 1 || stats.freeSize != mem_size
+      || mm.freeSize() != mem_size || stats.largestFreeBlock != mem_size) {
+    std::cerr << "memory not coalesced after freeing all buffers\n";
+    ++errors;
+  }
+
+  return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  try {
+    return run(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "memorymanager_bench: " << ex.what() << "\n";
+  }
+  return EXIT_FAILURE;
+}
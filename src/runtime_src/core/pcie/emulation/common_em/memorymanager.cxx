@@ -19,10 +19,10 @@
 namespace xclemulation {
   MemoryManager::MemoryManager(uint64_t size, uint64_t start,
       unsigned alignment,std::string& tag ) : mSize(size), mStart(start), mAlignment(alignment), mTag(tag),
-  mCoalesceThreshold(4), mFreeSize(0)
+  mFreeSize(0), mAllocCount(0), mAllocFailCount(0), mFreeCount(0)
   {
     assert(start % alignment == 0);
-    mFreeBufferList.push_back(std::make_pair(mStart, mSize));
+    insertFreeBlock(mStart, mSize);
     mFreeSize = mSize;
   }
 
@@ -31,6 +31,20 @@ namespace xclemulation {
 
   }
 
+  void MemoryManager::insertFreeBlock(uint64_t start, uint64_t size)
+  {
+    if (!size)
+      return;
+    mFreeBlocks.emplace(start, size);
+    mFreeBlocksBySize.emplace(size, start);
+  }
+
+  void MemoryManager::eraseFreeBlock(std::map<uint64_t, uint64_t>::iterator it)
+  {
+    mFreeBlocksBySize.erase(std::make_pair(it->second, it->first));
+    mFreeBlocks.erase(it);
+  }
+
   uint64_t MemoryManager::alloc(size_t& origSize, unsigned int paddingFactor,std::map<uint64_t, uint64_t> &chunks )
   {
     if (origSize == 0)
@@ -80,100 +94,72 @@ namespace xclemulation {
 	    }
     }
 
-    for (PairList::iterator i = mFreeBufferList.begin(), e = mFreeBufferList.end(); i != e; ++i) 
-    {
-      if (i->second < size)
-        continue;
-      result = i->first;
-      if (i->second > size) 
-      {
-        // Resize the existing entry in freelist
-        i->first += size;
-        i->second -= size;
-      }
-      else 
-      {
-        // remove the exact match found
-        mFreeBufferList.erase(i);
-      }
-      mBusyBufferList.push_back(std::make_pair(result, size));
-      mFreeSize -= size;
-      break;
+    // Best fit: smallest free block that can hold the request, lowest
+    // address among blocks of equal size
+    auto fit = mFreeBlocksBySize.lower_bound(std::make_pair(static_cast<uint64_t>(size), static_cast<uint64_t>(0)));
+    if (fit == mFreeBlocksBySize.end()) {
+      ++mAllocFailCount;
+      return result;
     }
+
+    const uint64_t blockStart = fit->second;
+    const uint64_t blockSize = fit->first;
+    eraseFreeBlock(mFreeBlocks.find(blockStart));
+    // Return the tail of the block to the free lists
+    insertFreeBlock(blockStart + size, blockSize - size);
+
+    result = blockStart;
+    mBusyBlocks.emplace(result, size);
+    mFreeSize -= size;
+    ++mAllocCount;
     return result;
   }
 
   void MemoryManager::free(uint64_t buf)
   {
     std::lock_guard<std::mutex> lock(mMemManagerMutex);
-    PairList::iterator i = find(buf);
-    if (i == mBusyBufferList.end())
+    auto busy = mBusyBlocks.find(buf);
+    if (busy == mBusyBlocks.end())
       return;
-    mFreeSize += i->second;
-    mFreeBufferList.push_back(std::make_pair(i->first, i->second));
-    mBusyBufferList.erase(i);
-    if (mFreeBufferList.size() > mCoalesceThreshold) {
-      coalesce();
-    }
-  }
-
 
-  void MemoryManager::coalesce()
-  {
-    // First sort the free buffers and then attempt to coalesce the neighbors
-    mFreeBufferList.sort();
-
-    PairList::iterator curr = mFreeBufferList.begin();
-    PairList::iterator next = curr;
-    ++next;
-    PairList::iterator last = mFreeBufferList.end();
-    while (next != last) {
-      if ((curr->first + curr->second) != next->first) {
-        // Non contiguous blocks
-        curr = next;
-        ++next;
-        continue;
+    uint64_t start = busy->first;
+    uint64_t size = busy->second;
+    mBusyBlocks.erase(busy);
+    mFreeSize += size;
+    ++mFreeCount;
+
+    // Coalesce with the free neighbors on either side
+    auto next = mFreeBlocks.lower_bound(start);
+    if (next != mFreeBlocks.begin()) {
+      auto prev = std::prev(next);
+      if (prev->first + prev->second == start) {
+        start = prev->first;
+        size += prev->second;
+        eraseFreeBlock(prev);
       }
-      // Coalesce curr and next
-      curr->second += next->second;
-      mFreeBufferList.erase(next);
-      next = curr;
-      ++next;
     }
-  }
-
-
-  MemoryManager::PairList::iterator MemoryManager::find(uint64_t buf)
-  {
-#if GCC_VERSION >= 40800
-    PairList::iterator i = std::find_if(mBusyBufferList.begin(), mBusyBufferList.end(), [&] (const PairList::value_type& s)
-        { return s.first == buf; });
-#else
-    PairList::iterator i = mBusyBufferList.begin();
-    PairList::iterator last  = mBusyBufferList.end();
-    while(i != last) {
-      if (i->first == buf)
-        break;
-      ++i;
+    if (next != mFreeBlocks.end() && start + size == next->first) {
+      size += next->second;
+      eraseFreeBlock(next);
     }
-#endif
-    return i;
+    insertFreeBlock(start, size);
   }
 
   void MemoryManager::reset()
   {
     std::lock_guard<std::mutex> lock(mMemManagerMutex);
-    mFreeBufferList.clear();
-    mBusyBufferList.clear();
-    mFreeBufferList.push_back(std::make_pair(mStart, mSize));
-    mFreeSize = 0;
+    mFreeBlocks.clear();
+    mFreeBlocksBySize.clear();
+    mBusyBlocks.clear();
+    insertFreeBlock(mStart, mSize);
+    mFreeSize = mSize;
   }
 
   std::pair<uint64_t, uint64_t> MemoryManager::lookup(uint64_t buf)
   {
     std::lock_guard<std::mutex> lock(mMemManagerMutex);
-    PairList::iterator i = find(buf);
-    if (i != mBusyBufferList.end())
+    auto i = mBusyBlocks.find(buf);
+    if (i != mBusyBlocks.end())
       return *i;
     // Compiler bug -- Some versions of GCC C++11 compiler do not
     // like mNull directly inside std::make_pair, so capture mNull
@@ -181,5 +167,18 @@ namespace xclemulation {
     const uint64_t v = mNull;
     return std::make_pair(v, v);
   }
-}
 
+  MemoryManager::Stats MemoryManager::getStats()
+  {
+    std::lock_guard<std::mutex> lock(mMemManagerMutex);
+    Stats stats;
+    stats.allocCount = mAllocCount;
+    stats.allocFailCount = mAllocFailCount;
+    stats.freeCount = mFreeCount;
+    stats.busyBlocks = mBusyBlocks.size();
+    stats.freeBlocks = mFreeBlocks.size();
+    stats.freeSize = mFreeSize;
+    stats.largestFreeBlock = mFreeBlocksBySize.empty() ? 0 : mFreeBlocksBySize.rbegin()->first;
+    return stats;
+  }
+}
@@ -20,6 +20,8 @@
 #include <mutex>
 #include <list>
 #include <map>
+#include <set>
+#include <unordered_map>
 #include <cassert>
 #include <algorithm>
 
@@ -33,21 +35,44 @@ static std::string DEFAULT_TAG("");
     class MemoryManager 
     {
         std::mutex mMemManagerMutex;
-        std::list<std::pair<uint64_t, uint64_t> > mFreeBufferList;
-        std::list<std::pair<uint64_t, uint64_t> > mBusyBufferList;
+        // Free blocks by start address, adjacent free blocks are always merged
+        std::map<uint64_t, uint64_t> mFreeBlocks;
+        // Free blocks ordered by (size, start) for best fit allocation
+        std::set<std::pair<uint64_t, uint64_t> > mFreeBlocksBySize;
+        // Allocated blocks by start address
+        std::unordered_map<uint64_t, uint64_t> mBusyBlocks;
         uint64_t mSize;
         uint64_t mStart;
         uint64_t mAlignment;
 	std::string mTag;
-        const unsigned mCoalesceThreshold;
         uint64_t mFreeSize;
-
-        typedef std::list<std::pair<uint64_t, uint64_t> > PairList;
+        uint64_t mAllocCount;
+        uint64_t mAllocFailCount;
+        uint64_t mFreeCount;
 
     public:
 	static const uint64_t mNull = 0xffffffffffffffffull;
 	std::list<MemoryManager*> mChildMemories;
 
+        // Allocation statistics of this memory manager, excluding child memories
+        struct Stats
+        {
+          uint64_t allocCount = 0;        // successful allocations
+          uint64_t allocFailCount = 0;    // failed allocations
+          uint64_t freeCount = 0;         // freed allocations
+          uint64_t busyBlocks = 0;        // live allocations
+          uint64_t freeBlocks = 0;        // number of free blocks
+          uint64_t freeSize = 0;          // total size of free blocks
+          uint64_t largestFreeBlock = 0;  // size of largest free block
+
+          // 0 when all free memory is one block, approaching 1 as free
+          // memory is split into blocks that are small relative to the total
+          double fragmentation() const
+          {
+            return freeSize ? 1.0 - static_cast<double>(largestFreeBlock) / freeSize : 0.0;
+          }
+        };
+
     public:
         MemoryManager(uint64_t size, uint64_t start, unsigned alignment, std::string&tag = DEFAULT_TAG );
         ~MemoryManager();
@@ -62,10 +87,11 @@ static std::string DEFAULT_TAG("");
         static bool isNullAlloc(const std::pair<uint64_t, uint64_t>& buf) { return ((buf.first == mNull) || (buf.second == mNull)); }
 
         std::pair<uint64_t, uint64_t>lookup(uint64_t buf);
+        Stats getStats();
 
     private:
-        void coalesce();
-        PairList::iterator find(uint64_t buf);
+        void insertFreeBlock(uint64_t start, uint64_t size);
+        void eraseFreeBlock(std::map<uint64_t, uint64_t>::iterator it);
     };
 }
 
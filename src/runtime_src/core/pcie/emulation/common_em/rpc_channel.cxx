@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef _WINDOWS
+
+#include "rpc_channel.h"
+#include "rpc_messages.pb.h"
+
+namespace {
+
+template <typename MessageType>
+static size_t
+byte_size(const MessageType& msg)
+{
+#if GOOGLE_PROTOBUF_VERSION < 3006001
+  return msg.ByteSize();
+#else
+  return msg.ByteSizeLong();
+#endif
+}
+
+// Size of the fixed size response header of a pipelined response
+static size_t
+response_header_size()
+{
+  static const size_t size = [] {
+    response_packet_info ri;
+    ri.set_size(0);
+    ri.set_id(0);
+    return byte_size(ri);
+  }();
+  return size;
+}
+
+} // namespace
+
+namespace xclemulation {
+
+rpc_channel::
+rpc_channel(unix_socket* sock)
+  : rpc_channel([sock](const void* buf, size_t count) { return sock->sk_write(buf, count); },
+                [sock](void* buf, size_t count) { return sock->sk_read(buf, count); })
+{}
+
+rpc_channel::
+rpc_channel(write_fn write, read_fn read)
+  : m_write(std::move(write))
+  , m_read(std::move(read))
+{}
+
+void
+rpc_channel::
+enable(uint32_t device_features)
+{
+  m_pipelined = (device_features & feature_pipeline) != 0;
+}
+
+bool
+rpc_channel::
+read_response(uint64_t& id, std::string& payload)
+{
+  std::string header(response_header_size(), '\0');
+  if (m_read(&header[0], header.size()) != static_cast<ssize_t>(header.size()))
+    return false;
+
+  response_packet_info ri;
+  if (!ri.ParseFromString(header) || !ri.has_id())
+    return false;
+
+  id = ri.id();
+  payload.resize(ri.size());
+  if (payload.empty())
+    return true;
+
+  return m_read(&payload[0], payload.size()) == static_cast<ssize_t>(payload.size());
+}
+
+bool
+rpc_channel::
+wait_response(uint64_t id, std::string& payload)
+{
+  std::unique_lock<std::mutex> lk(m_mutex);
+  while (true) {
+    auto itr = m_responses.find(id);
+    if (itr != m_responses.end()) {
+      payload = std::move(itr->second);
+      m_responses.erase(itr);
+      return true;
+    }
+
+    if (m_failed)
+      return false;
+
+    if (m_reading) {
+      m_cv.wait(lk);
+      continue;
+    }
+
+    // Read the next response from the socket, which may be for
+    // this caller or for another caller waiting on m_cv
+    m_reading = true;
+    lk.unlock();
+    uint64_t rid = 0;
+    std::string data;
+    auto ok = read_response(rid, data);
+    lk.lock();
+    m_reading = false;
+    if (ok)
+      m_responses.emplace(rid, std::move(data));
+    else
+      m_failed = true;
+    m_cv.notify_all();
+  }
+}
+
+bool
+rpc_channel::
+call(uint32_t xcl_api,
+     const google::protobuf::MessageLite& request,
+     google::protobuf::MessageLite& response)
+{
+  auto id = m_next_id++;
+
+  std::string payload;
+  if (!request.SerializeToString(&payload))
+    return false;
+
+  call_packet_info ci;
+  ci.set_size(payload.size());
+  ci.set_xcl_api(xcl_api);
+  ci.set_id(id);
+  std::string frame;
+  if (!ci.SerializeToString(&frame))
+    return false;
+  frame += payload;
+
+  {
+    std::lock_guard<std::mutex> lk(m_write_mutex);
+    if (m_write(frame.data(), frame.size()) != static_cast<ssize_t>(frame.size()))
+      return false;
+  }
+
+  std::string rbuf;
+  if (!wait_response(id, rbuf))
+    return false;
+
+  return response.ParseFromString(rbuf);
+}
+
+} // xclemulation
+
+#endif
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef _EMULATION_RPC_CHANNEL_H_
+#define _EMULATION_RPC_CHANNEL_H_
+
+#ifndef _WINDOWS
+
+#include "unix_socket.h"
+
+#include <google/protobuf/message_lite.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace xclemulation {
+
+// class rpc_channel - Pipelined RPC transport over the emulation socket
+//
+// By default the shim serializes RPC calls on the socket mutex, one
+// request/response round trip at a time.  When the device process
+// accepts the pipeline feature during the handshake, calls are tagged
+// with a request id and the socket mutex is no longer held for the
+// round trip.  Several host threads can then have requests in flight,
+// and responses are matched to callers by id in any order.
+//
+// Handshake: the shim sends features() in the rpc_features field of
+// its first setup call (xclLoadBitstream for sw_emu, xclSetEnvironment
+// for hw_emu) and passes the rpc_features field of the response to
+// enable().  A device process that does not know the field ignores it
+// and leaves it unset in the response, and the channel stays
+// disabled.
+//
+// Frame format once enabled:
+//   call:     call_packet_info {size, xcl_api, id} + call payload
+//   response: response_packet_info {size, id} + response payload
+// Each call is sent with a single write.
+//
+// The device process must echo the feature in its response for the
+// channel to be used, until it does every call takes the serialized
+// path.  Small calls (register reads and writes, exec buffers) are
+// not batched into one frame, that needs a multi-call message on the
+// device side as well; pipelining lets them be in flight together
+// instead.
+class rpc_channel
+{
+public:
+  // Feature bits exchanged in the handshake
+  static constexpr uint32_t feature_pipeline = 0x1;
+
+  // Transport writing and reading whole buffers, returning the number
+  // of bytes transferred or -1
+  using write_fn = std::function<ssize_t(const void* buf, size_t count)>;
+  using read_fn = std::function<ssize_t(void* buf, size_t count)>;
+
+  explicit
+  rpc_channel(unix_socket* sock);
+
+  rpc_channel(write_fn write, read_fn read);
+
+  // Features requested by the host
+  static uint32_t
+  features()
+  {
+    return feature_pipeline;
+  }
+
+  // Enable features accepted by the device.  Must be called while
+  // no pipelined call is in flight, i.e. from the serialized
+  // handshake call.
+  void
+  enable(uint32_t device_features);
+
+  bool
+  pipelined() const
+  {
+    return m_pipelined;
+  }
+
+  // Send a call and wait for its response.  Thread safe.
+  // Returns false if the socket failed or a message could not be
+  // serialized or parsed.
+  bool
+  call(uint32_t xcl_api,
+       const google::protobuf::MessageLite& request,
+       google::protobuf::MessageLite& response);
+
+private:
+  bool
+  read_response(uint64_t& id, std::string& payload);
+
+  bool
+  wait_response(uint64_t id, std::string& payload);
+
+  write_fn m_write;
+  read_fn m_read;
+  std::atomic<bool> m_pipelined {false};
+  std::atomic<uint64_t> m_next_id {1};
+
+  // Serializes writes of complete frames
+  std::mutex m_write_mutex;
+
+  // Responses read by one caller on behalf of other callers.  One
+  // caller at a time reads from the socket (m_reading), others wait
+  // on m_cv for their response to arrive.
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::map<uint64_t, std::string> m_responses;
+  bool m_reading = false;
+  bool m_failed = false;
+};
+
+} // xclemulation
+
+#endif
+
+#endif
@@ -0,0 +1,8 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Each unit test executable links this file for the Boost.Test main.
+// The header only variant is used because XRT does not link the
+// Boost unit_test_framework library.
+#define BOOST_TEST_MODULE "XRT emulation unit test"
+#include <boost/test/included/unit_test.hpp>
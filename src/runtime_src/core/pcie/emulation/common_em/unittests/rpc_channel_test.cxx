@@ -0,0 +1,290 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Test of xclemulation::rpc_channel without a device process.
+//
+// % rpc_channel_test --run_test=test_rpc_channel
+//
+// A socketpair stands in for the emulation socket.  A helper thread
+// plays the device process: it waits until every host thread has a
+// call in flight and then answers the calls in reverse order, so
+// responses must be matched to callers by id.
+#include <boost/test/unit_test.hpp>
+
+#include "rpc_channel.h"
+#include "rpc_messages.pb.h"
+#include "xcl_macros.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct socket_pair
+{
+  int fd[2];
+
+  socket_pair()
+  {
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fd))
+      throw std::runtime_error("socketpair failed");
+  }
+
+  ~socket_pair()
+  {
+    close_end(0);
+    close_end(1);
+  }
+
+  void
+  close_end(int i)
+  {
+    if (fd[i] >= 0)
+      close(fd[i]);
+    fd[i] = -1;
+  }
+};
+
+static ssize_t
+read_all(int fd, void* buf, size_t count)
+{
+  size_t done = 0;
+  while (done < count) {
+    auto ret = recv(fd, static_cast<char*>(buf) + done, count - done, 0);
+    if (ret <= 0)
+      return -1;
+    done += ret;
+  }
+  return done;
+}
+
+static ssize_t
+write_all(int fd, const void* buf, size_t count)
+{
+  size_t done = 0;
+  while (done < count) {
+    auto ret = send(fd, static_cast<const char*>(buf) + done, count - done, MSG_NOSIGNAL);
+    if (ret <= 0)
+      return -1;
+    done += ret;
+  }
+  return done;
+}
+
+static xclemulation::rpc_channel
+make_channel(int fd)
+{
+  return {
+    [fd](const void* buf, size_t count) { return write_all(fd, buf, count); },
+    [fd](void* buf, size_t count) { return read_all(fd, buf, count); }
+  };
+}
+
+template <typename MessageType>
+static size_t
+byte_size(const MessageType& msg)
+{
+#if GOOGLE_PROTOBUF_VERSION < 3006001
+  return msg.ByteSize();
+#else
+  return msg.ByteSizeLong();
+#endif
+}
+
+// A call as received by the device process
+struct device_call
+{
+  uint64_t id;
+  uint32_t xcl_api;
+  xclRegRead_call msg;
+};
+
+// Device process end of the socket
+class device
+{
+  int m_fd;
+
+public:
+  explicit
+  device(int fd)
+    : m_fd(fd)
+  {}
+
+  // Wait up to timeout_ms for a call, false on timeout or error
+  bool
+  receive(device_call& call, int timeout_ms = 5000)
+  {
+    struct pollfd pfd = {m_fd, POLLIN, 0};
+    if (poll(&pfd, 1, timeout_ms) != 1)
+      return false;
+
+    call_packet_info ci;
+    ci.set_size(0);
+    ci.set_xcl_api(0);
+    ci.set_id(0);
+    std::string header(byte_size(ci), '\0');
+    if (read_all(m_fd, &header[0], header.size()) < 0 || !ci.ParseFromString(header))
+      return false;
+
+    std::string payload(ci.size(), '\0');
+    if (!payload.empty() && read_all(m_fd, &payload[0], payload.size()) < 0)
+      return false;
+
+    call.id = ci.id();
+    call.xcl_api = ci.xcl_api();
+    return call.msg.ParseFromString(payload);
+  }
+
+  // Answer a register read with the offset that was read
+  bool
+  respond(const device_call& call)
+  {
+    xclRegRead_response r_msg;
+    r_msg.set_valid(true);
+    r_msg.set_data(std::to_string(call.msg.offset()));
+    std::string payload;
+    r_msg.SerializeToString(&payload);
+
+    response_packet_info ri;
+    ri.set_size(payload.size());
+    ri.set_id(call.id);
+    std::string frame;
+    ri.SerializeToString(&frame);
+    frame += payload;
+    return write_all(m_fd, frame.data(), frame.size()) > 0;
+  }
+};
+
+static bool
+reg_read(xclemulation::rpc_channel& channel, uint32_t offset)
+{
+  xclRegRead_call c_msg;
+  c_msg.set_baseaddress(0);
+  c_msg.set_offset(offset);
+  c_msg.set_size(4);
+  xclRegRead_response r_msg;
+  if (!channel.call(xclRegRead_n, c_msg, r_msg))
+    return false;
+  return r_msg.valid() && r_msg.data() == std::to_string(offset);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE ( test_rpc_channel )
+
+BOOST_AUTO_TEST_CASE( test_features )
+{
+  socket_pair sp;
+  auto channel = make_channel(sp.fd[0]);
+  BOOST_CHECK(!channel.pipelined());
+
+  // A device process that does not know the feature leaves it unset
+  channel.enable(0);
+  BOOST_CHECK(!channel.pipelined());
+
+  channel.enable(xclemulation::rpc_channel::features());
+  BOOST_CHECK(channel.pipelined());
+}
+
+BOOST_AUTO_TEST_CASE( test_out_of_order )
+{
+  constexpr int threads = 8;
+  constexpr int calls = 50;
+
+  socket_pair sp;
+  auto channel = make_channel(sp.fd[0]);
+  channel.enable(xclemulation::rpc_channel::features());
+
+  // Every thread has one call in flight at a time, the device waits
+  // for all of them and answers the last received first
+  std::atomic<int> batches{0};
+  std::atomic<bool> device_ok{false};
+  std::thread device_peer([&] {
+    device dev(sp.fd[1]);
+    std::vector<uint64_t> ids;
+    for (int batch = 0; batch < calls; ++batch) {
+      std::vector<device_call> pending(threads);
+      for (auto& call : pending) {
+        if (!dev.receive(call) || call.xcl_api != xclRegRead_n)
+          return;
+        ids.push_back(call.id);
+      }
+      for (auto itr = pending.rbegin(); itr != pending.rend(); ++itr)
+        if (!dev.respond(*itr))
+          return;
+      ++batches;
+    }
+
+    // Ids are unique
+    std::sort(ids.begin(), ids.end());
+    device_ok = std::adjacent_find(ids.begin(), ids.end()) == ids.end();
+  });
+
+  std::atomic<int> matched{0};
+  std::vector<std::thread> hosts;
+  for (int t = 0; t < threads; ++t)
+    hosts.emplace_back([&, t] {
+      for (int i = 0; i < calls; ++i)
+        if (reg_read(channel, t * 1000 + i))
+          ++matched;
+    });
+
+  for (auto& h : hosts)
+    h.join();
+  device_peer.join();
+
+  BOOST_CHECK_EQUAL(batches, calls);
+  BOOST_CHECK(device_ok);
+  BOOST_CHECK_EQUAL(matched, threads * calls);
+}
+
+BOOST_AUTO_TEST_CASE( test_device_gone )
+{
+  constexpr int threads = 4;
+
+  socket_pair sp;
+  auto channel = make_channel(sp.fd[0]);
+  channel.enable(xclemulation::rpc_channel::features());
+
+  // The device answers one call and goes away with the others in flight
+  std::thread device_peer([&] {
+    device dev(sp.fd[1]);
+    std::vector<device_call> pending(threads);
+    for (auto& call : pending)
+      if (!dev.receive(call))
+        return;
+    dev.respond(pending[1]);
+    shutdown(sp.fd[1], SHUT_RDWR);
+  });
+
+  std::atomic<int> succeeded{0};
+  std::atomic<int> failed{0};
+  std::vector<std::thread> hosts;
+  for (int t = 0; t < threads; ++t)
+    hosts.emplace_back([&, t] {
+      if (reg_read(channel, t))
+        ++succeeded;
+      else
+        ++failed;
+    });
+
+  for (auto& h : hosts)
+    h.join();
+  device_peer.join();
+
+  BOOST_CHECK_EQUAL(succeeded, 1);
+  BOOST_CHECK_EQUAL(failed, threads - 1);
+
+  // Later calls fail at once
+  BOOST_CHECK(!reg_read(channel, 0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
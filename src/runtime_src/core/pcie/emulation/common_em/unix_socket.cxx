@@ -125,6 +125,21 @@ void unix_socket::start_server(double timeout_insec, bool fatal_error)
 
 
 
+/************************************************************************
+ * sk_wait - Wait for the client file descriptor to become ready for
+ *           the requested events (POLLIN or POLLOUT).
+ *
+ * Only used in non-blocking mode after send/recv would block.  The wait
+ * is bounded so that callers recheck whether the socket is still live,
+ * which is determined by monitor_socket_thread.
+ ************************************************************************/
+void unix_socket::sk_wait(short events)
+{
+  struct pollfd pfd = {fd, events, 0};
+  if (poll(&pfd, 1, 10) < 0 && errno != EINTR) // 10 ms
+    std::cerr << "\n failed to poll socket\n";
+}
+
 /************************************************************************
  * sk_write - A block/non-block send call on the client file descriptor
  *  
@@ -137,35 +152,23 @@ ssize_t unix_socket::sk_write(const void *wbuf, size_t count)
   ssize_t r;
   ssize_t wlen = 0;
   auto buf = reinterpret_cast<const unsigned char *>(wbuf);
-  int flags = MSG_WAITALL; // wait for whole message.
 
-  // make fd as non-blocking if and only if it is asked for.
-  if (mNonBlocking)
-  {
-    struct timeval timeout;
-    timeout.tv_sec = 0;
-    timeout.tv_usec = 10000; // 10 ms
-    fd_set rfds;
-    FD_ZERO(&rfds);
-    FD_SET(fd, &rfds);
-    // Let's wait for a specific time on the file descriptor fd for a state change.
-    if (select(fd + 1, &rfds, NULL, NULL, &timeout) < 0)
-    {
-      std::cerr << "\n failed to set select timedout for sk_write \n";
-    }
-    flags = MSG_DONTWAIT; // for non-blocking calls, DO NOT WAIT for more than timedout period.
-  }
+  // In non-blocking mode, send is attempted right away and the socket
+  // is polled for space only if send would block.
+  int flags = mNonBlocking ? MSG_DONTWAIT : 0;
 
   do
   {
-    // send() system API is a non-blocking call based on flags set.
     if ((r = send(fd, buf + wlen, count - wlen, flags)) < 0)
     {
-      // I did not get data, alright Let me recall.
+      if (errno == EINTR)
+        continue;
+
+      // Socket buffer is full, wait for the peer to drain it.
+      // If socket is not live then monitor_socket_thread will detect and while condition fails.
       if (errno == EAGAIN || errno == EWOULDBLOCK)
       {
-        // Data might not be received by timedout period, so Let's try
-        // If socket is not live then monitor_socket_thread will detect and while condition fails.
+        sk_wait(POLLOUT);
         continue;
       }
       // something fishy! so let's return.
@@ -175,7 +178,7 @@ ssize_t unix_socket::sk_write(const void *wbuf, size_t count)
       return -1;
     }
     wlen += r;
-  } while ((server_started == true) && (wlen < static_cast<unsigned int>(count)));
+  } while ((server_started == true) && (wlen < static_cast<ssize_t>(count)));
   return wlen;
 }
 
@@ -191,42 +194,35 @@ ssize_t unix_socket::sk_read(void *rbuf, size_t count)
   ssize_t r;
   ssize_t rlen = 0;
   auto buf = reinterpret_cast<unsigned char *>(rbuf);
-  int flags = MSG_WAITALL; // wait for whole message.
 
-  // make fd as non-blocking if and only if it is asked for.
-  if (mNonBlocking)
-  {
-    struct timeval timeout;
-    timeout.tv_sec = 0;
-    timeout.tv_usec = 10000; // 10ms
-    fd_set rfds;
-    FD_ZERO(&rfds);
-    FD_SET(fd, &rfds);
-    // Let's wait for a specific time on the file descriptor fd for a state change.
-    if (select(fd + 1, &rfds, NULL, NULL, &timeout) < 0)
-    {
-      std::cerr << "\n failed to set select timedout for read socket\n";
-    }
-    flags = MSG_DONTWAIT; // for non-blocking calls, DO NOT WAIT for more than timedout period.
-  }
+  // In non-blocking mode, recv is attempted right away and the socket
+  // is polled for data only if recv would block.
+  int flags = mNonBlocking ? MSG_DONTWAIT : MSG_WAITALL;
 
   do
   {
-    // recv() system API is a non-blocking call based on flags set.
     if ((r = recv(fd, buf + rlen, count - rlen, flags)) < 0)
     {
-      // Alright! I did not get any data in the timedout period, so Let me retry again!!!
+      if (errno == EINTR)
+        continue;
+
+      // No data yet, wait for the peer to send it.
+      // If socket is not live then monitor_socket_thread will detect and while condition fails.
       if (errno == EAGAIN || errno == EWOULDBLOCK)
       {
-        // Data might not be received by timedout period, so Let's try
-        // If socket is not live then monitor_socket_thread will detect and while condition fails.
-        continue; // OMG! data is not received, timedout? ok, Let's try
+        sk_wait(POLLIN);
+        continue;
       }
 
       return -1; // other failures, then let me stop calling recv.
     }
+
+    // Peer has closed the connection
+    if (r == 0)
+      return rlen ? rlen : -1;
+
     rlen += r;
-  } while ((server_started == true) && (rlen < static_cast<unsigned int>(count)));
+  } while ((server_started == true) && (rlen < static_cast<ssize_t>(count)));
 
   return rlen;
 }
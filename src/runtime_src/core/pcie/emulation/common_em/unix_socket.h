@@ -40,6 +40,7 @@ class unix_socket {
     std::string name;
     std::thread mthread;                        // Let's start socket monitor thread.
     struct pollfd mpoll_on_filedescriptor;      // Let's perform poll on Connected Client Socket only.
+    void sk_wait(short events);                 // Bounded wait for non-blocking send/recv.
 public:
     std::atomic<bool> server_started;           // Is Server Socket/Client Socket started?
     std::atomic<bool> m_is_socket_live;         // Is Server socket Live?
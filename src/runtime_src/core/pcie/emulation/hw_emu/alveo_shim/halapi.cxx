@@ -7,6 +7,7 @@
 
 #include "core/common/device.h"
 #include "core/common/system.h"
+#include "core/common/xclbin_parser.h"
 #include "plugin/xdp/device_offload.h"
 #include "plugin/xdp/hal_trace.h"
 #include "plugin/xdp/pl_deadlock.h"
@@ -439,14 +440,18 @@ int xclLoadXclBin(xclDeviceHandle handle, const xclBin *buffer)
   if (!drv)
     return -1;
   xdp::hw_emu::flush_device(handle);
-  auto ret = drv->xclLoadXclBin(buffer);
+
+  // The emulation device does not support compressed sections
+  std::vector<char> uncompressed;
+  auto top = xrt_core::xclbin::get_uncompressed_axlf(buffer, uncompressed);
+  auto ret = drv->xclLoadXclBin(top);
   if (!ret) {
     auto device = xrt_core::get_userpf_device(drv);
-    device->register_axlf(buffer);
+    device->register_axlf(top);
     // Call update_device only when xclbin is loaded and registered successfully
     xdp::hw_emu::update_device(handle);
     xdp::pl_deadlock::update_device(handle);
-    ret = xrt_core::scheduler::init(handle, buffer);
+    ret = xrt_core::scheduler::init(handle, top);
   }
   return ret;
   }) ;
@@ -16,12 +16,19 @@
 
 #include "mem_model.h"
 
+#include <algorithm>
+#include <sys/mman.h>
+
 mem_model::~ mem_model()
 {
   serialize();
+  for (auto& r : regions)
+    munmap(r.second.base, REGIONSIZE);
 }
 
 mem_model::mem_model(std::string deviceName):
+  lastRegionIdx(0),
+  lastRegion(nullptr),
   mDeviceName(deviceName),
   module_name("dr_wrapper_dr_i_sdaccel_generic_pcie_0.sdaccel_generic_pcie_model.ddrx_top_tlm_model_0.axi_app_tlm_model_0")
 {
@@ -35,26 +42,12 @@ mem_model::mem_model(std::string deviceName):
       uint64_t written_bytes = 0;
       uint64_t addr = offset;
       while(written_bytes < size){
-          uint64_t src_offset = written_bytes;
-
-          unsigned char* page_ptr  = get_page(addr);
-          uint64_t       page_addr = addr & ~( ~uint64_t(0) << ADDRBITS);
-
-          unsigned char* dest_buf_ptr = page_ptr + page_addr;
-          unsigned char* src_buf_ptr  = (unsigned char*)(src)      + src_offset;
-
-          uint64_t remaining_bytes_to_write = size - written_bytes;
-          uint64_t unaligned_bytes_in_addr = (addr & ~(~uint64_t(0) << ADDRBITS));
-          uint64_t bytes_upto_next_alignment = (0x1 << ADDRBITS) - unaligned_bytes_in_addr;
-
-          uint64_t buf_size = 0;
-          if(bytes_upto_next_alignment > remaining_bytes_to_write)
-          {
-              buf_size = remaining_bytes_to_write;
-          }else{
-              buf_size = bytes_upto_next_alignment;
-          }
+          // copy up to end of region in one go
+          uint64_t bytes_upto_region_end = REGIONSIZE - (addr & (REGIONSIZE - 1));
+          uint64_t buf_size = std::min<uint64_t>(size - written_bytes, bytes_upto_region_end);
 
+          unsigned char* dest_buf_ptr = get_range(addr, buf_size);
+          const unsigned char* src_buf_ptr = static_cast<const unsigned char*>(src) + written_bytes;
           memcpy(dest_buf_ptr,src_buf_ptr,buf_size);
 
           written_bytes += buf_size;
@@ -82,26 +75,14 @@ mem_model::mem_model(std::string deviceName):
 	  uint64_t read_bytes = 0;
 	  uint64_t addr = offset;
 	  while(read_bytes < size){
-		  uint64_t dest_offset = read_bytes;
-
-		  unsigned char* page_ptr  = get_page(addr);
-		  uint64_t       page_addr = addr & ~(~uint64_t(0) << ADDRBITS);
-
-		  unsigned char* src_buf_ptr = page_ptr + page_addr;
-		  unsigned char* dest_buf_ptr  = (unsigned char*)(dest)      + dest_offset;
+		  // copy up to end of region in one go
+		  uint64_t bytes_upto_region_end = REGIONSIZE - (addr & (REGIONSIZE - 1));
+		  uint64_t buf_size = std::min<uint64_t>(size - read_bytes, bytes_upto_region_end);
 
-		  uint64_t remaining_bytes_to_read = size - read_bytes;
-		  uint64_t unaligned_bytes_in_addr = (addr & ~(~uint64_t(0) << ADDRBITS));
-		  uint64_t bytes_upto_next_alignment = (0x1 << ADDRBITS) - unaligned_bytes_in_addr;
+		  unsigned char* src_buf_ptr = get_range(addr, buf_size);
+		  unsigned char* dest_buf_ptr = static_cast<unsigned char*>(dest) + read_bytes;
+		  memcpy(dest_buf_ptr,src_buf_ptr,buf_size);
 
-		  uint64_t buf_size = 0;
-		  if(bytes_upto_next_alignment > remaining_bytes_to_read)
-		  {
-			  buf_size = remaining_bytes_to_read;
-		  }else{
-			  buf_size = bytes_upto_next_alignment;
-		  }
-	  memcpy(dest_buf_ptr,src_buf_ptr,buf_size);
 		  read_bytes += buf_size;
 		  addr += buf_size;
 	  }
@@ -118,45 +99,78 @@ mem_model::mem_model(std::string deviceName):
 
 	  return 0;
   }
-  unsigned char* mem_model::get_page(uint64_t offset) {
-	  uint64_t page_idx = offset >> ADDRBITS;
-	  std::string file_name = get_mem_file_name(page_idx);
-	  if(pageCache.size() > N_1MBARRAYS)
+
+  // Region containing offset, the virtual address space of the region
+  // is reserved on first access.  The last region used is cached since
+  // transfers are typically to one buffer.
+  mem_model::region& mem_model::get_region(uint64_t regionIdx) {
+	  if (lastRegion && lastRegionIdx == regionIdx)
+		  return *lastRegion;
+
+	  auto& r = regions[regionIdx];
+	  if (!r.base) {
+		  void* base = mmap(nullptr, REGIONSIZE, PROT_READ | PROT_WRITE,
+				    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		  if (base == MAP_FAILED) {
+			  std::cerr << "Out of Memory. DDR model failed to reserve device memory\n";
+			  exit(1);
+		  }
+		  r.base = static_cast<unsigned char*>(base);
+	  }
+
+	  lastRegionIdx = regionIdx;
+	  lastRegion = &r;
+	  return r;
+  }
+
+  // Host address of device memory range [offset, offset+size), which
+  // must be within one region.  Pages accessed for the first time are
+  // initialized from page files saved by a previous model, if any.
+  unsigned char* mem_model::get_range(uint64_t offset, uint64_t size) {
+	  uint64_t region_idx = offset >> REGIONBITS;
+	  uint64_t region_offset = offset & (REGIONSIZE - 1);
+	  auto& r = get_region(region_idx);
+
+	  uint64_t first = region_offset >> ADDRBITS;
+	  uint64_t last = (region_offset + size - 1) >> ADDRBITS;
+	  for (uint64_t page = first; page <= last; ++page) {
+		  if (r.pages.test(page))
+			  continue;
+		  load_page(region_idx * PAGES_PER_REGION + page, r.base + (page << ADDRBITS));
+		  r.pages.set(page);
+	  }
+
+	  return r.base + region_offset;
+  }
+
+  void mem_model::load_page(uint64_t pageIdx, unsigned char* page) {
+	  std::string file_name = get_mem_file_name(pageIdx);
+	  FILE* pFile = fopen(file_name.c_str(),"r");
+	  if (!pFile)
+		  return;
+
+	  int fhandle = fileno(pFile);
+	  if (deserialize_msg.ParseFromFileDescriptor(fhandle) == false)
 	  {
-		  std::cerr << "Out of Memory. DDR model does not support this much of memory\n";
+		  fclose(pFile);
 		  exit(1);
-	  } else {
-      FILE* pFile = NULL;
-		  if(pageCache.find(page_idx) != pageCache.end())
-		  {
-			  return pageCache[page_idx];
-		  } else if(((pFile = fopen(file_name.c_str(),"r")) != NULL)) {
-			  int fhandle = fileno(pFile);
-
-			  if (deserialize_msg.ParseFromFileDescriptor(fhandle) == false)
-        {
-          fclose(pFile);
-          exit(1);
-        }
-			  pageCache[page_idx] = new unsigned char[PAGESIZE];
-
-			  memcpy(pageCache[page_idx],deserialize_msg.data().c_str(),PAGESIZE);
-			  fclose(pFile);
-			  return pageCache[page_idx];
-		  } else {
-			  pageCache[page_idx] = new unsigned char[PAGESIZE];
-			  return pageCache[page_idx];
-		  }
 	  }
+	  memcpy(page,deserialize_msg.data().c_str(),std::min<size_t>(PAGESIZE,deserialize_msg.data().size()));
+	  fclose(pFile);
   }
 
 
   void mem_model::serialize() {
      FILE *pFile;
      int fhandle;
-     for (pageCacheItr=pageCache.begin(); pageCacheItr != pageCache.end(); ++pageCacheItr)
+     for (auto& r : regions)
      {
-        std::string file_name = get_mem_file_name(pageCacheItr->first);
+       for (uint64_t page = 0; page < PAGES_PER_REGION; ++page)
+       {
+        if (!r.second.pages.test(page))
+          continue;
+
+        std::string file_name = get_mem_file_name(r.first * PAGES_PER_REGION + page);
         pFile = fopen(file_name.c_str(),"w+");
         if(!pFile)
           continue;
@@ -167,13 +181,14 @@ mem_model::mem_model(std::string deviceName):
           exit(1);
         }
 
-        serialize_msg.set_data(reinterpret_cast<const char*>(pageCacheItr->second),PAGESIZE);
+        serialize_msg.set_data(reinterpret_cast<const char*>(r.second.base + (page << ADDRBITS)),PAGESIZE);
         if(serialize_msg.SerializeToFileDescriptor(fhandle) == false)
         {
           fclose(pFile);
           exit(1);
         }
         fclose(pFile);
+       }
      }
   }
 
@@ -22,7 +22,8 @@
 #include <string.h> // memcpy
 #include <sstream> // memcpy
 #include <stdlib.h> //realloc
-#include <map> //realloc
+#include <bitset>
+#include <unordered_map>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -33,7 +34,12 @@
 #define ONE_MB (ONE_KB * ONE_KB)
 #define PAGESIZE (ONE_MB)
 #define ADDRBITS (20)
-#define N_1MBARRAYS 4096
+
+// Device memory is reserved in 1 GB regions of virtual address space,
+// the OS allocates physical memory only for pages that are accessed.
+#define REGIONBITS (30)
+#define REGIONSIZE (uint64_t(1) << REGIONBITS)
+#define PAGES_PER_REGION (REGIONSIZE >> ADDRBITS)
 
 class mem_model{
 public:
@@ -42,10 +48,19 @@ unsigned int readDevMem(uint64_t offset, void* dest, unsigned int size);
 
 protected:
 private:
-  unsigned char* get_page(uint64_t offset);
+  struct region
+  {
+    unsigned char* base = nullptr;            // MAP_NORESERVE mapping of REGIONSIZE
+    std::bitset<PAGES_PER_REGION> pages;      // pages accessed, saved on exit
+  };
+
+  unsigned char* get_range(uint64_t offset, uint64_t size);
+  region& get_region(uint64_t regionIdx);
+  void load_page(uint64_t pageIdx, unsigned char* page);
   std::string get_mem_file_name(uint64_t pageIdx);
-  std::map<uint64_t,unsigned char*> pageCache;
-  std::map<uint64_t,unsigned char*>::iterator pageCacheItr;
+  std::unordered_map<uint64_t,region> regions;
+  uint64_t lastRegionIdx;
+  region* lastRegion;
 
   ddr_mem_msg serialize_msg;
   ddr_mem_msg deserialize_msg;
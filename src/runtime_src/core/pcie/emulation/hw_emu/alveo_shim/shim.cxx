@@ -1097,6 +1097,7 @@ namespace xclhwemhal2 {
 
     try {
        sock = std::make_shared<unix_socket>();
+       mRpcChannel = std::make_unique<xclemulation::rpc_channel>(sock.get());
     }
     catch(const std::exception &e){
        std::cerr << "\n ERROR: [HW-EMU 28] ERROR unable to allocate memory, error is ::" << e.what();
@@ -2048,6 +2049,7 @@ namespace xclhwemhal2 {
     }
     //ProfilerStop();
 
+    mRpcChannel.reset();
     sock.reset();
 
     PRINTENDFUNC;
@@ -2243,6 +2245,7 @@ namespace xclhwemhal2 {
     binaryCounter = 0;
     host_sptag_idx = -1;
     sock = nullptr;
+    mRpcChannel = nullptr;
     mCURangeMap.clear();
 
     deviceName = "device"+std::to_string(deviceIndex);
@@ -29,6 +29,7 @@
 #include "xclbin.h"
 #include "xcl_api_macros.h"
 #include "xcl_macros.h"
+#include "rpc_channel.h"
 #include "unix_socket.h"
 #include "nocddr_fastaccess_hwemu.h"
 
@@ -567,6 +568,7 @@ using addr_type = uint64_t;
       unsigned int binaryCounter;
 
       std::shared_ptr<unix_socket> sock;
+      std::unique_ptr<xclemulation::rpc_channel> mRpcChannel;
       std::string deviceName;
       xclDeviceInfo2 mDeviceInfo;
       unsigned int mDeviceIndex;
@@ -7,6 +7,7 @@
 #include "core/include/xdp/app_debug.h"
 #include "core/common/device.h"
 #include "core/common/system.h"
+#include "core/common/xclbin_parser.h"
 #include "core/include/experimental/xrt_hw_context.h"
 
 namespace {
@@ -145,12 +146,16 @@ int xclLoadXclBin(xclDeviceHandle handle, const xclBin *buffer)
   xclswemuhal2::SwEmuShim *drv = xclswemuhal2::SwEmuShim::handleCheck(handle);
   if (!drv)
     return -1;
-  auto ret = drv->xclLoadXclBin(buffer);
+
+  // The emulation device does not support compressed sections
+  std::vector<char> uncompressed;
+  auto top = xrt_core::xclbin::get_uncompressed_axlf(buffer, uncompressed);
+  auto ret = drv->xclLoadXclBin(top);
   if (!ret) {
     auto device = xrt_core::get_userpf_device(drv);
-    device->register_axlf(buffer);
+    device->register_axlf(top);
     if (xclemulation::is_sw_emulation() && xrt_core::config::get_flag_kds_sw_emu())
-      ret = xrt_core::scheduler::init(handle, buffer);
+      ret = xrt_core::scheduler::init(handle, top);
   }
   return ret;
 }
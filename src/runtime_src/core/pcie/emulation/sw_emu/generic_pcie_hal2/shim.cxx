@@ -526,6 +526,7 @@ namespace xclswemuhal2
       }
     }
     sock = new unix_socket("EMULATION_SOCKETID");
+    mRpcChannel = std::make_unique<xclemulation::rpc_channel>(sock);
   }
 
   void SwEmuShim::getCuRangeIdx()
@@ -926,6 +927,9 @@ namespace xclswemuhal2
       return 0;
     }
 
+    if (!sFileName.empty())
+      mapSharedDeviceMemory(result, size, sFileName);
+
     DEBUG_MSGS("%s, %d(ENDED)\n", __func__, __LINE__);
     PRINTENDFUNC;
     return result;
@@ -936,6 +940,8 @@ namespace xclswemuhal2
     if (mLogStream.is_open())
       mLogStream << __func__ << ", " << std::this_thread::get_id() << ", " << offset << std::endl;
 
+    unmapSharedDeviceMemory(offset);
+
     for (auto i : mDDRMemoryManager)
     {
       if (offset < i->start() + i->size())
@@ -1119,6 +1125,70 @@ namespace xclswemuhal2
     return size;
   }
 
+  // The device process reports the file backing device memory of a
+  // buffer, where file offset equals device address.  The region is
+  // mapped MAP_SHARED into host, so data copied to the mapping is
+  // visible to the device process without any RPC.  Not used when
+  // single mmap is disabled, since then the file offset does not
+  // correspond to device address.
+  void SwEmuShim::mapSharedDeviceMemory(uint64_t base, uint64_t size, const std::string &fileName)
+  {
+    if (!xrt_core::config::get_sw_emu_shared_memory() || std::getenv("VITIS_SW_EMU_DISABLE_SINGLE_MMAP"))
+      return;
+
+    int fd = open(fileName.c_str(), O_RDWR);
+    if (fd == -1)
+      return;
+
+    // Accessing a mapping beyond the end of the file raises SIGBUS, so
+    // the device process must have sized the file for the buffer
+    static const uint64_t pageSize = getpagesize();
+    uint64_t mapOffset = base & ~(pageSize - 1);
+    size_t mapSize = size + (base - mapOffset);
+    struct stat st;
+    if (fstat(fd, &st) == -1 || static_cast<uint64_t>(st.st_size) < mapOffset + mapSize) {
+      close(fd);
+      return;
+    }
+
+    void *map = mmap(0, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, mapOffset);
+    close(fd);
+    if (map == MAP_FAILED)
+      return;
+
+    DEBUG_MSGS("%s, %d(fileName: %s base: %lx size: %lx)\n", __func__, __LINE__, fileName.c_str(), base, size);
+
+    auto region = std::make_shared<SharedRegion>(size, map, mapSize, static_cast<char *>(map) + (base - mapOffset));
+    std::lock_guard lk(mSharedRegionsMtx);
+    mSharedRegions[base] = std::move(region);
+  }
+
+  void SwEmuShim::unmapSharedDeviceMemory(uint64_t base)
+  {
+    std::lock_guard lk(mSharedRegionsMtx);
+    mSharedRegions.erase(base);
+  }
+
+  // Host address of device memory range [addr, addr+size) if the
+  // range is within a shared region, nullptr otherwise.  The returned
+  // pointer keeps the region mapped while a copy is in progress, even
+  // if the buffer is freed or the program reset concurrently.
+  std::shared_ptr<char> SwEmuShim::getSharedDeviceMemory(uint64_t addr, size_t size)
+  {
+    std::lock_guard lk(mSharedRegionsMtx);
+    auto itr = mSharedRegions.upper_bound(addr);
+    if (itr == mSharedRegions.begin())
+      return nullptr;
+
+    --itr;
+    auto base = itr->first;
+    auto& region = itr->second;
+    if (addr + size > base + region->size)
+      return nullptr;
+
+    return {region, region->data + (addr - base)};
+  }
+
   size_t SwEmuShim::xclCopyBufferHost2Device(uint64_t dest, const void *src, size_t size, size_t seek)
   {
     if (mLogStream.is_open())
@@ -1135,6 +1205,13 @@ namespace xclswemuhal2
     src = (unsigned char *)src + seek;
     dest += seek;
 
+    if (auto shared = getSharedDeviceMemory(dest, size))
+    {
+      std::memcpy(shared.get(), src, size);
+      DEBUG_MSGS("%s, %d(ENDED shared memory)\n", __func__, __LINE__);
+      return size;
+    }
+
     void *handle = this;
 
     unsigned int messageSize = get_messagesize();
@@ -1180,6 +1257,14 @@ namespace xclswemuhal2
       launchTempProcess();
 
     src += skip;
+
+    if (auto shared = getSharedDeviceMemory(src, size))
+    {
+      std::memcpy(dest, shared.get(), size);
+      DEBUG_MSGS("%s, %d(ENDED shared memory)\n", __func__, __LINE__);
+      return size;
+    }
+
     void *handle = this;
 
     unsigned int messageSize = get_messagesize();
@@ -1288,6 +1373,11 @@ namespace xclswemuhal2
       mFdToFileNameMap.clear();
     }
 
+    {
+      std::lock_guard lk(mSharedRegionsMtx);
+      mSharedRegions.clear();
+    }
+
     if (mLogStream.is_open())
       mLogStream << __func__ << ", " << std::this_thread::get_id() << std::endl;
 
@@ -1408,6 +1498,7 @@ namespace xclswemuhal2
       while (-1 == waitpid(0, &status, 0));
 
     systemUtil::makeSystemCall(socketName, systemUtil::systemOperation::REMOVE);
+    mRpcChannel.reset();
     delete sock;
     sock = nullptr;
     PRINTENDFUNC;
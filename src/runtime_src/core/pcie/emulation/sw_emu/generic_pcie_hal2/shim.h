@@ -14,6 +14,7 @@
 #include "core/include/xdp/trace.h"
 
 #include "swscheduler.h"
+#include "rpc_channel.h"
 #include "unix_socket.h"
 #include "xclbin.h"
 #include "xcl_api_macros.h"
@@ -37,6 +38,7 @@
 #include <sys/wait.h>
 
 #include <atomic>
+#include <memory>
 #include <thread>
 #include <tuple>
 #include <utility>
@@ -667,6 +669,11 @@ namespace xclswemuhal2
 
     void launchDeviceProcess(bool debuggable, std::string &binDir);
     void launchTempProcess();
+
+    // Device memory shared with device process through backing file
+    void mapSharedDeviceMemory(uint64_t base, uint64_t size, const std::string &fileName);
+    void unmapSharedDeviceMemory(uint64_t base);
+    std::shared_ptr<char> getSharedDeviceMemory(uint64_t addr, size_t size);
     void initMemoryManager(std::list<xclemulation::DDRBank> &DDRBankList);
     std::vector<xclemulation::MemoryManager *> mDDRMemoryManager;
 
@@ -681,6 +688,7 @@ namespace xclswemuhal2
     size_t buf_size;
     unsigned int binaryCounter;
     unix_socket *sock;
+    std::unique_ptr<xclemulation::rpc_channel> mRpcChannel;
     unix_socket *aiesim_sock;
 
     uint64_t mRAMSize;
@@ -690,6 +698,32 @@ namespace xclswemuhal2
 
     std::mutex mProcessLaunchMtx;
     std::mutex mApiMtx;
+
+    // Device buffers mapped into host for zero copy transfers, keyed
+    // by device address.  A region maps [base, base+size) of the
+    // device memory file which is shared with the device process.
+    // The region is unmapped when the last reference is dropped.
+    struct SharedRegion
+    {
+      uint64_t size;
+      void *map;               // page aligned start of mapping
+      size_t mapSize;          // size of mapping
+      char *data;              // host address of device address base
+
+      SharedRegion(uint64_t sz, void *mp, size_t msz, char *dt)
+        : size(sz), map(mp), mapSize(msz), data(dt)
+      {}
+
+      ~SharedRegion()
+      {
+        munmap(map, mapSize);
+      }
+
+      SharedRegion(const SharedRegion&) = delete;
+      SharedRegion& operator=(const SharedRegion&) = delete;
+    };
+    std::map<uint64_t, std::shared_ptr<SharedRegion>> mSharedRegions;
+    std::mutex mSharedRegionsMtx;
     static bool mFirstBinary;
     bool bUnified;
     bool bXPR;
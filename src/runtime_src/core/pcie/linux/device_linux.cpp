@@ -461,7 +461,7 @@ struct instance
   static result_type
   get(const xrt_core::device* device, key_type)
   {
-    static const std::string  dev_root = "/sys/bus/pci/devices/";
+    static const std::string  dev_root = xrt_core::pci::sysfs_root() + "/bus/pci/devices/";
     std::string errmsg;
     auto pdev = get_pcidev(device);
 
@@ -1324,6 +1324,7 @@ initialize_query_table()
   emplace_sysfs_get<query::shared_host_mem>                    ("", "host_mem_size");
   emplace_sysfs_get<query::enabled_host_mem>                   ("address_translator", "host_mem_size");
   emplace_sysfs_get<query::cpu_affinity>                       ("", "local_cpulist");
+  emplace_sysfs_get<query::numa_node>                          ("", "numa_node");
   emplace_sysfs_get<query::mailbox_metrics>                    ("mailbox", "recv_metrics");
   emplace_sysfs_get<query::clock_timestamp>                    ("ert_ctrl", "clock_timestamp");
   emplace_sysfs_getput<query::ert_sleep>                       ("ert_ctrl", "mb_sleep");
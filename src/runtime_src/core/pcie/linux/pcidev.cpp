@@ -5,6 +5,7 @@
 #include "pcidrv.h"
 #include "xclbin.h"
 
+#include "core/common/config_reader.h"
 #include "core/common/utils.h"
 
 #include <boost/filesystem/fstream.hpp>
@@ -12,6 +13,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
 #include <dirent.h>
 #include <fstream>
@@ -155,18 +157,47 @@ wordcopy(void *dst, const void* src, size_t bytes)
 
 namespace xrt_core { namespace pci {
 
+static std::string
+get_root(const char* env, const std::string& config)
+{
+  auto value = std::getenv(env);
+  std::string root = (value && *value) ? value : config;
+  while (root.size() > 1 && root.back() == '/')
+    root.pop_back();
+  return root;
+}
+
+const std::string&
+sysfs_root()
+{
+  static const std::string root = get_root("XRT_SYSFS_ROOT", config::get_sysfs_root());
+  return root;
+}
+
+const std::string&
+devfs_root()
+{
+  static const std::string root = get_root("XRT_DEVFS_ROOT", config::get_devfs_root());
+  return root;
+}
+
 namespace sysfs {
 
-static constexpr const char* dev_root = "/sys/bus/pci/devices/";
+static const std::string&
+dev_root()
+{
+  static const std::string root = sysfs_root() + "/bus/pci/devices/";
+  return root;
+}
 
 static std::string
 get_path(const std::string& name, const std::string& subdev, const std::string& entry)
 {
   std::string subdir;
-  if (get_subdev_dir_name(dev_root + name, subdev, subdir) != 0)
+  if (get_subdev_dir_name(dev_root() + name, subdev, subdir) != 0)
     return "";
 
-  std::string path = dev_root;
+  std::string path = dev_root();
   path += name;
   path += "/";
   path += subdir;
@@ -208,7 +239,7 @@ open(const std::string& name,
   if (path.empty()) {
     std::stringstream ss;
     ss << "Failed to find subdirectory for " << subdev
-       << " under " << dev_root + name << std::endl;
+       << " under " << dev_root() + name << std::endl;
     err = ss.str();
   } else {
     fs = open_path(path, err, write, binary);
@@ -420,15 +451,15 @@ get_subdev_path(const std::string& subdev, uint idx) const
   if (subdev.empty()) {
     std::string instStr = std::to_string(m_instance);
     if (m_is_mgmt) {
-      std::string prefixStr = "/dev/xclmgmt";
+      std::string prefixStr = devfs_root() + "/xclmgmt";
       return prefixStr + instStr;
     }
-    std::string prefixStr = "/dev/dri/" RENDER_NM;
+    std::string prefixStr = devfs_root() + "/dri/" RENDER_NM;
     return prefixStr + instStr;
   }
 
   // Subdev devfs path
-  std::string path("/dev/xfpga/");
+  std::string path(devfs_root() + "/xfpga/");
 
   path += subdev;
   path += m_is_mgmt ? ".m" : ".u";
@@ -470,10 +501,10 @@ dev(const drv& driver, const std::string& sysfs) : m_sysfs_name(sysfs)
   if (m_is_mgmt)
     sysfs_get("", "instance", err, m_instance, static_cast<uint32_t>(INVALID_ID));
   else
-    m_instance = get_render_value(sysfs::dev_root + sysfs + "/drm");
+    m_instance = get_render_value(sysfs::dev_root() + sysfs + "/drm");
 
   sysfs_get<int>("", "userbar", err, m_user_bar, 0);
-  m_user_bar_size = bar_size(sysfs::dev_root + sysfs, m_user_bar);
+  m_user_bar_size = bar_size(sysfs::dev_root() + sysfs, m_user_bar);
   sysfs_get<bool>("", "ready", err, m_is_ready, false);
   m_user_bar_map = reinterpret_cast<char *>(MAP_FAILED);
 }
@@ -191,6 +191,15 @@ private:
   char *m_user_bar_map = reinterpret_cast<char *>(MAP_FAILED);
 };
 
+// Root of sysfs, normally /sys, and of devfs, normally /dev.  Both
+// can be redirected to a synthetic tree, see get_sysfs_root() in
+// config_reader.h and tools/scripts/gen_pcie_sysfs.py
+const std::string&
+sysfs_root();
+
+const std::string&
+devfs_root();
+
 size_t
 get_dev_total(bool user = true);
 
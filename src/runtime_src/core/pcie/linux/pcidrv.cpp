@@ -4,6 +4,11 @@
 #include "pcidrv.h"
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+
 namespace xrt_core { namespace pci {
 
 void
@@ -12,7 +17,7 @@ scan_devices(std::vector<std::shared_ptr<dev>>& ready_list,
              std::vector<std::shared_ptr<dev>>& nonready_list) const
 {
   namespace bfs = boost::filesystem;
-  const std::string drv_root = "/sys/bus/pci/drivers/";
+  const std::string drv_root = sysfs_root() + "/bus/pci/drivers/";
   const std::string drvpath = drv_root + name();
 
   if (!bfs::exists(drvpath))
@@ -22,24 +27,58 @@ scan_devices(std::vector<std::shared_ptr<dev>>& ready_list,
   std::vector<bfs::path> vec{ bfs::directory_iterator(drvpath), bfs::directory_iterator() };
   std::sort(vec.begin(), vec.end());
 
-  for (auto& path : vec) {
+  auto probe = [this] (const std::string& sysfs) -> std::shared_ptr<dev> {
     try {
-      auto pf = create_pcidev(path.filename().string());
+      auto pf = create_pcidev(sysfs);
 
       // In docker, all host sysfs nodes are available. So, we need to check
       // devnode to make sure the device is really assigned to docker.
       if (!bfs::exists(pf->get_subdev_path("", -1)))
-        continue;
+        return nullptr;
 
-      // Insert detected device into proper list.
-      if (pf->m_is_ready)
-        ready_list.push_back(std::move(pf));
-      else
-        nonready_list.push_back(std::move(pf));
+      return pf;
     }
     catch (const std::invalid_argument& ex) {
-      continue;
+      return nullptr;
     }
+  };
+
+  // Other entries in the driver directory, eg. bind or new_id, are
+  // not devices.
+  std::vector<std::string> devices;
+  for (auto& path : vec) {
+    auto sysfs = path.filename().string();
+    if (sysfs.find(':') != std::string::npos)
+      devices.push_back(std::move(sysfs));
+  }
+
+  // Probing a device reads several sysfs nodes, probe the devices
+  // concurrently on at most one thread per core.  Each thread takes
+  // the next device not yet probed.
+  std::vector<std::shared_ptr<dev>> probed(devices.size());
+  std::atomic<size_t> next{0};
+  auto worker = [&] {
+    for (size_t idx = next++; idx < devices.size(); idx = next++)
+      probed[idx] = probe(devices[idx]);
+  };
+
+  auto cores = std::max(std::thread::hardware_concurrency(), 1u);
+  auto threads = std::min<size_t>(devices.size(), cores);
+  std::vector<std::future<void>> workers;
+  for (size_t i = 1; i < threads; ++i)
+    workers.push_back(std::async(std::launch::async, worker));
+  worker();
+  for (auto& w : workers)
+    w.get();
+
+  // Insert detected devices into proper list in sysfs name order.
+  for (auto& pf : probed) {
+    if (!pf)
+      continue;
+    if (pf->m_is_ready)
+      ready_list.push_back(std::move(pf));
+    else
+      nonready_list.push_back(std::move(pf));
   }
 }
 
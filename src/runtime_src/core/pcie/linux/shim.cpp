@@ -1398,7 +1398,7 @@ int shim::p2pEnable(bool enable, bool force)
         mDev->sysfs_put("", "root_dev/remove", err, input);
 
         // initiate rescan "echo 1 > /sys/bus/pci/rescan"
-        const std::string rescan_path = "/sys/bus/pci/rescan";
+        const std::string rescan_path = xrt_core::pci::sysfs_root() + "/bus/pci/rescan";
         std::ofstream rescanFile(rescan_path);
         if(!rescanFile.is_open()) {
             perror(rescan_path.c_str());
@@ -1651,7 +1651,7 @@ int shim::xclPrepareAxlf(const axlf *buffer, struct drm_xocl_axlf *axlf_obj)
     axlf_obj->kds_cfg.cu_dma = xrt_core::config::get_ert_cudma();
     axlf_obj->kds_cfg.cu_isr = xrt_core::config::get_ert_cuisr() && xrt_core::xclbin::get_cuisr(buffer);
     axlf_obj->kds_cfg.cq_int = xrt_core::config::get_ert_cqint();
-    axlf_obj->kds_cfg.dataflow = xrt_core::config::get_feature_toggle("Runtime.dataflow") || xrt_core::xclbin::get_dataflow(buffer);
+    axlf_obj->kds_cfg.dataflow = xrt_core::config::get_dataflow() || xrt_core::xclbin::get_dataflow(buffer);
     axlf_obj->kds_cfg.rw_shared = xrt_core::config::get_rw_shared();
 
     /* TODO: In scheduler.cpp init() function, it use get_ert_slots(void) to get slot size.
@@ -1684,7 +1684,9 @@ xclLoadXclBin(const xclBin *buffer)
   // profiling is enabled).
   xdp::flush_device(this);
 
-  auto top = reinterpret_cast<const axlf*>(buffer);
+  // The driver does not support compressed sections
+  std::vector<char> uncompressed;
+  auto top = xrt_core::xclbin::get_uncompressed_axlf(buffer, uncompressed);
   if (auto ret = xclLoadAxlf(top)) {
     // Something wrong, determine what
     if (ret == -EOPNOTSUPP) {
@@ -1721,7 +1723,7 @@ xclLoadXclBin(const xclBin *buffer)
   }
 
   // Success
-  mCoreDevice->register_axlf(buffer);
+  mCoreDevice->register_axlf(top);
 
   // Update the profiling library with the information on this new xclbin
   // configuration on this device as appropriate (when profiling is enabled).
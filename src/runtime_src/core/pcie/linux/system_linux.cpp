@@ -10,6 +10,7 @@
 
 #include "core/common/module_loader.h"
 #include "core/common/query_requests.h"
+#include "core/common/startup_profile.h"
 
 #include <boost/format.hpp>
 #include <boost/property_tree/ini_parser.hpp>
@@ -18,6 +19,7 @@
 
 #include <chrono>
 #include <fstream>
+#include <future>
 #include <map>
 #include <memory>
 #include <thread>
@@ -31,7 +33,8 @@
   // /proc/device-tree/system-id may be 000000
   // /proc/device-tree/model may be 00000
 #elif defined (__x86_64__)
-  #define MACHINE_NODE_PATH "/sys/devices/virtual/dmi/id/product_name"
+  // Relative to the sysfs root, see xrt_core::pci::sysfs_root()
+  #define MACHINE_SYSFS_NODE_PATH "/devices/virtual/dmi/id/product_name"
 #else
 #error "Unsupported platform"
   #define MACHINE_NODE_PATH ""
@@ -80,7 +83,7 @@ driver_version(const std::string& driver)
   boost::property_tree::ptree _pt;
   std::string ver("unknown");
   std::string hash("unknown");
-  std::string path("/sys/module/");
+  std::string path(xrt_core::pci::sysfs_root() + "/module/");
   path += driver;
   path += "/version";
 
@@ -111,7 +114,11 @@ glibc_info()
 static std::string machine_info()
 {
   std::string model("unknown");
+#ifdef MACHINE_SYSFS_NODE_PATH
+  std::ifstream stream(xrt_core::pci::sysfs_root() + MACHINE_SYSFS_NODE_PATH);
+#else
   std::ifstream stream(MACHINE_NODE_PATH);
+#endif
   if (stream.good()) {
     std::getline(stream, model);
     stream.close();
@@ -182,11 +189,28 @@ system_linux()
     xrt_core::send_exception_message(err.what(), "WARNING");
   }
 
+  // Scan drivers concurrently, devices are listed in driver order.
+  xrt_core::startup::phase phase("scan devices");
+  struct scan_result
+  {
+    std::vector<std::shared_ptr<pci::dev>> ready;
+    std::vector<std::shared_ptr<pci::dev>> nonready;
+  };
+  std::vector<std::pair<std::shared_ptr<pci::drv>, std::future<scan_result>>> scans;
   for (const auto& driver : driver_list::get()) {
-    if (driver->is_user())
-      driver->scan_devices(user_ready_list, user_nonready_list);
-    else
-      driver->scan_devices(mgmt_ready_list, mgmt_nonready_list);
+    scans.emplace_back(driver, std::async(std::launch::async, [driver] {
+      scan_result res;
+      driver->scan_devices(res.ready, res.nonready);
+      return res;
+    }));
+  }
+
+  for (auto& scan : scans) {
+    auto res = scan.second.get();
+    auto& ready = scan.first->is_user() ? user_ready_list : mgmt_ready_list;
+    auto& nonready = scan.first->is_user() ? user_nonready_list : mgmt_nonready_list;
+    ready.insert(ready.end(), res.ready.begin(), res.ready.end());
+    nonready.insert(nonready.end(), res.nonready.begin(), res.nonready.end());
   }
 }
 
@@ -19,6 +19,7 @@
 #include "core/common/system.h"
 #include "core/common/task.h"
 #include "core/common/thread.h"
+#include "core/common/xclbin_parser.h"
 #include "core/common/shim/buffer_handle.h"
 #include "core/common/shim/hwctx_handle.h"
 
@@ -980,10 +981,14 @@ xclLoadXclBin(xclDeviceHandle handle, const struct axlf *buffer)
     xrt_core::message::
       send(xrt_core::message::severity_level::debug, "XRT", "xclLoadXclbin()");
     auto shim = get_shim_object(handle);
-    if (auto ret = shim->load_xclbin(buffer))
+
+    // Loading does not support compressed sections
+    std::vector<char> uncompressed;
+    auto top = xrt_core::xclbin::get_uncompressed_axlf(buffer, uncompressed);
+    if (auto ret = shim->load_xclbin(top))
       return ret;
     auto core_device = xrt_core::get_userpf_device(shim);
-    core_device->register_axlf(buffer);
+    core_device->register_axlf(top);
     return 0;
   }
   catch (const xrt_core::error& ex) {
@@ -8,8 +8,6 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
-#include <sys/select.h>
-#include <sys/time.h>
 #include <syslog.h>
 #include <unistd.h>
 #include <strings.h>
@@ -44,22 +42,6 @@ int splitLine(const std::string &line, std::string& key,
     return 0;
 }
 
-/* Retrieve size for the next msg from socket fd. */
-size_t getSockMsgSize(const pcieFunc& dev, int sockfd)
-{
-    std::unique_ptr<sw_msg> swmsg = std::make_unique<sw_msg>(0);
-
-    if (recv(sockfd, swmsg->data(), swmsg->size(), MSG_PEEK|MSG_WAITALL) !=
-        static_cast<ssize_t>(swmsg->size())) {
-        dev.log(LOG_ERR, "can't receive sw_chan from socket, %m");
-        return 0;
-    }
-
-    dev.log(LOG_INFO, "retrieved msg size from socket: %d bytes",
-        swmsg->payloadSize());
-    return swmsg->payloadSize();
-}
-
 /* Retrieve size for the next msg from mailbox fd. */
 size_t getMailboxMsgSize(const pcieFunc& dev, int mbxfd)
 {
@@ -118,81 +100,6 @@ bool sendMsg(const pcieFunc& dev, int fd, sw_msg *swmsg)
     return (cur == total);
 }
 
-/*
- * Wait for incoming msg from udev event from all FPGA nodes.
- * The fd with incoming msg is returned.
- */
-int waitForMsg(int fd, long interval)
-{
-    fd_set fds;
-    int ret = 0;
-    struct timeval timeout = { interval, 0 };
-
-    FD_ZERO(&fds);
-    if (fd >= 0)
-        FD_SET(fd, &fds);
-
-    if (interval == 0) {
-        ret = select(fd + 1, &fds, NULL, NULL, NULL);
-    } else {
-        ret = select(fd + 1, &fds, NULL, NULL, &timeout);
-    }
-
-    if (ret == -1) {
-        syslog(LOG_ERR, "failed to select: %m");
-        return -EINVAL; // failed
-    }
-    if (ret == 0)
-        return -EAGAIN; // time'd tout
-
-    if (fd > 0 && FD_ISSET(fd, &fds)) {
-        syslog(LOG_INFO, "udev msg arrived on fd %d", fd);
-    }
-    return 0;
-}
-
-/*
- * Wait for incoming msg from either socket or mailbox fd.
- * The fd with incoming msg is returned.
- */
-int waitForMsg(const pcieFunc& dev, int localfd, int remotefd, long interval, int retfd[2])
-{
-    fd_set fds;
-    int ret = 0;
-    struct timeval timeout = { interval, 0 };
-
-    FD_ZERO(&fds);
-    if (localfd >= 0)
-        FD_SET(localfd, &fds);
-    if (remotefd >= 0)
-        FD_SET(remotefd, &fds);
-
-    if (interval == 0) {
-        ret = select(std::max(localfd, remotefd) + 1, &fds, NULL, NULL, NULL);
-    } else {
-        ret = select(std::max(localfd, remotefd) + 1, &fds,
-            NULL, NULL, &timeout);
-    }
-
-    if (ret == -1) {
-        dev.log(LOG_ERR, "failed to select: %m");
-        return -EINVAL; // failed
-    }
-    if (ret == 0)
-        return -EAGAIN; // time'd tout
-
-    //it is possible both FDs have data ready concurrently.
-    if (localfd > 0 && FD_ISSET(localfd, &fds)) {
-        retfd[0] = localfd;
-        dev.log(LOG_INFO, "msg arrived on mailbox fd %d", retfd[0]);
-    }
-    if (remotefd > 0 && FD_ISSET(remotefd, &fds)) {
-        retfd[1] = remotefd;
-        dev.log(LOG_INFO, "msg arrived on remote fd %d", retfd[1]);
-    }
-    return 0;
-}
-
 /*
  * Fetch sw channel msg from local mailbox fd
  */
@@ -212,29 +119,6 @@ std::unique_ptr<sw_msg> getLocalMsg(const pcieFunc& dev, int localfd)
     return swmsg;
 }
 
-/*
- * Fetch sw channel msg from remote socket fd, process it by passing it through
- * to local mailbox fd or by the callback.
- */
-std::unique_ptr<sw_msg> getRemoteMsg(const pcieFunc& dev, int remotefd)
-{
-    size_t msgsz = getSockMsgSize(dev, remotefd);
-    if (msgsz == 0)
-        return nullptr;
-
-    if (msgsz > 1024 * 1024 * 1024)
-        return nullptr;
-
-    std::unique_ptr<sw_msg> swmsg = std::make_unique<sw_msg>(msgsz);
-    if (swmsg == nullptr)
-        return nullptr;
-
-    if (!readMsg(dev, remotefd, swmsg.get()))
-        return nullptr;
-
-    return swmsg;
-}
-
 /*
  *  passing the msg directly or the processed msg by the callback 
  *  to local mailbox or the peer side
@@ -87,13 +87,8 @@ public:
 std::string str_trim(const std::string &str);
 int splitLine(const std::string &line, std::string& key,
     std::string& value, const std::string& delim = "=");
-int waitForMsg(int fd, long interval);
-int waitForMsg(const pcieFunc& dev, int localfd, int remotefd, long interval,
-    int retfd[2]);
 std::unique_ptr<sw_msg> getLocalMsg(const pcieFunc& dev, int localfd);
-std::unique_ptr<sw_msg> getRemoteMsg(const pcieFunc& dev, int remotefd);
 int handleMsg(const pcieFunc& dev, queue_msg &msg);
-size_t getSockMsgSize(const pcieFunc& dev, int sockfd);
 size_t getMailboxMsgSize(const pcieFunc& dev, int mbxfd);
 bool readMsg(const pcieFunc& dev, int fd, sw_msg *swmsg);
 bool sendMsg(const pcieFunc& dev, int fd, sw_msg *swmsg);
@@ -0,0 +1,525 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+/*
+ * In this file, we provide the event loop and msg relay used by all daemons.
+ */
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "event_loop.h"
+
+// Reserved epoll id of the eventfd waking up the loop for posted functions.
+static const uint64_t postId = 0;
+
+eventLoop::eventLoop()
+{
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0)
+        throw std::runtime_error(std::string("epoll_create1: ") + strerror(errno));
+
+    evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (evfd < 0) {
+        close(epfd);
+        throw std::runtime_error(std::string("eventfd: ") + strerror(errno));
+    }
+
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = postId;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, evfd, &ev) < 0) {
+        close(evfd);
+        close(epfd);
+        throw std::runtime_error(std::string("epoll_ctl: ") + strerror(errno));
+    }
+}
+
+eventLoop::~eventLoop()
+{
+    close(evfd);
+    close(epfd);
+}
+
+int eventLoop::add(int fd, uint32_t events, handler h)
+{
+    if (fd < 0 || ids.find(fd) != ids.end())
+        return -EINVAL;
+
+    uint64_t id = nextId++;
+    struct epoll_event ev = {};
+    ev.events = events;
+    ev.data.u64 = id;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+        return -errno;
+
+    ids[fd] = id;
+    handlers[id] = std::make_shared<handler>(std::move(h));
+    return 0;
+}
+
+int eventLoop::modify(int fd, uint32_t events)
+{
+    auto it = ids.find(fd);
+    if (it == ids.end())
+        return -EINVAL;
+
+    struct epoll_event ev = {};
+    ev.events = events;
+    ev.data.u64 = it->second;
+    if (epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &ev) < 0)
+        return -errno;
+    return 0;
+}
+
+void eventLoop::remove(int fd)
+{
+    auto it = ids.find(fd);
+    if (it == ids.end())
+        return;
+
+    (void) epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+    handlers.erase(it->second);
+    ids.erase(it);
+}
+
+void eventLoop::post(std::function<void()> fn)
+{
+    {
+        std::lock_guard<std::mutex> l(postLock);
+        posted.push_back(std::move(fn));
+    }
+
+    uint64_t one = 1;
+    (void) !::write(evfd, &one, sizeof(one));
+}
+
+void eventLoop::runPosted()
+{
+    uint64_t cnt;
+    (void) !::read(evfd, &cnt, sizeof(cnt));
+
+    std::vector<std::function<void()>> fns;
+    {
+        std::lock_guard<std::mutex> l(postLock);
+        fns.swap(posted);
+    }
+    for (auto& fn : fns)
+        fn();
+}
+
+int eventLoop::runOnce(int timeout_ms)
+{
+    const int maxEvents = 64;
+    struct epoll_event evs[maxEvents];
+
+    int n = epoll_wait(epfd, evs, maxEvents, timeout_ms);
+    if (n < 0)
+        return -errno;
+
+    for (int i = 0; i < n; i++) {
+        if (evs[i].data.u64 == postId) {
+            runPosted();
+            continue;
+        }
+
+        // The handler may remove itself, or others, keep it alive
+        // while it runs and skip events of removed fds.
+        auto it = handlers.find(evs[i].data.u64);
+        if (it == handlers.end())
+            continue;
+        std::shared_ptr<handler> h = it->second;
+        (*h)(evs[i].events);
+    }
+    return n;
+}
+
+workerPool::workerPool(size_t num)
+{
+    for (size_t i = 0; i < std::max<size_t>(num, 1); i++) {
+        workers.emplace_back([this] {
+            for ( ;; ) {
+                std::function<void()> fn;
+                if (q.getMsg(3, fn)) //timeout
+                    continue;
+                if (!fn)
+                    break;
+                fn();
+            }
+        });
+    }
+}
+
+workerPool::~workerPool()
+{
+    // One empty function stops one worker, after all queued functions ran.
+    for (size_t i = 0; i < workers.size(); i++) {
+        std::function<void()> stop;
+        q.addMsg(stop);
+    }
+    for (auto& t : workers)
+        t.join();
+}
+
+void workerPool::submit(std::function<void()> fn)
+{
+    q.addMsg(fn);
+}
+
+size_t workerPool::defaultSize(size_t num)
+{
+    // Handlers of one board run one at a time, there is no point in
+    // having more workers than boards, or than cpus to run them on.
+    size_t cpus = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    return std::max<size_t>(std::min(num, cpus), 1);
+}
+
+int sockMsgReader::read(int fd, std::unique_ptr<sw_msg>& msg)
+{
+    for ( ;; ) {
+        char *buf;
+        size_t len;
+        if (cur == nullptr) {
+            buf = reinterpret_cast<char *>(&header) + offset;
+            len = headerSize - offset;
+        } else {
+            buf = cur->data() + offset;
+            len = cur->size() - offset;
+        }
+
+        ssize_t ret = ::read(fd, buf, len);
+        if (ret == 0)
+            return -ECONNRESET;
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return 0;
+            return -errno;
+        }
+        offset += ret;
+
+        if (cur == nullptr) {
+            if (offset < headerSize)
+                continue;
+            if (header.sz == 0 || header.sz > maxPayload)
+                return -EMSGSIZE;
+            // Payload is read in place from now on.
+            cur = std::make_unique<sw_msg>(header.sz);
+            std::memcpy(cur->data(), &header, headerSize);
+        }
+
+        if (offset == cur->size()) {
+            msg = std::move(cur);
+            offset = 0;
+            return 1;
+        }
+    }
+}
+
+int sockMsgWriter::write(int fd, std::unique_ptr<sw_msg> msg)
+{
+    q.push_back(std::move(msg));
+    return flush(fd);
+}
+
+int sockMsgWriter::flush(int fd)
+{
+    while (!q.empty()) {
+        sw_msg *msg = q.front().get();
+        ssize_t ret = ::write(fd, msg->data() + offset, msg->size() - offset);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return 1;
+            return -errno;
+        }
+
+        offset += ret;
+        if (offset == msg->size()) {
+            q.pop_front();
+            offset = 0;
+        }
+    }
+    return 0;
+}
+
+struct msgRelay::state : public std::enable_shared_from_this<msgRelay::state> {
+    state(eventLoop& l, workerPool& p, const config& c) :
+        loop(l), pool(p), cfg(c)
+    {
+    }
+
+    // A msg waiting for its handler or local write.
+    struct job {
+        std::unique_ptr<sw_msg> msg;
+        const handler *h;
+    };
+
+    eventLoop& loop;
+    workerPool& pool;
+    config cfg;
+    sockMsgReader reader;
+    sockMsgWriter writer;
+    bool closed = false;        // no more msgs relayed
+    bool stopped = false;       // closed callback is not to be called
+    bool busy = false;          // a job is running on the pool
+    std::deque<std::shared_ptr<job>> jobs;
+    std::function<void()> released;
+
+    void onLocal(uint32_t events);
+    void onRemote(uint32_t events);
+    void queue(std::unique_ptr<sw_msg> msg, const handler *h);
+    void runNext();
+    void done(int ret, std::unique_ptr<sw_msg> processed);
+    void toRemote(std::unique_ptr<sw_msg> msg);
+    void fail(int err);
+    void stop(std::function<void()> fn);
+    void release();
+};
+
+void msgRelay::state::onLocal(uint32_t events)
+{
+    if (closed)
+        return;
+
+    if (!(events & EPOLLIN)) {
+        fail(-EIO);
+        return;
+    }
+
+    std::unique_ptr<sw_msg> msg = cfg.readLocal(cfg.localFd);
+    if (msg == nullptr) {
+        fail(-EIO);
+        return;
+    }
+
+    if (cfg.localHandler)
+        queue(std::move(msg), &cfg.localHandler);
+    else
+        toRemote(std::move(msg));
+}
+
+void msgRelay::state::onRemote(uint32_t events)
+{
+    if (closed)
+        return;
+
+    if (events & EPOLLOUT) {
+        int ret = writer.flush(cfg.remoteFd);
+        if (ret < 0) {
+            fail(ret);
+            return;
+        }
+        if (ret == 0)
+            (void) loop.modify(cfg.remoteFd, EPOLLIN);
+    }
+
+    if (!(events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+        return;
+
+    for ( ;; ) {
+        std::unique_ptr<sw_msg> msg;
+        int ret = reader.read(cfg.remoteFd, msg);
+        if (ret < 0) {
+            fail(ret);
+            return;
+        }
+        if (ret == 0)
+            return;
+        queue(std::move(msg), cfg.remoteHandler ? &cfg.remoteHandler : nullptr);
+    }
+}
+
+void msgRelay::state::queue(std::unique_ptr<sw_msg> msg, const handler *h)
+{
+    auto j = std::make_shared<job>();
+    j->msg = std::move(msg);
+    j->h = h;
+    jobs.push_back(j);
+    runNext();
+}
+
+void msgRelay::state::runNext()
+{
+    if (closed || busy || jobs.empty())
+        return;
+
+    std::shared_ptr<job> j = jobs.front();
+    jobs.pop_front();
+    busy = true;
+
+    std::shared_ptr<state> self = shared_from_this();
+    pool.submit([self, j]() mutable {
+        int ret = 0;
+        int pass;
+        std::unique_ptr<sw_msg> processed;
+
+        if (j->h) {
+            pass = (*j->h)(j->msg, processed);
+        } else {
+            processed = std::move(j->msg);
+            pass = FOR_LOCAL;
+        }
+
+        if (pass == FOR_LOCAL) {
+            if (processed == nullptr ||
+                !self->cfg.writeLocal(self->cfg.localFd, processed.get()))
+                ret = -EIO;
+            processed.reset();
+        } else if (pass != FOR_REMOTE || processed == nullptr) {
+            ret = -EINVAL;
+        }
+
+        // Hand the result back to the loop, which owns the remote end.
+        // The last reference to a stopped relay is dropped there too.
+        eventLoop& loop = self->loop;
+        auto result = std::make_shared<std::unique_ptr<sw_msg>>(std::move(processed));
+        loop.post([s = std::move(self), ret, result] {
+            s->done(ret, std::move(*result));
+        });
+    });
+}
+
+void msgRelay::state::done(int ret, std::unique_ptr<sw_msg> processed)
+{
+    busy = false;
+    if (stopped) {
+        release();
+        return;
+    }
+    if (closed)
+        return;
+
+    if (ret) {
+        fail(ret);
+        return;
+    }
+    if (processed)
+        toRemote(std::move(processed));
+    runNext();
+}
+
+void msgRelay::state::toRemote(std::unique_ptr<sw_msg> msg)
+{
+    if (cfg.remoteFd < 0) {
+        fail(-EINVAL);
+        return;
+    }
+
+    bool idle = writer.empty();
+    int ret = writer.write(cfg.remoteFd, std::move(msg));
+    if (ret < 0)
+        fail(ret);
+    else if (ret > 0 && idle)
+        (void) loop.modify(cfg.remoteFd, EPOLLIN | EPOLLOUT);
+}
+
+void msgRelay::state::fail(int err)
+{
+    if (closed)
+        return;
+
+    closed = true;
+    jobs.clear();
+    loop.remove(cfg.localFd);
+    if (cfg.remoteFd >= 0)
+        loop.remove(cfg.remoteFd);
+
+    // The callback may destroy the relay, don't call it from one of our
+    // own handlers.
+    std::weak_ptr<state> w = shared_from_this();
+    loop.post([w, err] {
+        std::shared_ptr<state> s = w.lock();
+        if (s && !s->stopped && s->cfg.closed)
+            s->cfg.closed(err);
+    });
+}
+
+void msgRelay::state::stop(std::function<void()> fn)
+{
+    if (stopped)
+        return;
+
+    if (!closed) {
+        closed = true;
+        jobs.clear();
+        loop.remove(cfg.localFd);
+        if (cfg.remoteFd >= 0)
+            loop.remove(cfg.remoteFd);
+    }
+    stopped = true;
+    released = std::move(fn);
+
+    // A running job releases the relay when its result is back on the
+    // loop, otherwise there is nothing to wait for.
+    if (!busy) {
+        std::shared_ptr<state> self = shared_from_this();
+        loop.post([self] { self->release(); });
+    }
+}
+
+// Drop the handlers, and what they refer to, once nothing runs on the pool.
+void msgRelay::state::release()
+{
+    std::function<void()> fn = std::move(released);
+    released = nullptr;
+    cfg = config();
+    if (fn)
+        fn();
+}
+
+msgRelay::msgRelay(eventLoop& loop, workerPool& pool, const config& cfg) :
+    st(std::make_shared<state>(loop, pool, cfg))
+{
+}
+
+msgRelay::~msgRelay()
+{
+    stop();
+}
+
+int msgRelay::start()
+{
+    std::weak_ptr<state> w = st;
+    int ret;
+
+    if (st->cfg.remoteFd >= 0) {
+        int flags = fcntl(st->cfg.remoteFd, F_GETFL);
+        if (flags < 0 || fcntl(st->cfg.remoteFd, F_SETFL, flags | O_NONBLOCK) < 0)
+            return -errno;
+    }
+
+    ret = st->loop.add(st->cfg.localFd, EPOLLIN, [w](uint32_t events) {
+        std::shared_ptr<state> s = w.lock();
+        if (s)
+            s->onLocal(events);
+    });
+    if (ret)
+        return ret;
+
+    if (st->cfg.remoteFd >= 0) {
+        ret = st->loop.add(st->cfg.remoteFd, EPOLLIN, [w](uint32_t events) {
+            std::shared_ptr<state> s = w.lock();
+            if (s)
+                s->onRemote(events);
+        });
+        if (ret) {
+            st->loop.remove(st->cfg.localFd);
+            return ret;
+        }
+    }
+    return 0;
+}
+
+void msgRelay::stop(std::function<void()> released)
+{
+    st->stop(std::move(released));
+}
@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+/*
+ * Event loop and sw channel msg relay shared by the cloud daemons.
+ *
+ * All mailbox and socket fds of all boards are watched by one epoll
+ * based loop. Msgs are read from sockets incrementally straight into
+ * the sw_msg buffer they are handled from, and written out to sockets
+ * without blocking the loop. Msg handlers and writes to the mailbox,
+ * which may take a long time (eg. downloading an xclbin) or block,
+ * are run on a small pool of worker threads.
+ */
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <sys/epoll.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+#include "sw_msg.h"
+#include "core/pcie/driver/linux/include/mailbox_proto.h"
+
+class eventLoop {
+public:
+    using handler = std::function<void(uint32_t events)>;
+
+    eventLoop();
+    ~eventLoop();
+
+    // Watch fd for events (EPOLLIN, EPOLLOUT), level triggered.
+    // Handlers run on the thread calling runOnce(). Returns 0 or -errno.
+    int add(int fd, uint32_t events, handler h);
+    int modify(int fd, uint32_t events);
+    // Stop watching fd, it is safe to remove any fd from a handler.
+    void remove(int fd);
+
+    // Run fn on the loop thread, can be called from any thread.
+    void post(std::function<void()> fn);
+
+    // Wait up to timeout_ms for events and dispatch them. Returns the
+    // number of events dispatched, 0 on timeout or -errno.
+    int runOnce(int timeout_ms);
+
+private:
+    int epfd = -1;
+    int evfd = -1;
+    // Handlers are looked up by a never reused id, so that events of a
+    // removed fd are not delivered to a new handler of the same fd.
+    uint64_t nextId = 1;
+    std::map<int, uint64_t> ids;
+    std::map<uint64_t, std::shared_ptr<handler>> handlers;
+    std::mutex postLock;
+    std::vector<std::function<void()>> posted;
+
+    void runPosted();
+
+    eventLoop(const eventLoop&) = delete;
+    eventLoop& operator=(const eventLoop&) = delete;
+};
+
+// Fixed number of threads running submitted functions in FIFO order.
+class workerPool {
+public:
+    workerPool(size_t num);
+    ~workerPool();
+
+    void submit(std::function<void()> fn);
+
+    // Default pool size for a daemon serving num boards.
+    static size_t defaultSize(size_t num);
+
+private:
+    Msgq<std::function<void()>> q;
+    std::vector<std::thread> workers;
+};
+
+/*
+ * Incremental sw channel msg reader for a non-blocking stream fd.
+ * The msg header is read first, the payload is then read directly
+ * into the sw_msg allocated from the size in the header.
+ */
+class sockMsgReader {
+public:
+    // Largest payload accepted from the peer.
+    static const size_t maxPayload = 1024 * 1024 * 1024;
+
+    // Returns 1 when a msg is complete and moved to msg, 0 when more
+    // data is needed, or -errno on error or end of file.
+    int read(int fd, std::unique_ptr<sw_msg>& msg);
+
+private:
+    static const size_t headerSize = offsetof(xcl_sw_chan, data);
+    xcl_sw_chan header;
+    size_t offset = 0;
+    std::unique_ptr<sw_msg> cur;
+};
+
+// Queue of sw channel msgs written out to a non-blocking stream fd.
+class sockMsgWriter {
+public:
+    // Queue msg and write out as much as possible, see flush().
+    int write(int fd, std::unique_ptr<sw_msg> msg);
+    // Returns 0 when everything is written, 1 when the fd would block
+    // with msgs pending or -errno on error.
+    int flush(int fd);
+    bool empty() const { return q.empty(); }
+
+private:
+    std::deque<std::unique_ptr<sw_msg>> q;
+    size_t offset = 0;
+};
+
+/*
+ * Relay sw channel msgs of one board between its local mailbox and the
+ * remote end (msd, mpd or a plugin provided fd).
+ *
+ * Msgs with a handler are passed to it on the worker pool, and the
+ * processed msg is sent to the local or remote end as told by the
+ * handler (FOR_LOCAL, FOR_REMOTE). Msgs without a handler are passed
+ * through to the other end. Handlers and local writes of a relay run
+ * one at a time in the order the msgs arrived.
+ *
+ * Stopping or destroying a relay never waits for a running handler or
+ * local write, the relay state is released by the loop once it is done.
+ * Until then the handlers may still use localFd and whatever they refer
+ * to, see stop().
+ *
+ * All calls, and the closed and released callbacks, happen on the loop
+ * thread.
+ */
+class msgRelay {
+public:
+    using handler = std::function<int(std::unique_ptr<sw_msg>& orig,
+        std::unique_ptr<sw_msg>& processed)>;
+
+    struct config {
+        int localFd = -1;
+        int remoteFd = -1;          // set non-blocking by the relay, -1 if none
+        handler localHandler;       // empty to pass through to remote
+        handler remoteHandler;      // empty to pass through to local
+        // Read one msg from localFd, nullptr on error.
+        std::function<std::unique_ptr<sw_msg>(int fd)> readLocal;
+        // Write one msg to localFd, may block.
+        std::function<bool(int fd, sw_msg *msg)> writeLocal;
+        // Called once after an error on either end, the relay has
+        // stopped and may be destroyed from the callback.
+        std::function<void(int err)> closed;
+    };
+
+    msgRelay(eventLoop& loop, workerPool& pool, const config& cfg);
+    ~msgRelay();
+
+    int start();
+    // Stop relaying, the fds are no longer watched by the loop and the
+    // closed callback is not called. released is posted to the loop once
+    // no handler or local write of the relay is running any more.
+    void stop(std::function<void()> released = nullptr);
+
+private:
+    struct state;
+    std::shared_ptr<state> st;
+
+    msgRelay(const msgRelay&) = delete;
+    msgRelay& operator=(const msgRelay&) = delete;
+};
+
+#endif // EVENT_LOOP_H
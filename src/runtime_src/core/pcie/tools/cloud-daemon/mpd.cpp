@@ -39,6 +39,7 @@
 #include "pciefunc.h"
 #include "sw_msg.h"
 #include "common.h"
+#include "event_loop.h"
 #include "mpd_plugin.h"
 
 enum Hotplug_state {
@@ -48,13 +49,33 @@ enum Hotplug_state {
 static bool quit = false;
 static const std::string plugin_path("/opt/xilinx/xrt/lib/libmpd_plugin.so");
 static struct mpd_plugin_callbacks plugin_cbs;
-static std::map<std::string, std::atomic<bool>> threads_handling;
 static std::map<std::string, enum Hotplug_state> state_machine;
-static std::map<std::string, std::shared_ptr<Msgq<queue_msg>>> threads_msgq;
 static std::map<std::string, std::string>dev_maj_min;
 udev* mpd_hotplug;
 udev_monitor* mpd_hotplug_monitor;
 
+/*
+ * Per board state. Connecting to msd may block, so it is done on the
+ * worker pool, msgs are relayed by the event loop once connected.
+ */
+struct mpdDevice : public std::enable_shared_from_this<mpdDevice> {
+    mpdDevice(size_t index, const std::string &sysfs_name) :
+        dev(index), index(index), sysfs_name(sysfs_name)
+    {
+    }
+
+    pcieFunc dev;
+    size_t index;
+    std::string sysfs_name;
+    int mbxfd = -1;
+    int msdfd = -1;
+    msgHandler cb = nullptr;
+    bool connecting = true;     // being set up on the worker pool
+    bool removed = false;       // mailbox removed while connecting
+    bool online = false;        // mailbox driver told mgmt is online
+    std::unique_ptr<msgRelay> relay;
+};
+
 class Mpd : public Common
 {
 public:
@@ -70,8 +91,7 @@ public:
     void start();
     void run();
     void stop();
-    static void mpd_getMsg(size_t index);
-    static void mpd_handleMsg(size_t index);
+    static int connectDevice(mpdDevice &d);
     static int localMsgHandler(const pcieFunc& dev,
         std::unique_ptr<sw_msg>& orig,
         std::unique_ptr<sw_msg>& processed);
@@ -80,10 +100,15 @@ public:
         uint16_t port, int id);
     init_fn plugin_init;
     fini_fn plugin_fini;
-    std::map<std::string, std::thread> threads_getMsg;
-    std::map<std::string, std::thread> threads_handleMsg;
+    eventLoop loop;
+    std::unique_ptr<workerPool> pool;
+    std::map<std::string, std::shared_ptr<mpdDevice>> devices;
 
 private:
+    void addDevice(size_t index, const std::string &sysfs_name);
+    void startRelay(const std::shared_ptr<mpdDevice> &d, int ret);
+    void shutdownDevice(mpdDevice &d);
+    void handleUdev();
     void update_profile_subdev_to_container(const std::string &sysfs_name,
         const std::string &subdev_name,
         const std::string &suffix);
@@ -278,11 +303,13 @@ void Mpd::start()
 void Mpd::run()
 {
     /*
-     * Fire up 2 threads for each board - one is to get msg and the other is to
-     * handle msg. The reason is, in some cases, handle msg may take a relative
-     * long time, eg. downloading a large xclbin, and in this case, one thead
-     * implementation makes the next mailbox msg not read out promptly and ends
-     * up a tx timeout
+     * All boards are served by one event loop, which relays msgs between
+     * mailbox and msd (or plugin) and monitors udev events. Msgs handled
+     * by the plugin, and writes to the mailbox, run on a pool of worker
+     * threads. The reason is, in some cases, handle msg may take a relative
+     * long time, eg. downloading a large xclbin, and in this case, handling
+     * it in the loop makes the next mailbox msg not read out promptly and
+     * ends up a tx timeout
      *
      * MPD, running as a daemon, will open mailbox subdevice. As a result, removing
      * the xocl module before mailbox is closed is impossible, this will make
@@ -291,10 +318,10 @@ void Mpd::run()
      * events, which hotplug will produce. For each hotplug, a bunch of events will
      * be produced, here we need to monitor mailbox remove and add events.
      * We maintain a state machine for each fpga. After mpd get started, the state is
-     * initialized as MAILBOX_ADDED, we create pair of threads for each fpga. Whenever
-     * a mailbox remove event is monitored, the state machine changes to MAILBOX_REMOVED,
-     * and the pair of threads will exit and the mailbox will be closed. After a
-     * mailbox add event is monitored, new pair of threads will be created.
+     * initialized as MAILBOX_ADDED, and the board is connected. Whenever a mailbox
+     * remove event is monitored, the state machine changes to MAILBOX_REMOVED,
+     * the board stops relaying msgs and the mailbox will be closed. After a
+     * mailbox add event is monitored, the board will be connected again.
      *
      */
     for (size_t i = 0; i < total; i++) {
@@ -310,7 +337,12 @@ void Mpd::run()
         state_machine[sysfs_name] = MAILBOX_ADDED;
     }
 
+    pool = std::make_unique<workerPool>(workerPool::defaultSize(total));
+
     int udev_fd = udev_monitor_get_fd(mpd_hotplug_monitor);
+    if (loop.add(udev_fd, EPOLLIN, [this](uint32_t) { handleUdev(); }) != 0)
+        syslog(LOG_ERR, "failed to monitor udev events");
+
     do
     {
         if (total == 0)
@@ -320,97 +352,36 @@ void Mpd::run()
 
             if (state_machine[sysfs_name] != MAILBOX_ADDED)
                 continue;
-            if (threads_getMsg.find(sysfs_name) != threads_getMsg.end() &&
-                threads_handleMsg.find(sysfs_name) != threads_handleMsg.end())
+            // A board failed to connect, or lost its connection, is not
+            // retried until its mailbox is removed and added back.
+            if (devices.find(sysfs_name) != devices.end())
                 continue;
 
-            threads_handling[sysfs_name] = true;
-
-            /*
-             * create the thread pair for it.
-             */
-            syslog(LOG_INFO, "create thread pair for %s", sysfs_name.c_str());
-            std::shared_ptr<Msgq<queue_msg>> msgq = std::make_shared<Msgq<queue_msg>>();
-            threads_msgq[sysfs_name] = msgq;
-            threads_getMsg.insert(std::pair<std::string, std::thread>(sysfs_name,
-                std::move(std::thread(Mpd::mpd_getMsg, i))));
-            threads_handleMsg.insert(std::pair<std::string, std::thread>(sysfs_name,
-                std::move(std::thread(Mpd::mpd_handleMsg, i))));
-            syslog(LOG_INFO, "%ld pairs of threads running...", threads_getMsg.size());
+            addDevice(i, sysfs_name);
         }
 
-
-        std::string sysfs_name = "";
-        int ret = waitForMsg(udev_fd, 3);
-        if (ret) { //timeout
-            continue;
-        } else { //udev events
-            udev_device* udev_dev = udev_monitor_receive_device(mpd_hotplug_monitor);
-            if (!udev_dev)
-                continue;
-            const char *subsystem = udev_device_get_subsystem(udev_dev);
-            if (!subsystem || strcmp(subsystem, "xrt_user")) {
-                udev_device_unref(udev_dev);
-                continue;
-            }
-            const char *devpath = udev_device_get_devpath(udev_dev);
-            if (!devpath) {
-                udev_device_unref(udev_dev);
-                continue;
-            }
-            std::string pathStr = devpath;
-            std::string subdev = "";
-            extract_sysfs_name_and_subdev_name(pathStr, sysfs_name, subdev);
-            if (subdev.empty() || sysfs_name.empty()) {
-                udev_device_unref(udev_dev);
-                continue;
-            }
-
-            const char *action = udev_device_get_action(udev_dev);
-            if (action && strcmp(action, "remove") == 0) {
-                if (subdev.find("mailbox.u") != std::string::npos) {
-                    state_machine[sysfs_name] = MAILBOX_REMOVED;
-                    threads_handling[sysfs_name] = false;
-                    if (threads_getMsg.find(sysfs_name) != threads_getMsg.end()) {
-                        threads_getMsg[sysfs_name].join();
-                        threads_getMsg.erase(sysfs_name);
-                    }
-                    if (threads_handleMsg.find(sysfs_name) != threads_handleMsg.end()) {
-                        threads_handleMsg[sysfs_name].join();
-                        threads_handleMsg.erase(sysfs_name);
-                    }
-                    syslog(LOG_INFO, "udev: %s %s. Close mailbox", action, devpath);
-                } else {
-                    syslog(LOG_INFO, "udev: %s %s of %s", action, subdev.c_str(), devpath);
-                    update_profile_subdev_to_container(sysfs_name, subdev, "deny");
-                }
-            } else if (action && strcmp(action, "add") == 0 ) {
-                if (subdev.find("mailbox.u") != std::string::npos &&
-                    state_machine[sysfs_name] == MAILBOX_REMOVED) {
-                    state_machine[sysfs_name] = MAILBOX_ADDED;
-                    syslog(LOG_INFO, "udev: %s %s. Open mailbox", action, devpath);
-                } else if (subdev.find("mailbox.u") == std::string::npos) {
-                    syslog(LOG_INFO, "udev: %s %s of %s", action, subdev.c_str(), devpath);
-                    update_profile_subdev_to_container(sysfs_name, subdev, "allow");
-                }
-            }
-            udev_device_unref(udev_dev);
+        // Waiting for msgs and udev events, interval is 3 seconds.
+        int ret = loop.runOnce(3000);
+        if (ret < 0 && ret != -EINTR) {
+            syslog(LOG_ERR, "failed to wait for events: %d", ret);
+            break;
         }
-
     } while (!quit);
+
+    loop.remove(udev_fd);
 }
 
 void Mpd::stop()
 {
-    // Wait for all threads to finish before quit.
-    for (auto& t : threads_handleMsg) {
-        syslog(LOG_INFO, "%s handleMsg thread exit", t.first.c_str());
-        t.second.join();
-    }
-    for (auto& t : threads_getMsg) {
-        syslog(LOG_INFO, "%s getMsg thread exit", t.first.c_str());
-        t.second.join();
+    // Stop relaying, boards still connecting are shut down when the
+    // worker pool has finished with them.
+    for (auto& d : devices) {
+        if (!d.second->connecting)
+            shutdownDevice(*d.second);
     }
+    pool.reset();
+    loop.runOnce(0);
+    devices.clear();
 
     if (mpd_hotplug_monitor)
         udev_monitor_unref(mpd_hotplug_monitor);
@@ -421,6 +392,62 @@ void Mpd::stop()
         (*plugin_fini)(plugin_cbs.mpc_cookie);
 }
 
+void Mpd::handleUdev()
+{
+    std::string sysfs_name = "";
+    udev_device* udev_dev = udev_monitor_receive_device(mpd_hotplug_monitor);
+    if (!udev_dev)
+        return;
+    const char *subsystem = udev_device_get_subsystem(udev_dev);
+    if (!subsystem || strcmp(subsystem, "xrt_user")) {
+        udev_device_unref(udev_dev);
+        return;
+    }
+    const char *devpath = udev_device_get_devpath(udev_dev);
+    if (!devpath) {
+        udev_device_unref(udev_dev);
+        return;
+    }
+    std::string pathStr = devpath;
+    std::string subdev = "";
+    extract_sysfs_name_and_subdev_name(pathStr, sysfs_name, subdev);
+    if (subdev.empty() || sysfs_name.empty()) {
+        udev_device_unref(udev_dev);
+        return;
+    }
+
+    const char *action = udev_device_get_action(udev_dev);
+    if (action && strcmp(action, "remove") == 0) {
+        if (subdev.find("mailbox.u") != std::string::npos) {
+            state_machine[sysfs_name] = MAILBOX_REMOVED;
+            auto it = devices.find(sysfs_name);
+            if (it != devices.end()) {
+                std::shared_ptr<mpdDevice> d = it->second;
+                devices.erase(it);
+                // The mailbox is closed when the last reference is dropped,
+                // by the worker pool if it is still connecting.
+                d->removed = true;
+                if (!d->connecting)
+                    shutdownDevice(*d);
+            }
+            syslog(LOG_INFO, "udev: %s %s. Close mailbox", action, devpath);
+        } else {
+            syslog(LOG_INFO, "udev: %s %s of %s", action, subdev.c_str(), devpath);
+            update_profile_subdev_to_container(sysfs_name, subdev, "deny");
+        }
+    } else if (action && strcmp(action, "add") == 0 ) {
+        if (subdev.find("mailbox.u") != std::string::npos &&
+            state_machine[sysfs_name] == MAILBOX_REMOVED) {
+            state_machine[sysfs_name] = MAILBOX_ADDED;
+            syslog(LOG_INFO, "udev: %s %s. Open mailbox", action, devpath);
+        } else if (subdev.find("mailbox.u") == std::string::npos) {
+            syslog(LOG_INFO, "udev: %s %s of %s", action, subdev.c_str(), devpath);
+            update_profile_subdev_to_container(sysfs_name, subdev, "allow");
+        }
+    }
+    udev_device_unref(udev_dev);
+}
+
 std::string Mpd::getIP(std::string host)
 {
     struct hostent *hp = gethostbyname(host.c_str());
@@ -663,18 +690,13 @@ int Mpd::localMsgHandler(const pcieFunc& dev, std::unique_ptr<sw_msg>& orig,
     return FOR_LOCAL;
 }
 
-// Client of MPD getting msg. Will quit on any error from either local mailbox or socket fd.
-// No retry is ever conducted.
-void Mpd::mpd_getMsg(size_t index)
+// Connect a board to msd, or to the plugin provided fd, and open its mailbox.
+// Runs on the worker pool. No retry is ever conducted.
+int Mpd::connectDevice(mpdDevice &d)
 {
-    std::string sysfs_name = xrt_core::pci::get_dev(index, true)->m_sysfs_name;
-    std::shared_ptr<Msgq<queue_msg>> msgq = threads_msgq[sysfs_name];
-    int msdfd = -1, mbxfd = -1;
-    int ret = 0;
+    pcieFunc &dev = d.dev;
     std::string ip;
-    msgHandler cb = nullptr;
-
-    pcieFunc dev(index);
+    int ret = 0;
 
     /*
      * If there is user plugin, then we assume the users either don't want to
@@ -683,44 +705,40 @@ void Mpd::mpd_getMsg(size_t index)
      * mailbox msg and process the msg with the hook function the plugin provides.
      */
     if (plugin_cbs.get_remote_msd_fd) {
-        ret = (*plugin_cbs.get_remote_msd_fd)(dev.getIndex(), &msdfd);
+        ret = (*plugin_cbs.get_remote_msd_fd)(dev.getIndex(), &d.msdfd);
         if (ret) {
-            dev.log(LOG_ERR, "failed to get remote fd in plugin, mpd_getMsg thread for %s exit!!", sysfs_name.c_str());
-            threads_handling[sysfs_name] = false;
-            return;
+            dev.log(LOG_ERR, "failed to get remote fd in plugin for %s", d.sysfs_name.c_str());
+            d.msdfd = -1;
+            return ret;
         }
-        cb = Mpd::localMsgHandler;
+        d.cb = Mpd::localMsgHandler;
     } else {
         if (!dev.loadConf()) {
-            dev.log(LOG_ERR, "loadConf() failed, mpd_getMsg thread for %s exit!!", sysfs_name.c_str());
-            threads_handling[sysfs_name] = false;
-            return;
+            dev.log(LOG_ERR, "loadConf() failed for %s", d.sysfs_name.c_str());
+            return -EINVAL;
         }
 
         ip = getIP(dev.getHost());
         if (ip.empty()) {
-            dev.log(LOG_ERR, "Can't find out IP from host: %s, mpd_getMsg thread for %s exit!!",
-                    dev.getHost().c_str(), sysfs_name.c_str());
-            threads_handling[sysfs_name] = false;
-            return;
+            dev.log(LOG_ERR, "Can't find out IP from host: %s for %s",
+                    dev.getHost().c_str(), d.sysfs_name.c_str());
+            return -EINVAL;
         }
 
         dev.log(LOG_INFO, "peer msd ip=%s, port=%d, id=0x%x",
             ip.c_str(), dev.getPort(), dev.getId());
 
-        if ((msdfd = connectMsd(dev, ip, dev.getPort(), dev.getId())) < 0) {
-            dev.log(LOG_ERR, "Unable to connect to msd, mpd_getMsg thread for %s exit!!", sysfs_name.c_str());
-            threads_handling[sysfs_name] = false;
-            return;
+        if ((d.msdfd = connectMsd(dev, ip, dev.getPort(), dev.getId())) < 0) {
+            dev.log(LOG_ERR, "Unable to connect to msd for %s", d.sysfs_name.c_str());
+            d.msdfd = -1;
+            return -ECONNREFUSED;
         }
     }
 
-    mbxfd = dev.getMailbox();
-    if (mbxfd == -1) {
-        dev.log(LOG_ERR, "Unable to get mailbox fd, mpd_getMsg thread for %s exit!!",
-                sysfs_name.c_str());
-        threads_handling[sysfs_name] = false;
-        return;
+    d.mbxfd = dev.getMailbox();
+    if (d.mbxfd == -1) {
+        dev.log(LOG_ERR, "Unable to get mailbox fd for %s", d.sysfs_name.c_str());
+        return -ENODEV;
     }
 
    /*
@@ -735,97 +753,88 @@ void Mpd::mpd_getMsg(size_t index)
     * will get and msg and send back a MB_PEER_READY response.
     */
     if (plugin_cbs.mb_notify) {
-        ret = (*plugin_cbs.mb_notify)(index, mbxfd, true);
+        ret = (*plugin_cbs.mb_notify)(d.index, d.mbxfd, true);
         if (ret)
             dev.log(LOG_ERR, "failed to mark mgmt as online");
     }
+    d.online = true;
+    return 0;
+}
 
-    struct queue_msg msg = {
-        .localFd = mbxfd,
-        .remoteFd = msdfd,
-        .cb = cb,
-        .data = nullptr,
-    };
-
-    int retfd[2];
-    for ( ;; ) {
-        retfd[0] = retfd[1] = -100;
-        ret = waitForMsg(dev, mbxfd, msdfd, 3, retfd);
-
-        if (quit)
-            break;
-        if (!threads_handling[sysfs_name])
-            break;
+void Mpd::addDevice(size_t index, const std::string &sysfs_name)
+{
+    std::shared_ptr<mpdDevice> d = std::make_shared<mpdDevice>(index, sysfs_name);
+    devices[sysfs_name] = d;
+
+    syslog(LOG_INFO, "connect %s", sysfs_name.c_str());
+    pool->submit([this, d] {
+        int ret = connectDevice(*d);
+        loop.post([this, d, ret] { startRelay(d, ret); });
+    });
+}
 
-        if (ret < 0) {
-            if (ret == -EAGAIN)
-                continue;
-            else
-                break;
-        }
+void Mpd::startRelay(const std::shared_ptr<mpdDevice> &d, int ret)
+{
+    d->connecting = false;
+    if (ret || d->removed || quit || !pool) {
+        shutdownDevice(*d);
+        return;
+    }
 
-        bool broken = false;
-        for (int i = 0; i < 2; i++) {
-            if (retfd[i] == mbxfd) {
-                msg.type = LOCAL_MSG;
-                msg.data = std::move(getLocalMsg(dev, mbxfd));
-            } else if (retfd[i] == msdfd) {
-                msg.type = REMOTE_MSG;
-                msg.data = std::move(getRemoteMsg(dev, msdfd));
-            } else
-                continue;
+    mpdDevice *dp = d.get();
+    msgRelay::config cfg;
+    cfg.localFd = d->mbxfd;
+    cfg.remoteFd = d->msdfd;
+    if (d->cb) {
+        cfg.localHandler = [dp](std::unique_ptr<sw_msg>& orig, std::unique_ptr<sw_msg>& processed) {
+            return (*dp->cb)(dp->dev, orig, processed);
+        };
+        cfg.remoteHandler = cfg.localHandler;
+    }
+    cfg.readLocal = [dp](int fd) { return getLocalMsg(dp->dev, fd); };
+    cfg.writeLocal = [dp](int fd, sw_msg *msg) { return sendMsg(dp->dev, fd, msg); };
+    cfg.closed = [this, dp](int err) {
+        dp->dev.log(LOG_ERR, "msg relay for %s stopped: %d", dp->sysfs_name.c_str(), err);
+        shutdownDevice(*dp);
+    };
 
-            if (msg.data == nullptr) {
-                broken = true;
-                break;
-            }
+    d->relay = std::make_unique<msgRelay>(loop, *pool, cfg);
+    ret = d->relay->start();
+    if (ret) {
+        d->dev.log(LOG_ERR, "failed to start msg relay for %s: %d", d->sysfs_name.c_str(), ret);
+        shutdownDevice(*d);
+        return;
+    }
+    syslog(LOG_INFO, "%ld boards connected...", devices.size());
+}
 
-            msgq->addMsg(msg);
-        }
+// Stop relaying msgs of a board, it stays in devices until its mailbox is removed.
+void Mpd::shutdownDevice(mpdDevice &d)
+{
+    if (!d.relay && !d.online && d.msdfd < 0)
+        return;
 
-        if (broken)
-            break;
+    // Don't wait for a running handler or mailbox write on the loop, the
+    // board and its mailbox are kept until the relay is released.
+    if (d.relay) {
+        std::shared_ptr<mpdDevice> keep = d.shared_from_this();
+        d.relay->stop([keep] {});
+        d.relay.reset();
     }
 
-    threads_handling[sysfs_name] = false;
-
     //notify mailbox driver the daemon is offline
-    if (plugin_cbs.mb_notify) {
-        ret = (*plugin_cbs.mb_notify)(index, mbxfd, false);
+    if (d.online && plugin_cbs.mb_notify) {
+        int ret = (*plugin_cbs.mb_notify)(d.index, d.mbxfd, false);
         if (ret)
-            dev.log(LOG_ERR, "failed to mark mgmt as offline");
+            d.dev.log(LOG_ERR, "failed to mark mgmt as offline");
     }
+    d.online = false;
 
-    if (msdfd > 0)
-        close(msdfd);
-
-    dev.log(LOG_INFO, "mpd_getMsg thread for %s exit!!",
-	xrt_core::pci::get_dev(index)->m_sysfs_name.c_str());
-}
-
-// Client of MPD handling msg. Will quit on any error from either local mailbox or socket fd.
-// No retry is ever conducted.
-void Mpd::mpd_handleMsg(size_t index)
-{
-    pcieFunc dev(index);
-    std::string sysfs_name = xrt_core::pci::get_dev(index, true)->m_sysfs_name;
-    std::shared_ptr<Msgq<queue_msg>> msgq = threads_msgq[sysfs_name];
-    for ( ;; ) {
-        struct queue_msg msg;
-        if (quit)
-                break;
-        if (!threads_handling[sysfs_name])
-                break;
-        int ret = msgq->getMsg(3, msg);
-        if (ret) //timeout
-            continue;
-        if (handleMsg(dev, msg) != 0)
-            break;
-    }
-    threads_handling[sysfs_name] = false;
+    if (d.msdfd > 0)
+        close(d.msdfd);
+    d.msdfd = -1;
 
-    dev.log(LOG_INFO, "mpd_handleMsg thread for %s exit!!",
-	xrt_core::pci::get_dev(index)->m_sysfs_name.c_str());
+    d.dev.log(LOG_INFO, "msg relay for %s exit!!", d.sysfs_name.c_str());
 }
 
 /*
@@ -844,6 +853,8 @@ int main(void)
 {
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
+    // Errors writing to a closed socket are handled where they happen.
+    signal(SIGPIPE, SIG_IGN);
     try {
         Mpd mpd("mpd", plugin_path, true);
         mpd.preStart();
@@ -22,6 +22,7 @@
 #include <unistd.h>
 #include <syslog.h>
 #include <sys/socket.h>
+#include <sys/time.h>
 #include <netinet/in.h>
 
 #include <fstream>
@@ -36,6 +37,7 @@
 #include "pciefunc.h"
 #include "sw_msg.h"
 #include "common.h"
+#include "event_loop.h"
 #include "msd_plugin.h"
 #include "xclbin.h"
 #include "core/pcie/driver/linux/include/mgmt-ioctl.h"
@@ -50,6 +52,20 @@ static uint64_t chanSwitch = (1UL<<XCL_MAILBOX_REQ_TEST_READY) |
 static struct msd_plugin_callbacks plugin_cbs;
 static const std::string plugin_path("/opt/xilinx/xrt/lib/libmsd_plugin.so");
 
+// Per board state, serving one mpd connection at a time.
+struct msdDevice {
+    msdDevice(size_t index) : dev(index, false)
+    {
+    }
+
+    pcieFunc dev;
+    int mbxfd = -1;
+    int sockfd = -1;
+    int mpdfd = -1;
+    bool connecting = false;    // mpd being verified on the worker pool
+    std::unique_ptr<msgRelay> relay;
+};
+
 class Msd : public Common
 {
 public:
@@ -68,17 +84,23 @@ public:
     static std::string getHost();
     static void createSocket(const pcieFunc& dev, int& sockfd, uint16_t& port);
     static int verifyMpd(const pcieFunc& dev, int mpdfd, int id);
-    static int connectMpd(const pcieFunc& dev, int sockfd, int id, int& mpdfd);
-    static void msd_thread(size_t index, std::string host);
+    static int connectMpd(const pcieFunc& dev, int sockfd, int& mpdfd);
+    static int setupDevice(msdDevice &d, const std::string &host);
     static int remoteMsgHandler(const pcieFunc& dev, std::unique_ptr<sw_msg>& orig,
         std::unique_ptr<sw_msg>& processed);
     static int download_xclbin(const pcieFunc& dev, char *xclbin, uint32_t slot_id = 0);
 
     init_fn plugin_init;
     fini_fn plugin_fini;
-    std::vector<std::thread> threads;
+    eventLoop loop;
+    std::unique_ptr<workerPool> pool;
+    std::vector<std::unique_ptr<msdDevice>> devices;
 
 private:
+    void acceptMpd(msdDevice &d);
+    void startRelay(msdDevice &d, int mpdfd, int ret);
+    void closeMpd(msdDevice &d);
+    void teardownDevice(msdDevice &d);
 };
 
 
@@ -106,18 +128,38 @@ void Msd::run()
         return;
     }
 
-    // Fire one thread for each board.
+    pool = std::make_unique<workerPool>(workerPool::defaultSize(total));
+
+    // Serve all boards from one event loop.
     if (total == 0)
         syslog(LOG_INFO, "no device found");
-    for (size_t i = 0; i < total; i++)
-        threads.emplace_back(Msd::msd_thread, i, host);
+    for (size_t i = 0; i < total; i++) {
+        std::unique_ptr<msdDevice> d = std::make_unique<msdDevice>(i);
+        msdDevice *dp = d.get();
+        if (setupDevice(*d, host) != 0 ||
+            loop.add(d->sockfd, EPOLLIN, [this, dp](uint32_t) { acceptMpd(*dp); }) != 0) {
+            teardownDevice(*d);
+            continue;
+        }
+        devices.push_back(std::move(d));
+    }
+
+    while (!quit) {
+        int ret = loop.runOnce(2000);
+        if (ret < 0 && ret != -EINTR) {
+            syslog(LOG_ERR, "failed to wait for events: %d", ret);
+            break;
+        }
+    }
 }
 
 void Msd::stop()
 {
-    // Wait for all threads to finish before quit.
-    for (auto& t : threads)
-        t.join();
+    // Wait for running handlers to finish before quit.
+    for (auto& d : devices)
+        teardownDevice(*d);
+    pool.reset();
+    devices.clear();
 
     if (plugin_fini)
         (*plugin_fini)(plugin_cbs.mpc_cookie);
@@ -162,6 +204,7 @@ void Msd::createSocket(const pcieFunc& dev, int& sockfd, uint16_t& port)
     if ((bind(sockfd, (struct sockaddr *)&saddr, sizeof(saddr))) < 0) {
         dev.log(LOG_ERR, "failed to bind socket: %m");
         close(sockfd);
+        sockfd = -1;
         return;
     }
 
@@ -169,6 +212,7 @@ void Msd::createSocket(const pcieFunc& dev, int& sockfd, uint16_t& port)
     if ((listen(sockfd, backlog)) != 0) {
         dev.log(LOG_ERR, "failed to listen: %m");
         close(sockfd);
+        sockfd = -1;
         return;
     }
 
@@ -176,6 +220,7 @@ void Msd::createSocket(const pcieFunc& dev, int& sockfd, uint16_t& port)
     if (getsockname(sockfd, (struct sockaddr *)&saddr, &slen) < 0) {
         dev.log(LOG_ERR, "failed to obtain port: %m");
         close(sockfd);
+        sockfd = -1;
         return;
     }
     port = ntohs(saddr.sin_port); // Retrieve allocated port by kernel
@@ -205,7 +250,7 @@ int Msd::verifyMpd(const pcieFunc& dev, int mpdfd, int id)
     return 0;
 }
 
-int Msd::connectMpd(const pcieFunc& dev, int sockfd, int id, int& mpdfd)
+int Msd::connectMpd(const pcieFunc& dev, int sockfd, int& mpdfd)
 {
     struct sockaddr_in mpdaddr = { 0 };
 
@@ -219,14 +264,9 @@ int Msd::connectMpd(const pcieFunc& dev, int sockfd, int id, int& mpdfd)
         return -errno;
     }
 
-    if (verifyMpd(dev, mpdfd, id) != 0) {
-        dev.log(LOG_ERR, "failed to verify mpd");
-        close(mpdfd);
-        mpdfd = -1;
-        return -EINVAL;
-    }
-
-    dev.log(LOG_INFO, "successfully connected to mpd");
+    // Don't let a silent peer hold up a worker for long.
+    struct timeval timeout = { 2, 0 };
+    (void) setsockopt(mpdfd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
     return 0;
 }
 
@@ -324,93 +364,123 @@ int Msd::remoteMsgHandler(const pcieFunc& dev, std::unique_ptr<sw_msg>& orig,
     return pass;
 }
 
-// Server serving MPD. Any error from socket fd, re-accept, don't quit.
-// Will quit on any error from local mailbox fd.
-void Msd::msd_thread(size_t index, std::string host)
+// Open mailbox and listening socket of a board, and publish the port to mpd.
+int Msd::setupDevice(msdDevice &d, const std::string &host)
 {
+    pcieFunc &dev = d.dev;
     uint16_t port;
-    int sockfd = -1, mpdfd = -1, mbxfd = -1;
-    int retfd[2];
-    int ret;
-    const int interval = 2;
-
-    pcieFunc dev(index, false);
 
-    mbxfd = dev.getMailbox();
-    if (mbxfd == -1)
-        goto done;
+    d.mbxfd = dev.getMailbox();
+    if (d.mbxfd == -1)
+        return -ENODEV;
 
     // Create socket and obtain port.
     port = dev.getPort();
-    createSocket(dev, sockfd, port);
-    if (sockfd < 0 || port == 0)
-        goto done;
+    createSocket(dev, d.sockfd, port);
+    if (d.sockfd < 0 || port == 0)
+        return -EINVAL;
 
     // Update config, if the existing one is not the same.
     (void) dev.loadConf();
     if (host != dev.getHost() || port != dev.getPort() ||
         chanSwitch != dev.getSwitch()) {
         if (dev.updateConf(host, port, chanSwitch) != 0)
-            goto done;
+            return -EINVAL;
     }
+    return 0;
+}
 
-    while (!quit) {
-        // Connect to mpd.
-        if (mpdfd == -1) {
-            ret = connectMpd(dev, sockfd, dev.getId(), mpdfd);
-            if (ret) {
-                mpdfd = -1;
-                sleep(interval);
-                continue; // MPD is not ready yet, retry.
-            }
-        }
+// Server serving MPD. Any error from either socket or local mailbox fd,
+// re-accept, don't quit.
+void Msd::acceptMpd(msdDevice &d)
+{
+    pcieFunc &dev = d.dev;
 
-        retfd[0] = retfd[1] = -100;
-        // Waiting for msg to show up, interval is 3 seconds.
-        ret = waitForMsg(dev, mbxfd, mpdfd, interval, retfd);
-        if (ret < 0) {
-            if (ret == -EAGAIN) // MPD has been quiet, retry.
-                continue;
+    if (d.mpdfd != -1 || d.connecting)
+        return;
+    int mpdfd = -1;
+    if (connectMpd(dev, d.sockfd, mpdfd) != 0)
+        return; // MPD is not ready yet, retry.
+
+    // One mpd at a time, stop accepting until it is gone.
+    (void) loop.modify(d.sockfd, 0);
+
+    // Read the identification of mpd on the worker pool, the loop
+    // keeps serving the other boards meanwhile.
+    d.connecting = true;
+    msdDevice *dp = &d;
+    int id = dev.getId();
+    pool->submit([this, dp, mpdfd, id] {
+        int ret = verifyMpd(dp->dev, mpdfd, id);
+        loop.post([this, dp, mpdfd, ret] { startRelay(*dp, mpdfd, ret); });
+    });
+}
 
-            close(mpdfd);
-            mpdfd = -1;
-            continue;
-        }
+void Msd::startRelay(msdDevice &d, int mpdfd, int ret)
+{
+    pcieFunc &dev = d.dev;
 
-        // Process msg.
-        for (int i = 0; i < 2; i++) {
-            struct queue_msg msg = {0};
-            if (retfd[i] == mbxfd) {
-                msg.localFd = mbxfd;
-                msg.remoteFd = -1;
-                msg.type = LOCAL_MSG;
-                msg.data = std::move(getLocalMsg(dev, mbxfd));
-            } else if (retfd[i] == mpdfd) {
-                msg.localFd = -1;
-                msg.remoteFd = mpdfd;
-                msg.type = REMOTE_MSG;
-                msg.data = std::move(getRemoteMsg(dev, mpdfd));
-                msg.cb = Msd::remoteMsgHandler;
-            } else {
-                continue;
-            }
-
-            ret = handleMsg(dev, msg);
-            if (ret) { // Socket connection was lost, retry
-                if (mpdfd >= 0)
-                    close(mpdfd);
-                mpdfd = -1;
-                continue;
-            }
-        }
+    d.connecting = false;
+    if (ret || quit || d.sockfd < 0) {
+        if (ret)
+            dev.log(LOG_ERR, "failed to verify mpd");
+        close(mpdfd);
+        if (d.sockfd >= 0)
+            (void) loop.modify(d.sockfd, EPOLLIN);
+        return;
+    }
+
+    dev.log(LOG_INFO, "successfully connected to mpd");
+    d.mpdfd = mpdfd;
+
+    msdDevice *dp = &d;
+    msgRelay::config cfg;
+    cfg.localFd = d.mbxfd;
+    cfg.remoteFd = d.mpdfd;
+    cfg.remoteHandler = [dp](std::unique_ptr<sw_msg>& orig, std::unique_ptr<sw_msg>& processed) {
+        return Msd::remoteMsgHandler(dp->dev, orig, processed);
+    };
+    cfg.readLocal = [dp](int fd) { return getLocalMsg(dp->dev, fd); };
+    cfg.writeLocal = [dp](int fd, sw_msg *msg) { return sendMsg(dp->dev, fd, msg); };
+    cfg.closed = [this, dp](int err) {
+        dp->dev.log(LOG_INFO, "connection to mpd closed: %d", err);
+        closeMpd(*dp);
+    };
+
+    d.relay = std::make_unique<msgRelay>(loop, *pool, cfg);
+    ret = d.relay->start();
+    if (ret) {
+        dev.log(LOG_ERR, "failed to start msg relay: %d", ret);
+        closeMpd(d);
     }
+}
 
-done:
-    dev.updateConf("", 0, 0); // Restore default config.
-    if (mpdfd >= 0)
-    	close(mpdfd);
-    if (sockfd >= 0)
-    	close(sockfd);
+void Msd::closeMpd(msdDevice &d)
+{
+    // Accept the next mpd once a running handler of this one is done,
+    // without waiting for it on the loop.
+    msdDevice *dp = &d;
+    d.relay->stop([this, dp] {
+        if (dp->sockfd >= 0)
+            (void) loop.modify(dp->sockfd, EPOLLIN);
+    });
+    d.relay.reset();
+    if (d.mpdfd >= 0)
+        close(d.mpdfd);
+    d.mpdfd = -1;
+}
+
+void Msd::teardownDevice(msdDevice &d)
+{
+    d.relay.reset();
+    loop.remove(d.sockfd);
+    d.dev.updateConf("", 0, 0); // Restore default config.
+    if (d.mpdfd >= 0)
+        close(d.mpdfd);
+    d.mpdfd = -1;
+    if (d.sockfd >= 0)
+        close(d.sockfd);
+    d.sockfd = -1;
 }
 
 /*
@@ -430,6 +500,8 @@ int main(void)
 {
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
+    // Errors writing to a closed socket are handled where they happen.
+    signal(SIGPIPE, SIG_IGN);
 
     try {
         Msd msd("msd", plugin_path, false);
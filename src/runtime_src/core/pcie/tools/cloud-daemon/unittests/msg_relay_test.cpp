@@ -0,0 +1,373 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Test of the cloud daemon event loop and msg relay without a board.
+//
+// % msg_relay_test --run_test=test_msg_relay
+//
+// Socketpairs stand in for the mailbox and for the remote end (msd or
+// mpd). The tests play both peers from helper threads while the relay
+// runs on the main thread.
+#include <boost/test/unit_test.hpp>
+
+#include "event_loop.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const size_t header_size = offsetof(xcl_sw_chan, data);
+
+struct socket_pair
+{
+  int fd[2];
+
+  socket_pair()
+  {
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fd))
+      throw std::runtime_error("socketpair failed");
+  }
+
+  ~socket_pair()
+  {
+    close_end(0);
+    close_end(1);
+  }
+
+  void
+  close_end(int i)
+  {
+    if (fd[i] >= 0)
+      close(fd[i]);
+    fd[i] = -1;
+  }
+};
+
+static std::unique_ptr<sw_msg>
+make_msg(uint64_t id, size_t len)
+{
+  std::vector<char> payload(len);
+  for (size_t i = 0; i < len; ++i)
+    payload[i] = static_cast<char>(id + i);
+  return std::make_unique<sw_msg>(payload.data(), len, id, 0);
+}
+
+static bool
+check_msg(sw_msg* msg, uint64_t id, size_t len)
+{
+  if (msg == nullptr || msg->id() != id || msg->payloadSize() != len || !msg->valid())
+    return false;
+  for (size_t i = 0; i < len; ++i)
+    if (msg->payloadData()[i] != static_cast<char>(id + i))
+      return false;
+  return true;
+}
+
+// Blocking whole msg read and write, like the mailbox driver does
+static std::unique_ptr<sw_msg>
+read_msg(int fd)
+{
+  xcl_sw_chan header;
+  if (recv(fd, &header, header_size, MSG_PEEK | MSG_WAITALL) != static_cast<ssize_t>(header_size))
+    return nullptr;
+  auto msg = std::make_unique<sw_msg>(header.sz);
+  if (recv(fd, msg->data(), msg->size(), MSG_WAITALL) != static_cast<ssize_t>(msg->size()))
+    return nullptr;
+  return msg;
+}
+
+static bool
+write_msg(int fd, sw_msg* msg)
+{
+  size_t done = 0;
+  while (done < msg->size()) {
+    ssize_t ret = send(fd, msg->data() + done, msg->size() - done, MSG_NOSIGNAL);
+    if (ret <= 0)
+      return false;
+    done += ret;
+  }
+  return true;
+}
+
+// Run loop until cond or timeout
+template <typename Cond>
+static bool
+run_until(eventLoop& loop, Cond cond, int timeout_ms = 10000)
+{
+  auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (!cond()) {
+    if (std::chrono::steady_clock::now() > end)
+      return false;
+    loop.runOnce(10);
+  }
+  return true;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE ( test_msg_relay )
+
+BOOST_AUTO_TEST_CASE( test_event_loop )
+{
+  eventLoop loop;
+
+  // Posted functions run on the loop thread
+  std::atomic<int> posted{0};
+  std::thread t([&] {
+    for (int i = 0; i < 100; ++i)
+      loop.post([&] { posted++; });
+  });
+  t.join();
+  BOOST_CHECK(run_until(loop, [&] { return posted == 100; }));
+
+  // A handler may remove another fd with a pending event
+  socket_pair a, b;
+  int calls = 0;
+  BOOST_REQUIRE_EQUAL(loop.add(a.fd[0], EPOLLIN, [&](uint32_t) { calls++; loop.remove(a.fd[0]); loop.remove(b.fd[0]); }), 0);
+  BOOST_REQUIRE_EQUAL(loop.add(b.fd[0], EPOLLIN, [&](uint32_t) { calls++; loop.remove(a.fd[0]); loop.remove(b.fd[0]); }), 0);
+  BOOST_CHECK_EQUAL(loop.add(a.fd[0], EPOLLIN, [](uint32_t) {}), -EINVAL);
+  char c = 0;
+  BOOST_REQUIRE(write(a.fd[1], &c, 1) == 1 && write(b.fd[1], &c, 1) == 1);
+  loop.runOnce(1000);
+  loop.runOnce(10);
+  BOOST_CHECK_EQUAL(calls, 1);
+}
+
+BOOST_AUTO_TEST_CASE( test_reader )
+{
+  // Msg trickling in a byte at a time is assembled in place
+  socket_pair p;
+  int flags = fcntl(p.fd[0], F_GETFL);
+  fcntl(p.fd[0], F_SETFL, flags | O_NONBLOCK);
+
+  auto msg = make_msg(7, 1000);
+  sockMsgReader reader;
+  std::unique_ptr<sw_msg> out;
+  for (size_t i = 0; i < msg->size(); ++i) {
+    BOOST_REQUIRE_EQUAL(reader.read(p.fd[0], out), 0);
+    BOOST_REQUIRE_EQUAL(write(p.fd[1], msg->data() + i, 1), 1);
+  }
+  BOOST_CHECK_EQUAL(reader.read(p.fd[0], out), 1);
+  BOOST_CHECK(check_msg(out.get(), 7, 1000));
+
+  // Oversized msgs are refused before allocating them
+  xcl_sw_chan header = {};
+  header.sz = sockMsgReader::maxPayload + 1;
+  BOOST_REQUIRE_EQUAL(write(p.fd[1], &header, header_size), static_cast<ssize_t>(header_size));
+  BOOST_CHECK_EQUAL(reader.read(p.fd[0], out), -EMSGSIZE);
+
+  p.close_end(1);
+  sockMsgReader eof;
+  BOOST_CHECK_LT(eof.read(p.fd[0], out), 0);
+}
+
+// Relay msgs both ways, with a large remote msg pending while local
+// msgs keep flowing, and a slow remote handler not holding up the loop.
+BOOST_AUTO_TEST_CASE( test_relay )
+{
+  eventLoop loop;
+  workerPool pool(2);
+  socket_pair mbx, remote;
+
+  const int count = 200;
+  const size_t big = 16 * 1024 * 1024;
+  int closed_err = 0;
+  bool closed = false;
+
+  msgRelay::config cfg;
+  cfg.localFd = mbx.fd[0];
+  cfg.remoteFd = remote.fd[0];
+  cfg.readLocal = read_msg;
+  cfg.writeLocal = write_msg;
+  cfg.remoteHandler = [](std::unique_ptr<sw_msg>& orig, std::unique_ptr<sw_msg>& processed) {
+    // Ids above 1000 are answered back to the remote end, slowly
+    if (orig->id() > 1000) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      int ret = 0;
+      processed = std::make_unique<sw_msg>(&ret, sizeof(ret), orig->id(), 0);
+      return FOR_REMOTE;
+    }
+    processed = std::move(orig);
+    return FOR_LOCAL;
+  };
+  cfg.closed = [&](int err) { closed = true; closed_err = err; };
+
+  msgRelay relay(loop, pool, cfg);
+  BOOST_REQUIRE_EQUAL(relay.start(), 0);
+
+  // Mailbox side: send count msgs, expect the big msg and count msgs
+  std::atomic<bool> mbx_ok{false};
+  std::thread mbx_peer([&] {
+    for (int i = 0; i < count; ++i) {
+      auto msg = make_msg(i, 100 + i);
+      if (!write_msg(mbx.fd[1], msg.get()))
+        return;
+    }
+    auto m = read_msg(mbx.fd[1]);
+    if (!check_msg(m.get(), 500, big))
+      return;
+    for (int i = 0; i < count; ++i) {
+      m = read_msg(mbx.fd[1]);
+      if (!check_msg(m.get(), 1000 - count + i, 10))
+        return;
+    }
+    mbx_ok = true;
+  });
+
+  // Remote side: send big msg, request, then count msgs, and expect
+  // the mailbox msgs with the response to the request in between
+  std::atomic<bool> remote_ok{false};
+  std::atomic<bool> answered{false};
+  std::thread remote_peer([&] {
+    auto m = make_msg(500, big);
+    if (!write_msg(remote.fd[1], m.get()))
+      return;
+    int ret = 0;
+    sw_msg req(&ret, sizeof(ret), 2000, 0);
+    if (!write_msg(remote.fd[1], &req))
+      return;
+    for (int i = 0; i < count; ++i) {
+      m = make_msg(1000 - count + i, 10);
+      if (!write_msg(remote.fd[1], m.get()))
+        return;
+    }
+    int got = 0;
+    bool response = false;
+    while (got < count || !response) {
+      m = read_msg(remote.fd[1]);
+      if (m == nullptr)
+        return;
+      if (m->id() == 2000) {
+        response = true;
+        continue;
+      }
+      if (!check_msg(m.get(), got, 100 + got))
+        return;
+      got++;
+    }
+    answered = response;
+    remote_ok = true;
+  });
+
+  bool done = run_until(loop, [&] { return (mbx_ok && remote_ok) || closed; });
+  mbx_peer.join();
+  remote_peer.join();
+  BOOST_CHECK(done);
+  BOOST_CHECK(mbx_ok);
+  BOOST_CHECK(remote_ok);
+  BOOST_CHECK(answered);
+  BOOST_CHECK(!closed);
+
+  // Remote end going away closes the relay
+  remote.close_end(1);
+  BOOST_CHECK(run_until(loop, [&] { return closed; }));
+  BOOST_CHECK_LT(closed_err, 0);
+}
+
+// Stopping a relay with a handler running returns at once, the relay is
+// released by the loop when the handler is done.
+BOOST_AUTO_TEST_CASE( test_stop_running )
+{
+  eventLoop loop;
+  workerPool pool(1);
+  socket_pair mbx, remote;
+
+  std::atomic<bool> running{false};
+  std::atomic<bool> proceed{false};
+  auto owner = std::make_shared<int>(0);
+  bool closed = false;
+  bool released = false;
+
+  msgRelay::config cfg;
+  cfg.localFd = mbx.fd[0];
+  cfg.remoteFd = remote.fd[0];
+  cfg.readLocal = read_msg;
+  cfg.writeLocal = write_msg;
+  cfg.remoteHandler = [&running, &proceed, owner](std::unique_ptr<sw_msg>& orig,
+                                                  std::unique_ptr<sw_msg>& processed) {
+    running = true;
+    while (!proceed)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    processed = std::move(orig);
+    return FOR_REMOTE;
+  };
+  cfg.closed = [&](int) { closed = true; };
+
+  auto relay = std::make_unique<msgRelay>(loop, pool, cfg);
+  cfg = msgRelay::config();
+  BOOST_REQUIRE_EQUAL(relay->start(), 0);
+
+  auto msg = make_msg(1, 10);
+  BOOST_REQUIRE(write_msg(remote.fd[1], msg.get()));
+  BOOST_REQUIRE(run_until(loop, [&] { return running.load(); }));
+
+  // Let the handler go if stop() waits for it, so a regression fails
+  // rather than hangs
+  std::thread guard([&] {
+    for (int i = 0; i < 500 && !proceed; ++i)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    proceed = true;
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  relay->stop([&] { released = true; });
+  relay.reset();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  BOOST_CHECK(elapsed < std::chrono::seconds(1));
+  BOOST_CHECK(!proceed);
+
+  // The handler, and what it refers to, stays until it is done
+  BOOST_CHECK(!run_until(loop, [&] { return released; }, 100));
+  BOOST_CHECK_GT(owner.use_count(), 1);
+
+  proceed = true;
+  BOOST_CHECK(run_until(loop, [&] { return released; }));
+  BOOST_CHECK_EQUAL(owner.use_count(), 1);
+  BOOST_CHECK(!closed);
+  guard.join();
+
+  // Nothing is relayed after stop
+  int flags = fcntl(remote.fd[1], F_GETFL);
+  fcntl(remote.fd[1], F_SETFL, flags | O_NONBLOCK);
+  char c;
+  BOOST_CHECK_LT(read(remote.fd[1], &c, 1), 0);
+}
+
+// An idle relay is released by the next loop iteration
+BOOST_AUTO_TEST_CASE( test_stop_idle )
+{
+  eventLoop loop;
+  workerPool pool(1);
+  socket_pair mbx, remote;
+
+  auto owner = std::make_shared<int>(0);
+  bool released = false;
+
+  msgRelay::config cfg;
+  cfg.localFd = mbx.fd[0];
+  cfg.remoteFd = remote.fd[0];
+  cfg.readLocal = read_msg;
+  cfg.writeLocal = [owner](int fd, sw_msg* msg) { return write_msg(fd, msg); };
+
+  msgRelay relay(loop, pool, cfg);
+  cfg = msgRelay::config();
+  BOOST_REQUIRE_EQUAL(relay.start(), 0);
+
+  relay.stop([&] { released = true; });
+  relay.stop([&] { released = false; });
+  BOOST_CHECK(!released);
+  BOOST_CHECK(run_until(loop, [&] { return released; }));
+  BOOST_CHECK_EQUAL(owner.use_count(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -754,7 +754,7 @@ public:
     axlf_obj->kds_cfg.cu_dma = xrt_core::config::get_ert_cudma();
     axlf_obj->kds_cfg.cu_isr = xrt_core::config::get_ert_cuisr() && xrt_core::xclbin::get_cuisr(top);
     axlf_obj->kds_cfg.cq_int = xrt_core::config::get_ert_cqint();
-    axlf_obj->kds_cfg.dataflow = xrt_core::config::get_feature_toggle("Runtime.dataflow") || xrt_core::xclbin::get_dataflow(top);
+    axlf_obj->kds_cfg.dataflow = xrt_core::config::get_dataflow() || xrt_core::xclbin::get_dataflow(top);
     axlf_obj->kds_cfg.rw_shared = xrt_core::config::get_rw_shared();
 
     /* TODO: In scheduler.cpp init() function, it use get_ert_slots(void) to get slot size.
@@ -1996,10 +1996,14 @@ xclLoadXclBin(xclDeviceHandle handle, const struct axlf *buffer)
     xrt_core::message::
       send(xrt_core::message::severity_level::debug, "XRT", "xclLoadXclbin()");
     auto shim = get_shim_object(handle);
-    if (auto ret =shim->load_xclbin(buffer))
+
+    // Drivers do not support compressed sections
+    std::vector<char> uncompressed;
+    auto top = xrt_core::xclbin::get_uncompressed_axlf(buffer, uncompressed);
+    if (auto ret =shim->load_xclbin(top))
       return ret;
     auto core_device = xrt_core::get_userpf_device(shim);
-    core_device->register_axlf(buffer);
+    core_device->register_axlf(top);
     return 0;
   }
   catch (const xrt_core::error& ex) {
@@ -0,0 +1,415 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#include "bo_bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+using namespace xrt_core::bo_bench;
+
+// Host memory allocated by the benchmark, page aligned and optionally
+// bound to a NUMA node.  Pages are touched after binding so they are
+// resident on the requested node before any transfer is timed.
+class host_buffer
+{
+  void* m_addr = nullptr;
+  size_t m_size = 0;
+
+public:
+  host_buffer(size_t size, int numa_node)
+  {
+    auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    m_size = (size + page - 1) / page * page;
+    m_addr = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (m_addr == MAP_FAILED)
+      throw std::system_error(errno, std::generic_category(), "mmap");
+
+    if (numa_node >= 0) {
+      // mbind(2) through syscall to avoid a dependency on libnuma
+      constexpr int mpol_bind = 2;
+      constexpr auto bits = sizeof(unsigned long) * 8;
+      std::vector<unsigned long> mask(numa_node / bits + 1, 0);
+      mask[numa_node / bits] = 1UL << (numa_node % bits);
+      if (::syscall(SYS_mbind, m_addr, m_size, mpol_bind, mask.data(), mask.size() * bits + 1, 0)) {
+        auto err = errno;
+        ::munmap(m_addr, m_size);
+        throw std::system_error(err, std::generic_category(), "mbind to node " + std::to_string(numa_node));
+      }
+    }
+
+    std::memset(m_addr, 'x', m_size);
+  }
+
+  ~host_buffer()
+  {
+    ::munmap(m_addr, m_size);
+  }
+
+  host_buffer(const host_buffer&) = delete;
+  host_buffer& operator=(const host_buffer&) = delete;
+
+  void*
+  get() const
+  {
+    return m_addr;
+  }
+};
+
+// Buffers used by one benchmark thread
+struct thread_buffers
+{
+  std::unique_ptr<host_buffer> host;     // write source, read destination
+  std::unique_ptr<host_buffer> bo_host;  // backing store of bo if userptr
+  std::unique_ptr<host_buffer> src_host; // backing store of src if userptr
+  xrt::bo bo;
+  xrt::bo src;                           // copy source
+  void* bo_map = nullptr;
+
+  thread_buffers(const xrt::device& device, const config& cfg, operation op, size_t size)
+    : host(std::make_unique<host_buffer>(size, cfg.numa_node))
+  {
+    auto alloc = [&](std::unique_ptr<host_buffer>& backing) {
+      if (!cfg.userptr)
+        return xrt::bo(device, size, cfg.group);
+      backing = std::make_unique<host_buffer>(size, cfg.numa_node);
+      return xrt::bo(device, backing->get(), size, cfg.group);
+    };
+
+    bo = alloc(bo_host);
+    if (op == operation::copy)
+      src = alloc(src_host);
+    if (op == operation::map)
+      bo_map = bo.map();
+  }
+};
+
+void
+transfer(operation op, thread_buffers& buffers, size_t size)
+{
+  switch (op) {
+  case operation::write:
+    buffers.bo.write(buffers.host->get(), size, 0);
+    buffers.bo.sync(XCL_BO_SYNC_BO_TO_DEVICE, size, 0);
+    break;
+  case operation::map:
+    std::memcpy(buffers.bo_map, buffers.host->get(), size);
+    buffers.bo.sync(XCL_BO_SYNC_BO_TO_DEVICE, size, 0);
+    break;
+  case operation::read:
+    buffers.bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE, size, 0);
+    buffers.bo.read(buffers.host->get(), size, 0);
+    break;
+  case operation::sync:
+    buffers.bo.sync(XCL_BO_SYNC_BO_TO_DEVICE, size, 0);
+    break;
+  case operation::copy:
+    buffers.bo.copy(buffers.src, size);
+    break;
+  }
+}
+
+// Threads do their warmup transfers and then wait at the gate until
+// all threads are ready, so that the timed transfers overlap fully
+class start_gate
+{
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  unsigned int m_waiting = 0;
+  bool m_open = false;
+
+public:
+  void
+  arrive()
+  {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    ++m_waiting;
+    m_cv.notify_all();
+    m_cv.wait(lk, [this] { return m_open; });
+  }
+
+  void
+  open(unsigned int threads)
+  {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    m_cv.wait(lk, [this, threads] { return m_waiting == threads; });
+    m_open = true;
+    m_cv.notify_all();
+  }
+};
+
+uint64_t
+percentile(const std::vector<uint64_t>& sorted, double p)
+{
+  // nearest rank
+  auto rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+unsigned int
+log2_bucket(uint64_t ns)
+{
+  unsigned int bucket = 0;
+  while (ns >>= 1)
+    ++bucket;
+  return bucket;
+}
+
+void
+compute_statistics(result& res, std::vector<uint64_t>& samples)
+{
+  if (samples.empty())
+    return;
+
+  std::sort(samples.begin(), samples.end());
+  res.transfers = samples.size();
+  res.min_ns = samples.front();
+  res.max_ns = samples.back();
+  double sum = 0.0;
+  for (auto ns : samples)
+    sum += ns;
+  res.mean_ns = sum / samples.size();
+  res.p50_ns = percentile(samples, 0.50);
+  res.p90_ns = percentile(samples, 0.90);
+  res.p99_ns = percentile(samples, 0.99);
+  res.p999_ns = percentile(samples, 0.999);
+
+  res.histogram.assign(log2_bucket(res.max_ns) + 1, 0);
+  for (auto ns : samples)
+    ++res.histogram[log2_bucket(ns)];
+}
+
+} // namespace
+
+namespace xrt_core { namespace bo_bench {
+
+std::string
+to_string(operation op)
+{
+  switch (op) {
+  case operation::write: return "write";
+  case operation::map:   return "map";
+  case operation::read:  return "read";
+  case operation::sync:  return "sync";
+  case operation::copy:  return "copy";
+  }
+  return "unknown";
+}
+
+operation
+to_operation(const std::string& name)
+{
+  for (auto op : {operation::write, operation::map, operation::read, operation::sync, operation::copy})
+    if (name == to_string(op))
+      return op;
+  throw std::invalid_argument("unknown operation '" + name + "'");
+}
+
+result
+run_point(const xrt::device& device, const config& cfg, operation op,
+          size_t block_size, unsigned int threads)
+{
+  result res;
+  res.op = op;
+  res.block_size = block_size;
+  res.threads = threads;
+
+  if (!block_size || !threads) {
+    res.error = "block size and thread count must be non zero";
+    return res;
+  }
+
+  auto iterations = std::max<size_t>(cfg.bytes_per_thread / block_size, cfg.min_iterations);
+
+  // Buffers are allocated before any thread is started so that
+  // allocation is not part of the measurement
+  std::vector<std::unique_ptr<thread_buffers>> buffers;
+  try {
+    for (unsigned int t = 0; t < threads; ++t)
+      buffers.emplace_back(std::make_unique<thread_buffers>(device, cfg, op, block_size));
+  }
+  catch (const std::exception& ex) {
+    res.error = ex.what();
+    return res;
+  }
+
+  std::vector<std::vector<uint64_t>> samples(threads);
+  std::vector<std::exception_ptr> errors(threads);
+  start_gate gate;
+  bool aborted = false;  // set before the gate opens
+
+  auto worker = [&](unsigned int t) {
+    bool ok = true;
+    try {
+      for (unsigned int i = 0; i < cfg.warmup; ++i)
+        transfer(op, *buffers[t], block_size);
+      samples[t].reserve(iterations);
+    }
+    catch (...) {
+      errors[t] = std::current_exception();
+      ok = false;
+    }
+
+    gate.arrive();
+    if (!ok || aborted)
+      return;
+
+    try {
+      for (size_t i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        transfer(op, *buffers[t], block_size);
+        auto end = std::chrono::steady_clock::now();
+        samples[t].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+      }
+    }
+    catch (...) {
+      errors[t] = std::current_exception();
+    }
+  };
+
+  // Threads started before one fails to start are waiting at the
+  // gate, let them through to exit before giving up
+  std::vector<std::thread> workers;
+  try {
+    for (unsigned int t = 0; t < threads; ++t)
+      workers.emplace_back(worker, t);
+  }
+  catch (...) {
+    aborted = true;
+    gate.open(static_cast<unsigned int>(workers.size()));
+    for (auto& w : workers)
+      w.join();
+    throw;
+  }
+
+  gate.open(threads);
+  auto start = std::chrono::steady_clock::now();
+  for (auto& w : workers)
+    w.join();
+  auto end = std::chrono::steady_clock::now();
+  res.seconds = std::chrono::duration<double>(end - start).count();
+
+  for (auto& err : errors) {
+    if (!err)
+      continue;
+    try {
+      std::rethrow_exception(err);
+    }
+    catch (const std::exception& ex) {
+      res.error = ex.what();
+    }
+    catch (...) {
+      res.error = "unknown error";
+    }
+    res.seconds = 0.0;
+    return res;
+  }
+
+  std::vector<uint64_t> all;
+  all.reserve(iterations * threads);
+  for (auto& s : samples)
+    all.insert(all.end(), s.begin(), s.end());
+  compute_statistics(res, all);
+  return res;
+}
+
+std::vector<result>
+run(const xrt::device& device, const config& cfg,
+    const std::function<void(const result&)>& callback)
+{
+  std::vector<result> results;
+  for (auto op : cfg.operations) {
+    for (auto threads : cfg.threads) {
+      for (auto block_size : cfg.block_sizes) {
+        results.push_back(run_point(device, cfg, op, block_size, threads));
+        if (callback)
+          callback(results.back());
+      }
+    }
+  }
+  return results;
+}
+
+boost::property_tree::ptree
+to_ptree(const xrt::device& device, const config& cfg, const std::vector<result>& results)
+{
+  boost::property_tree::ptree pt;
+
+  // Device properties that determine the copy path, not all shims
+  // support all properties
+  boost::property_tree::ptree pt_device;
+  try { pt_device.put("name", device.get_info<xrt::info::device::name>()); } catch (const std::exception&) {}
+  try { pt_device.put("bdf", device.get_info<xrt::info::device::bdf>()); } catch (const std::exception&) {}
+  try { pt_device.put("m2m", device.get_info<xrt::info::device::m2m>()); } catch (const std::exception&) {}
+  try { pt_device.put("kdma", device.get_info<xrt::info::device::kdma>()); } catch (const std::exception&) {}
+  pt.add_child("device", pt_device);
+
+  boost::property_tree::ptree pt_config;
+  pt_config.put("bytes_per_thread", cfg.bytes_per_thread);
+  pt_config.put("min_iterations", cfg.min_iterations);
+  pt_config.put("warmup", cfg.warmup);
+  pt_config.put("userptr", cfg.userptr);
+  pt_config.put("numa_node", cfg.numa_node);
+  pt_config.put("group", cfg.group);
+  pt.add_child("config", pt_config);
+
+  boost::property_tree::ptree pt_results;
+  for (const auto& res : results) {
+    boost::property_tree::ptree pt_res;
+    pt_res.put("operation", to_string(res.op));
+    pt_res.put("block_size", res.block_size);
+    pt_res.put("threads", res.threads);
+    if (!res.error.empty()) {
+      pt_res.put("error", res.error);
+      pt_results.push_back({"", pt_res});
+      continue;
+    }
+
+    pt_res.put("transfers", res.transfers);
+    pt_res.put("seconds", res.seconds);
+    pt_res.put("bandwidth_mbps", res.bandwidth());
+
+    boost::property_tree::ptree pt_latency;
+    pt_latency.put("min", res.min_ns);
+    pt_latency.put("max", res.max_ns);
+    pt_latency.put("mean", res.mean_ns);
+    pt_latency.put("p50", res.p50_ns);
+    pt_latency.put("p90", res.p90_ns);
+    pt_latency.put("p99", res.p99_ns);
+    pt_latency.put("p999", res.p999_ns);
+    pt_res.add_child("latency_ns", pt_latency);
+
+    // Histogram buckets with samples, keyed by the bucket lower bound
+    boost::property_tree::ptree pt_histogram;
+    for (size_t bucket = 0; bucket < res.histogram.size(); ++bucket) {
+      if (!res.histogram[bucket])
+        continue;
+      boost::property_tree::ptree pt_bucket;
+      pt_bucket.put("min_ns", uint64_t(1) << bucket);
+      pt_bucket.put("count", res.histogram[bucket]);
+      pt_histogram.push_back({"", pt_bucket});
+    }
+    pt_res.add_child("histogram", pt_histogram);
+
+    pt_results.push_back({"", pt_res});
+  }
+  pt.add_child("results", pt_results);
+
+  return pt;
+}
+
+}} // bo_bench, xrt_core
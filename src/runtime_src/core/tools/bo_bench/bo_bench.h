@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrtcore_tools_bo_bench_h_
+#define xrtcore_tools_bo_bench_h_
+
+// Buffer object bandwidth and latency benchmark
+//
+// The benchmark measures buffer transfers through the public xrt::bo
+// API only, so it runs unmodified against any shim including the noop
+// and sw_emu shims.  On those shims the numbers reflect the host side
+// overhead of XRT, which is what regressions are most often about.
+//
+// A benchmark point is one operation at one block size with a number
+// of threads.  Each thread owns its buffers and transfers one block
+// per iteration.  The latency of every transfer is recorded, and the
+// bandwidth is computed from the wall clock time of all threads.
+
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace xrt_core { namespace bo_bench {
+
+/**
+ * enum class operation - buffer operation measured by a benchmark point
+ *
+ * @write:  bo.write() from host memory followed by sync to device
+ * @map:    memcpy into the mapped buffer followed by sync to device
+ * @read:   sync from device followed by bo.read() into host memory
+ * @sync:   sync to device of a buffer already populated
+ * @copy:   bo.copy() between two buffers, which XRT performs with
+ *          m2m, kdma, or through host memory depending on the device
+ */
+enum class operation { write, map, read, sync, copy };
+
+std::string
+to_string(operation op);
+
+// Throws std::invalid_argument for unknown operation names
+operation
+to_operation(const std::string& name);
+
+/**
+ * struct config - benchmark parameters
+ *
+ * @operations:       operations to measure
+ * @block_sizes:      transfer sizes in bytes
+ * @threads:          thread counts
+ * @bytes_per_thread: bytes transferred by each thread per point, the
+ *                    iteration count is derived from this and the
+ *                    block size, but is never less than min_iterations
+ * @min_iterations:   minimum number of timed transfers per thread
+ * @warmup:           untimed transfers per thread before timing starts
+ * @userptr:          host buffers are allocated by the benchmark and
+ *                    imported as user pointer buffers, otherwise XRT
+ *                    allocates the buffers
+ * @numa_node:        NUMA node to bind benchmark allocated host memory
+ *                    to, -1 for the default policy (requires userptr)
+ * @group:            memory bank group of the buffers
+ */
+struct config
+{
+  std::vector<operation> operations {operation::write, operation::read};
+  std::vector<size_t> block_sizes {4096, 65536, 1 << 20, 16 << 20};
+  std::vector<unsigned int> threads {1};
+  size_t bytes_per_thread = 256 << 20;
+  unsigned int min_iterations = 16;
+  unsigned int warmup = 2;
+  bool userptr = false;
+  int numa_node = -1;
+  xrt::memory_group group = 0;
+};
+
+/**
+ * struct result - measurements of one benchmark point
+ *
+ * @op:            operation measured
+ * @block_size:    bytes per transfer
+ * @threads:       number of threads
+ * @transfers:     total number of timed transfers, all threads
+ * @seconds:       wall clock time of the timed transfers
+ * @min_ns:        shortest transfer
+ * @max_ns:        longest transfer
+ * @mean_ns:       average transfer time
+ * @p50_ns:        median transfer time
+ * @p90_ns:        90th percentile transfer time
+ * @p99_ns:        99th percentile transfer time
+ * @p999_ns:       99.9th percentile transfer time
+ * @histogram:     number of transfers per log2 latency bucket, where
+ *                 bucket i counts transfers of [2^i, 2^(i+1)) ns
+ * @error:         why the point could not be measured, empty on success
+ */
+struct result
+{
+  operation op = operation::write;
+  size_t block_size = 0;
+  unsigned int threads = 0;
+  uint64_t transfers = 0;
+  double seconds = 0.0;
+  uint64_t min_ns = 0;
+  uint64_t max_ns = 0;
+  double mean_ns = 0.0;
+  uint64_t p50_ns = 0;
+  uint64_t p90_ns = 0;
+  uint64_t p99_ns = 0;
+  uint64_t p999_ns = 0;
+  std::vector<uint64_t> histogram;
+  std::string error;
+
+  // Aggregate bandwidth of all threads in MB/s (2^20 bytes)
+  double
+  bandwidth() const
+  {
+    return seconds > 0.0
+      ? static_cast<double>(transfers) * block_size / (1 << 20) / seconds
+      : 0.0;
+  }
+};
+
+/**
+ * run_point() - Measure one operation, block size, and thread count
+ *
+ * Errors while allocating or transferring buffers, e.g. an operation
+ * that is not supported by the shim, are returned in result.error.
+ */
+result
+run_point(const xrt::device& device, const config& cfg, operation op,
+          size_t block_size, unsigned int threads);
+
+/**
+ * run() - Measure all combinations of operations, block sizes, and threads
+ *
+ * @callback: Optional, called with each result as it is measured
+ */
+std::vector<result>
+run(const xrt::device& device, const config& cfg,
+    const std::function<void(const result&)>& callback = nullptr);
+
+/**
+ * to_ptree() - Results and configuration as a property tree
+ *
+ * The tree is written as JSON by the bo_bench tool.
+ */
+boost::property_tree::ptree
+to_ptree(const xrt::device& device, const config& cfg, const std::vector<result>& results);
+
+}} // bo_bench, xrt_core
+
+#endif
@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Command line front end for the buffer object benchmark
+//
+//  % bo_bench --ops write,read,map --sizes 4k,64k,1m,16m --threads 1,4
+//  % bo_bench --ops copy --xclbin verify.xclbin --json results.json
+//  % XCL_EMULATION_MODE=noop bo_bench --sizes 4k,1m --bytes 16m
+//
+// A table of results is printed to stdout, and optionally the full
+// results including latency histograms are written as JSON.
+#include "bo_bench.h"
+
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace po = boost::program_options;
+namespace bench = xrt_core::bo_bench;
+
+namespace {
+
+std::vector<std::string>
+split(const std::string& list)
+{
+  std::vector<std::string> items;
+  boost::split(items, list, boost::is_any_of(","), boost::token_compress_on);
+  items.erase(std::remove(items.begin(), items.end(), ""), items.end());
+  return items;
+}
+
+// Size with optional k, m, or g suffix for KiB, MiB, GiB
+size_t
+to_size(std::string str)
+{
+  size_t shift = 0;
+  switch (str.empty() ? 0 : std::tolower(str.back())) {
+  case 'k': shift = 10; break;
+  case 'm': shift = 20; break;
+  case 'g': shift = 30; break;
+  default: break;
+  }
+  if (shift)
+    str.pop_back();
+
+  size_t idx = 0;
+  auto value = std::stoull(str, &idx, 0);
+  if (idx != str.size())
+    throw std::invalid_argument("invalid size '" + str + "'");
+  return static_cast<size_t>(value) << shift;
+}
+
+std::string
+to_size_string(size_t size)
+{
+  if (size >= (1 << 30) && !(size % (1 << 30)))
+    return std::to_string(size >> 30) + "G";
+  if (size >= (1 << 20) && !(size % (1 << 20)))
+    return std::to_string(size >> 20) + "M";
+  if (size >= (1 << 10) && !(size % (1 << 10)))
+    return std::to_string(size >> 10) + "K";
+  return std::to_string(size);
+}
+
+void
+print_header(std::ostream& ostr)
+{
+  ostr << boost::format("%-6s %8s %7s %10s %10s %10s %10s %10s\n")
+    % "op" % "block" % "threads" % "MB/s" % "p50(us)" % "p90(us)" % "p99(us)" % "max(us)";
+}
+
+void
+print_result(std::ostream& ostr, const bench::result& res)
+{
+  if (!res.error.empty()) {
+    ostr << boost::format("%-6s %8s %7d  error: %s\n")
+      % bench::to_string(res.op) % to_size_string(res.block_size) % res.threads % res.error;
+    return;
+  }
+
+  ostr << boost::format("%-6s %8s %7d %10.1f %10.1f %10.1f %10.1f %10.1f\n")
+    % bench::to_string(res.op) % to_size_string(res.block_size) % res.threads % res.bandwidth()
+    % (res.p50_ns / 1000.0) % (res.p90_ns / 1000.0) % (res.p99_ns / 1000.0) % (res.max_ns / 1000.0);
+}
+
+int
+run(int argc, char** argv)
+{
+  std::string device_id = "0";
+  std::string xclbin;
+  std::string ops = "write,read";
+  std::string sizes = "4k,64k,1m,16m";
+  std::string threads = "1";
+  std::string bytes = "256m";
+  std::string json;
+  bench::config cfg;
+
+  po::options_description options("Options");
+  options.add_options()
+    ("help,h", "Print this help")
+    ("device,d", po::value<std::string>(&device_id), "Device index or BDF (default 0)")
+    ("xclbin,k", po::value<std::string>(&xclbin), "Load xclbin before running, required for sw_emu")
+    ("ops,o", po::value<std::string>(&ops), "Comma separated operations: write, map, read, sync, copy (default write,read)")
+    ("sizes,s", po::value<std::string>(&sizes), "Comma separated block sizes, k/m/g suffix allowed (default 4k,64k,1m,16m)")
+    ("threads,t", po::value<std::string>(&threads), "Comma separated thread counts (default 1)")
+    ("bytes,b", po::value<std::string>(&bytes), "Bytes transferred per thread per point (default 256m)")
+    ("iterations,i", po::value<unsigned int>(&cfg.min_iterations), "Minimum timed transfers per thread (default 16)")
+    ("warmup,w", po::value<unsigned int>(&cfg.warmup), "Untimed transfers per thread (default 2)")
+    ("group,g", po::value<xrt::memory_group>(&cfg.group), "Memory bank group of buffers (default 0)")
+    ("userptr,u", po::bool_switch(&cfg.userptr), "Use benchmark allocated host memory for buffers")
+    ("numa-node,n", po::value<int>(&cfg.numa_node), "Bind benchmark allocated host memory to NUMA node, implies --userptr")
+    ("json,j", po::value<std::string>(&json), "Write results as JSON to file, '-' for stdout")
+    ;
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, options), vm);
+  po::notify(vm);
+
+  if (vm.count("help")) {
+    std::cout << "Usage: " << argv[0] << " [options]\n" << options;
+    return 0;
+  }
+
+  cfg.operations.clear();
+  for (const auto& op : split(ops))
+    cfg.operations.push_back(bench::to_operation(op));
+  cfg.block_sizes.clear();
+  for (const auto& size : split(sizes))
+    cfg.block_sizes.push_back(to_size(size));
+  cfg.threads.clear();
+  for (const auto& count : split(threads))
+    cfg.threads.push_back(static_cast<unsigned int>(std::stoul(count)));
+  cfg.bytes_per_thread = to_size(bytes);
+  if (cfg.numa_node >= 0)
+    cfg.userptr = true;
+
+  xrt::device device{device_id};
+  if (!xclbin.empty())
+    device.load_xclbin(xclbin);
+
+  // Keep stdout clean for JSON output
+  auto& table = (json == "-") ? std::cerr : std::cout;
+  print_header(table);
+  auto results = bench::run(device, cfg, [&table](const bench::result& res) { print_result(table, res); });
+
+  if (!json.empty()) {
+    auto pt = bench::to_ptree(device, cfg, results);
+    if (json == "-") {
+      boost::property_tree::write_json(std::cout, pt);
+    }
+    else {
+      std::ofstream ostr(json);
+      if (!ostr)
+        throw std::runtime_error("Unable to open '" + json + "' for writing");
+      boost::property_tree::write_json(ostr, pt);
+    }
+  }
+
+  // Fail if any point could not be measured
+  for (const auto& res : results)
+    if (!res.error.empty())
+      return 1;
+
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  try {
+    return run(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "bo_bench: " << ex.what() << "\n";
+  }
+  return 1;
+}
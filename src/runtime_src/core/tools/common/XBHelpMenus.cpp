@@ -6,6 +6,7 @@
 // Local - Include Files
 #include "core/common/time.h"
 #include "core/common/query_requests.h"
+#include "core/common/query_snapshot.h"
 #include "XBHelpMenusCore.h"
 #include "XBUtilitiesCore.h"
 #include "XBHelpMenus.h"
@@ -208,14 +209,25 @@ XBUtilities::produce_reports( const std::shared_ptr<xrt_core::device>& device,
 
   if(dev_report()) {
     // -- Process reports that work on a device
+    // The reports share platform and xclbin information, which changes
+    // only if the device is reprogrammed, so query each value once for
+    // the duration of the reports rather than once per report
+    xrt_core::query::slow_changing_cache cache(device.get(), std::chrono::minutes(1));
+
+    xrt_core::query::snapshot snapshot(device.get());
+    snapshot.fetch<xrt_core::query::pcie_bdf,
+                   xrt_core::query::is_mfg,
+                   xrt_core::query::is_ready,
+                   xrt_core::query::is_recovery>();
+
     boost::property_tree::ptree ptDevice;
-    auto bdf = xrt_core::device_query<xrt_core::query::pcie_bdf>(device);
+    auto bdf = snapshot.get<xrt_core::query::pcie_bdf>();
     ptDevice.put("interface_type", "pcie");
     ptDevice.put("device_id", xrt_core::query::pcie_bdf::to_string(bdf));
 
     bool is_mfg = false;
     try {
-      is_mfg = xrt_core::device_query<xrt_core::query::is_mfg>(device);
+      is_mfg = snapshot.get<xrt_core::query::is_mfg>();
     } 
     catch (const xrt_core::query::exception&) {
       is_mfg = false;
@@ -225,10 +237,10 @@ XBUtilities::produce_reports( const std::shared_ptr<xrt_core::device>& device,
     std::string platform;
     try {
       if (is_mfg) {
-        platform = "xilinx_" + xrt_core::device_query<xrt_core::query::board_name>(device) + "_GOLDEN";
+        platform = "xilinx_" + snapshot.get<xrt_core::query::board_name>() + "_GOLDEN";
       }
       else {
-        platform = xrt_core::device_query<xrt_core::query::rom_vbnv>(device);
+        platform = snapshot.get<xrt_core::query::rom_vbnv>();
       }
     } 
     catch (const xrt_core::query::exception&) {
@@ -242,10 +254,10 @@ XBUtilities::produce_reports( const std::shared_ptr<xrt_core::device>& device,
     consoleStream << dev_desc;
     consoleStream << std::string(dev_desc.length(), '-') << std::endl;
 
-    const auto is_ready = xrt_core::device_query_default<xrt_core::query::is_ready>(device, true);
+    const auto is_ready = snapshot.get_default<xrt_core::query::is_ready>(true);
     bool is_recovery = false;
     try {
-      is_recovery = xrt_core::device_query<xrt_core::query::is_recovery>(device);
+      is_recovery = snapshot.get<xrt_core::query::is_recovery>();
     }
     catch(const xrt_core::query::exception&) { 
       is_recovery = false;
@@ -0,0 +1,222 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Startup time of XRT against the noop shim
+//
+//  % XILINX_XRT=/opt/xilinx/xrt startup_bench
+//  % startup_bench --iterations 50 --devices 4 --parallel
+//
+// Each iteration runs in a new process with XCL_EMULATION_MODE=noop,
+// so that every iteration pays for reading xrt.ini, loading the shim
+// and opening devices as a short lived application does.  The noop
+// shim needs no hardware, the time measured is that of XRT itself.
+//
+// The median wall time of each startup phase recorded by XRT, see
+// core/common/startup_profile.h, is reported along with the time until
+// all devices are open and the time of the whole process.
+#include "core/common/startup_profile.h"
+#include "core/include/experimental/xrt_system.h"
+#include "core/include/xrt/xrt_device.h"
+
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace po = boost::program_options;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// Phase name to duration in us of one iteration
+using sample = std::map<std::string, uint64_t>;
+
+const char* const open_phase = "devices usable (total)";
+const char* const process_phase = "process (fork to exit)";
+
+uint64_t
+elapsed_us(clock_type::time_point start)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - start).count();
+}
+
+// Runs in the child process, phases are written to fd as
+// "<duration_us> <name>" lines
+[[noreturn]] void
+start(unsigned int devices, bool parallel, int fd)
+{
+  int status = EXIT_FAILURE;
+  try {
+    auto begin = clock_type::now();
+    xrt::system::enumerate_devices();
+
+    std::vector<xrt::device> opened;
+    if (parallel) {
+      std::vector<std::future<xrt::device>> futures;
+      for (unsigned int idx = 0; idx < devices; ++idx)
+        futures.push_back(std::async(std::launch::async, [idx] { return xrt::device{idx}; }));
+      for (auto& f : futures)
+        opened.push_back(f.get());
+    }
+    else {
+      for (unsigned int idx = 0; idx < devices; ++idx)
+        opened.emplace_back(idx);
+    }
+    auto total = elapsed_us(begin);
+
+    std::ostringstream ostr;
+    for (const auto& p : xrt_core::startup::phases())
+      ostr << p.duration_us << " " << p.name << "\n";
+    ostr << total << " " << open_phase << "\n";
+
+    auto str = ostr.str();
+    if (::write(fd, str.data(), str.size()) == static_cast<ssize_t>(str.size()))
+      status = EXIT_SUCCESS;
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "startup_bench: " << ex.what() << "\n";
+  }
+  ::_exit(status);
+}
+
+sample
+run_once(unsigned int devices, bool parallel)
+{
+  int fds[2];
+  if (::pipe(fds))
+    throw std::runtime_error(std::string("pipe: ") + std::strerror(errno));
+
+  auto begin = clock_type::now();
+  auto pid = ::fork();
+  if (pid < 0)
+    throw std::runtime_error(std::string("fork: ") + std::strerror(errno));
+  if (pid == 0) {
+    ::close(fds[0]);
+    start(devices, parallel, fds[1]);
+  }
+
+  ::close(fds[1]);
+  std::string output;
+  char buf[4096];
+  ssize_t bytes;
+  while ((bytes = ::read(fds[0], buf, sizeof(buf))) > 0)
+    output.append(buf, bytes);
+  ::close(fds[0]);
+
+  int status = 0;
+  if (::waitpid(pid, &status, 0) < 0)
+    throw std::runtime_error(std::string("waitpid: ") + std::strerror(errno));
+  if (!WIFEXITED(status) || WEXITSTATUS(status))
+    throw std::runtime_error("startup failed");
+
+  sample smp;
+  smp[process_phase] = elapsed_us(begin);
+
+  // A phase recorded more than once, eg. loading several modules of
+  // the same name, is summed
+  std::istringstream istr(output);
+  uint64_t us;
+  std::string name;
+  while (istr >> us && std::getline(istr >> std::ws, name))
+    smp[name] += us;
+  return smp;
+}
+
+uint64_t
+median(const std::vector<sample>& samples, const std::string& name)
+{
+  std::vector<uint64_t> values;
+  for (const auto& smp : samples) {
+    auto itr = smp.find(name);
+    values.push_back(itr == smp.end() ? 0 : itr->second);
+  }
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+int
+run(int argc, char** argv)
+{
+  unsigned int iterations = 20;
+  unsigned int devices = 1;
+  bool parallel = false;
+
+  po::options_description options("Options");
+  options.add_options()
+    ("help,h", "Print this help")
+    ("iterations,i", po::value<unsigned int>(&iterations), "Startups, each in a new process (default 20)")
+    ("devices,d", po::value<unsigned int>(&devices), "Devices opened per startup (default 1)")
+    ("parallel,p", po::bool_switch(&parallel), "Open devices concurrently")
+    ;
+
+  po::variables_map vm;
+  po::store(po::command_line_parser(argc, argv).options(options).run(), vm);
+  po::notify(vm);
+
+  if (vm.count("help")) {
+    std::cout << "Usage: " << argv[0] << " [options]\n" << options;
+    return 0;
+  }
+
+  if (!iterations)
+    throw std::invalid_argument("iterations must be positive");
+
+  if (!std::getenv("XILINX_XRT"))
+    throw std::runtime_error("XILINX_XRT must point to an XRT installation with the noop shim");
+  ::setenv("XCL_EMULATION_MODE", "noop", 1);
+  // Devices opened are recorded with the report enabled only, the
+  // report itself is not printed since iterations exit with _exit()
+  ::setenv("Runtime.startup_report", "true", 1);
+
+  std::vector<sample> samples;
+  for (unsigned int idx = 0; idx < iterations; ++idx)
+    samples.push_back(run_once(devices, parallel));
+
+  // Report the longest phases first, totals last
+  std::vector<std::string> names;
+  for (const auto& p : samples.front())
+    if (p.first != open_phase && p.first != process_phase)
+      names.push_back(p.first);
+  std::sort(names.begin(), names.end(), [&samples](const auto& a, const auto& b) {
+    return median(samples, a) > median(samples, b);
+  });
+  names.push_back(open_phase);
+  names.push_back(process_phase);
+
+  std::cout << boost::format("%d startups, %d device(s) opened %s, median\n")
+    % iterations % devices % (parallel ? "concurrently" : "sequentially");
+  std::cout << boost::format("%-40s %12s\n") % "phase" % "time(us)";
+  for (const auto& name : names)
+    std::cout << boost::format("%-40s %12d\n") % name % median(samples, name);
+
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  try {
+    return run(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "startup_bench: " << ex.what() << "\n";
+  }
+  return 1;
+}
@@ -0,0 +1,251 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#include "mcs_image.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace {
+
+// Value of a hex digit, -1 for other characters
+static const std::array<int8_t, 256>&
+hexTable()
+{
+    static const std::array<int8_t, 256> table = [] {
+        std::array<int8_t, 256> t;
+        t.fill(-1);
+        for (int i = 0; i < 10; ++i)
+            t['0' + i] = static_cast<int8_t>(i);
+        for (int i = 0; i < 6; ++i) {
+            t['a' + i] = static_cast<int8_t>(10 + i);
+            t['A' + i] = static_cast<int8_t>(10 + i);
+        }
+        return t;
+    }();
+    return table;
+}
+
+// Record types found in Xilinx MCS files
+enum recordType
+{
+    RECORD_DATA = 0x00,
+    RECORD_EOF = 0x01,
+    RECORD_ELA = 0x04
+};
+
+// Decode a record line (":llaaaatt<data>cc") into its bytes and
+// verify the length and checksum.  Returns number of bytes, 0 if the
+// line is malformed.
+static size_t
+decodeRecord(const std::string& line, unsigned char *rec, size_t recSize)
+{
+    const auto& table = hexTable();
+    const size_t digits = line.size() - 1;
+
+    // Length, address, type and checksum are at least 5 bytes
+    if (line[0] != ':' || (digits & 1) || digits < 10 || digits / 2 > recSize)
+        return 0;
+
+    unsigned char sum = 0;
+    const unsigned char *p = reinterpret_cast<const unsigned char*>(line.data()) + 1;
+    for (size_t i = 0; i < digits / 2; ++i, p += 2) {
+        const int hi = table[p[0]];
+        const int lo = table[p[1]];
+        if ((hi | lo) < 0)
+            return 0;
+        rec[i] = static_cast<unsigned char>((hi << 4) | lo);
+        sum += rec[i];
+    }
+
+    if (rec[0] + 5u != digits / 2 || sum != 0)
+        return 0;
+
+    return digits / 2;
+}
+
+} // namespace
+
+int mcsImage::parse(std::istream& mcsStream)
+{
+    mSegments.clear();
+
+    std::string line;
+    unsigned char rec[5 + 255];
+    uint32_t ela = 0;
+    bool haveEla = false;
+    unsigned int lineno = 0;
+
+    while (std::getline(mcsStream, line)) {
+        lineno++;
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty())
+            continue;
+
+        if (decodeRecord(line, rec, sizeof(rec)) == 0) {
+            std::cout << "Found invalid MCS line " << lineno << ": " << line << std::endl;
+            return -EINVAL;
+        }
+
+        const unsigned int len = rec[0];
+        const uint32_t offset = (rec[1] << 8) | rec[2];
+        const unsigned char *data = rec + 4;
+
+        if (rec[3] == RECORD_EOF)
+            break;
+
+        if (rec[3] == RECORD_ELA) {
+            // For xilinx mcs files extended address can only be 2 bytes
+            if (len != 2 || offset != 0) {
+                std::cout << "Found invalid MCS address record at line " << lineno << std::endl;
+                return -EINVAL;
+            }
+            ela = ((data[0] << 8) | data[1]) << 16;
+            haveEla = true;
+            continue;
+        }
+
+        if (rec[3] != RECORD_DATA) {
+            // Xilinx mcs files should not contain other types
+            std::cout << "Found unsupported MCS record type " << (unsigned int)rec[3]
+                << " at line " << lineno << std::endl;
+            return -EINVAL;
+        }
+
+        if (!haveEla) {
+            std::cout << "MCS missing page starting address" << std::endl;
+            return -EINVAL;
+        }
+
+        const uint32_t addr = ela | offset;
+        if (mSegments.empty() || mSegments.back().endAddress() != addr)
+            mSegments.push_back({addr, {}});
+        auto& seg = mSegments.back().mData;
+        seg.insert(seg.end(), data, data + len);
+    }
+
+    // Order segments by address, merge the adjacent ones
+    std::stable_sort(mSegments.begin(), mSegments.end(),
+        [](const segment& a, const segment& b) { return a.mStartAddress < b.mStartAddress; });
+
+    std::vector<segment> merged;
+    for (auto& seg : mSegments) {
+        if (seg.mData.empty())
+            continue;
+        if (!merged.empty() && merged.back().endAddress() > seg.mStartAddress) {
+            std::cout << "MCS data overlaps at address 0x" << std::hex
+                << seg.mStartAddress << std::dec << std::endl;
+            mSegments.clear();
+            return -EINVAL;
+        }
+        if (!merged.empty() && merged.back().endAddress() == seg.mStartAddress) {
+            auto& data = merged.back().mData;
+            data.insert(data.end(), seg.mData.begin(), seg.mData.end());
+            continue;
+        }
+        merged.push_back(std::move(seg));
+    }
+    mSegments = std::move(merged);
+
+    return 0;
+}
+
+size_t mcsImage::size() const
+{
+    size_t total = 0;
+    for (const auto& seg : mSegments)
+        total += seg.mData.size();
+    return total;
+}
+
+uint32_t mcsImage::startAddress() const
+{
+    return mSegments.empty() ? 0 : mSegments.front().mStartAddress;
+}
+
+std::vector<uint32_t>
+mcsSectors(const mcsImage& image, uint32_t shift, uint32_t sectorSize)
+{
+    std::vector<uint32_t> sectors;
+    for (const auto& seg : image.segments()) {
+        const uint32_t start = seg.mStartAddress + shift;
+        const uint32_t end = seg.endAddress() + shift;
+        for (uint32_t addr = start - (start % sectorSize); addr < end; addr += sectorSize) {
+            if (sectors.empty() || sectors.back() != addr)
+                sectors.push_back(addr);
+        }
+    }
+    return sectors;
+}
+
+int
+mcsProgram(const mcsImage& image, uint32_t shift, const flashOps& ops,
+    mcsProgramStats& stats)
+{
+    const auto& segments = image.segments();
+    const uint32_t sectorSize = ops.sectorSize;
+    const uint32_t pageSize = ops.pageSize;
+    const auto sectors = mcsSectors(image, shift, sectorSize);
+
+    stats = mcsProgramStats();
+    stats.sectors = sectors.size();
+
+    std::vector<unsigned char> expected(sectorSize);
+    std::vector<unsigned char> current(pageSize);
+    size_t first = 0;
+    for (size_t idx = 0; idx < sectors.size(); ++idx) {
+        const uint32_t sectorAddr = sectors[idx];
+        const uint32_t sectorEnd = sectorAddr + sectorSize;
+
+        // Expected sector content, 0xff where the image has no data
+        std::fill(expected.begin(), expected.end(), 0xff);
+        while (first < segments.size() && segments[first].endAddress() + shift <= sectorAddr)
+            first++;
+        for (size_t s = first; s < segments.size() && segments[s].mStartAddress + shift < sectorEnd; ++s) {
+            const uint32_t segStart = segments[s].mStartAddress + shift;
+            const uint32_t from = std::max(sectorAddr, segStart);
+            const uint32_t to = std::min(sectorEnd, segments[s].endAddress() + shift);
+            std::memcpy(expected.data() + (from - sectorAddr),
+                segments[s].mData.data() + (from - segStart), to - from);
+        }
+
+        // Compare against the flash content, stop at the first difference
+        bool changed = !ops.read;
+        for (uint32_t off = 0; !changed && off < sectorSize; off += pageSize) {
+            if (ops.read(sectorAddr + off, current.data(), pageSize) != 0 ||
+                std::memcmp(current.data(), expected.data() + off, pageSize) != 0)
+                changed = true;
+        }
+
+        if (!changed) {
+            stats.skipped++;
+        } else {
+            if (ops.erase) {
+                int ret = ops.erase(sectorAddr);
+                if (ret)
+                    return ret;
+            }
+
+            for (uint32_t off = 0; off < sectorSize; off += pageSize) {
+                const unsigned char *page = expected.data() + off;
+                if (ops.erase && std::all_of(page, page + pageSize,
+                        [](unsigned char c) { return c == 0xff; }))
+                    continue;
+
+                int ret = ops.program(sectorAddr + off, page, pageSize);
+                if (ret)
+                    return ret;
+                stats.pages++;
+            }
+        }
+
+        if (ops.progress)
+            ops.progress(idx + 1, sectors.size());
+    }
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef _MCS_IMAGE_H_
+#define _MCS_IMAGE_H_
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <vector>
+
+/*
+ * Binary image of a Xilinx MCS (Intel HEX) flash file.
+ *
+ * The MCS text is decoded in a single pass into contiguous segments of
+ * flash data, which are then programmed without going back to the text.
+ */
+class mcsImage
+{
+public:
+    struct segment
+    {
+        uint32_t mStartAddress;
+        std::vector<unsigned char> mData;
+
+        uint32_t endAddress() const
+        {
+            return mStartAddress + static_cast<uint32_t>(mData.size());
+        }
+    };
+
+    // Decode MCS text, returns 0 on success or -EINVAL if malformed
+    int parse(std::istream& mcsStream);
+
+    // Segments sorted by address, adjacent segments are merged
+    const std::vector<segment>& segments() const { return mSegments; }
+
+    bool empty() const { return mSegments.empty(); }
+
+    // Number of data bytes in the image
+    size_t size() const;
+
+    // Address of the first data byte
+    uint32_t startAddress() const;
+
+    // A golden image starts in the first 64KB of flash
+    bool isGolden() const { return (startAddress() >> 16) == 0; }
+
+private:
+    std::vector<segment> mSegments;
+};
+
+/*
+ * Flash device operations used to program an MCS image.  Addresses
+ * are flash byte addresses.
+ *
+ * read: read len bytes, may be empty in which case every sector
+ *   covered by the image is reprogrammed
+ * erase: erase the sector at a sector aligned address, may be empty
+ *   for devices that erase as part of program
+ * program: program len bytes, at most one page, at a page aligned
+ *   address
+ *
+ * All operations return 0 on success.
+ */
+struct flashOps
+{
+    uint32_t sectorSize;
+    uint32_t pageSize;
+    std::function<int(uint32_t addr, unsigned char *buf, size_t len)> read;
+    std::function<int(uint32_t addr)> erase;
+    std::function<int(uint32_t addr, const unsigned char *buf, size_t len)> program;
+    std::function<void(size_t done, size_t total)> progress;
+};
+
+struct mcsProgramStats
+{
+    size_t sectors = 0;         // sectors covered by the image
+    size_t skipped = 0;         // sectors already matching the image
+    size_t pages = 0;           // pages programmed
+};
+
+// Sector aligned addresses of the sectors covered by an image shifted
+// by @shift bytes, in address order
+std::vector<uint32_t>
+mcsSectors(const mcsImage& image, uint32_t shift, uint32_t sectorSize);
+
+/*
+ * Program an MCS image, shifted by @shift bytes, sector by sector.
+ *
+ * Erasing works on whole sectors, so the expected content of a sector
+ * is the image data with 0xff for bytes not covered by the image.  A
+ * sector whose current content already matches is neither erased nor
+ * programmed, and pages left all 0xff by an erase are not programmed.
+ *
+ * Returns 0 on success or the first failing operation's error.
+ */
+int
+mcsProgram(const mcsImage& image, uint32_t shift, const flashOps& ops,
+    mcsProgramStats& stats);
+
+#endif
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#include "flash_sim.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+flashSim::flashSim(size_t size, uint32_t sectorSize, uint32_t pageSize, const timing& t)
+    : mData(size, 0xff), mSectorSize(sectorSize), mPageSize(pageSize), mTiming(t)
+{
+}
+
+int flashSim::read(uint32_t addr, unsigned char *buf, size_t len)
+{
+    if (addr > mData.size() || len > mData.size() - addr)
+        return -EINVAL;
+
+    std::memcpy(buf, mData.data() + addr, len);
+    mStats.reads++;
+    mStats.elapsedUs += mTiming.readUs * ((len + mPageSize - 1) / mPageSize);
+    return 0;
+}
+
+int flashSim::erase(uint32_t addr)
+{
+    if (addr % mSectorSize || addr >= mData.size())
+        return -EINVAL;
+
+    std::fill_n(mData.begin() + addr, std::min<size_t>(mSectorSize, mData.size() - addr), 0xff);
+    mStats.erases++;
+    mStats.elapsedUs += mTiming.eraseUs;
+    return 0;
+}
+
+int flashSim::program(uint32_t addr, const unsigned char *buf, size_t len)
+{
+    // A program must not wrap around the end of a page
+    if (addr % mPageSize || len > mPageSize || addr > mData.size() || len > mData.size() - addr)
+        return -EINVAL;
+
+    // Programming only clears bits
+    for (size_t i = 0; i < len; ++i)
+        mData[addr + i] &= buf[i];
+    mStats.programs++;
+    mStats.elapsedUs += mTiming.programUs;
+    return 0;
+}
+
+flashOps flashSim::ops(bool withRead)
+{
+    flashOps ops;
+    ops.sectorSize = mSectorSize;
+    ops.pageSize = mPageSize;
+    if (withRead) {
+        ops.read = [this](uint32_t addr, unsigned char *buf, size_t len) {
+            return read(addr, buf, len);
+        };
+    }
+    ops.erase = [this](uint32_t addr) { return erase(addr); };
+    ops.program = [this](uint32_t addr, const unsigned char *buf, size_t len) {
+        return program(addr, buf, len);
+    };
+    return ops;
+}
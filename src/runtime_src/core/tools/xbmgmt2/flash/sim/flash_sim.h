@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef _FLASH_SIM_H_
+#define _FLASH_SIM_H_
+
+#include "../mcs_image.h"
+
+#include <cstdint>
+#include <vector>
+
+/*
+ * Simulated NOR flash used to test and benchmark MCS programming
+ * without a card.
+ *
+ * Erase sets a whole sector to 0xff and program can only clear bits,
+ * as on the real device.  Every operation adds its modelled duration
+ * to a simulated clock so that programming strategies can be compared
+ * without waiting for them.
+ */
+class flashSim
+{
+public:
+    // Modelled duration of operations in microseconds, the defaults
+    // are for 4KB subsectors and 128 byte pages accessed through the
+    // XSPI register interface
+    struct timing
+    {
+        double eraseUs = 50000;
+        double programUs = 400;
+        double readUs = 300;
+    };
+
+    struct counters
+    {
+        size_t reads = 0;
+        size_t erases = 0;
+        size_t programs = 0;
+        double elapsedUs = 0;
+    };
+
+    flashSim(size_t size, uint32_t sectorSize, uint32_t pageSize, const timing& t);
+
+    int read(uint32_t addr, unsigned char *buf, size_t len);
+    int erase(uint32_t addr);
+    int program(uint32_t addr, const unsigned char *buf, size_t len);
+
+    // Operations for mcsProgram(), read is left out when !withRead
+    flashOps ops(bool withRead = true);
+
+    const std::vector<unsigned char>& data() const { return mData; }
+    std::vector<unsigned char>& data() { return mData; }
+
+    const counters& stats() const { return mStats; }
+    void resetStats() { mStats = counters(); }
+
+private:
+    std::vector<unsigned char> mData;
+    uint32_t mSectorSize;
+    uint32_t mPageSize;
+    timing mTiming;
+    counters mStats;
+};
+
+#endif
@@ -0,0 +1,275 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Benchmark of MCS decoding and flash programming against the
+// simulated flash.
+//
+// % flash_sim_bench [--size <MB>] [--change <pct,...>] [--shift <n>]
+//                   [--seed <n>]
+//
+// A random image is encoded as MCS text and decoded, once with the
+// table driven decoder and once with a substr/stoi decoder like the
+// one it replaced.  The image is then programmed over stale flash
+// content, and reprogrammed after changing a percentage of its
+// sectors, comparing sector diffing against erasing and programming
+// every sector.  Flash content is verified after each run, the
+// program returns non zero on any mismatch which makes it usable as a
+// regression test.
+#include "flash_sim.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+const uint32_t sector_size = 0x1000;
+const uint32_t page_size = 128;
+
+static void
+usage()
+{
+  std::cout << "usage: flash_sim_bench [options]\n"
+            << " [--size <MB>]         image size in MB (default 16)\n"
+            << " [--change <pct,...>]  percent of sectors changed when reprogramming (default 0,1,10,100)\n"
+            << " [--shift <n>]         flash address shift of the image (default 0x1000)\n"
+            << " [--seed <n>]          random seed (default 1)\n";
+}
+
+static std::vector<uint32_t>
+to_list(const std::string& str)
+{
+  std::vector<uint32_t> list;
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, ','))
+    list.push_back(std::stoul(item));
+  return list;
+}
+
+static double
+elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Encode data at address as MCS text, 16 bytes per data record
+static std::string
+to_mcs(uint32_t address, const std::vector<unsigned char>& data)
+{
+  std::string mcs;
+  mcs.reserve(data.size() * 45 / 16 + 64);
+  char line[64];
+  auto record = [&](unsigned int len, unsigned int offset, unsigned int type, const unsigned char* bytes) {
+    unsigned int sum = len + (offset >> 8) + (offset & 0xff) + type;
+    int n = std::sprintf(line, ":%02X%04X%02X", len, offset, type);
+    for (unsigned int i = 0; i < len; ++i) {
+      n += std::sprintf(line + n, "%02X", bytes[i]);
+      sum += bytes[i];
+    }
+    std::sprintf(line + n, "%02X\n", (0x100 - (sum & 0xff)) & 0xff);
+    mcs += line;
+  };
+
+  uint32_t ela = UINT32_MAX;
+  for (size_t pos = 0; pos < data.size(); pos += 16) {
+    uint32_t addr = address + static_cast<uint32_t>(pos);
+    if ((addr >> 16) != ela) {
+      ela = addr >> 16;
+      unsigned char bytes[2] = { static_cast<unsigned char>(ela >> 8), static_cast<unsigned char>(ela) };
+      record(2, 0, 4, bytes);
+    }
+    record(static_cast<unsigned int>(std::min<size_t>(16, data.size() - pos)), addr & 0xffff, 0, data.data() + pos);
+  }
+  record(0, 0, 1, nullptr);
+  return mcs;
+}
+
+// Decoder in the style of the one replaced by mcsImage, for comparison
+static size_t
+legacy_decode(std::istream& mcs, std::vector<unsigned char>& out)
+{
+  out.clear();
+  std::string line;
+  while (std::getline(mcs, line)) {
+    if (line.empty())
+      continue;
+    unsigned int len = std::stoi(line.substr(1, 2), nullptr, 16);
+    unsigned int type = std::stoi(line.substr(7, 2), nullptr, 16);
+    if (type == 1)
+      break;
+    if (type != 0)
+      continue;
+    std::string data = line.substr(9, len * 2);
+    for (unsigned int i = 0; i < data.length(); i += 2)
+      out.push_back(static_cast<unsigned char>(std::stoi(data.substr(i, 2), nullptr, 16)));
+  }
+  return out.size();
+}
+
+// Flash must hold the image at address, and 0xff in the remainder of
+// the sectors covered by the image
+static bool
+verify(const flashSim& flash, uint32_t address, const std::vector<unsigned char>& image)
+{
+  const auto& data = flash.data();
+  uint32_t first = address - address % sector_size;
+  uint32_t end = address + static_cast<uint32_t>(image.size());
+  uint32_t last = (end + sector_size - 1) / sector_size * sector_size;
+  for (uint32_t addr = first; addr < last; ++addr) {
+    unsigned char expected = (addr >= address && addr < end) ? image[addr - address] : 0xff;
+    if (data[addr] != expected) {
+      std::cout << "mismatch at 0x" << std::hex << addr << ": 0x" << (unsigned int)data[addr]
+                << " != 0x" << (unsigned int)expected << std::dec << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool
+program(flashSim& flash, const mcsImage& image, uint32_t shift, bool diff,
+        const std::string& label, const std::vector<unsigned char>& expected, uint32_t address)
+{
+  flash.resetStats();
+  mcsProgramStats stats;
+  auto start = std::chrono::steady_clock::now();
+  int ret = mcsProgram(image, shift, flash.ops(diff), stats);
+  double wall = elapsed_ms(start);
+  const auto& c = flash.stats();
+
+  std::cout << std::left << std::setw(26) << label << std::right
+            << std::setw(8) << stats.sectors
+            << std::setw(8) << stats.skipped
+            << std::setw(8) << c.erases
+            << std::setw(9) << c.programs
+            << std::setw(9) << c.reads
+            << std::setw(12) << std::fixed << std::setprecision(1) << c.elapsedUs / 1e6
+            << std::setw(10) << std::setprecision(1) << wall << "\n";
+
+  if (ret) {
+    std::cout << "programming failed: " << ret << "\n";
+    return false;
+  }
+  return verify(flash, address + shift, expected);
+}
+
+static int
+run(int argc, char** argv)
+{
+  size_t size_mb = 16;
+  std::vector<uint32_t> changes = {0, 1, 10, 100};
+  uint32_t shift = 0x1000;
+  unsigned int seed = 1;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto next = [&]() -> std::string {
+      if (++i >= argc)
+        throw std::runtime_error("missing value for " + arg);
+      return argv[i];
+    };
+    if (arg == "--size")
+      size_mb = std::stoul(next());
+    else if (arg == "--change")
+      changes = to_list(next());
+    else if (arg == "--shift")
+      shift = std::stoul(next(), nullptr, 0);
+    else if (arg == "--seed")
+      seed = std::stoul(next());
+    else {
+      usage();
+      return arg == "--help" ? 0 : 1;
+    }
+  }
+
+  // Image with runs of 0xff as found in bitstreams, ending mid sector
+  const uint32_t address = 0x01000000;
+  std::mt19937 rng(seed);
+  std::vector<unsigned char> data(size_mb * 1024 * 1024 + 100);
+  for (size_t pos = 0; pos < data.size(); ++pos)
+    data[pos] = ((pos / 0x10000) % 4 == 3) ? 0xff : static_cast<unsigned char>(rng());
+
+  // Decode
+  auto mcs = to_mcs(address, data);
+  std::istringstream legacy_stream(mcs);
+  std::vector<unsigned char> legacy;
+  auto start = std::chrono::steady_clock::now();
+  legacy_decode(legacy_stream, legacy);
+  double legacy_ms = elapsed_ms(start);
+
+  std::istringstream mcs_stream(mcs);
+  mcsImage image;
+  start = std::chrono::steady_clock::now();
+  int ret = image.parse(mcs_stream);
+  double decode_ms = elapsed_ms(start);
+  if (ret || image.segments().size() != 1 || image.startAddress() != address
+      || image.segments().front().mData != data || legacy != data) {
+    std::cout << "decoded image does not match\n";
+    return 1;
+  }
+
+  std::cout << "MCS text: " << mcs.size() / (1024 * 1024) << " MB, image: " << data.size() << " bytes\n"
+            << std::fixed << std::setprecision(1)
+            << "decode substr/stoi: " << legacy_ms << " ms, table driven: " << decode_ms << " ms\n\n";
+
+  // Stale flash content to program over
+  flashSim flash(address + shift + data.size() + sector_size, sector_size, page_size, flashSim::timing());
+  for (auto& byte : flash.data())
+    byte = static_cast<unsigned char>(rng());
+
+  std::cout << std::left << std::setw(26) << "run" << std::right
+            << std::setw(8) << "sectors" << std::setw(8) << "skipped" << std::setw(8) << "erases"
+            << std::setw(9) << "programs" << std::setw(9) << "reads"
+            << std::setw(12) << "sim (s)" << std::setw(10) << "wall (ms)" << "\n";
+
+  bool ok = program(flash, image, shift, true, "initial", data, address);
+
+  const size_t num_sectors = data.size() / sector_size;
+  for (auto pct : changes) {
+    // Change one byte in pct percent of the sectors
+    auto changed = data;
+    size_t count = num_sectors * pct / 100;
+    for (size_t idx = 0; idx < count; ++idx) {
+      size_t sector = (count == num_sectors) ? idx : rng() % num_sectors;
+      changed[sector * sector_size + rng() % sector_size] ^= 0x5a;
+    }
+
+    std::istringstream changed_stream(to_mcs(address, changed));
+    mcsImage changed_image;
+    if (changed_image.parse(changed_stream)) {
+      std::cout << "failed to decode changed image\n";
+      return 1;
+    }
+
+    auto saved = flash.data();
+    ok &= program(flash, changed_image, shift, false, "full, " + std::to_string(pct) + "% changed", changed, address);
+    flash.data() = saved;
+    ok &= program(flash, changed_image, shift, true, "diff, " + std::to_string(pct) + "% changed", changed, address);
+    data = changed;
+  }
+
+  return ok ? 0 : 1;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  try {
+    return run(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "flash_sim_bench: " << ex.what() << "\n";
+  }
+  return 1;
+}
@@ -552,13 +552,14 @@ int XSPI_Flasher::xclUpgradeFirmware1(std::istream& mcsStream1, std::istream& st
     if (mFlashDev)
         return upgradeFirmware1Drv(mcsStream1, stripped);
 
-    //Parse MCS file for first flash device
-    status = parseMCS(mcsStream1);
+    //Decode MCS file for first flash device
+    mcsImage image;
+    status = image.parse(mcsStream1);
     if(status)
         return status;
 
     //Get bitstream start location
-    bitstream_start_loc = recordList.front().mStartAddress;
+    bitstream_start_loc = image.startAddress();
 
     //Write bitstream guard if MCS file is not at address 0
     if(bitstream_start_loc != 0) {
@@ -574,7 +575,7 @@ int XSPI_Flasher::xclUpgradeFirmware1(std::istream& mcsStream1, std::istream& st
         throw xrt_core::error("Unable to prepare the flash chip");
 
     //Program MCS file
-    status = programXSpi(mcsStream1, bitstream_shift_addr);
+    status = programXSpi(image, bitstream_shift_addr);
     if(status)
         return status;
 
@@ -603,13 +604,17 @@ int XSPI_Flasher::xclUpgradeFirmware2(std::istream& mcsStream1, std::istream& mc
     if (mFlashDev)
         return upgradeFirmware2Drv(mcsStream1, mcsStream2, stripped);
 
-    //Parse MCS file for first flash device
-    status = parseMCS(mcsStream1);
+    //Decode MCS files for both flash devices before touching the flash
+    mcsImage image1, image2;
+    status = image1.parse(mcsStream1);
+    if(status)
+        return status;
+    status = image2.parse(mcsStream2);
     if(status)
         return status;
 
     //Get bitstream start location
-    bitstream_start_loc = recordList.front().mStartAddress;
+    bitstream_start_loc = image1.startAddress();
 
     //Write bitstream guard if MCS file is not at address 0
     if(bitstream_start_loc != 0) {
@@ -628,12 +633,7 @@ int XSPI_Flasher::xclUpgradeFirmware2(std::istream& mcsStream1, std::istream& mc
         return -EINVAL;
     }
     //Program first MCS file
-    status = programXSpi(mcsStream1, bitstream_shift_addr);
-    if(status)
-        return status;
-
-    //Parse MCS file for second flash device
-    status = parseMCS(mcsStream2);
+    status = programXSpi(image1, bitstream_shift_addr);
     if(status)
         return status;
 
@@ -644,7 +644,7 @@ int XSPI_Flasher::xclUpgradeFirmware2(std::istream& mcsStream1, std::istream& mc
         return -EINVAL;
     }
     //Program second MCS file
-    status = programXSpi(mcsStream2, bitstream_shift_addr);
+    status = programXSpi(image2, bitstream_shift_addr);
     if(status)
         return status;
 
@@ -661,98 +661,6 @@ int XSPI_Flasher::xclUpgradeFirmware2(std::istream& mcsStream1, std::istream& mc
     return 0;
 }
 
-int XSPI_Flasher::parseMCS(std::istream& mcsStream) {
-    clearBuffers();
-    recordList.clear();
-
-    std::string startAddress;
-    ELARecord record;
-    bool endRecordFound = false;
-
-    int lineno = 0;
-    while (!mcsStream.eof() && !endRecordFound) {
-        lineno++;
-        std::string line;
-        std::getline(mcsStream, line);
-        if (line.size() == 0) {
-            continue;
-        }
-        if (line[0] != ':') {
-            return -EINVAL;
-        }
-        const unsigned int dataLen = std::stoi(line.substr(1, 2), 0 , 16);
-        const unsigned int address = std::stoi(line.substr(3, 4), 0, 16);
-        const unsigned int recordType = std::stoi(line.substr(7, 2), 0 , 16);
-        switch (recordType) {
-        case 0x00:
-        {
-            if (dataLen > 16) {
-                // For xilinx mcs files data length should be 16 for all records
-                // except for the last one which can be smaller
-                return -EINVAL;
-            }
-            if (address != (record.mDataCount+(record.mStartAddress & 0xFFFF))) {
-                if(record.mDataCount == 0) {
-                    //First entry only.
-                    assert(record.mStartAddress != 0);
-                    assert(record.mEndAddress != 0);
-                    record.mStartAddress += address;
-                    record.mEndAddress += address;
-                }else {
-                    std::cout << "Address is not contiguous ! " << std::endl;
-                    return -EINVAL;
-                }
-            }
-            //if ( ((record.mEndAddress-record.mStartAddress)& 0xFFFF) != address) {
-              //  return -EINVAL;
-            //}
-            record.mDataCount += dataLen;
-            record.mEndAddress += dataLen;
-            break;
-        }
-        case 0x01:
-        {
-            if (startAddress.size() == 0) {
-                break;
-            }
-            recordList.push_back(record);
-            endRecordFound = true;
-            break;
-        }
-        case 0x02:
-        {
-            assert(0);
-            break;
-        }
-        case 0x04:
-        {
-            if (address != 0x0) {
-                return -EINVAL;
-            }
-            if (dataLen != 2) {
-                return -EINVAL;
-            }
-            std::string newAddress = line.substr(9, dataLen * 2);
-            if (startAddress.size()) {
-                // Finish the old record
-                recordList.push_back(record);
-            }
-            // Start a new record
-            record.mStartAddress = std::stoi(newAddress, 0 , 16);
-            record.mStartAddress <<= 16;
-            record.mDataPos = mcsStream.tellg();
-            record.mEndAddress = record.mStartAddress;
-            record.mDataCount = 0;
-            startAddress = newAddress;
-        }
-        }
-    }
-
-    mcsStream.seekg(0);
-    std::cout << boost::format("%-8s : %s %s %s\n") % "INFO" % "Found" % recordList.size() % "ELA records";
-    return 0;
-}
-
 unsigned int XSPI_Flasher::readReg(unsigned int RegOffset)
 {
     unsigned int value = 0;
@@ -1539,207 +1447,49 @@ bool XSPI_Flasher::prepareXSpi(uint8_t slave_sel)
     return true;
 }
 
-int XSPI_Flasher::programRecord(std::istream& mcsStream, const ELARecord& record) {
-
-#if defined(_debug)
-    std::cout << "Programming block (" << std::hex << record.mStartAddress << ", " << record.mEndAddress << std::dec << ")" << std::endl;
-#endif
-
-    assert(mcsStream.tellg() < record.mDataPos);
-    mcsStream.seekg(record.mDataPos, std::ios_base::beg);
-    unsigned char* buffer = &WriteBuffer[READ_WRITE_EXTRA_BYTES];
-    int bufferIndex = 0;
-    int pageIndex = 0;
-    std::string prevLine("");
-    for (unsigned int index = record.mDataCount; index > 0;) {
-        std::string line;
-        std::getline(mcsStream, line);
-        if(TEST_MODE)
-            std::cout << line << std::endl;
-        const unsigned int dataLen = std::stoi(line.substr(1, 2), 0 , 16);
-        index -= dataLen;
-        const unsigned int recordType = std::stoi(line.substr(7, 2), 0 , 16);
-        if (recordType != 0x00) {
-            continue;
-        }
-        const std::string data = line.substr(9, dataLen * 2);
-        // Write in byte swapped order
-        for (unsigned int i = 0; i < data.length(); i += 2) {
-            unsigned int value = std::stoi(data.substr(i, 2), 0, 16);
-            buffer[bufferIndex++] = (unsigned char)value;
-            assert(bufferIndex <= WRITE_DATA_SIZE);
-
-#if 0
-            //To enable byte swapping uncomment this.
-            //      if ((bufferIndex % 4) == 0) {
-            //        bufferIndex += 4;
-            //      }
-            //      assert(bufferIndex <= WRITE_DATA_SIZE);
-            //      unsigned value = std::stoi(data.substr(i, 2), 0, 16);
-            //      if(TEST_MODE)
-            //        std::cout << data.substr(i, 2);
-            //      buffer[--bufferIndex] = (unsigned char)value;
-            //      if ((bufferIndex % 4) == 0) {
-            //        bufferIndex += 4;
-            //      }
-#endif
-            if (bufferIndex == WRITE_DATA_SIZE) {
-                break;
-            }
-        }
-
-        if(TEST_MODE)
-            std::cout << std::endl;
-
-#if 0
-        //Uncomment if byte swapping enabled.
-
-        //account for the last line
-        //which can have say 14 bytes instead of 16
-        if((bufferIndex %4)!= 0) {
-            while ((bufferIndex %4)!= 0) {
-                unsigned char fillValue = 0xFF;
-                buffer[--bufferIndex] = fillValue;
-            }
-            bufferIndex += 4;
-        }
-
-        assert((bufferIndex % 4) == 0);
-#endif
-
-        assert(bufferIndex <= WRITE_DATA_SIZE);
-        if (bufferIndex == WRITE_DATA_SIZE) {
-#if defined(_debug)
-            std::cout << "writing page " << pageIndex << std::endl;
-#endif
-            const unsigned int address = std::stoi(line.substr(3, 4), 0, 16);
-            if(TEST_MODE) {
-                std::cout << (address + dataLen) << " " << (pageIndex +1)*WRITE_DATA_SIZE << std::endl;
-                std::cout << record.mStartAddress << " " << record.mStartAddress + pageIndex*PAGE_SIZE;
-                std::cout << " " << address << std::endl;
-            } else {
-                if(!writePage(record.mStartAddress + pageIndex*WRITE_DATA_SIZE))
-                    return -ENXIO;
-                clearBuffers();
-                {
-                    //debug stuff
-#if defined(_debug)
-                    if(pageIndex == 0) {
-                        if(!readPage(record.mStartAddress + pageIndex*WRITE_DATA_SIZE))
-                            return -ENXIO;
-                        clearBuffers();
-                    }
-#endif
-                }
-            }
-            pageIndex++;
-            delay(std::chrono::microseconds(20));
-            bufferIndex = 0;
-        }
-        prevLine = line;
-
-    }
-    if (bufferIndex) {
-        //Write the last page
-        if(TEST_MODE) {
-            std::cout << "writing final page " << pageIndex << std::endl;
-            std::cout << bufferIndex << std::endl;
-            std::cout << prevLine << std::endl;
-        }
-
-        const unsigned int address = std::stoi(prevLine.substr(3, 4), 0, 16);
-        const unsigned int dataLen = std::stoi(prevLine.substr(1, 2), 0 , 16);
-
-        if(TEST_MODE)
-            std::cout << address % WRITE_DATA_SIZE << " " << dataLen << std::endl;
-
-        //assert( (address % WRITE_DATA_SIZE + dataLen) == bufferIndex);
-
-        if(!TEST_MODE) {
-
-            //Fill unused half page to FF
-            for(unsigned int i = bufferIndex; i < WRITE_DATA_SIZE; ++i) {
-                buffer[i] = 0xff;
-            }
-
-            if(!writePage(record.mStartAddress + pageIndex*WRITE_DATA_SIZE))
-                return -ENXIO;
-            delay(std::chrono::microseconds(20));
-            clearBuffers();
-            {
-                //debug stuff
-#if defined(_debug)
-                if(!readPage(record.mStartAddress + pageIndex*WRITE_DATA_SIZE))
-                    return -ENXIO;
-                clearBuffers();
-#endif
-            }
-        }
-    }
-    return 0;
-}
-
-int XSPI_Flasher::programXSpi(std::istream& mcsStream, uint32_t bitstream_shift_addr)
+int XSPI_Flasher::programXSpi(const mcsImage& image, uint32_t bitstream_shift_addr)
 {
-
-    //Now we can safely erase all subsectors
-    int beatCount = 0;
-    XBU::ProgressBar erase_flash("Erasing flash", static_cast<unsigned int>(recordList.size()), XBU::is_escape_codes_disabled(), std::cout);
-    for (ELARecordList::iterator i = recordList.begin(), e = recordList.end(); i != e; ++i) {
-        beatCount++;
-        // if(beatCount%20==0) {
-            erase_flash.update(beatCount);
-        // }
-
-        //Shift all write addresses below bitstream guard
-        i->mStartAddress += bitstream_shift_addr;
-        i->mEndAddress += bitstream_shift_addr;
-
-        //Erase any subsectors in address range.
-        for(uint32_t j = i->mStartAddress; j < i->mEndAddress; j+=0x1000) {
-            //std::cout << "DEBUG: Erasing subsector @ 0x" << std::hex << j << std::dec << std::endl;
-            if(!sectorErase(j, COMMAND_4KB_SUBSECTOR_ERASE)) {
-                // std::cout << "\nERROR: Failed to erase subsector!" << std::endl;
-                erase_flash.finish(false, "Failed to erase subsector!");
-                return -EINVAL;
-            }
-
-            delay(std::chrono::microseconds(20));
-        }
-    }
-    erase_flash.finish(true, "Flash erased");
-
-    //Next we program flash. Note that bitstream guard is still active
-    beatCount = 0;
-    XBU::ProgressBar program_flash("Programming flash", static_cast<unsigned int>(recordList.size()), XBU::is_escape_codes_disabled(), std::cout);
-    for (ELARecordList::iterator i = recordList.begin(), e = recordList.end(); i != e; ++i)
-    {
-        beatCount++;
-        // if(beatCount%20==0) {
-            program_flash.update(beatCount);
-        // }
-
-        if(TEST_MODE) {
-            std::cout << boost::format("%-8s : %s %x\n") % "INFO" % "Start address 0x" % recordList.front().mStartAddress;
-            std::cout << boost::format("%-8s : %s %x\n") % "INFO" % "End address 0x" % recordList.front().mEndAddress;
-        }
-
-        bool ready = isFlashReady();
-        if(!ready){
-            program_flash.finish(false, "Unable to get flash ready");
+    //Only 4KB subsectors that differ from the image are erased and
+    //programmed. Note that bitstream guard is still active
+    flashOps ops;
+    ops.sectorSize = 0x1000;
+    ops.pageSize = WRITE_DATA_SIZE;
+    ops.read = [this](uint32_t addr, unsigned char *buf, size_t len) {
+        clearBuffers();
+        if(!readPage(addr, COMMAND_RANDOM_READ))
+            return -ENXIO;
+        std::memcpy(buf, &ReadBuffer[READ_WRITE_EXTRA_BYTES], len);
+        return 0;
+    };
+    ops.erase = [this](uint32_t addr) {
+        if(!sectorErase(addr, COMMAND_4KB_SUBSECTOR_ERASE))
             return -EINVAL;
-        }
-
+        delay(std::chrono::microseconds(20));
+        return 0;
+    };
+    ops.program = [this](uint32_t addr, const unsigned char *buf, size_t len) {
         clearBuffers();
+        std::memcpy(&WriteBuffer[READ_WRITE_EXTRA_BYTES], buf, len);
+        if(!writePage(addr))
+            return -ENXIO;
+        delay(std::chrono::microseconds(20));
+        return 0;
+    };
 
-        if (programRecord(mcsStream, *i)) {
-            program_flash.finish(false, "Could not program the block");
-            return -EINVAL;
-        }
+    const auto numSectors = mcsSectors(image, bitstream_shift_addr, ops.sectorSize).size();
+    XBU::ProgressBar program_flash("Programming flash", static_cast<unsigned int>(numSectors), XBU::is_escape_codes_disabled(), std::cout);
+    ops.progress = [&program_flash](size_t done, size_t) {
+        program_flash.update(static_cast<unsigned int>(done));
+    };
 
-        delay(std::chrono::microseconds(20));
+    mcsProgramStats stats;
+    if (mcsProgram(image, bitstream_shift_addr, ops, stats)) {
+        program_flash.finish(false, "Could not program the flash");
+        return -EINVAL;
     }
     program_flash.finish(true, "Flash programmed");
+    std::cout << boost::format("%-8s : %s %s %s %s %s\n") % "INFO" % "Skipped" % stats.skipped % "of"
+        % stats.sectors % "unchanged subsectors";
     return 0;
 }
 
@@ -1989,210 +1739,39 @@ int XSPI_Flasher::revertToMFG(void)
     return 0;
 }
 
-static int splitMcsLine(std::string& line,
-    unsigned int& type, unsigned int& address, std::vector<unsigned char>& data)
-{
-    int ret = 0;
-
-    // Every line should start with ":"
-    if (line[0] != ':')
-        return -EINVAL;
-
-    unsigned int len = std::stoi(line.substr(1, 2), NULL , 16);
-    type = std::stoi(line.substr(7, 2), NULL , 16);
-    address = std::stoi(line.substr(3, 4), NULL, 16);
-    data.clear();
-
-    switch (type) {
-    case 0:
-        if (len > 16) {
-            // For xilinx mcs files data length should be 16 for all records
-            // except for the last one which can be smaller
-            ret = -EINVAL;
-        } else {
-            unsigned int l = len * 2;
-            std::string d = line.substr(9, len * 2);
-            for (unsigned int i = 0; i < l; i += 2)
-                data.push_back(static_cast<unsigned char>(std::stoi(d.substr(i, 2), NULL, 16)));
-        }
-        break;
-    case 1:
-        break;
-    case 4:
-        if (len != 2) {
-            // For xilinx mcs files extended address can only be 2 bytes
-            ret = -EINVAL;
-        }
-        address = std::stoi(line.substr(9, len * 2), NULL, 16);
-        break;
-    default:
-        // Xilinx mcs files should not contain other types
-        ret = -EINVAL;
-        break;
-    }
-
-    return ret;
-}
-
-static inline unsigned int pageOffset(unsigned int addr)
-{
-    return (addr & 0xffff);
-}
-
-static bool mcsStreamIsGolden(std::istream& mcsStream)
-{
-    std::string line;
-    unsigned int type = 0;
-    unsigned int addr = 0;
-    std::vector<unsigned char> data;
-
-    mcsStream.seekg(0, std::ios_base::beg);
-
-    // Try to find the first address in mcs stream
-    while (!mcsStream.eof() && type != 4) {
-        std::getline(mcsStream, line);
-        if (!line.empty())
-            splitMcsLine(line, type, addr, data);
-    }
-
-    mcsStream.seekg(0, std::ios_base::beg);
-    return addr == 0;
-}
-
-static int mcsStreamToBin(std::istream& mcsStream, unsigned int& currentAddr,
-    std::vector<unsigned char>& buf, unsigned int& nextAddr)
+static int programXSpiDrv(xrt_core::device *dev, std::FILE *mFlashDev, const mcsImage& image,
+    int index, uint32_t addressShift)
 {
-    bool done = false;
-    size_t cnt = 0;
-
-    buf.clear();
-
-    while (!mcsStream.eof() && !done) {
-        std::string line;
-        unsigned int type;
-        unsigned int addr;
-        std::vector<unsigned char> data;
-
-        std::getline(mcsStream, line);
-        if (line.size() == 0)
-            continue;
-
-        if (splitMcsLine(line, type, addr, data) != 0) {
-            std::cout << "Found invalid MCS line: " << line << std::endl;
-            return -EINVAL;
-        }
-
-        switch (type) {
-        case 0:
-            if (currentAddr == UINT_MAX) {
-                std::cout << "MCS missing page starting address" << std::endl;
-                return -EINVAL;
-            } else if (buf.size() == 0) {
-                // we're the 1st data in this page, updating the current addr
-                assert(pageOffset(currentAddr) == 0);
-                currentAddr |= addr;
-            } else if (pageOffset(currentAddr + static_cast<unsigned int>(buf.size())) != addr) {
-                std::cout << "MCS page offset is not contiguous, expecting 0x"
-                    << std::hex << pageOffset(currentAddr) + buf.size()
-                    << ", but, got 0x" << addr << std::dec << std::endl;
-                return -EINVAL;
-            }
-            // keep adding data to existing buffer
-            buf.insert(buf.end(), data.begin(), data.end());
-            cnt += data.size();
-            break;
-        case 1:
-            // end current buffer and no more
-            nextAddr = UINT_MAX;
-            done = true;
-            break;
-        case 4:
-            addr <<= 16;
-            if (currentAddr == UINT_MAX) {
-                currentAddr = addr; // addr of the very first page
-            } else if (currentAddr + buf.size() != addr) {
-                nextAddr = addr; // start new page
-                done = true;
-            }
-            // otherwise, continue to next page since page is still contiguous
-            break;
-        default:
-            assert(1); // shouldn't be here
-            break;
-        }
-
-        if (cnt >= pagesz) {
-            std::cout << "." << std::flush;
-            cnt = 0;
-        }
-    }
-    if (cnt) // print the last "."
+    // The driver erases as part of writing, so whole 4KB subsectors
+    // that differ from the image are written
+    flashOps ops;
+    ops.sectorSize = 0x1000;
+    ops.pageSize = 0x1000;
+    ops.read = [=](uint32_t addr, unsigned char *buf, size_t len) {
+        return readFromFlash(mFlashDev, index, addr, buf, len);
+    };
+    ops.program = [=](uint32_t addr, const unsigned char *buf, size_t len) {
+        return writeToFlash(mFlashDev, index, addr, buf, len);
+    };
+    // Print '.' for each pagesz bytes of flash as progress indicator
+    ops.progress = [&ops](size_t done, size_t) {
+        if ((done * ops.sectorSize) % pagesz == 0)
             std::cout << "." << std::flush;
-    std::cout << std::endl;
-
-    if (buf.size() > UINT_MAX) {
-        std::cout << "MCS bitstream is too large: 0x" << std::hex << buf.size()
-            << std::dec << " bytes" << std::endl;
-        return -EINVAL;
-    }
+    };
 
-    return 0;
-}
-
-static int writeBitstream(std::FILE *flashDev, int index, unsigned int addr,
-    std::vector<unsigned char>& buf)
-{
-    int ret = 0;
-    size_t len = 0;
-
-    // Write to flash page by page and print '.' for each write
-    // as progress indicator
-    for (size_t i = 0; ret == 0 && i < buf.size(); i += len) {
-        len = pagesz - ((addr + i) % pagesz);
-        len = std::min(len, buf.size() - i);
-
-        std::cout << "." << std::flush;
-        ret = writeToFlash(flashDev, index, addr + static_cast<unsigned int>(i), buf.data() + static_cast<unsigned int>(i), len);
-    }
+    std::cout << "Writing " << image.size() << " bytes of bitstream @0x"
+        << std::hex << image.startAddress() << std::dec << " to flash " << index << ":" << std::endl;
+    mcsProgramStats stats;
+    int ret = mcsProgram(image, addressShift, ops, stats);
     std::cout << std::endl;
-    return ret;
-}
-
-static int programXSpiDrv(xrt_core::device *dev, std::FILE *mFlashDev, std::istream& mcsStream,
-    int index, uint32_t addressShift)
-{
-    // Parse MCS data and write each contiguous chunk to flash.
-    std::vector<unsigned char> buf;
-    unsigned int curAddr = UINT_MAX;
-    unsigned int nextAddr = 0;
-    unsigned int startAddr = 0;
-    int ret;
-    bool store = true;
-
-    while (nextAddr != UINT_MAX) {
-        std::cout << "Extracting bitstream from MCS data:" << std::endl;
-        ret = mcsStreamToBin(mcsStream, curAddr, buf, nextAddr);
-        if (ret)
-            return ret;
-        assert(nextAddr == UINT_MAX || pageOffset(nextAddr) == 0);
-        std::cout << "Extracted " << buf.size() << " bytes from bitstream @0x"
-            << std::hex << curAddr << std::dec << std::endl;
-
-        if (store) {
-          startAddr = curAddr;
-          store = false;
-        }
-
-        std::cout << "Writing bitstream to flash " << index << ":" << std::endl;
-        ret = writeBitstream(mFlashDev, index, curAddr + addressShift, buf);
-        if (ret)
-            return ret;
-        curAddr = nextAddr;
-    }
+    if (ret)
+        return ret;
+    std::cout << "Skipped " << stats.skipped << " of " << stats.sectors
+        << " unchanged subsectors" << std::endl;
 
     // provide flash controller information to icap controller for webstar flow. Required only for U.2
     try {
-        xrt_core::device_update<xrt_core::query::ic_load_flash_address>(dev, startAddr);
+        xrt_core::device_update<xrt_core::query::ic_load_flash_address>(dev, image.startAddress());
         std::cout << "Successfully programmed flash address into icap controller ip" << std::endl;
     } catch (...) {}
 
@@ -2203,9 +1782,14 @@ int XSPI_Flasher::upgradeFirmware1Drv(std::istream& mcsStream, std::istream& str
 {
     int ret = 0;
     uint32_t bsGuardAddr;
+    mcsImage image;
+
+    ret = image.parse(mcsStream);
+    if (ret)
+        return ret;
 
-    if (mcsStreamIsGolden(mcsStream))
-        return programXSpiDrv(mDev.get(), mFlashDev, mcsStream, 0, 0);
+    if (image.isGolden())
+        return programXSpiDrv(mDev.get(), mFlashDev, image, 0, 0);
 
     ret = bitstreamGuardAddress(mDev.get(), bsGuardAddr);
     if (ret)
@@ -2228,7 +1812,7 @@ int XSPI_Flasher::upgradeFirmware1Drv(std::istream& mcsStream, std::istream& str
     }
 
     // Write MCS
-    ret = programXSpiDrv(mDev.get(), mFlashDev, mcsStream, 0, bitstreamGuardSize);
+    ret = programXSpiDrv(mDev.get(), mFlashDev, image, 0, bitstreamGuardSize);
     if (ret)
         return ret;
 
@@ -2241,12 +1825,20 @@ int XSPI_Flasher::upgradeFirmware2Drv(std::istream& mcsStream0,
 {
     int ret = 0;
     uint32_t bsGuardAddr = 0;
+    mcsImage image0, image1;
+
+    ret = image0.parse(mcsStream0);
+    if (ret)
+        return ret;
+    ret = image1.parse(mcsStream1);
+    if (ret)
+        return ret;
 
-    if (mcsStreamIsGolden(mcsStream0)) {
-        ret = programXSpiDrv(mDev.get(), mFlashDev, mcsStream0, 0, 0);
+    if (image0.isGolden()) {
+        ret = programXSpiDrv(mDev.get(), mFlashDev, image0, 0, 0);
         if (ret)
             return ret;
-        return programXSpiDrv(mDev.get(), mFlashDev, mcsStream1, 1, 0);
+        return programXSpiDrv(mDev.get(), mFlashDev, image1, 1, 0);
     }
 
     ret = bitstreamGuardAddress(mDev.get(), bsGuardAddr);
@@ -2270,10 +1862,10 @@ int XSPI_Flasher::upgradeFirmware2Drv(std::istream& mcsStream0,
     }
 
     // Write MCS
-    ret = programXSpiDrv(mDev.get(), mFlashDev, mcsStream0, 0, bitstreamGuardSize);
+    ret = programXSpiDrv(mDev.get(), mFlashDev, image0, 0, bitstreamGuardSize);
     if (ret)
         return ret;
-    ret = programXSpiDrv(mDev.get(), mFlashDev, mcsStream1, 1, bitstreamGuardSize);
+    ret = programXSpiDrv(mDev.get(), mFlashDev, image1, 1, bitstreamGuardSize);
     if (ret)
         return ret;
 
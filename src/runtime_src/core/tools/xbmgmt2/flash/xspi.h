@@ -17,26 +17,13 @@
 #ifndef _XSPI_H_
 #define _XSPI_H_
 
-#include <list>
 #include <iostream>
 #include "core/common/system.h"
 #include "core/common/device.h"
+#include "mcs_image.h"
 
 class XSPI_Flasher
 {
-  struct ELARecord
-  {
-    unsigned int mStartAddress;
-    unsigned int mEndAddress;
-    unsigned int mDataCount;
-    std::streampos mDataPos;
-
-    ELARecord() : mStartAddress(0), mEndAddress(0), mDataCount(0), mDataPos(0) {}
-  };
-
-  typedef std::list<ELARecord> ELARecordList;
-  ELARecordList recordList;
-
  public:
   XSPI_Flasher(std::shared_ptr<xrt_core::device> dev);
   ~XSPI_Flasher();
@@ -48,8 +35,6 @@ class XSPI_Flasher
   std::shared_ptr<xrt_core::device> mDev;
   std::FILE *mFlashDev = nullptr;
 
-  int parseMCS(std::istream& mcsStream);
-
   unsigned long long flash_base;
   int xclTestXSpi(int device_index);
   unsigned int readReg(unsigned int offset);
@@ -67,8 +52,7 @@ class XSPI_Flasher
   bool writePage(unsigned int addr, uint8_t writeCmd = 0xff);
   bool readPage(unsigned int addr, uint8_t readCmd = 0xff);
   bool prepareXSpi(uint8_t slave_sel);
-  int programRecord(std::istream& mcsStream, const ELARecord& record);
-  int programXSpi(std::istream& mcsStream, uint32_t bitstream_shift_addr);
+  int programXSpi(const mcsImage& image, uint32_t bitstream_shift_addr);
   bool readRegister(uint8_t commandCode, unsigned int bytes);
   bool writeRegister(uint8_t commandCode, unsigned int value, unsigned int bytes);
   bool setSector(unsigned int address);
@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Load time and memory of xclbin files
+//
+//  % xclbin_bench uncompressed.xclbin compressed.xclbin
+//  % xclbin_bench --iterations 10 a.xclbin
+//
+// Compare an xclbin with its compressed form, created with
+//  % xclbinutil -i a.xclbin --compress-section BITSTREAM -o compressed.xclbin
+//
+// Each iteration runs in a new process so that the peak resident set
+// size is that of a single load.  An iteration constructs xrt::xclbin
+// from the file, which reads the file and decompresses the metadata
+// sections used by xrt::xclbin, and then retrieves the axlf image as
+// given to drivers, which decompresses all sections.  No device is
+// needed.  The median of each measurement is reported.
+#include "core/include/experimental/xrt_xclbin.h"
+
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace po = boost::program_options;
+
+namespace {
+
+struct sample
+{
+  uint64_t construct_us = 0;   // xrt::xclbin construction
+  uint64_t axlf_us = 0;        // uncompressed axlf image for drivers
+  uint64_t maxrss_kb = 0;      // peak resident set size of the process
+};
+
+using clock_type = std::chrono::steady_clock;
+
+uint64_t
+elapsed_us(clock_type::time_point start)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - start).count();
+}
+
+// Runs in the child process, timings are written to fd
+[[noreturn]] void
+load(const std::string& file, int fd)
+{
+  int status = EXIT_FAILURE;
+  try {
+    sample smp;
+    auto start = clock_type::now();
+    xrt::xclbin xclbin{file};
+    smp.construct_us = elapsed_us(start);
+
+    start = clock_type::now();
+    auto top = xclbin.get_axlf();
+    smp.axlf_us = elapsed_us(start);
+    if (!top)
+      throw std::runtime_error("no axlf image");
+
+    if (::write(fd, &smp, sizeof(smp)) == sizeof(smp))
+      status = EXIT_SUCCESS;
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "xclbin_bench: " << file << ": " << ex.what() << "\n";
+  }
+  ::_exit(status);
+}
+
+sample
+run_once(const std::string& file)
+{
+  int fds[2];
+  if (::pipe(fds))
+    throw std::runtime_error(std::string("pipe: ") + std::strerror(errno));
+
+  auto pid = ::fork();
+  if (pid < 0)
+    throw std::runtime_error(std::string("fork: ") + std::strerror(errno));
+  if (pid == 0) {
+    ::close(fds[0]);
+    load(file, fds[1]);
+  }
+
+  ::close(fds[1]);
+  sample smp;
+  auto bytes = ::read(fds[0], &smp, sizeof(smp));
+  ::close(fds[0]);
+
+  int status = 0;
+  struct rusage usage = {};
+  if (::wait4(pid, &status, 0, &usage) < 0)
+    throw std::runtime_error(std::string("wait4: ") + std::strerror(errno));
+  if (!WIFEXITED(status) || WEXITSTATUS(status) || bytes != sizeof(smp))
+    throw std::runtime_error("failed to load " + file);
+
+  smp.maxrss_kb = usage.ru_maxrss;
+  return smp;
+}
+
+template <typename Field>
+uint64_t
+median(std::vector<sample> samples, Field field)
+{
+  std::sort(samples.begin(), samples.end(),
+            [field](const sample& a, const sample& b) { return a.*field < b.*field; });
+  return samples[samples.size() / 2].*field;
+}
+
+int
+run(int argc, char** argv)
+{
+  unsigned int iterations = 5;
+  std::vector<std::string> files;
+
+  po::options_description options("Options");
+  options.add_options()
+    ("help,h", "Print this help")
+    ("iterations,i", po::value<unsigned int>(&iterations), "Loads per xclbin, each in a new process (default 5)")
+    ("xclbin", po::value<std::vector<std::string>>(&files), "xclbin files to load")
+    ;
+  po::positional_options_description positional;
+  positional.add("xclbin", -1);
+
+  po::variables_map vm;
+  po::store(po::command_line_parser(argc, argv).options(options).positional(positional).run(), vm);
+  po::notify(vm);
+
+  if (vm.count("help") || files.empty()) {
+    std::cout << "Usage: " << argv[0] << " [options] <xclbin>...\n" << options;
+    return files.empty() && !vm.count("help") ? 1 : 0;
+  }
+
+  if (!iterations)
+    throw std::invalid_argument("iterations must be positive");
+
+  std::cout << boost::format("%-40s %12s %14s %12s %12s\n")
+    % "xclbin" % "file(KB)" % "construct(us)" % "axlf(us)" % "maxrss(KB)";
+
+  for (const auto& file : files) {
+    struct stat st = {};
+    if (::stat(file.c_str(), &st))
+      throw std::runtime_error("cannot access " + file);
+
+    std::vector<sample> samples;
+    for (unsigned int idx = 0; idx < iterations; ++idx)
+      samples.push_back(run_once(file));
+
+    std::cout << boost::format("%-40s %12d %14d %12d %12d\n")
+      % file % (st.st_size >> 10)
+      % median(samples, &sample::construct_us)
+      % median(samples, &sample::axlf_us)
+      % median(samples, &sample::maxrss_kb);
+  }
+
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  try {
+    return run(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "xclbin_bench: " << ex.what() << "\n";
+  }
+  return 1;
+}
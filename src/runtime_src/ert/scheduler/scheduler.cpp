@@ -241,6 +241,14 @@ static size_type cu_slot_usage[max_cus];
 // Fixed sized map from cu_idx -> number of times executed
 static size_type cu_usage[max_cus];
 
+// Fixed sized map from cu_idx -> slot_idx of the command for which
+// the CU is reserved, or no_index.  When a command is started on a
+// CU, the CU is reserved for the next queued command assigned to the
+// CU in slot order, or for the first command that later finds the CU
+// busy.  Commands waiting for the same CU thus get the CU in
+// round-robin order.
+static size_type cu_next_slot[max_cus];
+
 // Bitmask indicating status of CUs. (0) idle, (1) running.
 // Only 'num_cus' lower bits are used
 static bitset_type cu_status;
@@ -250,6 +258,23 @@ static bitset_type slot_submitted;
 
 // Bitmask for interrupt enabled CUs.  (0) no interrupt (1) enabled
 static bitset_type cu_interrupt_mask;
+
+// Bitmasks of slots that must be processed by the scheduler loop,
+// (1) the slot command is new, queued, or running and polled for
+// completion.  Free slots, and running slots completed by the CU
+// interrupt handler, are not active and cost nothing in the loop.
+// Only 'num_slot_masks' words are used.  Owned by the scheduler loop.
+static bitmask_type slot_active[4];
+
+// Bitmasks of slots transitioned to new by the command queue
+// interrupt handler.  Owned by the interrupt handler, merged
+// into slot_active by the scheduler loop with interrupts disabled.
+static volatile bitmask_type slot_isr_new[4];
+
+// Bitmasks of queued slots for which the CU interrupt handler has
+// released a reserved CU (see cu_next_slot).  Owned by the interrupt
+// handler, processed ahead of other slots by the scheduler loop.
+static volatile bitmask_type slot_isr_ready[4];
 #ifndef ERT_HW_EMU
 /**
  * Utility to read a 32 bit value from any axi-lite peripheral
@@ -377,6 +402,59 @@ idx_to_mask(size_type idx, size_type mask_idx)
     : 0;
 }
 
+/**
+ * slot_mask_valid() - Bitmask of valid slots in specified 32 bit mask
+ *
+ * @mask_idx: Index of bit mask determines range of mask (1=>[63,32])
+ * Return: 32 bit bitmask with bits set for slots less than num_slots
+ */
+inline bitmask_type
+slot_mask_valid(size_type mask_idx)
+{
+  auto slots = num_slots - (mask_idx<<5);
+  return slots >= 32 ? ~bitmask_type(0) : (bitmask_type(1) << slots) - 1;
+}
+
+inline void
+set_slot_active(size_type slot_idx)
+{
+  slot_active[slot_idx>>5] |= bitmask_type(1) << (slot_idx & 0x1F);
+}
+
+inline void
+clear_slot_active(size_type slot_idx)
+{
+  slot_active[slot_idx>>5] &= ~(bitmask_type(1) << (slot_idx & 0x1F));
+}
+
+inline bool
+is_slot_active(size_type slot_idx)
+{
+  return slot_active[slot_idx>>5] & (bitmask_type(1) << (slot_idx & 0x1F));
+}
+
+/**
+ * next_slot() - Find next slot to visit in scheduler loop
+ *
+ * @slot_idx: First slot to consider
+ * @poll: Visit all slots, not just active slots
+ * Return: Index of next slot to visit, or num_slots if none
+ */
+inline size_type
+next_slot(size_type slot_idx, bool poll)
+{
+  while (slot_idx < num_slots) {
+    auto w = slot_idx>>5;
+    auto mask = (poll ? slot_mask_valid(w) : slot_active[w]) & (~bitmask_type(0) << (slot_idx & 0x1F));
+    if (mask) {
+      size_type idx = (w<<5) + __builtin_ctz(mask);
+      return idx < num_slots ? idx : num_slots;
+    }
+    slot_idx = (w+1)<<5;
+  }
+  return num_slots;
+}
+
 // scope guard for disabling interrupts
 struct disable_interrupt_guard
 {
@@ -476,10 +554,16 @@ setup()
 
   cu_status.reset();
   slot_submitted.reset();
+  for (size_type w=0; w<4; ++w) {
+    slot_active[w] = 0;
+    slot_isr_new[w] = 0;
+    slot_isr_ready[w] = 0;
+  }
 
   // Initialize cu_slot_usage
   for (size_type i=0; i<num_cus; ++i) {
     cu_slot_usage[i] = no_index;
+    cu_next_slot[i] = no_index;
     cu_usage[i] = 0;
   }
 
@@ -698,6 +782,33 @@ configure_cu_dma(size_type cu_idx, size_type slot_idx, addr_type slot_addr)
   write_reg(CU_DMA_REGISTER_ADDR[mask_idx],idx_to_mask(slot_idx,mask_idx));
 }
 
+/**
+ * Find next queued command for a CU in round-robin order
+ *
+ * @param slot_idx
+ *  Index of command that was started on the CU
+ * @param cu_idx
+ *  Index of the CU
+ * @return
+ *  Index of first queued slot after slot_idx, wrapping around, that
+ *  is assigned to cu_idx, or no_index if none
+ */
+static inline size_type
+next_queued_slot(size_type slot_idx, size_type cu_idx)
+{
+  for (size_type i=1; i<num_slots; ++i) {
+    auto idx = slot_idx + i;
+    if (idx >= num_slots)
+      idx -= num_slots;
+    if (!is_slot_active(idx))
+      continue;
+    auto& slot = command_slots[idx];
+    if ((slot.header_value & 0xF) == 0x2 && slot.cu_idx == cu_idx)
+      return idx;
+  }
+  return no_index;
+}
+
 /**
  * Start a CU for command in slot
  *
@@ -708,16 +819,31 @@ configure_cu_dma(size_type cu_idx, size_type slot_idx, addr_type slot_addr)
  *  started (all were busy).
  *
  * Command is already assigned a CU by KDS.  This function checks
- * the current ERT status of that CU and starts it if it is unused.
+ * the current ERT status of that CU and starts it if it is unused
+ * and not reserved for another command (see cu_next_slot).
  */
 inline size_type
 start_cu(size_type slot_idx)
 {
   auto& slot = command_slots[slot_idx];
   auto cu_idx = slot.cu_idx;
+  auto& next_slot_idx = cu_next_slot[cu_idx];
 
-  if (cu_status[cu_idx])
+  if (cu_status[cu_idx]) {
+    if (next_slot_idx == no_index)
+      next_slot_idx = slot_idx;
     return no_index;
+  }
+
+  // CU is reserved for another queued command
+  if (next_slot_idx != no_index && next_slot_idx != slot_idx) {
+    auto& next = command_slots[next_slot_idx];
+    if ((next.header_value & 0xF) == 0x2 && next.cu_idx == cu_idx)
+      return no_index;
+  }
+
+  // reserve the CU for the next command waiting for it
+  next_slot_idx = next_queued_slot(slot_idx,cu_idx);
 
   ERT_DEBUGF("start_cu cu(%d) for slot_idx(%d)\n",cu_idx,slot_idx);
   ERT_ASSERT(read_reg(cu_idx_to_addr(cu_idx))==AP_IDLE,"cu not ready");
@@ -1151,10 +1277,10 @@ static inline void
 cu_state_check(size_type slot_idx)
 {
   auto& slot = command_slots[slot_idx];
-  auto cuvalue = read_reg(cu_idx_to_addr(slot.cu_idx));
 
   // check this CU if done
   if (cu_status[slot.cu_idx]) {
+    auto cuvalue = read_reg(cu_idx_to_addr(slot.cu_idx));
     if (cuvalue & (AP_DONE)) {
       auto cu_slot = cu_slot_usage[slot.cu_idx];
 
@@ -1186,113 +1312,298 @@ cu_execution(size_type slot_idx)
   }
 }
 /**
- * Main routine executed by embedded scheduler loop
+ * Merge slots transitioned to new by command queue interrupt handler
+ */
+static inline void
+merge_isr_new_slots()
+{
+  bitmask_type pending = 0;
+  for (size_type w=0; w<num_slot_masks; ++w)
+    pending |= slot_isr_new[w];
+
+  if (!pending)
+    return;
+
+  disable_interrupt_guard guard;
+  for (size_type w=0; w<num_slot_masks; ++w) {
+    slot_active[w] |= slot_isr_new[w];
+    slot_isr_new[w] = 0;
+  }
+}
+
+/**
+ * Release a CU completed by the CU interrupt handler
  *
- * For each command slot do
- *  1. If status is free (0x4), then read new command header
- *     Status remains free (0x4), or transitions to new (0x1)
- *  2. If status is new (0x1), then read CUs in command
- *     Status transitions to queued (0x2)
- *  3. If status is queued (0x2), then start command on available CU
- *     Status remains queued if no CUs available, or transitions to running (0x3)
- *  4. If status is running (0x4), then check CU status
- *     Status remains running (0x4) if CU is still running, or
- *     transitions to free if CU is done
+ * If a queued command has reserved the CU, then the command's slot
+ * is marked ready so that the scheduler loop starts the command on
+ * the CU right away rather than when the slot is next visited.
  */
-static void
-scheduler_loop()
+static inline void
+release_cu(size_type cu_idx)
 {
-  ERT_DEBUG("ERT scheduler\n");
+  cu_slot_usage[cu_idx] = no_index; // reset slot index
+  cu_status[cu_idx] = !cu_status[cu_idx]; // toggle status of completed cus
 
-  // Set up ERT base address, this should only call once
-  setup_ert_base_addr();
+  auto slot_idx = cu_next_slot[cu_idx];
+  if (slot_idx != no_index)
+    slot_isr_ready[slot_idx>>5] |= bitmask_type(1) << (slot_idx & 0x1F);
+}
 
-  // Basic setup will be changed by configure_mb, but is necessary
-  // for even configure_mb() to work.
-  setup();
+/**
+ * Transition an active slot through its states
+ *
+ * 1. If status is new (0x1), then read CUs in command
+ *    Status transitions to queued (0x2)
+ * 2. If status is queued (0x2), then start command on available CU
+ *    Status remains queued if no CUs available, or transitions to running (0x3)
+ * 3. If status is running (0x3), then check CU status
+ *    Status remains running (0x3) if CU is still running, or
+ *    transitions to free if CU is done
+ *
+ * The slot is deactivated when it is free, or when it is running
+ * and completion is handled by the CU interrupt handler.
+ */
+static inline void
+process_slot(size_type slot_idx)
+{
+  auto& slot = command_slots[slot_idx];
 
-  while (1) {
-    for (size_type slot_idx=0; slot_idx<num_slots; ++slot_idx) {
-      auto& slot = command_slots[slot_idx];
+  if ((slot.header_value & 0xF) == 0x1) { // new
+    if (!new_to_queued(slot_idx)) {
+      // special commands are processed directly
+      if ((slot.header_value & 0xF) == 0x4)
+        clear_slot_active(slot_idx);
+      return;
+    }
+  }
+
+  if ((slot.header_value & 0xF) == 0x2) { // queued
+    if (!queued_to_running(slot_idx))
+      return;
+  }
+
+  if ((slot.header_value & 0xF) == 0x3) { // running
+    if (cu_interrupt_enabled)
+      clear_slot_active(slot_idx);
+    else if (running_to_free(slot_idx))
+      clear_slot_active(slot_idx);
+    return;
+  }
+
+  if ((slot.header_value & 0xF) == 0x4) // free
+    clear_slot_active(slot_idx);
+}
+
+/**
+ * Process one pass over slots in dataflow mode
+ *
+ * In dataflow mode the slots map to CUs and are polled in order,
+ * see scheduler_loop.
+ */
+static inline void
+dataflow_loop()
+{
+  for (size_type slot_idx=0; slot_idx<num_slots; ++slot_idx) {
+    auto& slot = command_slots[slot_idx];
 
 #ifdef ERT_HW_EMU
-      reg_access_wait();
+    reg_access_wait();
 #endif
-      // In dataflow mode ERT is polling CUs for completion after
-      // host has started CU or acknowleged completion.  Ctrl cmds
-      // are processed in normal flow.
-      if (dataflow_enabled && slot_idx>0 && !kds_30) {
-        size_type cuidx = slot_idx-1;  // compensate for reserved slot (0)
-
-        // Check if host has started or continued this CU
-        if (!cu_status[cuidx]) {
-          auto cqvalue = read_reg(slot.slot_addr);
-          if (cqvalue & (AP_START|AP_CONTINUE)) {
-            write_reg(slot.slot_addr,0x0); // clear
-            ERT_DEBUGF("enable cu(%d) cqvalue(0x%x)\n",cuidx,cqvalue);
-            cu_status[cuidx] = !cu_status[cuidx]; // enable polling of this CU
-          }
+    // Ctrl cmds in slot (0) are processed in normal flow.
+    if (slot_idx==0) {
+      if (!cq_status_enabled && ((slot.header_value & 0xF) == 0x4)) { // free
+        if (!free_to_new(slot_idx))
+          continue;
+      }
+      process_slot(slot_idx);
+      continue;
+    }
+
+    // In dataflow mode ERT is polling CUs for completion after
+    // host has started CU or acknowleged completion.
+    if (!kds_30) {
+      size_type cuidx = slot_idx-1;  // compensate for reserved slot (0)
+
+      // Check if host has started or continued this CU
+      if (!cu_status[cuidx]) {
+        auto cqvalue = read_reg(slot.slot_addr);
+        if (cqvalue & (AP_START|AP_CONTINUE)) {
+          write_reg(slot.slot_addr,0x0); // clear
+          ERT_DEBUGF("enable cu(%d) cqvalue(0x%x)\n",cuidx,cqvalue);
+          cu_status[cuidx] = !cu_status[cuidx]; // enable polling of this CU
         }
+      }
 
-        if (!cu_status[cuidx])
-          continue; // CU is not used
-
-        /* For dataflow kernel, KDS and ERT will check the CUs from both sides.
-         * It's likely that ERT checks the CUs after the CUs are completed by KDS.
-         * So here ERT should check both AP_DONE and AP_IDLE bits or ERT will keep
-         * polling CU status register and never get AP_DONE. It may cause firewall
-         * tripped if we freeze the axi gate of the dynamic region.
-         *
-         * For some CUs have no cmd to execute but AP_IDLE remain 0x0
-         * We should turn off ert and let KDS be in charge of this alone
-         */
-        auto cuvalue = read_reg(cu_idx_to_addr(cuidx));
-        if (!(cuvalue & (AP_DONE|AP_IDLE)))
-          continue;
+      if (!cu_status[cuidx])
+        continue; // CU is not used
+
+      /* For dataflow kernel, KDS and ERT will check the CUs from both sides.
+       * It's likely that ERT checks the CUs after the CUs are completed by KDS.
+       * So here ERT should check both AP_DONE and AP_IDLE bits or ERT will keep
+       * polling CU status register and never get AP_DONE. It may cause firewall
+       * tripped if we freeze the axi gate of the dynamic region.
+       *
+       * For some CUs have no cmd to execute but AP_IDLE remain 0x0
+       * We should turn off ert and let KDS be in charge of this alone
+       */
+      auto cuvalue = read_reg(cu_idx_to_addr(cuidx));
+      if (!(cuvalue & (AP_DONE|AP_IDLE)))
+        continue;
 
-        cu_status[cuidx] = !cu_status[cuidx]; // disable polling until host re-enables
-        ERT_DEBUGF("polled cu(%d) cuvalue(0x%x)\n",cuidx,cuvalue);
+      cu_status[cuidx] = !cu_status[cuidx]; // disable polling until host re-enables
+      ERT_DEBUGF("polled cu(%d) cuvalue(0x%x)\n",cuidx,cuvalue);
 
-        // wake up host
-        notify_host(slot_idx);
+      // wake up host
+      notify_host(slot_idx);
+      continue;
+    }
+
+    if (!slot_cache[slot_idx])
+      command_queue_fetch(slot_idx);
+
+    // we have nothing else to do
+    if (!slot_cache[slot_idx])
+      continue;
+
+    cu_state_check(slot_idx);
+
+    cu_execution(slot_idx);
+  }
+}
+
+/**
+ * Process slots marked ready by the CU interrupt handler
+ *
+ * A ready slot holds a queued command that has reserved a CU which
+ * the interrupt handler just released.  Starting the command right
+ * away keeps the CU busy; the CU cannot be used by other commands
+ * until the reserving command is started.
+ *
+ * @return
+ *   Number of slots visited
+ */
+static inline size_type
+process_isr_ready_slots()
+{
+  size_type visited = 0;
+  for (size_type w=0,offset=0; w<num_slot_masks; ++w,offset+=32) {
+    if (!slot_isr_ready[w])
+      continue;
+
+    bitmask_type ready = 0;
+    {
+      disable_interrupt_guard guard;
+      ready = slot_isr_ready[w];
+      slot_isr_ready[w] = 0;
+    }
+
+    while (ready) {
+      size_type slot_idx = offset + __builtin_ctz(ready);
+      ready &= ready - 1;
+      if (slot_idx >= num_slots || !is_slot_active(slot_idx))
         continue;
-      }
+#ifdef ERT_HW_EMU
+      reg_access_wait();
+#endif
+      ++visited;
+      process_slot(slot_idx);
+    }
+  }
+  return visited;
+}
 
-      if (dataflow_enabled && slot_idx>0 && kds_30) {
-        if (!slot_cache[slot_idx])
-            command_queue_fetch(slot_idx);
+/**
+ * Process one pass over slots in slot order
+ *
+ * Active slots are processed per process_slot.  When the host does
+ * not interrupt MB with new commands, inactive slots are visited too
+ * and free slots are polled for a new command.  A slot that
+ * transitions to new is processed right away.  Running slots that
+ * are completed by the CU interrupt handler are inactive, but not
+ * free, and are skipped without accessing any registers.
+ *
+ * A busy CU is reserved for the next command waiting for it (see
+ * cu_next_slot), which bounds the time a queued command waits for
+ * its CU.  When the CU interrupt handler releases a reserved CU, the
+ * reserving slot is processed before the pass continues.
+ *
+ * @return
+ *   Number of slots visited
+ */
+static inline size_type
+process_slots()
+{
+  size_type visited = 0;
+  for (size_type slot_idx = 0; ; ++slot_idx) {
+    // Pick up new commands as soon as the interrupt handler has
+    // transitioned them, new slots ahead of slot_idx are processed
+    // in this pass
+    if (cq_status_enabled)
+      merge_isr_new_slots();
 
-        // we have nothing else to do
-        if (!slot_cache[slot_idx])
-          continue;
+    if (cu_interrupt_enabled)
+      visited += process_isr_ready_slots();
 
-        cu_state_check(slot_idx);
+    slot_idx = next_slot(slot_idx,!cq_status_enabled);
+    if (slot_idx >= num_slots)
+      break;
 
-        cu_execution(slot_idx);
-        
+#ifdef ERT_HW_EMU
+    reg_access_wait();
+#endif
+    ++visited;
+    if (!is_slot_active(slot_idx)) {
+      if ((command_slots[slot_idx].header_value & 0xF) != 0x4)
         continue;
-      }
+      if (!free_to_new(slot_idx))
+        continue;
+      set_slot_active(slot_idx);
+    }
 
-      if (!cq_status_enabled && ((slot.header_value & 0xF) == 0x4)) { // free
-        if (!free_to_new(slot_idx))
-          continue;
-      }
+    // processing a slot may reconfigure the scheduler (configure_mb),
+    // so next_slot re-reads the masks and features for each slot visited
+    process_slot(slot_idx);
+  }
+  return visited;
+}
 
-      if ((slot.header_value & 0xF) == 0x1) { // new
-        if (!new_to_queued(slot_idx))
-          continue;
-      }
+/**
+ * Main routine executed by embedded scheduler loop
+ *
+ * Each pass of the loop visits slots in order (see process_slots).
+ * Only active slots are visited unless free slots must be polled
+ * for new commands (0x4 -> 0x1).  If the host interrupts MB with
+ * new commands, then slots transitioned to new by the interrupt
+ * handler are made active as the pass proceeds.
+ *
+ * Idle slots cost nothing when the host interrupts MB with new
+ * commands.
+ */
+static void
+scheduler_loop()
+{
+  ERT_DEBUG("ERT scheduler\n");
 
-      if ((slot.header_value & 0xF) == 0x2) { // queued
-        if (!queued_to_running(slot_idx))
-          continue;
-      }
+  // Set up ERT base address, this should only call once
+  setup_ert_base_addr();
 
-      if (!cu_interrupt_enabled && ((slot.header_value & 0xF) == 0x3)) { // running
-        if (!running_to_free(slot_idx))
-          continue;
-      }
+  // Basic setup will be changed by configure_mb, but is necessary
+  // for even configure_mb() to work.
+  setup();
+
+  while (1) {
+    if (dataflow_enabled) {
+      dataflow_loop();
+      continue;
     }
+
+    ERT_UNUSED auto visited = process_slots();
+
+#ifdef ERT_HW_EMU
+    // all slots idle, wait for interrupts
+    if (!visited)
+      reg_access_wait();
+#endif
   } // while
 }
 
@@ -1317,8 +1628,7 @@ cu_interrupt_handler()
           ERT_ASSERT(cu_status[cu_idx],"cu wasn't started");
           // check if command is done
           check_command(cu_slot_usage[cu_idx],cu_idx);
-          cu_slot_usage[cu_idx] = no_index; // reset slot index
-          cu_status[cu_idx] = !cu_status[cu_idx]; // toggle status of completed cus
+          release_cu(cu_idx);
         }
       }
     }
@@ -1329,9 +1639,12 @@ cu_interrupt_handler()
       auto slot_mask = read_reg(CQ_STATUS_REGISTER_ADDR[w]);
       ERT_DEBUGF("command queue interrupt from host: 0x%x\n",slot_mask);
       // Transition each new command into new state
-      for (size_type slot_idx=offset; slot_mask; slot_mask >>= 1, ++slot_idx)
-        if (slot_mask & 0x1)
-          free_to_new(slot_idx);
+      while (slot_mask) {
+        size_type slot_idx = offset + __builtin_ctz(slot_mask);
+        slot_mask &= slot_mask - 1;
+        if (free_to_new(slot_idx))
+          slot_isr_new[w] |= bitmask_type(1) << (slot_idx - offset);
+      }
     }
   }
 
@@ -1340,8 +1653,7 @@ cu_interrupt_handler()
     ERT_DEBUGF("cdma cu(%d) interrupts\n",cu_idx);
     ERT_ASSERT(cu_status[cu_idx],"cdma cu wasn't started");
     check_command(cu_slot_usage[cu_idx],cu_idx);
-    cu_slot_usage[cu_idx] = no_index; // reset slot index;
-    cu_status[cu_idx] = !cu_status[cu_idx]; // toggle status of completed cus
+    release_cu(cu_idx);
 
     // Reset cdma (1) read status to clear it, (2) reset isr at base + 0xC
     ERT_UNUSED volatile auto val = read_reg(cu_idx_to_addr(cu_idx));
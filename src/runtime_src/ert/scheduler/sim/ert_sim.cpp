@@ -0,0 +1,430 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Memory backed register file and CU model for the embedded scheduler.
+// See ert_sim.h for details.
+#include "ert_sim.h"
+
+#include "core/include/ert.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+using addr_type = uint32_t;
+using value_type = uint32_t;
+
+// Entry points of scheduler.cpp when built for emulation
+extern "C" void scheduler_loop();
+extern "C" void cu_interrupt_handler();
+
+namespace {
+
+// Simulated CU address space, CUs are 64K apart
+const addr_type cu_base_address = 0x01000000;
+const uint32_t cu_offset = 16;
+
+// HLS control register bits (see scheduler.cpp)
+const value_type AP_START = 0x1;
+const value_type AP_DONE  = 0x2;
+const value_type AP_IDLE  = 0x4;
+
+// Thrown from reg_access_wait() to break out of scheduler_loop()
+struct stop_simulation {};
+
+struct cu_model
+{
+  bool running = false;
+  bool done = false;
+  uint64_t done_tick = 0;
+};
+
+class simulator
+{
+  const ert::sim::config& m_cfg;
+  ert::sim::result& m_result;
+
+  uint32_t m_slot_size;
+  std::vector<value_type> m_cq;                       // command queue words
+  std::unordered_map<addr_type, value_type> m_regs;   // CSRs and others
+  std::vector<cu_model> m_cus;
+
+  uint64_t m_tick = 0;
+  uint64_t m_start_tick = 0;
+  bool m_configure_submitted = false;
+  bool m_configured = false;
+  bool m_stop = false;
+
+  // Interrupt controller and status registers, clear on read
+  bool m_mb_interrupts = false;
+  value_type m_ipr = 0;
+  value_type m_cq_status[4] = {0};
+  value_type m_cu_status[4] = {0};
+
+  // Host side view of command queue
+  std::vector<uint32_t> m_free_slots;
+  std::vector<uint64_t> m_submit_tick;
+  uint64_t m_submitted = 0;
+  uint32_t m_next_cu = 0;
+
+  std::chrono::steady_clock::time_point m_start_time;
+
+  size_t
+  cq_index(addr_type addr) const
+  {
+    return (addr - ERT_CQ_BASE_ADDR) / sizeof(value_type);
+  }
+
+  bool
+  is_cq(addr_type addr) const
+  {
+    return addr >= ERT_CQ_BASE_ADDR && addr < ERT_CQ_BASE_ADDR + ERT_CQ_SIZE;
+  }
+
+  bool
+  is_cu(addr_type addr) const
+  {
+    return addr >= cu_base_address
+      && ((addr - cu_base_address) >> cu_offset) < m_cus.size();
+  }
+
+  size_t
+  slot_word(uint32_t slot_idx) const
+  {
+    return slot_idx * m_slot_size / sizeof(value_type);
+  }
+
+  // Write CONFIGURE_MB to slot 0 per the scheduler's default slot size
+  // Host interrupts MB with new command if scheduler enabled CQ
+  // status.  Note that scheduler state is static and may carry
+  // CQ status enabled from a previous run into the configure command
+  void
+  notify_slot(uint32_t slot_idx)
+  {
+    if (!m_regs[ERT_CQ_STATUS_ENABLE_ADDR])
+      return;
+    m_cq_status[slot_idx >> 5] |= 1u << (slot_idx & 0x1F);
+    m_ipr |= 0x1;
+  }
+
+  void
+  submit_configure()
+  {
+    auto idx = slot_word(0);
+    auto cq = &m_cq[idx];
+    cq[1] = m_slot_size;
+    cq[2] = static_cast<value_type>(m_cus.size());
+    cq[3] = cu_offset;
+    cq[4] = cu_base_address;
+    cq[5] = 0x1 | 0x2;  // ert enabled, no mb->host interrupts
+    if (m_cfg.cu_interrupt)
+      cq[5] |= 0x8;
+    if (m_cfg.cq_interrupt)
+      cq[5] |= 0x10;
+    for (size_t cu = 0; cu < m_cus.size(); ++cu)
+      cq[6 + cu] = cu_base_address + (static_cast<addr_type>(cu) << cu_offset);
+
+    value_type count = 5 + static_cast<value_type>(m_cus.size());
+    cq[0] = ERT_CMD_STATE_NEW | (count << 12) | (ERT_CONFIGURE << 23) | (ERT_CTRL << 28);
+    notify_slot(0);
+  }
+
+  void
+  submit_command(uint32_t slot_idx)
+  {
+    auto cq = &m_cq[slot_word(slot_idx)];
+    cq[1] = m_next_cu;   // cu index assigned by host
+    for (uint32_t i = 0; i < m_cfg.regmap_size; ++i)
+      cq[2 + i] = (i < 4) ? 0 : static_cast<value_type>(m_submitted + i);
+
+    value_type count = 1 + m_cfg.regmap_size;
+    cq[0] = ERT_CMD_STATE_NEW | (count << 12) | (ERT_START_CU << 23) | (ERT_CU << 28);
+
+    notify_slot(slot_idx);
+
+    m_submit_tick[slot_idx] = m_tick;
+    ++m_submitted;
+    m_next_cu = (m_next_cu + 1) % m_cus.size();
+  }
+
+  void
+  complete(uint32_t slot_idx)
+  {
+    if (!m_configured) {
+      if (slot_idx != 0)
+        throw std::runtime_error("unexpected completion before configure");
+      m_configured = true;
+      m_start_tick = m_tick;
+      m_result.reg_reads = 0;
+      m_result.reg_writes = 0;
+      m_start_time = std::chrono::steady_clock::now();
+
+      // Scheduler reinitialized the command queue, all slots are free
+      m_free_slots.clear();
+      for (uint32_t idx = m_cfg.num_slots; idx-- > 0;)
+        m_free_slots.push_back(idx);
+      return;
+    }
+
+    if (slot_idx >= m_cfg.num_slots)
+      throw std::runtime_error("completion for invalid slot " + std::to_string(slot_idx));
+
+    auto latency = m_tick - m_submit_tick[slot_idx];
+    m_result.latency_sum += latency;
+    m_result.latency_max = std::max(m_result.latency_max, latency);
+    m_result.latency_min = m_result.completed
+      ? std::min(m_result.latency_min, latency)
+      : latency;
+    m_free_slots.push_back(slot_idx);
+
+    if (++m_result.completed == m_cfg.num_commands)
+      m_stop = true;
+  }
+
+  void
+  finish()
+  {
+    auto end = std::chrono::steady_clock::now();
+    m_result.ticks = m_tick - m_start_tick;
+    m_result.seconds = std::chrono::duration<double>(end - m_start_time).count();
+  }
+
+public:
+  simulator(const ert::sim::config& cfg, ert::sim::result& result)
+    : m_cfg(cfg)
+    , m_result(result)
+    , m_slot_size(ERT_CQ_SIZE / cfg.num_slots)
+    , m_cq(ERT_CQ_SIZE / sizeof(value_type), 0)
+    , m_cus(cfg.num_cus)
+    , m_submit_tick(cfg.num_slots, 0)
+  {
+    if (cfg.num_slots < 2 || cfg.num_slots > 128 || (cfg.num_slots & (cfg.num_slots - 1)))
+      throw std::invalid_argument("num_slots must be a power of 2 in range [2,128]");
+    if (cfg.num_cus < 1 || cfg.num_cus > 128)
+      throw std::invalid_argument("num_cus must be in range [1,128]");
+    if (cfg.regmap_size < 4 || 2 + cfg.regmap_size > m_slot_size / sizeof(value_type))
+      throw std::invalid_argument("regmap_size does not fit in command slot");
+
+    m_result.cus.resize(cfg.num_cus);
+  }
+
+  value_type
+  read(addr_type addr)
+  {
+    ++m_result.reg_reads;
+
+    if (is_cq(addr))
+      return m_cq[cq_index(addr)];
+
+    if (is_cu(addr)) {
+      auto off = (addr - cu_base_address) & ((1 << cu_offset) - 1);
+      if (off)
+        return m_regs[addr];
+      auto& cu = m_cus[(addr - cu_base_address) >> cu_offset];
+      if (cu.done) {
+        cu.done = false;  // AP_DONE is clear on read
+        return AP_DONE | AP_IDLE;
+      }
+      return cu.running ? 0 : AP_IDLE;
+    }
+
+    if (addr >= ERT_CQ_STATUS_REGISTER_ADDR0 && addr <= ERT_CQ_STATUS_REGISTER_ADDR3) {
+      auto& status = m_cq_status[(addr - ERT_CQ_STATUS_REGISTER_ADDR0) / sizeof(value_type)];
+      auto val = status;
+      status = 0;
+      return val;
+    }
+
+    if (addr >= ERT_CU_STATUS_REGISTER_ADDR0 && addr <= ERT_CU_STATUS_REGISTER_ADDR3) {
+      auto& status = m_cu_status[(addr - ERT_CU_STATUS_REGISTER_ADDR0) / sizeof(value_type)];
+      auto val = status;
+      status = 0;
+      return val;
+    }
+
+    if (addr == ERT_INTC_IPR_ADDR)
+      return m_ipr;
+
+    return m_regs[addr];
+  }
+
+  void
+  write(addr_type addr, value_type val)
+  {
+    ++m_result.reg_writes;
+
+    if (is_cq(addr)) {
+      m_cq[cq_index(addr)] = val;
+      return;
+    }
+
+    if (is_cu(addr)) {
+      auto cu_idx = (addr - cu_base_address) >> cu_offset;
+      auto off = (addr - cu_base_address) & ((1 << cu_offset) - 1);
+      if (off || !(val & AP_START)) {
+        m_regs[addr] = val;
+        return;
+      }
+
+      auto& cu = m_cus[cu_idx];
+      if (cu.running)
+        throw std::runtime_error("cu " + std::to_string(cu_idx) + " started while running");
+      cu.running = true;
+      cu.done = false;
+      cu.done_tick = m_tick + m_cfg.cu_latency;
+      ++m_result.cus[cu_idx].executions;
+      return;
+    }
+
+    if (addr >= ERT_STATUS_REGISTER_ADDR0 && addr <= ERT_STATUS_REGISTER_ADDR3) {
+      // MB notifies host of completed slots
+      uint32_t offset = (addr - ERT_STATUS_REGISTER_ADDR0) / sizeof(value_type) * 32;
+      for (uint32_t bit = 0; val; ++bit, val >>= 1)
+        if (val & 0x1)
+          complete(offset + bit);
+      return;
+    }
+
+    if (addr == ERT_INTC_IAR_ADDR) {
+      m_ipr &= ~val;
+      return;
+    }
+
+    m_regs[addr] = val;
+  }
+
+  void
+  enable_interrupts(bool enable)
+  {
+    m_mb_interrupts = enable;
+  }
+
+  // Advance simulated hardware and host by one tick
+  void
+  tick()
+  {
+    ++m_tick;
+
+    for (size_t idx = 0; idx < m_cus.size(); ++idx) {
+      auto& cu = m_cus[idx];
+      if (cu.running && m_tick >= cu.done_tick) {
+        cu.running = false;
+        cu.done = true;
+        m_result.cus[idx].busy_ticks += m_cfg.cu_latency;
+
+        // CU ISR hardware acknowledges the CU and records completion
+        auto ier = cu_base_address + (static_cast<addr_type>(idx) << cu_offset) + 0x8;
+        if (m_regs[ERT_CU_ISR_HANDLER_ENABLE_ADDR] && m_regs[ier]) {
+          cu.done = false;
+          m_cu_status[idx >> 5] |= 1u << (idx & 0x1F);
+          m_ipr |= 0x2;
+        }
+      }
+    }
+
+    // The scheduler clears the command queue before entering its
+    // loop, so CONFIGURE_MB is written on the first slot visit
+    if (!m_configure_submitted) {
+      submit_configure();
+      m_configure_submitted = true;
+    }
+
+    if (m_configured) {
+      while (!m_free_slots.empty() && m_submitted < m_cfg.num_commands) {
+        submit_command(m_free_slots.back());
+        m_free_slots.pop_back();
+      }
+    }
+
+    if (m_mb_interrupts && (m_regs[ERT_INTC_MER_ADDR] & 0x1) && (m_ipr & m_regs[ERT_INTC_IER_ADDR]))
+      cu_interrupt_handler();
+
+    if (m_cfg.max_ticks && m_tick - m_start_tick > m_cfg.max_ticks) {
+      m_result.timeout = true;
+      m_stop = true;
+    }
+
+    if (m_stop) {
+      finish();
+      throw stop_simulation();
+    }
+  }
+};
+
+simulator* s_simulator = nullptr;
+
+} // namespace
+
+////////////////////////////////////////////////////////////////
+// Hardware access functions required by scheduler.cpp
+////////////////////////////////////////////////////////////////
+value_type
+read_reg(addr_type addr)
+{
+  return s_simulator->read(addr);
+}
+
+void
+write_reg(addr_type addr, value_type val)
+{
+  s_simulator->write(addr, val);
+}
+
+void
+microblaze_enable_interrupts()
+{
+  s_simulator->enable_interrupts(true);
+}
+
+void
+microblaze_disable_interrupts()
+{
+  s_simulator->enable_interrupts(false);
+}
+
+void
+reg_access_wait()
+{
+  s_simulator->tick();
+}
+
+namespace ert { namespace sim {
+
+double
+result::
+cu_utilization() const
+{
+  if (!ticks || cus.empty())
+    return 0.0;
+
+  uint64_t busy = 0;
+  for (auto& cu : cus)
+    busy += cu.busy_ticks;
+  return static_cast<double>(busy) / (static_cast<double>(ticks) * cus.size());
+}
+
+result
+run(const config& cfg)
+{
+  result res;
+  simulator sim(cfg, res);
+  s_simulator = &sim;
+
+  try {
+    scheduler_loop();
+  }
+  catch (const stop_simulation&) {
+  }
+  catch (...) {
+    s_simulator = nullptr;
+    throw;
+  }
+
+  s_simulator = nullptr;
+  return res;
+}
+
+}} // sim, ert
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef ert_scheduler_sim_ert_sim_h_
+#define ert_scheduler_sim_ert_sim_h_
+
+// Host side simulator for the embedded scheduler
+//
+// The simulator links scheduler.cpp (built with ERT_HW_EMU) against
+// a memory backed register file.  The register file
+// models the command queue, the ERT CSRs, and a set of compute units
+// that complete a configurable number of ticks after being started.
+//
+// A tick is one call to reg_access_wait(), which the scheduler loop
+// makes once per visited command queue slot, or once per pass if no
+// slot is visited.  Host and CU models
+// advance on each tick, so all measurements are deterministic and
+// independent of the speed of the machine running the simulation.
+// Interrupts are delivered to cu_interrupt_handler() between ticks.
+
+#include <cstdint>
+#include <vector>
+
+namespace ert { namespace sim {
+
+/**
+ * struct config - simulation parameters
+ *
+ * @num_slots:     number of command queue slots, must be a power of 2
+ *                 between 2 and 128 (slot size is ERT_CQ_SIZE/num_slots)
+ * @num_cus:       number of simulated compute units, max 128
+ * @cu_latency:    number of ticks a CU runs before it is done
+ * @num_commands:  number of start CU commands the host submits
+ * @regmap_size:   size of CU register map in 32 bit words (incl. 4 ctrl words)
+ * @max_ticks:     abort simulation after this many ticks (0 for no limit)
+ * @cq_interrupt:  host interrupts MB with new commands (CQ status registers)
+ * @cu_interrupt:  CU completion is signalled by interrupt (CU status registers)
+ */
+struct config
+{
+  uint32_t num_slots = 16;
+  uint32_t num_cus = 3;
+  uint32_t cu_latency = 64;
+  uint64_t num_commands = 1000;
+  uint32_t regmap_size = 8;
+  uint64_t max_ticks = 0;
+  bool cq_interrupt = false;
+  bool cu_interrupt = false;
+};
+
+/**
+ * struct cu_stats - per CU measurements
+ *
+ * @executions:  number of commands executed by the CU
+ * @busy_ticks:  number of ticks the CU was running
+ */
+struct cu_stats
+{
+  uint64_t executions = 0;
+  uint64_t busy_ticks = 0;
+};
+
+/**
+ * struct result - simulation measurements
+ *
+ * @completed:      number of commands completed by the scheduler
+ * @ticks:          total ticks (slot visits) until last completion
+ * @reg_reads:      register reads issued by scheduler
+ * @reg_writes:     register writes issued by scheduler
+ * @latency_min:    min ticks from host submit to completion notification
+ * @latency_max:    max ticks from host submit to completion notification
+ * @latency_sum:    sum of ticks from submit to completion, all commands
+ * @seconds:        wall clock time of the simulation
+ * @timeout:        true if simulation was aborted per max_ticks
+ * @cus:            per CU measurements
+ */
+struct result
+{
+  uint64_t completed = 0;
+  uint64_t ticks = 0;
+  uint64_t reg_reads = 0;
+  uint64_t reg_writes = 0;
+  uint64_t latency_min = 0;
+  uint64_t latency_max = 0;
+  uint64_t latency_sum = 0;
+  double seconds = 0.0;
+  bool timeout = false;
+  std::vector<cu_stats> cus;
+
+  // Average number of register reads per completed command
+  double
+  reads_per_command() const
+  {
+    return completed ? static_cast<double>(reg_reads) / completed : 0.0;
+  }
+
+  // Fraction of ticks CUs were busy, averaged over all CUs
+  double
+  cu_utilization() const;
+};
+
+/**
+ * run() - Run the scheduler loop against simulated hardware
+ *
+ * @cfg: Simulation parameters
+ * Return: Measurements collected during the simulation
+ *
+ * The function configures the scheduler through a CONFIGURE_MB
+ * command and then submits cfg.num_commands start CU commands
+ * round robin to the CUs.  The function returns when all commands
+ * have completed or max_ticks has been reached.
+ *
+ * The scheduler uses static state, so run() is not reentrant.
+ */
+result
+run(const config& cfg);
+
+}} // sim, ert
+
+#endif
@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Benchmark harness for the embedded scheduler running against the
+// host side simulator.
+//
+// % ert_sim_bench [--slots n,n,...] [--cus n,n,...] [--commands n]
+//                 [--latency n] [--regmap n] [--max-ticks n]
+//                 [--max-latency-ratio r] [--cq-interrupt] [--cu-interrupt]
+//
+// For each combination of slots and cus, the harness runs the
+// scheduler until all commands complete and reports register reads,
+// command latency, CU utilization and throughput.  The program
+// returns non zero if any simulation fails to complete all commands,
+// or if the max command latency exceeds the specified ratio of the
+// round-robin latency (slots per CU times CU latency), which makes it
+// usable as a regression test for throughput and fairness.
+#include "ert_sim.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+static void
+usage()
+{
+  std::cout << "usage: ert_sim_bench [options]\n"
+            << " [--slots <n,...>]    number of command queue slots (default 16,32,64,128)\n"
+            << " [--cus <n,...>]      number of compute units (default 1,4,16,64)\n"
+            << " [--commands <n>]     number of commands per run (default 10000)\n"
+            << " [--latency <n>]      CU execution time in ticks (default 64)\n"
+            << " [--regmap <n>]       CU register map size in words (default 8)\n"
+            << " [--max-ticks <n>]    abort a run after this many ticks (default 0, no limit)\n"
+            << " [--max-latency-ratio <r>]\n"
+            << "                      fail if max latency exceeds r times slots/cus*latency (default 0, no limit)\n"
+            << " [--cq-interrupt]     host interrupts MB with new commands\n"
+            << " [--cu-interrupt]     CUs interrupt MB on completion\n";
+}
+
+static std::vector<uint32_t>
+to_list(const std::string& str)
+{
+  std::vector<uint32_t> list;
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, ','))
+    list.push_back(std::stoul(item));
+  return list;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::vector<uint32_t> slots = {16, 32, 64, 128};
+  std::vector<uint32_t> cus = {1, 4, 16, 64};
+  ert::sim::config cfg;
+  cfg.num_commands = 10000;
+  double max_latency_ratio = 0.0;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  for (size_t i = 0; i < args.size(); ++i) {
+    const auto& arg = args[i];
+    if (arg == "--help" || arg == "-h") {
+      usage();
+      return 0;
+    }
+    if (arg == "--cq-interrupt") {
+      cfg.cq_interrupt = true;
+      continue;
+    }
+    if (arg == "--cu-interrupt") {
+      cfg.cu_interrupt = true;
+      continue;
+    }
+    if (i + 1 == args.size())
+      throw std::runtime_error("missing value for option: " + arg);
+
+    const auto& val = args[++i];
+    if (arg == "--slots")
+      slots = to_list(val);
+    else if (arg == "--cus")
+      cus = to_list(val);
+    else if (arg == "--commands")
+      cfg.num_commands = std::stoull(val);
+    else if (arg == "--latency")
+      cfg.cu_latency = std::stoul(val);
+    else if (arg == "--regmap")
+      cfg.regmap_size = std::stoul(val);
+    else if (arg == "--max-ticks")
+      cfg.max_ticks = std::stoull(val);
+    else if (arg == "--max-latency-ratio")
+      max_latency_ratio = std::stod(val);
+    else
+      throw std::runtime_error("unknown option: " + arg);
+  }
+
+  std::cout << std::left
+            << std::setw(7) << "slots" << std::setw(6) << "cus"
+            << std::setw(10) << "commands" << std::setw(12) << "ticks"
+            << std::setw(12) << "reads/cmd" << std::setw(12) << "lat(avg)"
+            << std::setw(10) << "lat(max)" << std::setw(9) << "cu-util"
+            << std::setw(14) << "cmds/ktick" << "cmds/sec\n";
+
+  int errors = 0;
+  for (auto num_slots : slots) {
+    for (auto num_cus : cus) {
+      cfg.num_slots = num_slots;
+      cfg.num_cus = num_cus;
+      auto res = ert::sim::run(cfg);
+
+      auto lat_avg = res.completed ? static_cast<double>(res.latency_sum) / res.completed : 0.0;
+      auto per_ktick = res.ticks ? 1000.0 * res.completed / res.ticks : 0.0;
+      auto per_sec = res.seconds > 0.0 ? res.completed / res.seconds : 0.0;
+
+      std::cout << std::fixed << std::setprecision(2)
+                << std::setw(7) << num_slots << std::setw(6) << num_cus
+                << std::setw(10) << res.completed << std::setw(12) << res.ticks
+                << std::setw(12) << res.reads_per_command() << std::setw(12) << lat_avg
+                << std::setw(10) << res.latency_max << std::setw(9) << res.cu_utilization()
+                << std::setw(14) << per_ktick << std::setprecision(0) << per_sec
+                << (res.timeout ? "  (timeout)" : "") << "\n";
+
+      if (res.timeout || res.completed != cfg.num_commands)
+        ++errors;
+
+      // A queued command should wait for at most the commands queued
+      // ahead of it for the same CU
+      auto rr_latency = static_cast<double>((num_slots + num_cus - 1) / num_cus) * cfg.cu_latency;
+      if (max_latency_ratio > 0.0 && res.latency_max > max_latency_ratio * rr_latency) {
+        std::cout << "max latency " << res.latency_max << " exceeds "
+                  << max_latency_ratio << " x " << rr_latency << " ticks\n";
+        ++errors;
+      }
+
+      uint64_t executions = 0;
+      for (auto& cu : res.cus)
+        executions += cu.executions;
+      if (executions != res.completed)
+        ++errors;
+    }
+  }
+
+  return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  try {
+    return run(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "ert_sim_bench: " << ex.what() << "\n";
+  }
+  return EXIT_FAILURE;
+}
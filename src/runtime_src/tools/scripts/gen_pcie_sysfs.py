@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+
+# SPDX-License-Identifier: Apache-2.0
+# Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#
+# Generate a synthetic sysfs and devfs tree of Alveo cards for the
+# PCIe Linux shim, so device scan, queries, reports, and sensor
+# sampling can be exercised and benchmarked without hardware.
+#
+#   % gen_pcie_sysfs.py --root /tmp/xrt-root --cards 16
+#   % XRT_SYSFS_ROOT=/tmp/xrt-root/sys XRT_DEVFS_ROOT=/tmp/xrt-root/dev \
+#       xbutil examine
+#
+# Each card has a management function (.0, driven by xclmgmt) and a
+# user function (.1, driven by xocl) with the rom, xmc, icap and
+# firewall subdevices and the attributes read by device_linux.cpp.
+# Device nodes under dev are plain files; anything that needs an
+# ioctl or a BAR mapping fails as it would on a card without the
+# driver loaded.
+
+import argparse
+import os
+import random
+import shutil
+import sys
+import uuid
+
+VBNV = "xilinx_u250_gen3x16_xdma_shell_4_1"
+FPGA = "xcu250-figd2104-2L-e"
+
+# xmc sensors and the range of values they report
+XMC_SENSORS = {
+    "xmc_12v_aux_curr":  (900, 1500),
+    "xmc_12v_aux_vol":   (12000, 12200),
+    "xmc_12v_pex_curr":  (1500, 3000),
+    "xmc_12v_pex_vol":   (12000, 12200),
+    "xmc_3v3_pex_curr":  (200, 400),
+    "xmc_3v3_pex_vol":   (3280, 3320),
+    "xmc_3v3_aux_vol":   (3280, 3320),
+    "xmc_3v3_aux_cur":   (10, 40),
+    "xmc_vccint_curr":   (5000, 12000),
+    "xmc_vccint_vol":    (845, 855),
+    "xmc_vccint_temp":   (40, 70),
+    "xmc_ddr_vpp_btm":   (2490, 2510),
+    "xmc_ddr_vpp_top":   (2490, 2510),
+    "xmc_sys_5v5":       (5450, 5550),
+    "xmc_1v2_top":       (1195, 1205),
+    "xmc_vcc1v2_btm":    (1195, 1205),
+    "xmc_1v8":           (1795, 1805),
+    "xmc_0v85":          (845, 855),
+    "xmc_mgt0v9avcc":    (895, 905),
+    "xmc_12v_sw":        (12000, 12200),
+    "xmc_mgtavtt":       (1195, 1205),
+    "xmc_se98_temp0":    (30, 50),
+    "xmc_se98_temp1":    (30, 50),
+    "xmc_se98_temp2":    (30, 50),
+    "xmc_fpga_temp":     (40, 75),
+    "xmc_fan_temp":      (30, 50),
+    "xmc_fan_rpm":       (2000, 4000),
+    "xmc_dimm_temp0":    (35, 55),
+    "xmc_dimm_temp1":    (35, 55),
+    "xmc_dimm_temp2":    (35, 55),
+    "xmc_dimm_temp3":    (35, 55),
+    "xmc_ddr_temp0":     (35, 55),
+    "xmc_ddr_temp1":     (35, 55),
+    "xmc_ddr_temp2":     (35, 55),
+    "xmc_ddr_temp3":     (35, 55),
+    "xmc_hbm_temp":      (0, 0),
+    "xmc_cage_temp0":    (30, 45),
+    "xmc_cage_temp1":    (30, 45),
+    "xmc_cage_temp2":    (0, 0),
+    "xmc_cage_temp3":    (0, 0),
+    "xmc_power":         (20000000, 60000000),
+    "xmc_power_warn":    (0, 0),
+    "xmc_heartbeat_count": (1000, 100000),
+    "xmc_heartbeat_err_code": (0, 0),
+    "xmc_heartbeat_err_time": (0, 0),
+    "xmc_heartbeat_stall": (0, 0),
+}
+
+
+def write(path, value):
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "w") as f:
+        f.write("%s\n" % value)
+
+
+def subdev(fn_dir, name, inst, attrs):
+    # Subdevice directories are found by prefix "<name>." and have a
+    # "name" attribute, see get_subdev_dir_name() in pcidev.cpp
+    d = os.path.join(fn_dir, "%s.%s" % (name, inst))
+    write(os.path.join(d, "name"), name)
+    for attr, value in attrs.items():
+        write(os.path.join(d, attr), value)
+
+
+def card(root, rng, index, domain, bus):
+    sys_root = os.path.join(root, "sys")
+    dev_root = os.path.join(root, "dev")
+    devices = os.path.join(sys_root, "bus", "pci", "devices")
+    serial = "%012d" % rng.randrange(10**11, 10**12)
+    logic_uuid = uuid.UUID(int=rng.getrandbits(128)).hex
+    interface_uuid = uuid.UUID(int=rng.getrandbits(128)).hex
+    xclbin_uuid = uuid.UUID(int=rng.getrandbits(128)) if index % 2 == 0 else uuid.UUID(int=0)
+
+    for func, driver in ((0, "xclmgmt"), (1, "xocl")):
+        bdf = "%04x:%02x:00.%x" % (domain, bus, func)
+        fn_dir = os.path.join(devices, bdf)
+        inst = (domain << 16) + (bus << 8) + func
+        is_user = driver == "xocl"
+
+        common = {
+            "vendor": "0x10ee",
+            "device": "0x5005" if is_user else "0x5004",
+            "subsystem_vendor": "0x10ee",
+            "subsystem_device": "0x000e",
+            "link_speed": "3",
+            "link_speed_max": "3",
+            "link_width": "16",
+            "link_width_max": "16",
+            "ready": "1",
+            "userbar": "0" if is_user else "2",
+            "mfg": "0",
+            "mfg_ver": "0",
+            "recovery": "0",
+            "versal": "0",
+            "dev_offline": "0",
+            "board_name": "u250",
+            "local_cpulist": "0-%d" % (os.cpu_count() - 1),
+            "numa_node": "-1",
+            "logic_uuids": logic_uuid,
+            "interface_uuids": interface_uuid,
+            "xclbinuuid": str(xclbin_uuid),
+            "mig_calibration": "1",
+            "nodma": "0",
+        }
+        for attr, value in common.items():
+            write(os.path.join(fn_dir, attr), value)
+
+        # resource: start end flags for BARs 0-5
+        with open(os.path.join(fn_dir, "resource"), "w") as f:
+            base = 0x380000000000 + (index << 32) + (func << 28)
+            for bar, size in enumerate((0x2000000, 0x40000, 0x20000, 0, 0, 0)):
+                if size:
+                    f.write("0x%016x 0x%016x 0x%016x\n" % (base + bar * 0x4000000,
+                                                           base + bar * 0x4000000 + size - 1,
+                                                           0x140204))
+                else:
+                    f.write("0x%016x 0x%016x 0x%016x\n" % (0, 0, 0))
+
+        subdev(fn_dir, "rom", "%s.%d" % ("u" if is_user else "m", inst), {
+            "VBNV": VBNV,
+            "FPGA": FPGA,
+            "ddr_bank_size": "16",
+            "ddr_bank_count_max": "4",
+            "uuid": logic_uuid,
+            "timestamp": "1578968484",
+        })
+        xmc = {k: rng.randint(lo, hi) for k, (lo, hi) in XMC_SENSORS.items()}
+        xmc.update({
+            "version": "4.4.36",
+            "bd_name": "ALVEO U250 PQ",
+            "serial_num": serial,
+            "bmc_ver": "4.4.36",
+            "exp_bmc_ver": "4.4.36",
+            "max_power": "225",
+            "sc_presence": "1",
+            "sc_is_fixed": "0",
+            "status": "0x1",
+            "reg_base": "0x120000",
+            "fan_presence": "A",
+            "mac_contiguous_num": "4",
+            "mac_addr_first": "00:0a:35:%02x:%02x:00" % (bus, index & 0xff),
+            "xmc_oem_id": "0x10da",
+            "scaling_support": "0",
+            "scaling_enabled": "0",
+        })
+        subdev(fn_dir, "xmc", "%s.%d" % ("u" if is_user else "m", inst), xmc)
+        subdev(fn_dir, "firewall", "%s.%d" % ("u" if is_user else "m", inst), {
+            "detected_level": "0",
+            "detected_level_name": "",
+            "detected_status": "0",
+            "detected_time": "0",
+        })
+        subdev(fn_dir, "icap", "%s.%d" % ("u" if is_user else "m", inst), {
+            "idcode": "0x4b57093",
+            "clock_freqs": "300\n500",
+            "data_retention": "0",
+            "sec_level": "0",
+        })
+
+        # Driver binding and device nodes
+        drv_dir = os.path.join(sys_root, "bus", "pci", "drivers", driver)
+        os.makedirs(drv_dir, exist_ok=True)
+        os.symlink(os.path.join("..", "..", "devices", bdf), os.path.join(drv_dir, bdf))
+        if is_user:
+            render = "renderD%d" % (128 + index)
+            os.makedirs(os.path.join(fn_dir, "drm", render), exist_ok=True)
+            write(os.path.join(dev_root, "dri", render), "")
+        else:
+            write(os.path.join(fn_dir, "instance"), inst)
+            write(os.path.join(dev_root, "xclmgmt%d" % inst), "")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate a synthetic sysfs/devfs tree of Alveo cards")
+    parser.add_argument("--root", required=True, help="directory to create the tree in, <root>/sys and <root>/dev")
+    parser.add_argument("--cards", type=int, default=4, help="number of cards (default 4)")
+    parser.add_argument("--seed", type=int, default=1, help="random seed for sensor values and ids (default 1)")
+    parser.add_argument("--force", action="store_true", help="replace an existing tree at --root")
+    args = parser.parse_args()
+
+    if os.path.exists(args.root):
+        if not args.force:
+            sys.exit("error: %s exists, use --force to replace it" % args.root)
+        shutil.rmtree(args.root)
+
+    rng = random.Random(args.seed)
+    for index in range(args.cards):
+        # 32 cards per domain, one card per bus
+        card(args.root, rng, index, index // 32, 0x10 + (index % 32) * 4)
+
+    for driver in ("xocl", "xclmgmt"):
+        write(os.path.join(args.root, "sys", "module", driver, "version"), "2.16.0,0000000000000000000000000000000000000000")
+
+    print("export XRT_SYSFS_ROOT=%s" % os.path.abspath(os.path.join(args.root, "sys")))
+    print("export XRT_DEVFS_ROOT=%s" % os.path.abspath(os.path.join(args.root, "dev")))
+
+
+if __name__ == "__main__":
+    main()
@@ -222,6 +222,7 @@ ub_package_list()
      strace \
      unzip \
      uuid-dev \
+     zlib1g-dev \
     )
 
     if [ $docker == 0 ] && [ $sysroot == 0 ]; then
@@ -0,0 +1,208 @@
+/**
+ * Copyright (C) 2023 Advanced Micro Devices, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "Compression.h"
+
+#include "xclbin.h"
+#include "XclBinUtilities.h"
+#include <algorithm>
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+# include <zlib.h>
+#endif
+
+namespace XUtil = XclBinUtilities;
+
+// zlib sizes are 32 bits, larger sections are fed in chunks
+static const uint64_t zlibChunkSize = 1ULL << 30;
+
+uint32_t
+XclBinUtilities::getCompressionAlgorithm(const std::string& _sAlgorithm)
+{
+  std::string sAlgorithm = boost::to_lower_copy(_sAlgorithm);
+  if (sAlgorithm == "none")
+    return COMPRESSION_NONE;
+
+  if (sAlgorithm == "zlib")
+    return COMPRESSION_ZLIB;
+
+  auto errMsg = boost::format("ERROR: Unknown compression algorithm '%s'.  Supported: none, zlib") % _sAlgorithm;
+  throw std::runtime_error(errMsg.str());
+}
+
+std::string
+XclBinUtilities::getCompressionAlgorithmAsString(uint32_t _algorithm)
+{
+  switch (_algorithm) {
+    case COMPRESSION_NONE: return "none";
+    case COMPRESSION_ZLIB: return "zlib";
+    default: return (boost::format("unknown (%d)") % _algorithm).str();
+  }
+}
+
+bool
+XclBinUtilities::isCompressedSection(const char* _pData, uint64_t _size)
+{
+  if ((_pData == nullptr) || (_size < sizeof(axlf_compressed_section)))
+    return false;
+
+  auto pHdr = reinterpret_cast<const axlf_compressed_section*>(_pData);
+  return memcmp(pHdr->m_magic, AXLF_COMPRESSED_SECTION_MAGIC, sizeof(pHdr->m_magic)) == 0;
+}
+
+uint64_t
+XclBinUtilities::getUncompressedSize(const char* _pData, uint64_t _size, uint32_t& _algorithm)
+{
+  if (!isCompressedSection(_pData, _size))
+    throw std::runtime_error("ERROR: Section data is missing the compressed section header.");
+
+  auto pHdr = reinterpret_cast<const axlf_compressed_section*>(_pData);
+  _algorithm = pHdr->m_algorithm;
+  return pHdr->m_size;
+}
+
+void
+XclBinUtilities::decompressSection(const char* _pData, uint64_t _size, char* _pBuffer, uint64_t _bufferSize)
+{
+  uint32_t algorithm = COMPRESSION_NONE;
+  if (getUncompressedSize(_pData, _size, algorithm) != _bufferSize)
+    throw std::runtime_error("ERROR: Compressed section size does not match the buffer size.");
+
+  const char* pSrc = _pData + sizeof(axlf_compressed_section);
+  uint64_t srcSize = _size - sizeof(axlf_compressed_section);
+
+  XUtil::TRACE(boost::format("Decompressing section (%s): 0x%lx -> 0x%lx bytes")
+               % getCompressionAlgorithmAsString(algorithm) % srcSize % _bufferSize);
+
+  if (algorithm == COMPRESSION_NONE) {
+    if (srcSize != _bufferSize)
+      throw std::runtime_error("ERROR: Uncompressed section size does not match its header.");
+    memcpy(_pBuffer, pSrc, srcSize);
+    return;
+  }
+
+  if (algorithm != COMPRESSION_ZLIB) {
+    auto errMsg = boost::format("ERROR: Unsupported section compression algorithm: %d") % algorithm;
+    throw std::runtime_error(errMsg.str());
+  }
+
+#ifndef _WIN32
+  z_stream strm = {};
+  if (inflateInit(&strm) != Z_OK)
+    throw std::runtime_error("ERROR: Unable to initialize zlib.");
+
+  uint64_t srcLeft = srcSize;
+  uint64_t dstLeft = _bufferSize;
+  strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(pSrc));
+  strm.next_out = reinterpret_cast<Bytef*>(_pBuffer);
+  int ret = Z_OK;
+  while (ret == Z_OK) {
+    if ((strm.avail_in == 0) && (srcLeft != 0)) {
+      strm.avail_in = (uInt)std::min(srcLeft, zlibChunkSize);
+      srcLeft -= strm.avail_in;
+    }
+    if ((strm.avail_out == 0) && (dstLeft != 0)) {
+      strm.avail_out = (uInt)std::min(dstLeft, zlibChunkSize);
+      dstLeft -= strm.avail_out;
+    }
+    ret = inflate(&strm, Z_NO_FLUSH);
+    if ((ret == Z_BUF_ERROR) && ((strm.avail_in != 0) || (srcLeft != 0)) && ((strm.avail_out != 0) || (dstLeft != 0)))
+      ret = Z_OK;
+  }
+  bool bComplete = (strm.avail_out == 0) && (dstLeft == 0);
+  inflateEnd(&strm);
+
+  if ((ret != Z_STREAM_END) || !bComplete) {
+    auto errMsg = boost::format("ERROR: Unable to decompress section data (zlib: %d).") % ret;
+    throw std::runtime_error(errMsg.str());
+  }
+#else
+  (void)_pBuffer;
+  throw std::runtime_error("ERROR: Compressed sections are not supported on this platform.");
+#endif
+}
+
+std::vector<char>
+XclBinUtilities::compressSection(const char* _pData, uint64_t _size, uint32_t _algorithm)
+{
+  axlf_compressed_section hdr = {};
+  memcpy(hdr.m_magic, AXLF_COMPRESSED_SECTION_MAGIC, sizeof(hdr.m_magic));
+  hdr.m_algorithm = _algorithm;
+  hdr.m_size = _size;
+
+  std::vector<char> buffer;
+
+  if (_algorithm == COMPRESSION_NONE) {
+    buffer.resize(sizeof(hdr) + _size);
+    memcpy(buffer.data(), &hdr, sizeof(hdr));
+    if (_size != 0)
+      memcpy(buffer.data() + sizeof(hdr), _pData, _size);
+    return buffer;
+  }
+
+  if (_algorithm != COMPRESSION_ZLIB) {
+    auto errMsg = boost::format("ERROR: Unsupported section compression algorithm: %d") % _algorithm;
+    throw std::runtime_error(errMsg.str());
+  }
+
+#ifndef _WIN32
+  z_stream strm = {};
+  if (deflateInit(&strm, Z_DEFAULT_COMPRESSION) != Z_OK)
+    throw std::runtime_error("ERROR: Unable to initialize zlib.");
+
+  // Compress into a buffer of the worst case size, then trim it
+  uint64_t bound = deflateBound(&strm, (uLong)_size);
+  buffer.resize(sizeof(hdr) + bound);
+  memcpy(buffer.data(), &hdr, sizeof(hdr));
+
+  uint64_t srcLeft = _size;
+  uint64_t dstLeft = bound;
+  strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(_pData));
+  strm.next_out = reinterpret_cast<Bytef*>(buffer.data() + sizeof(hdr));
+  int ret = Z_OK;
+  while (ret == Z_OK) {
+    if ((strm.avail_in == 0) && (srcLeft != 0)) {
+      strm.avail_in = (uInt)std::min(srcLeft, zlibChunkSize);
+      srcLeft -= strm.avail_in;
+    }
+    if ((strm.avail_out == 0) && (dstLeft != 0)) {
+      strm.avail_out = (uInt)std::min(dstLeft, zlibChunkSize);
+      dstLeft -= strm.avail_out;
+    }
+    ret = deflate(&strm, (srcLeft == 0) ? Z_FINISH : Z_NO_FLUSH);
+  }
+  uint64_t compressedSize = (uint64_t)(reinterpret_cast<char*>(strm.next_out) - (buffer.data() + sizeof(hdr)));
+  deflateEnd(&strm);
+
+  if (ret != Z_STREAM_END) {
+    auto errMsg = boost::format("ERROR: Unable to compress section data (zlib: %d).") % ret;
+    throw std::runtime_error(errMsg.str());
+  }
+
+  buffer.resize(sizeof(hdr) + compressedSize);
+  buffer.shrink_to_fit();
+
+  XUtil::TRACE(boost::format("Compressed section (zlib): 0x%lx -> 0x%lx bytes") % _size % compressedSize);
+  return buffer;
+#else
+  (void)_pData;
+  throw std::runtime_error("ERROR: Compressed sections are not supported on this platform.");
+#endif
+}
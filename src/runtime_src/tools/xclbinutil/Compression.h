@@ -0,0 +1,46 @@
+/**
+ * Copyright (C) 2023 Advanced Micro Devices, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef __Compression_h_
+#define __Compression_h_
+
+// Include files
+// Please keep this list to a minimum
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compressed section payloads, see struct axlf_compressed_section
+namespace XclBinUtilities {
+
+uint32_t getCompressionAlgorithm(const std::string& _sAlgorithm);
+std::string getCompressionAlgorithmAsString(uint32_t _algorithm);
+
+// True if the data starts with the compressed section header
+bool isCompressedSection(const char* _pData, uint64_t _size);
+
+// Uncompressed size and algorithm of a compressed section
+uint64_t getUncompressedSize(const char* _pData, uint64_t _size, uint32_t& _algorithm);
+
+// Decompress a compressed section into a buffer of the uncompressed size
+void decompressSection(const char* _pData, uint64_t _size, char* _pBuffer, uint64_t _bufferSize);
+
+// Compressed section, including its header, of the given data
+std::vector<char> compressSection(const char* _pData, uint64_t _size, uint32_t _algorithm);
+
+};
+
+#endif
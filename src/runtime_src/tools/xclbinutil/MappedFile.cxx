@@ -0,0 +1,159 @@
+/**
+ * Copyright (C) 2023 Advanced Micro Devices, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "MappedFile.h"
+
+#include "XclBinUtilities.h"
+#include <boost/format.hpp>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+namespace XUtil = XclBinUtilities;
+
+#ifndef _WIN32
+// The kernel copies the range without it passing through user space,
+// file systems that support it (e.g., XFS, btrfs) share the extents.
+// Copies as much as possible and leaves the remainder in the arguments.
+static void
+copyFileRange(int _fdIn, uint64_t& _offIn, int _fdOut, uint64_t& _offOut, uint64_t& _size)
+{
+#ifdef SYS_copy_file_range
+  while (_size != 0) {
+    loff_t offIn = _offIn;
+    loff_t offOut = _offOut;
+    auto copied = ::syscall(SYS_copy_file_range, _fdIn, &offIn, _fdOut, &offOut, _size, 0);
+    if (copied <= 0)
+      return;
+
+    _offIn += copied;
+    _offOut += copied;
+    _size -= copied;
+  }
+#else
+  (void)_fdIn; (void)_offIn; (void)_fdOut; (void)_offOut; (void)_size;
+#endif
+}
+#endif
+
+MappedFile::MappedFile(const std::string& _fileName, int _fd, const char* _pData, uint64_t _size)
+    : m_fileName(_fileName)
+    , m_fd(_fd)
+    , m_pData(_pData)
+    , m_size(_size)
+{
+  // Empty
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+  if (m_pData != nullptr)
+    ::munmap(const_cast<char*>(m_pData), m_size);
+  ::close(m_fd);
+#endif
+}
+
+std::shared_ptr<MappedFile>
+MappedFile::open(const std::string& _fileName)
+{
+#ifndef _WIN32
+  int fd = ::open(_fileName.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return nullptr;
+
+  struct stat st = {};
+  if ((::fstat(fd, &st) != 0) || !S_ISREG(st.st_mode) || (st.st_size == 0)) {
+    ::close(fd);
+    return nullptr;
+  }
+
+  void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (addr == MAP_FAILED) {
+    ::close(fd);
+    return nullptr;
+  }
+
+  XUtil::TRACE(boost::format("Mapped input file: %s (%ld bytes)") % _fileName % st.st_size);
+  return std::shared_ptr<MappedFile>(new MappedFile(_fileName, fd, static_cast<const char*>(addr), st.st_size));
+#else
+  (void)_fileName;
+  return nullptr;
+#endif
+}
+
+int
+MappedFile::openOutput(const std::string& _fileName)
+{
+#ifndef _WIN32
+  return ::open(_fileName.c_str(), O_WRONLY | O_CLOEXEC);
+#else
+  (void)_fileName;
+  return -1;
+#endif
+}
+
+void
+MappedFile::closeOutput(int _fd)
+{
+#ifndef _WIN32
+  if (_fd >= 0)
+    ::close(_fd);
+#else
+  (void)_fd;
+#endif
+}
+
+void
+MappedFile::copyTo(int _fd, uint64_t _srcOffset, uint64_t _dstOffset, uint64_t _size) const
+{
+  if ((_srcOffset > m_size) || (_size > m_size - _srcOffset)) {
+    auto errMsg = boost::format("ERROR: Range (0x%lx, 0x%lx) is outside of the input file: %s") % _srcOffset % _size % m_fileName;
+    throw std::runtime_error(errMsg.str());
+  }
+
+#ifndef _WIN32
+  // Falls back to writing from the mapping, e.g., when the input and
+  // output are on different file systems on older kernels
+  copyFileRange(m_fd, _srcOffset, _fd, _dstOffset, _size);
+
+  const char* pData = m_pData + _srcOffset;
+  while (_size != 0) {
+    auto written = ::pwrite(_fd, pData, _size, _dstOffset);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      auto errMsg = boost::format("ERROR: Unable to write section data to the output file: %s") % strerror(errno);
+      throw std::runtime_error(errMsg.str());
+    }
+    pData += written;
+    _dstOffset += written;
+    _size -= written;
+  }
+#else
+  (void)_fd;
+  (void)_dstOffset;
+  throw std::runtime_error("ERROR: Mapped file copy is not supported on this platform.");
+#endif
+}
@@ -0,0 +1,67 @@
+/**
+ * Copyright (C) 2023 Advanced Micro Devices, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef __MappedFile_h_
+#define __MappedFile_h_
+
+// ----------------------- I N C L U D E S -----------------------------------
+
+// #includes here - please keep these to a bare minimum!
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// ------------------- C L A S S :   M a p p e d F i l e ---------------------
+
+// Read only memory mapping of an input xclbin image.
+//
+// Sections read from a mapped image reference the mapping instead of
+// owning a copy of their payload.  When the image is written back out,
+// unchanged sections are copied file to file by the kernel, so the
+// payload of large sections (e.g., BITSTREAM) never passes through
+// user space memory.
+class MappedFile {
+ public:
+  // Returns nullptr if the file can not be mapped (e.g., on Windows)
+  static std::shared_ptr<MappedFile> open(const std::string& _fileName);
+
+  // Output file descriptor for copyTo(), -1 if not supported
+  static int openOutput(const std::string& _fileName);
+  static void closeOutput(int _fd);
+
+ public:
+  ~MappedFile();
+
+  const char* data() const { return m_pData; }
+  uint64_t size() const { return m_size; }
+  const std::string& getFileName() const { return m_fileName; }
+
+  // Copy a range of the mapped file to the given offset of the output
+  void copyTo(int _fd, uint64_t _srcOffset, uint64_t _dstOffset, uint64_t _size) const;
+
+ private:
+  MappedFile(const std::string& _fileName, int _fd, const char* _pData, uint64_t _size);
+  MappedFile(const MappedFile& obj) = delete;
+  MappedFile& operator=(const MappedFile& obj) = delete;
+
+ private:
+  std::string m_fileName;
+  int m_fd;
+  const char* m_pData;
+  uint64_t m_size;
+};
+
+#endif
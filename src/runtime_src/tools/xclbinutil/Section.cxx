@@ -16,6 +16,8 @@
 
 #include "Section.h"
 
+#include "Compression.h"
+#include "MappedFile.h"
 #include "XclBinUtilities.h"
 #include <algorithm>
 #include <boost/algorithm/string.hpp>
@@ -26,6 +28,10 @@
 
 namespace XUtil = XclBinUtilities;
 
+// Stored format of section data that is not wrapped in a compressed
+// section header, otherwise the format is the compression algorithm
+static const int storedRaw = -1;
+
 // Disable windows compiler warnings
 #ifdef _WIN32
   #pragma warning( disable : 4100)      // 4100 - Unreferenced formal parameter
@@ -59,6 +65,12 @@ Section::Section()
     , m_sIndexName("")
     , m_pBuffer(nullptr)
     , m_bufferSize(0)
+    , m_compression(COMPRESSION_NONE)
+    , m_bCompressedImage(false)
+    , m_mappedOffset(0)
+    , m_mappedSize(0)
+    , m_mappedFormat(storedRaw)
+    , m_storedFormat(storedRaw)
     , m_name("")
 {
   // Empty
@@ -71,12 +83,97 @@ Section::~Section()
 
 void
 Section::purgeBuffers()
+{
+  // A raw mapped buffer is owned by the input image
+  if (!m_mappedFile || (m_mappedFormat != storedRaw))
+    delete[] m_pBuffer;
+
+  m_mappedFile.reset();
+  m_pBuffer = nullptr;
+  m_bufferSize = 0;
+  std::vector<char>().swap(m_storedBuffer);
+}
+
+void
+Section::setMappedFile(const std::shared_ptr<MappedFile>& _mappedFile)
 {
   if (m_pBuffer != nullptr) {
-    delete m_pBuffer;
-    m_pBuffer = nullptr;
+    std::string errMsg = "ERROR: Binary buffer already exists.";
+    throw std::runtime_error(errMsg);
   }
-  m_bufferSize = 0;
+
+  m_mappedFile = _mappedFile;
+}
+
+bool
+Section::isMapped() const
+{
+  return (m_mappedFile != nullptr) && (m_pBuffer != nullptr);
+}
+
+void
+Section::materializeBuffer()
+{
+  if (!isMapped())
+    return;
+
+  // A decompressed buffer is already owned by the section
+  if (m_mappedFormat == storedRaw) {
+    char* pBuffer = new char[m_bufferSize];
+    memcpy(pBuffer, m_pBuffer, m_bufferSize);
+    m_pBuffer = pBuffer;
+  }
+  m_mappedFile.reset();
+}
+
+void
+Section::setCompressedImage(bool _bCompressedImage)
+{
+  m_bCompressedImage = _bCompressedImage;
+}
+
+void
+Section::setCompression(uint32_t _algorithm)
+{
+  m_compression = _algorithm;
+}
+
+uint32_t
+Section::getCompression() const
+{
+  return m_compression;
+}
+
+void
+Section::prepareXclBinSectionBuffer(bool _bCompressedImage)
+{
+  std::vector<char>().swap(m_storedBuffer);
+
+  // Uncompressed data that could be mistaken for a compressed section
+  // is stored with a COMPRESSION_NONE header in a compressed image
+  m_storedFormat = storedRaw;
+  if ((m_compression != COMPRESSION_NONE) ||
+      (_bCompressedImage && XUtil::isCompressedSection(m_pBuffer, m_bufferSize)))
+    m_storedFormat = (int)m_compression;
+
+  // Raw data, or stored data that can be copied from the input image
+  if ((m_storedFormat == storedRaw) ||
+      (isMapped() && (m_mappedFormat == m_storedFormat)))
+    return;
+
+  m_storedBuffer = XUtil::compressSection(m_pBuffer, m_bufferSize, m_compression);
+}
+
+uint64_t
+Section::getStoredSize() const
+{
+  if (m_storedFormat == storedRaw)
+    return m_bufferSize;
+
+  if (isMapped() && (m_mappedFormat == m_storedFormat))
+    return m_mappedSize;
+
+  return m_storedBuffer.size();
 }
 
 void
@@ -308,13 +405,22 @@ void
 Section::initXclBinSectionHeader(axlf_section_header& _sectionHeader)
 {
   _sectionHeader.m_sectionKind = m_eKind;
-  _sectionHeader.m_sectionSize = m_bufferSize;
+  _sectionHeader.m_sectionSize = getStoredSize();
   XUtil::safeStringCopy((char*)&_sectionHeader.m_sectionName, m_name, sizeof(axlf_section_header::m_sectionName));
 }
 
 void
 Section::writeXclBinSectionBuffer(std::ostream& _ostream) const
 {
+  if (m_storedFormat != storedRaw) {
+    if (isMapped() && (m_mappedFormat == m_storedFormat))
+      _ostream.write(m_mappedFile->data() + m_mappedOffset, m_mappedSize);
+    else
+      _ostream.write(m_storedBuffer.data(), m_storedBuffer.size());
+    _ostream.flush();
+    return;
+  }
+
   if ((m_pBuffer == nullptr) ||
       (m_bufferSize == 0)) {
     return;
@@ -324,6 +430,17 @@ Section::writeXclBinSectionBuffer(std::ostream& _ostream) const
   _ostream.flush();
 }
 
+bool
+Section::copyXclBinSectionBuffer(int _fd, uint64_t _offset) const
+{
+  if (!isMapped() || (m_mappedFormat != m_storedFormat) || (m_mappedSize == 0))
+    return false;
+
+  XUtil::TRACE(boost::format("Copying unmodified section '%s' from the input file") % getSectionKindAsString());
+  m_mappedFile->copyTo(_fd, m_mappedOffset, _offset, m_mappedSize);
+  return true;
+}
+
 void
 Section::readXclBinBinary(std::istream& _istream, const axlf_section_header& _sectionHeader)
 {
@@ -346,17 +463,53 @@ Section::readXclBinBinary(std::istream& _istream, const axlf_section_header& _se
     throw std::runtime_error(errMsg);
   }
 
-  m_bufferSize = (unsigned int)_sectionHeader.m_sectionSize;
+  unsigned int storedSize = (unsigned int)_sectionHeader.m_sectionSize;
+  const char* pStored = nullptr;
+  std::unique_ptr<char[]> readBuffer;
 
-  m_pBuffer = new char[m_bufferSize];
+  if (m_mappedFile) {
+    // Reference the section in the input image, it is only read if used
+    if ((_sectionHeader.m_sectionOffset > m_mappedFile->size()) ||
+        (storedSize > m_mappedFile->size() - _sectionHeader.m_sectionOffset)) {
+      std::string errMsg = "ERROR: Input stream for the binary buffer is smaller then the expected size.";
+      throw std::runtime_error(errMsg);
+    }
 
-  _istream.seekg(_sectionHeader.m_sectionOffset);
+    pStored = m_mappedFile->data() + _sectionHeader.m_sectionOffset;
+    m_mappedOffset = _sectionHeader.m_sectionOffset;
+    m_mappedSize = storedSize;
+  } else {
+    readBuffer.reset(new char[storedSize]);
 
-  _istream.read(m_pBuffer, m_bufferSize);
+    _istream.seekg(_sectionHeader.m_sectionOffset);
 
-  if (_istream.gcount() != (std::streamsize)m_bufferSize) {
-    std::string errMsg = "ERROR: Input stream for the binary buffer is smaller then the expected size.";
-    throw std::runtime_error(errMsg);
+    _istream.read(readBuffer.get(), storedSize);
+
+    if (_istream.gcount() != (std::streamsize)storedSize) {
+      std::string errMsg = "ERROR: Input stream for the binary buffer is smaller then the expected size.";
+      throw std::runtime_error(errMsg);
+    }
+    pStored = readBuffer.get();
+  }
+
+  if (m_bCompressedImage && XUtil::isCompressedSection(pStored, storedSize)) {
+    uint32_t algorithm = COMPRESSION_NONE;
+    uint64_t size = XUtil::getUncompressedSize(pStored, storedSize, algorithm);
+    if (size > UINT32_MAX) {
+      std::string errMsg("FATAL ERROR: Uncompressed section size exceeds internal representation size.");
+      throw std::runtime_error(errMsg);
+    }
+
+    std::unique_ptr<char[]> buffer(new char[size]);
+    XUtil::decompressSection(pStored, storedSize, buffer.get(), size);
+    m_pBuffer = buffer.release();
+    m_bufferSize = (unsigned int)size;
+    m_compression = algorithm;
+    m_mappedFormat = (int)algorithm;
+  } else {
+    m_pBuffer = m_mappedFile ? const_cast<char*>(pStored) : readBuffer.release();
+    m_bufferSize = storedSize;
+    m_mappedFormat = storedRaw;
   }
 
   XUtil::TRACE(boost::format("Section: %s (%d)") % getSectionKindAsString() % (unsigned int)getSectionKind());
@@ -603,6 +756,8 @@ Section::printHeader(std::ostream& _ostream) const
   _ostream << boost::format("  Type    : '%s'\n") % getSectionKindAsString();
   _ostream << boost::format("  Name    : '%s'\n") % getName();
   _ostream << boost::format("  Size    : '%d'\n") % getSize();
+  if (m_compression != COMPRESSION_NONE)
+    _ostream << boost::format("  Compression : '%s'\n") % XUtil::getCompressionAlgorithmAsString(m_compression);
 }
 
 bool
@@ -681,11 +836,7 @@ Section::readSubPayload(std::istream& _istream,
   readSubPayload(m_pBuffer, m_bufferSize, _istream, _sSubSection, _eFormatType, buffer);
 
   // Now for some how cleaning
-  if (m_pBuffer != nullptr) {
-    delete m_pBuffer;
-    m_pBuffer = nullptr;
-    m_bufferSize = 0;
-  }
+  purgeBuffers();
 
   m_bufferSize = (unsigned int)buffer.tellp();
 
@@ -29,6 +29,9 @@
 #include <memory>
 #include <string>
 #include <vector>
+
+class MappedFile;
+
 // ------------------- C L A S S :   S e c t i o n ---------------------------
 
 class Section {
@@ -104,8 +107,10 @@ class Section {
   void printHeader(std::ostream& _ostream) const;
   bool getSubPayload(std::ostringstream& _buf, const std::string& _sSubSection, Section::FormatType _eFormatType) const;
   void readSubPayload(std::istream& _istream, const std::string& _sSubSection, Section::FormatType _eFormatType);
+  void prepareXclBinSectionBuffer(bool _bCompressedImage);
   virtual void initXclBinSectionHeader(axlf_section_header& _sectionHeader);
   virtual void writeXclBinSectionBuffer(std::ostream& _ostream) const;
+  bool copyXclBinSectionBuffer(int _fd, uint64_t _offset) const;
   virtual void appendToSectionMetadata(const boost::property_tree::ptree& _ptAppendData, boost::property_tree::ptree& _ptToAppendTo);
 
   void dumpContents(std::ostream& _ostream, FormatType _eFormatType) const;
@@ -113,6 +118,12 @@ class Section {
 
   void getPayload(boost::property_tree::ptree& _pt) const;
   void purgeBuffers();
+  void setMappedFile(const std::shared_ptr<MappedFile>& _mappedFile);
+  bool isMapped() const;
+  void materializeBuffer();
+  void setCompressedImage(bool _bCompressedImage);
+  void setCompression(uint32_t _algorithm);
+  uint32_t getCompression() const;
   void setName(const std::string& _sSectionName);
   void setPathAndName(const std::string& _pathAndName);
   const std::string& getPathAndName() const;
@@ -133,12 +144,28 @@ class Section {
   std::string m_sKindName;
   std::string m_sIndexName;
 
-  char* m_pBuffer;
+  char* m_pBuffer;                            // Uncompressed section data
   unsigned int m_bufferSize;
+  uint32_t m_compression;                     // COMPRESSION_ALGORITHM of the written section
+  bool m_bCompressedImage;                    // Input image may contain compressed sections
+
+  // Stored data of the section in the mapped input image.  When the
+  // stored data is raw, m_pBuffer references the image
+  std::shared_ptr<MappedFile> m_mappedFile;
+  uint64_t m_mappedOffset;
+  uint64_t m_mappedSize;
+  int m_mappedFormat;
+
+  // Stored data of the section in the output image
+  int m_storedFormat;
+  std::vector<char> m_storedBuffer;
   std::string m_name;
 
   std::string m_pathAndName;
 
+ private:
+  uint64_t getStoredSize() const;
+
  private:
   Section(const Section& obj) = delete;
   Section& operator=(const Section& obj) = delete;
@@ -19,9 +19,11 @@
 // ------ I N C L U D E   F I L E S -------------------------------------------
 #include "XclBinClass.h"
 
+#include "Compression.h"
 #include "ElfUtilities.h"
 #include "FormattedOutput.h"
 #include "KernelUtilities.h"
+#include "MappedFile.h"
 #include "Section.h"
 #include "version.h"                            // Generated include files
 #include "XclBinUtilities.h"
@@ -157,6 +159,9 @@ XclBin::readXclBinBinarySections(std::fstream& _istream)
 
     // Here for testing purposes, when all segments are supported it should be removed
     if (pSection != nullptr) {
+      if (m_mappedFile)
+        pSection->setMappedFile(m_mappedFile);
+      pSection->setCompressedImage((m_xclBinHeader.m_header.m_actionMask & AM_COMPRESSED_SECTIONS) != 0);
       pSection->readXclBinBinary(_istream, sectionHeader);
       addSection(pSection);
     }
@@ -188,10 +193,19 @@ XclBin::readXclBinBinary(const std::string& _binaryFileName,
 
     // Read in the mirror image
     readXclBinaryMirrorImage(ifXclBin, pt_mirrorData);
+
+    if (m_xclBinHeader.m_header.m_actionMask & AM_COMPRESSED_SECTIONS) {
+      std::string errMsg = "ERROR: Migrating an xclbin image with compressed sections is not supported.";
+      throw std::runtime_error(errMsg);
+    }
   } else {
     // Read in the header
     readXclBinBinaryHeader(ifXclBin);
 
+    // Sections reference the mapped image instead of reading their payload,
+    // falls back to reading the sections if the file can not be mapped
+    m_mappedFile = MappedFile::open(_binaryFileName);
+
     // Read the sections
     readXclBinBinarySections(ifXclBin);
   }
@@ -243,7 +257,7 @@ XclBin::writeXclBinBinaryHeader(std::ostream& _ostream, boost::property_tree::pt
 
 
 void
-XclBin::writeXclBinBinarySections(std::ostream& _ostream, boost::property_tree::ptree& _mirroredData)
+XclBin::writeXclBinBinarySections(std::ostream& _ostream, int _fd, boost::property_tree::ptree& _mirroredData)
 {
   // Nothing to write
   if (m_sections.empty()) {
@@ -257,11 +271,13 @@ XclBin::writeXclBinBinarySections(std::ostream& _ostream, boost::property_tree::
   // Populate the array size and offsets
   uint64_t currentOffset = (uint64_t)(sizeof(axlf) - sizeof(axlf_section_header) + (sizeof(axlf_section_header) * m_sections.size()));
 
+  const bool bCompressedImage = (m_xclBinHeader.m_header.m_actionMask & AM_COMPRESSED_SECTIONS) != 0;
   for (unsigned int index = 0; index < m_sections.size(); ++index) {
     // Calculate padding
     currentOffset += (uint64_t)XUtil::bytesToAlign(currentOffset);
 
     // Initialize section header
+    m_sections[index]->prepareXclBinSectionBuffer(bCompressedImage);
     m_sections[index]->initXclBinSectionHeader(sectionHeader[index]);
     sectionHeader[index].m_sectionOffset = currentOffset;
     currentOffset += (uint64_t)sectionHeader[index].m_sectionSize;
@@ -291,8 +307,13 @@ XclBin::writeXclBinBinarySections(std::ostream& _ostream, boost::property_tree::
       throw std::runtime_error(errMsg.str());
     }
 
-    // Write buffer
-    m_sections[index]->writeXclBinSectionBuffer(_ostream);
+    // Write buffer, sections unmodified from the input image are copied
+    // file to file at their offset and the stream is moved past them
+    _ostream.flush();
+    if ((_fd >= 0) && m_sections[index]->copyXclBinSectionBuffer(_fd, runningOffset))
+      _ostream.seekp(runningOffset + sectionHeader[index].m_sectionSize);
+    else
+      m_sections[index]->writeXclBinSectionBuffer(_ostream);
 
     // Write mirror data
     {
@@ -368,6 +389,16 @@ XclBin::writeXclBinBinary(const std::string& _binaryFileName,
     throw std::runtime_error(errMsg);
   }
 
+  // Overwriting the mapped input image, the sections can no longer
+  // reference it
+  if (m_mappedFile &&
+      boost::filesystem::exists(_binaryFileName) &&
+      boost::filesystem::equivalent(_binaryFileName, m_mappedFile->getFileName())) {
+    for (auto pSection : m_sections)
+      pSection->materializeBuffer();
+    m_mappedFile.reset();
+  }
+
   // Write the xclbin file image
   XUtil::TRACE("Writing the xclbin binary file: " + _binaryFileName);
   std::fstream ofXclBin;
@@ -383,6 +414,17 @@ XclBin::writeXclBinBinary(const std::string& _binaryFileName,
     updateUUID();
   }
 
+  // Loaders only look for compressed section payloads in images that
+  // are marked as containing them
+  bool bCompressedImage = false;
+  for (auto pSection : m_sections)
+    bCompressedImage |= (pSection->getCompression() != COMPRESSION_NONE);
+
+  if (bCompressedImage)
+    m_xclBinHeader.m_header.m_actionMask |= AM_COMPRESSED_SECTIONS;
+  else
+    m_xclBinHeader.m_header.m_actionMask &= ~AM_COMPRESSED_SECTIONS;
+
   // Mirrored data
   boost::property_tree::ptree mirroredData;
 
@@ -393,7 +435,14 @@ XclBin::writeXclBinBinary(const std::string& _binaryFileName,
   writeXclBinBinaryHeader(ofXclBin, mirroredData);
 
   // Write the section array and sections
-  writeXclBinBinarySections(ofXclBin, mirroredData);
+  int fd = m_mappedFile ? MappedFile::openOutput(_binaryFileName) : -1;
+  try {
+    writeXclBinBinarySections(ofXclBin, fd, mirroredData);
+  } catch (...) {
+    MappedFile::closeOutput(fd);
+    throw;
+  }
+  MappedFile::closeOutput(fd);
 
   // Write out our mirror data
   writeXclBinBinaryMirrorData(ofXclBin, mirroredData);
@@ -753,6 +802,43 @@ XclBin::findSection(enum axlf_section_kind _eKind,
   return nullptr;
 }
 
+void
+XclBin::compressSection(const std::string& _sCompressSection)
+{
+  XUtil::TRACE("Compressing Section: " + _sCompressSection);
+
+  // Format: <section>[:<algorithm>]
+  std::string sectionName = _sCompressSection;
+  std::string algorithmName = "zlib";
+
+  const std::size_t delimiter = _sCompressSection.find_last_of(':');
+  if (delimiter != std::string::npos) {
+    sectionName = _sCompressSection.substr(0, delimiter);
+    algorithmName = _sCompressSection.substr(delimiter + 1);
+  }
+
+  enum axlf_section_kind eKind;
+  Section::translateSectionKindStrToKind(sectionName, eKind);
+  const uint32_t algorithm = XUtil::getCompressionAlgorithm(algorithmName);
+
+  bool bFound = false;
+  for (auto pSection : m_sections) {
+    if (pSection->getSectionKind() != eKind)
+      continue;
+
+    pSection->setCompression(algorithm);
+    bFound = true;
+  }
+
+  if (!bFound) {
+    auto errMsg = boost::format("ERROR: Section '%s' does not exist.") % sectionName;
+    throw std::runtime_error(errMsg.str());
+  }
+
+  XUtil::QUIET("");
+  XUtil::QUIET(boost::format("Section: '%s' will be stored with compression '%s'.") % sectionName % XUtil::getCompressionAlgorithmAsString(algorithm));
+}
+
 void
 XclBin::removeSection(const std::string& _sSectionToRemove)
 {
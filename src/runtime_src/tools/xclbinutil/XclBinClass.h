@@ -20,12 +20,14 @@
 
 #include <string>
 #include <fstream>
+#include <memory>
 #include <vector>
 #include <boost/property_tree/ptree.hpp>
 
 #include "xclbin.h"
 #include "ParameterSectionData.h"
 
+class MappedFile;
 class Section;
 
 class XclBin {
@@ -47,6 +49,7 @@ class XclBin {
   void readXclBinBinary(const std::string &_binaryFileName, bool _bMigrate = false);
   void writeXclBinBinary(const std::string &_binaryFileName, bool _bSkipUUIDInsertion);
   void removeSection(const std::string & _sSectionToRemove);
+  void compressSection(const std::string & _sCompressSection);
   void addSection(ParameterSectionData &_PSD);
   void addReplaceSection(ParameterSectionData &_PSD);
   void addMergeSection(ParameterSectionData &_PSD);
@@ -96,7 +99,7 @@ class XclBin {
   void readXclBinHeader(const boost::property_tree::ptree& _ptHeader, struct axlf& _axlfHeader);
   void readXclBinSection(std::fstream& _istream, const boost::property_tree::ptree& _ptSection);
   void writeXclBinBinaryHeader(std::ostream& _ostream, boost::property_tree::ptree& _mirroredData);
-  void writeXclBinBinarySections(std::ostream& _ostream, boost::property_tree::ptree& _mirroredData);
+  void writeXclBinBinarySections(std::ostream& _ostream, int _fd, boost::property_tree::ptree& _mirroredData);
 
 
  protected:
@@ -106,6 +109,7 @@ class XclBin {
  private:
   std::vector<Section*> m_sections;
   axlf m_xclBinHeader;
+  std::shared_ptr<MappedFile> m_mappedFile;   // Input image referenced by unmodified sections
 
  protected:
   SchemaVersion m_SchemaVersionMirrorWrite;
@@ -153,6 +153,7 @@ int main_(int argc, const char** argv) {
   std::vector<std::string> keysToRemove;
   std::vector<std::string> keyValuePairs;
   std::vector<std::string> sectionsToAdd;
+  std::vector<std::string> sectionsToCompress;
   std::vector<std::string> sectionsToAddMerge;
   std::vector<std::string> sectionsToAddReplace;
   std::vector<std::string> sectionsToDump;
@@ -170,6 +171,7 @@ int main_(int argc, const char** argv) {
       ("add-section", boost::program_options::value<decltype(sectionsToAdd)>(&sectionsToAdd)->multitoken(), "Section name to add.  Format: <section>:<format>:<file>")
       ("add-signature", boost::program_options::value<decltype(sSignature)>(&sSignature), "Adds a user defined signature to the given xclbin image.")
       ("certificate", boost::program_options::value<decltype(sCertificate)>(&sCertificate), "Certificate used in signing and validating the xclbin image.")
+      ("compress-section", boost::program_options::value<decltype(sectionsToCompress)>(&sectionsToCompress)->multitoken(), "Section to store compressed.  Format: <section>[:<algorithm>]  Algorithms: zlib (default), none")
       ("digest-algorithm", boost::program_options::value<decltype(sDigestAlgorithm)>(&sDigestAlgorithm), "Digest algorithm. Default: sha512")
       ("dump-section", boost::program_options::value<decltype(sectionsToDump)>(&sectionsToDump)->multitoken(), "Section to dump. Format: <section>:<format>:<file>")
       ("force", boost::program_options::bool_switch(&bForce), "Forces a file overwrite.")
@@ -537,6 +539,10 @@ int main_(int argc, const char** argv) {
   // -- Update Interface uuid in xclbin --
   xclBin.updateInterfaceuuid();
 
+  // -- Compress Sections --
+  for (const auto &section : sectionsToCompress)
+    xclBin.compressSection(section);
+
   // -- Dump Sections --
   for (const auto &section : sectionsToDump) {
     ParameterSectionData psd(section);
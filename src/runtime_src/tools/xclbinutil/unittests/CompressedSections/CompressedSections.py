@@ -0,0 +1,192 @@
+from argparse import RawDescriptionHelpFormatter
+import argparse
+import filecmp
+import os
+import subprocess
+
+# Start of our unit test
+# -- main() -------------------------------------------------------------------
+#
+# The entry point to this script.
+#
+# Note: It is called at the end of this script so that the other functions
+#       and classes have been defined and the syntax validated
+def main():
+  # -- Configure the argument parser
+  parser = argparse.ArgumentParser(formatter_class=RawDescriptionHelpFormatter, description='description:\n  Unit test wrapper for storing xclbin sections compressed')
+  parser.add_argument('--image-size', nargs='?', default=8 * 1024 * 1024, type=int, help='size of the generated bitstream image in bytes')
+  args = parser.parse_args()
+
+  # Prepare for testing
+  xclbinutil = "xclbinutil"
+
+  # Start the tests
+  print ("Starting test")
+
+  # Bitstreams are mostly runs of padding, the image compresses well
+  bitstreamImage = "compressed_bitstream.bin"
+  with open(bitstreamImage, "wb") as f:
+    block = os.urandom(4096)
+    for index in range(args.image_size // 8192):
+      f.write(block)
+      f.write(bytes(4096))
+
+  # Uncompressed data that looks like a compressed section
+  pdiImage = "compressed_pdi.bin"
+  with open(pdiImage, "wb") as f:
+    f.write(b"xclbinz\0")
+    f.write(os.urandom(1021))
+
+  overlayImage = "compressed_overlay.bin"
+  writeRandomImage(overlayImage, 513)
+
+  # ---------------------------------------------------------------------------
+
+  step = "1) Create an xclbin image with a compressed section"
+
+  baseXclbin = "compressed_base.xclbin"
+  uncompressedXclbin = "compressed_uncompressed.xclbin"
+
+  cmd = [xclbinutil,
+         "--add-section", "BITSTREAM:RAW:" + bitstreamImage,
+         "--add-section", "PDI:RAW:" + pdiImage,
+         "--output", uncompressedXclbin,
+         "--force"]
+  execCmd(step, cmd)
+
+  cmd = [xclbinutil,
+         "--input", uncompressedXclbin,
+         "--compress-section", "BITSTREAM",
+         "--output", baseXclbin,
+         "--force"]
+  execCmd(step, cmd)
+
+  if os.path.getsize(baseXclbin) * 2 > os.path.getsize(uncompressedXclbin):
+    raise Exception("Error: The BITSTREAM section was not compressed")
+
+  dumpAndCompare(xclbinutil, baseXclbin, "BITSTREAM", bitstreamImage)
+  dumpAndCompare(xclbinutil, baseXclbin, "PDI", pdiImage)
+
+  # ---------------------------------------------------------------------------
+
+  step = "2) Edit the compressed image, the compressed section is kept as is"
+
+  addedXclbin = "compressed_added.xclbin"
+
+  cmd = [xclbinutil,
+         "--input", baseXclbin,
+         "--add-section", "OVERLAY:RAW:" + overlayImage,
+         "--output", addedXclbin,
+         "--force"]
+  execCmd(step, cmd)
+
+  if os.path.getsize(addedXclbin) * 2 > os.path.getsize(uncompressedXclbin):
+    raise Exception("Error: The BITSTREAM section is no longer compressed")
+
+  dumpAndCompare(xclbinutil, addedXclbin, "BITSTREAM", bitstreamImage)
+  dumpAndCompare(xclbinutil, addedXclbin, "PDI", pdiImage)
+  dumpAndCompare(xclbinutil, addedXclbin, "OVERLAY", overlayImage)
+
+  # ---------------------------------------------------------------------------
+
+  step = "3) Store the section uncompressed"
+
+  decompressedXclbin = "compressed_decompressed.xclbin"
+
+  cmd = [xclbinutil,
+         "--input", addedXclbin,
+         "--compress-section", "BITSTREAM:none",
+         "--output", decompressedXclbin,
+         "--force"]
+  execCmd(step, cmd)
+
+  if os.path.getsize(decompressedXclbin) < os.path.getsize(bitstreamImage):
+    raise Exception("Error: The BITSTREAM section is still compressed")
+
+  dumpAndCompare(xclbinutil, decompressedXclbin, "BITSTREAM", bitstreamImage)
+  dumpAndCompare(xclbinutil, decompressedXclbin, "PDI", pdiImage)
+  dumpAndCompare(xclbinutil, decompressedXclbin, "OVERLAY", overlayImage)
+
+  # ---------------------------------------------------------------------------
+
+  step = "4) Unknown compression algorithm"
+
+  cmd = [xclbinutil,
+         "--input", baseXclbin,
+         "--compress-section", "BITSTREAM:unknown",
+         "--output", "compressed_unknown.xclbin",
+         "--force"]
+
+  try:
+    execCmd(step, cmd)
+  except Exception:
+    pass
+  else:
+    raise Exception("Error: Unknown compression algorithm was accepted")
+  # ---------------------------------------------------------------------------
+
+  # If the code gets this far, all is good.
+  return False
+
+def writeRandomImage(fileName, size):
+  with open(fileName, "wb") as f:
+    f.write(os.urandom(size))
+
+def dumpAndCompare(xclbinutil, xclbin, section, expectedImage):
+  outputImage = xclbin + "." + section.lower() + ".bin"
+  cmd = [xclbinutil,
+         "--input", xclbin,
+         "--dump-section", section + ":RAW:" + outputImage,
+         "--force"]
+  execCmd("Dump section " + section + " of " + xclbin, cmd)
+
+  binaryFileCompare(expectedImage, outputImage)
+
+def binaryFileCompare(file1, file2):
+    if not os.path.isfile(file1):
+      raise Exception("Error: The following file does not exist: '" + file1 +"'")
+
+    if not os.path.isfile(file2):
+      raise Exception("Error: The following file does not exist: '" + file2 +"'")
+
+    if filecmp.cmp(file1, file2, shallow=False) == False:
+        print ("\nFile1 : "+ file1)
+        print ("\nFile2 : "+ file2)
+
+        raise Exception("Error: The two files are not binary the same")
+
+def testDivider():
+  print("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~")
+
+
+def execCmd(pretty_name, cmd):
+  testDivider()
+  print(pretty_name)
+  testDivider()
+  cmdLine = ' '.join(cmd)
+  print(cmdLine)
+  proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+  o, e = proc.communicate()
+  print(o.decode('ascii'))
+  print(e.decode('ascii'))
+  errorCode = proc.returncode
+
+  if errorCode != 0:
+    raise Exception("Operation failed with the return code: " + str(errorCode))
+
+# -- Start executing the script functions
+if __name__ == '__main__':
+  try:
+    if main() == True:
+      print ("\nError(s) occurred.")
+      print("Test Status: FAILED")
+      exit(1)
+  except Exception as error:
+    print(repr(error))
+    print("Test Status: FAILED")
+    exit(1)
+
+
+# If the code get this far then no errors occured
+print("Test Status: PASSED")
+exit(0)
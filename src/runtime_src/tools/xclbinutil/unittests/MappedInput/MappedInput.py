@@ -0,0 +1,160 @@
+from argparse import RawDescriptionHelpFormatter
+import argparse
+import filecmp
+import os
+import subprocess
+
+# Start of our unit test
+# -- main() -------------------------------------------------------------------
+#
+# The entry point to this script.
+#
+# Note: It is called at the end of this script so that the other functions
+#       and classes have been defined and the syntax validated
+def main():
+  # -- Configure the argument parser
+  parser = argparse.ArgumentParser(formatter_class=RawDescriptionHelpFormatter, description='description:\n  Unit test wrapper for editing xclbin images whose unmodified sections are copied from the mapped input')
+  parser.add_argument('--image-size', nargs='?', default=8 * 1024 * 1024, type=int, help='size of the generated bitstream image in bytes')
+  args = parser.parse_args()
+
+  # Prepare for testing
+  xclbinutil = "xclbinutil"
+
+  # Start the tests
+  print ("Starting test")
+
+  bitstreamImage = "mapped_bitstream.bin"
+  pdiImage = "mapped_pdi.bin"
+  overlayImage = "mapped_overlay.bin"
+  writeRandomImage(bitstreamImage, args.image_size)
+  writeRandomImage(pdiImage, 4099)
+  writeRandomImage(overlayImage, 513)
+
+  # ---------------------------------------------------------------------------
+
+  step = "1) Create the base xclbin image"
+
+  baseXclbin = "mapped_base.xclbin"
+
+  cmd = [xclbinutil,
+         "--add-section", "BITSTREAM:RAW:" + bitstreamImage,
+         "--add-section", "PDI:RAW:" + pdiImage,
+         "--output", baseXclbin,
+         "--force"]
+  execCmd(step, cmd)
+
+  # ---------------------------------------------------------------------------
+
+  step = "2) Add a section, the unmodified sections are copied from the input"
+
+  addedXclbin = "mapped_added.xclbin"
+
+  cmd = [xclbinutil,
+         "--input", baseXclbin,
+         "--add-section", "OVERLAY:RAW:" + overlayImage,
+         "--output", addedXclbin,
+         "--force"]
+  execCmd(step, cmd)
+
+  dumpAndCompare(xclbinutil, addedXclbin, "BITSTREAM", bitstreamImage)
+  dumpAndCompare(xclbinutil, addedXclbin, "PDI", pdiImage)
+  dumpAndCompare(xclbinutil, addedXclbin, "OVERLAY", overlayImage)
+
+  # ---------------------------------------------------------------------------
+
+  step = "3) Remove a section in front of the remaining sections"
+
+  removedXclbin = "mapped_removed.xclbin"
+
+  cmd = [xclbinutil,
+         "--input", addedXclbin,
+         "--remove-section", "BITSTREAM",
+         "--output", removedXclbin,
+         "--force"]
+  execCmd(step, cmd)
+
+  dumpAndCompare(xclbinutil, removedXclbin, "PDI", pdiImage)
+  dumpAndCompare(xclbinutil, removedXclbin, "OVERLAY", overlayImage)
+
+  # ---------------------------------------------------------------------------
+
+  step = "4) Replace a section of the mapped input"
+
+  replacedXclbin = "mapped_replaced.xclbin"
+
+  cmd = [xclbinutil,
+         "--input", addedXclbin,
+         "--replace-section", "PDI:RAW:" + overlayImage,
+         "--output", replacedXclbin,
+         "--force"]
+  execCmd(step, cmd)
+
+  dumpAndCompare(xclbinutil, replacedXclbin, "BITSTREAM", bitstreamImage)
+  dumpAndCompare(xclbinutil, replacedXclbin, "PDI", overlayImage)
+  # ---------------------------------------------------------------------------
+
+  # If the code gets this far, all is good.
+  return False
+
+def writeRandomImage(fileName, size):
+  with open(fileName, "wb") as f:
+    f.write(os.urandom(size))
+
+def dumpAndCompare(xclbinutil, xclbin, section, expectedImage):
+  outputImage = xclbin + "." + section.lower() + ".bin"
+  cmd = [xclbinutil,
+         "--input", xclbin,
+         "--dump-section", section + ":RAW:" + outputImage,
+         "--force"]
+  execCmd("Dump section " + section + " of " + xclbin, cmd)
+
+  binaryFileCompare(expectedImage, outputImage)
+
+def binaryFileCompare(file1, file2):
+    if not os.path.isfile(file1):
+      raise Exception("Error: The following file does not exist: '" + file1 +"'")
+
+    if not os.path.isfile(file2):
+      raise Exception("Error: The following file does not exist: '" + file2 +"'")
+
+    if filecmp.cmp(file1, file2, shallow=False) == False:
+        print ("\nFile1 : "+ file1)
+        print ("\nFile2 : "+ file2)
+
+        raise Exception("Error: The two files are not binary the same")
+
+def testDivider():
+  print("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~")
+
+
+def execCmd(pretty_name, cmd):
+  testDivider()
+  print(pretty_name)
+  testDivider()
+  cmdLine = ' '.join(cmd)
+  print(cmdLine)
+  proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+  o, e = proc.communicate()
+  print(o.decode('ascii'))
+  print(e.decode('ascii'))
+  errorCode = proc.returncode
+
+  if errorCode != 0:
+    raise Exception("Operation failed with the return code: " + str(errorCode))
+
+# -- Start executing the script functions
+if __name__ == '__main__':
+  try:
+    if main() == True:
+      print ("\nError(s) occurred.")
+      print("Test Status: FAILED")
+      exit(1)
+  except Exception as error:
+    print(repr(error))
+    print("Test Status: FAILED")
+    exit(1)
+
+
+# If the code get this far then no errors occured
+print("Test Status: PASSED")
+exit(0)
@@ -15,6 +15,7 @@
  * under the License.
  */
 
+#include <algorithm>
 #include <vector>
 #include <thread>
 #include <iostream>
@@ -25,8 +26,11 @@
 
 namespace xdp {
 
+  std::atomic<uint64_t> VPStatisticsDatabase::instanceCount(0) ;
+
   VPStatisticsDatabase::VPStatisticsDatabase(VPDatabase* d) :
-    db(d), numMigrateMemCalls(0), numHostP2PTransfers(0),
+    db(d), callShards(std::make_shared<APICallShards>()),
+    instanceId(++instanceCount), numMigrateMemCalls(0), numHostP2PTransfers(0),
     numObjectsReleased(0), contextEnabled(false),
     totalHostReadTime(0), totalHostWriteTime(0), totalBufferStartTime(0),
     totalBufferEndTime(0), firstKernelStartTime(0.0), lastKernelEndTime(0.0)
@@ -206,39 +210,107 @@ namespace xdp {
     }
   }
 
-  void VPStatisticsDatabase::logFunctionCallStart(const std::string& name,
-                                                  double timestamp)
+  void VPStatisticsDatabase::APICallShards::retire(APICallShard* shard)
   {
-    std::lock_guard<std::mutex> lock(dbLock) ;
+    std::lock_guard<std::mutex> shardsLock(lock) ;
+    auto itr = std::find_if(live.begin(), live.end(),
+                            [shard](const auto& s) { return s.get() == shard ; }) ;
+    if (itr == live.end())
+      return ;
 
-    auto threadId = std::this_thread::get_id() ;
-    auto key      = std::make_pair(name, threadId) ;
-    auto value    = std::make_pair(timestamp, (double)0.0) ;
+    // Calls still in progress on an exiting thread never complete
+    //  and are dropped with the shard
+    for (const auto& function : shard->functions) {
+      if (function.second.stats.count == 0)
+        continue ;
+      retired[function.first].merge(function.second.stats) ;
+    }
+    live.erase(itr) ;
+  }
 
-    if (callCount.find(key) == callCount.end())
+  VPStatisticsDatabase::APICallShard* VPStatisticsDatabase::getCallShard()
+  {
+    // Each thread caches its shard.  The instance id guards against
+    //  a cached shard from a previous statistics database.  The shard
+    //  is retired when the thread exits or moves to another database.
+    struct ShardOwner
     {
-      std::vector<std::pair<double, double>> newVector ;
-      newVector.push_back(value) ;
-      callCount[key] = newVector ;
-    }
-    else
+      uint64_t instance = 0 ;
+      APICallShard* shard = nullptr ;
+      std::weak_ptr<APICallShards> shards ;
+
+      void release()
+      {
+        if (auto owner = shards.lock())
+          owner->retire(shard) ;
+        shard = nullptr ;
+        shards.reset() ;
+      }
+
+      ~ShardOwner() { release() ; }
+    } ;
+    thread_local ShardOwner cached ;
+
+    if (cached.instance == instanceId)
+      return cached.shard ;
+
+    cached.release() ;
+
+    std::lock_guard<std::mutex> lock(callShards->lock) ;
+    callShards->live.push_back(std::make_unique<APICallShard>()) ;
+    cached.instance = instanceId ;
+    cached.shard = callShards->live.back().get() ;
+    cached.shards = callShards ;
+    return cached.shard ;
+  }
+
+  void VPStatisticsDatabase::logFunctionCallStart(const std::string& name,
+                                                  double timestamp)
+  {
+    auto shard = getCallShard() ;
     {
-      callCount[key].push_back(value) ;
+      std::lock_guard<std::mutex> lock(shard->lock) ;
+      shard->functions[name].startTimes.push_back(timestamp) ;
     }
 
     // OpenCL specific information 
-    if (name == "clEnqueueMigrateMemObjects") addMigrateMemCall() ;
+    if (name == "clEnqueueMigrateMemObjects") {
+      std::lock_guard<std::mutex> lock(dbLock) ;
+      addMigrateMemCall() ;
+    }
   }
 
   void VPStatisticsDatabase::logFunctionCallEnd(const std::string& name,
                                                  double timestamp)
   {
-    std::lock_guard<std::mutex> lock(dbLock) ;
+    auto shard = getCallShard() ;
+    std::lock_guard<std::mutex> lock(shard->lock) ;
 
-    auto threadId = std::this_thread::get_id() ;
-    auto key      = std::make_pair(name, threadId) ;
-    
-    callCount[key].back().second = timestamp ;
+    auto function = shard->functions.find(name) ;
+    if (function == shard->functions.end() ||
+        function->second.startTimes.empty())
+      return ;
+
+    auto& startTimes = function->second.startTimes ;
+    function->second.stats.update(timestamp - startTimes.back()) ;
+    startTimes.pop_back() ;
+  }
+
+  std::map<std::string, APICallStatistics> VPStatisticsDatabase::getCallCount()
+  {
+    // Merge the statistics of every function across all threads,
+    //  starting from the threads that have already exited
+    std::lock_guard<std::mutex> lock(callShards->lock) ;
+    auto merged = callShards->retired ;
+    for (auto& shard : callShards->live) {
+      std::lock_guard<std::mutex> shardLock(shard->lock) ;
+      for (const auto& function : shard->functions) {
+        if (function.second.stats.count == 0)
+          continue ;
+        merged[function.first].merge(function.second.stats) ;
+      }
+    }
+    return merged ;
   }
 
   void VPStatisticsDatabase::logMemoryTransfer(uint64_t deviceId,
@@ -425,24 +497,13 @@ namespace xdp {
   void VPStatisticsDatabase::dumpCallCount(std::ofstream& fout)
   {
     // For each function call, across all of the threads, find out
-    //  the number of calls
-    std::map<std::string, uint64_t> counts ;
-
-    for (const auto& c : callCount)
-    {
-      if (counts.find(c.first.first) == counts.end())
-      {
-        counts[c.first.first] = c.second.size() ;
-      }
-      else
-      {
-        counts[c.first.first] += c.second.size() ;
-      }
-    }
-
-    for (const auto& i : counts)
+    //  the number of calls and the 50th, 90th, and 99th percentile
+    //  execution times
+    for (const auto& i : getCallCount())
     {
-      fout << i.first << "," << i.second << std::endl ;
+      fout << i.first << "," << i.second.count << ","
+           << i.second.percentile(50) << "," << i.second.percentile(90) << ","
+           << i.second.percentile(99) << std::endl ;
     }
   }
 
@@ -18,13 +18,18 @@
 #ifndef VP_STATISTICS_DATABASE_DOT_H
 #define VP_STATISTICS_DATABASE_DOT_H
 
+#include <atomic>
+#include <cmath>
 #include <fstream>
+#include <limits>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 // For the device results structures
@@ -148,6 +153,79 @@ namespace xdp {
     }
   } ;
 
+  // The APICallStatistics struct keeps streaming statistics on the
+  //  execution time of one API function.  Memory use is constant no
+  //  matter how often the function is called.  Execution times are
+  //  also counted in a histogram with four logarithmic buckets per
+  //  power of two, so percentiles are within 19% of the real value.
+  struct APICallStatistics
+  {
+    static constexpr unsigned int bucketsPerOctave = 4 ;
+    static constexpr unsigned int numBuckets = 48 * bucketsPerOctave ;
+
+    uint64_t count ;
+    double totalTime ;
+    double minTime ;
+    double maxTime ;
+    uint64_t buckets[numBuckets] ;
+
+    APICallStatistics() : count(0), totalTime(0), 
+      minTime((std::numeric_limits<double>::max)()), maxTime(0),
+      buckets{} { }
+
+    static unsigned int bucket(double executionTime)
+    {
+      if (!(executionTime > 1.0)) return 0 ;
+      auto index = static_cast<uint64_t>(std::log2(executionTime) * bucketsPerOctave) ;
+      return index < numBuckets ? static_cast<unsigned int>(index) : numBuckets - 1 ;
+    }
+
+    void update(double executionTime)
+    {
+      ++count ;
+      totalTime += executionTime ;
+      if (minTime > executionTime) minTime = executionTime ;
+      if (maxTime < executionTime) maxTime = executionTime ;
+      ++buckets[bucket(executionTime)] ;
+    }
+
+    void merge(const APICallStatistics& other)
+    {
+      count += other.count ;
+      totalTime += other.totalTime ;
+      if (minTime > other.minTime) minTime = other.minTime ;
+      if (maxTime < other.maxTime) maxTime = other.maxTime ;
+      for (unsigned int i = 0 ; i < numBuckets ; ++i)
+        buckets[i] += other.buckets[i] ;
+    }
+
+    double averageTime() const
+    {
+      return count ? totalTime / count : 0 ;
+    }
+
+    // Upper bound of the bucket holding the p-th percentile (0 - 100)
+    //  execution time, clamped to the observed min and max.  The last
+    //  bucket also holds all longer times, its bound is the max.
+    double percentile(double p) const
+    {
+      if (count == 0) return 0 ;
+      auto target = static_cast<uint64_t>(std::ceil(p / 100.0 * count)) ;
+      if (target == 0) target = 1 ;
+      uint64_t seen = 0 ;
+      for (unsigned int i = 0 ; i < numBuckets ; ++i) {
+        seen += buckets[i] ;
+        if (seen < target) continue ;
+        if (i == numBuckets - 1) return maxTime ;
+        double bound = std::exp2(static_cast<double>(i + 1) / bucketsPerOctave) ;
+        if (bound < minTime) bound = minTime ;
+        if (bound > maxTime) bound = maxTime ;
+        return bound ;
+      }
+      return maxTime ;
+    }
+  } ;
+
   struct MemoryChannelStatistics
   {
     uint64_t transactionCount ;
@@ -175,9 +253,37 @@ namespace xdp {
     VPDatabase* db ;
 
   private:
-    // Statistics on API calls (OpenCL and HAL) have to be thread specific
-    std::map<std::pair<std::string, std::thread::id>,
-             std::vector<std::pair<double, double>>> callCount ;
+    // Statistics on API calls (OpenCL and HAL) are kept in one shard
+    //  per host thread so logging a call never contends with other
+    //  threads.  The shards are merged when the summary is written.
+    struct APICallShard
+    {
+      struct Function
+      {
+        APICallStatistics stats ;
+        std::vector<double> startTimes ; // Calls in progress, innermost last
+      } ;
+      std::mutex lock ; // Only contended while shards are merged
+      std::unordered_map<std::string, Function> functions ;
+    } ;
+
+    // The shards of live threads.  When a thread exits, its shard is
+    //  folded into the retired statistics and freed.  Exiting threads
+    //  hold a weak reference, so this outlives the database only
+    //  while a shard is being retired.
+    struct APICallShards
+    {
+      std::mutex lock ;
+      std::vector<std::unique_ptr<APICallShard>> live ;
+      std::map<std::string, APICallStatistics> retired ;
+
+      void retire(APICallShard* shard) ;
+    } ;
+    std::shared_ptr<APICallShards> callShards ;
+    uint64_t instanceId ;
+    static std::atomic<uint64_t> instanceCount ;
+
+    APICallShard* getCallShard() ;
 
     // **** User Level Event Statistics ****
     std::map<std::string, uint64_t> eventCounts ;
@@ -253,9 +359,7 @@ namespace xdp {
     XDP_EXPORT ~VPStatisticsDatabase() ;
 
     // Getters and setters
-    inline const std::map<std::pair<std::string, std::thread::id>,
-                    std::vector<std::pair<double, double>>>& getCallCount() 
-      { return callCount ; }
+    XDP_EXPORT std::map<std::string, APICallStatistics> getCallCount() ;
     inline const std::map<uint64_t, DeviceMemoryStatistics>& getMemoryStats() 
       { return memoryStats ; }
     inline const std::map<std::string, TimeStatistics>& getKernelExecutionStats() 
@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+// Test of the streaming API call statistics in the XDP database.
+//
+// % api_call_statistics_test --run_test=test_api_call_statistics
+//
+// The test checks the percentiles of the log-scale histogram against
+// the exact percentiles of the recorded execution times, and that
+// merging the statistics of several threads gives the same result as
+// recording every call in one place.
+#include <boost/test/unit_test.hpp>
+
+#include "xdp/profile/database/statistics_database.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using xdp::APICallStatistics;
+
+// Relative error of a histogram percentile, 4 buckets per power of two
+const double max_error = std::exp2(1.0 / APICallStatistics::bucketsPerOctave);
+
+// Exact p-th percentile of a set of execution times
+static double
+exact_percentile(std::vector<double> times, double p)
+{
+  std::sort(times.begin(), times.end());
+  auto rank = static_cast<size_t>(std::ceil(p / 100.0 * times.size()));
+  return times[std::max<size_t>(rank, 1) - 1];
+}
+
+// Execution times spread over several orders of magnitude
+static std::vector<double>
+make_times(size_t count)
+{
+  std::vector<double> times;
+  for (size_t idx = 0; idx < count; ++idx)
+    times.push_back(100.0 + static_cast<double>((idx * 7919) % count) * (idx % 3 ? 10.0 : 1000.0));
+  return times;
+}
+
+static void
+check_equal(const APICallStatistics& actual, const APICallStatistics& expected)
+{
+  BOOST_CHECK_EQUAL(actual.count, expected.count);
+  BOOST_CHECK_CLOSE(actual.totalTime, expected.totalTime, 1e-9);
+  BOOST_CHECK_EQUAL(actual.minTime, expected.minTime);
+  BOOST_CHECK_EQUAL(actual.maxTime, expected.maxTime);
+  BOOST_CHECK(std::equal(std::begin(actual.buckets), std::end(actual.buckets),
+                         std::begin(expected.buckets)));
+  for (double p : {50.0, 90.0, 99.0})
+    BOOST_CHECK_EQUAL(actual.percentile(p), expected.percentile(p));
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE ( test_api_call_statistics )
+
+BOOST_AUTO_TEST_CASE( test_empty )
+{
+  APICallStatistics stats;
+  BOOST_CHECK_EQUAL(stats.count, 0);
+  BOOST_CHECK_EQUAL(stats.averageTime(), 0);
+  BOOST_CHECK_EQUAL(stats.percentile(50), 0);
+  BOOST_CHECK_EQUAL(stats.percentile(99), 0);
+}
+
+BOOST_AUTO_TEST_CASE( test_single_call )
+{
+  // Bucket bounds are clamped to the observed min and max
+  APICallStatistics stats;
+  stats.update(1234.5);
+  BOOST_CHECK_EQUAL(stats.averageTime(), 1234.5);
+  BOOST_CHECK_EQUAL(stats.percentile(0), 1234.5);
+  BOOST_CHECK_EQUAL(stats.percentile(50), 1234.5);
+  BOOST_CHECK_EQUAL(stats.percentile(100), 1234.5);
+}
+
+BOOST_AUTO_TEST_CASE( test_percentile )
+{
+  auto times = make_times(10000);
+  APICallStatistics stats;
+  for (auto time : times)
+    stats.update(time);
+
+  BOOST_CHECK_EQUAL(stats.count, times.size());
+  BOOST_CHECK_EQUAL(stats.minTime, *std::min_element(times.begin(), times.end()));
+  BOOST_CHECK_EQUAL(stats.maxTime, *std::max_element(times.begin(), times.end()));
+
+  // The percentile is the upper bound of its bucket, so it is never
+  // below the exact value and at most one bucket width above it
+  for (double p : {1.0, 50.0, 90.0, 99.0, 100.0}) {
+    auto exact = exact_percentile(times, p);
+    auto approx = stats.percentile(p);
+    BOOST_TEST_CONTEXT("p" << p) {
+      BOOST_CHECK_GE(approx, exact);
+      BOOST_CHECK_LE(approx, exact * max_error);
+    }
+  }
+  BOOST_CHECK_LE(stats.percentile(50), stats.percentile(90));
+  BOOST_CHECK_LE(stats.percentile(90), stats.percentile(99));
+}
+
+BOOST_AUTO_TEST_CASE( test_out_of_range )
+{
+  // Times below one and beyond the last bucket are kept in the first
+  // and last bucket, percentiles stay within the observed range
+  APICallStatistics stats;
+  stats.update(0);
+  stats.update(0.5);
+  stats.update(1e30);
+  BOOST_CHECK_EQUAL(stats.buckets[0], 2);
+  BOOST_CHECK_EQUAL(stats.buckets[APICallStatistics::numBuckets - 1], 1);
+  BOOST_CHECK_EQUAL(stats.percentile(50), max_error);
+  BOOST_CHECK_EQUAL(stats.percentile(100), 1e30);
+}
+
+BOOST_AUTO_TEST_CASE( test_merge )
+{
+  // Statistics of each thread merged into one are the same as the
+  // statistics of all calls
+  auto times = make_times(3000);
+  APICallStatistics all;
+  APICallStatistics shards[3];
+  for (size_t idx = 0; idx < times.size(); ++idx) {
+    all.update(times[idx]);
+    shards[idx % 3].update(times[idx]);
+  }
+
+  APICallStatistics merged;
+  for (const auto& shard : shards)
+    merged.merge(shard);
+  check_equal(merged, all);
+
+  // Merging empty statistics changes nothing
+  merged.merge(APICallStatistics());
+  check_equal(merged, all);
+
+  APICallStatistics empty;
+  empty.merge(all);
+  check_equal(empty, all);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -17,6 +17,7 @@
 
 #define XDP_SOURCE
 
+#include <algorithm>
 #include <map>
 
 #include "xdp/profile/plugin/power/power_plugin.h"
@@ -57,13 +58,17 @@ namespace xdp {
       "xmc_fan_rpm"      
     } ;
 
+  // How often the polling thread moves samples into the database
+  static constexpr unsigned int drainInterval = 100 ; // ms
+
   PowerProfilingPlugin::PowerProfilingPlugin() :
-    XDPPlugin(), keepPolling(true), pollingInterval(20)
+    XDPPlugin(), numDevices(0), keepPolling(true), pollingInterval(20)
   {
     db->registerPlugin(this) ;
     db->registerInfo(info::power) ;
 
-    pollingInterval = xrt_core::config::get_power_profile_interval_ms() ;
+    pollingInterval =
+      std::max(1u, xrt_core::config::get_power_profile_interval_ms()) ;
 
     // There can be multiple boards with the same shell loaded as well as
     //  different boards.  We number them all individually.
@@ -76,14 +81,13 @@ namespace xdp {
     while (handle != nullptr)
     {
       // For each device, keep track of the paths to the sysfs files
-      std::vector<std::string> paths ;
       for (auto f : powerFiles)
       {
-        char sysfsPath[512] ;
+        char sysfsPath[512] = { 0 } ;
         xclGetSysfsPath(handle, "xmc", f, sysfsPath, 512) ;
-        paths.push_back(sysfsPath) ;
+        filePaths.push_back(sysfsPath) ;
       }
-      filePaths.push_back(paths) ;
+      ++numDevices ;
 
       // Determine the name of the device
       struct xclDeviceInfo2 info ;
@@ -112,6 +116,14 @@ namespace xdp {
       handle = xclOpen(index, "/dev/null", XCL_INFO) ;
     }
 
+    // The sampler keeps all of the sysfs files open and reads them
+    //  at a fixed rate on its own thread.  Size its ring to hold a few
+    //  drain intervals worth of samples.
+    size_t capacity = std::max(64u, 4 * drainInterval / pollingInterval) ;
+    sampler = std::make_unique<xrt_core::sensor_sampler>
+      (filePaths, std::chrono::milliseconds(pollingInterval), capacity) ;
+    sampler->start() ;
+
     // Start the power profiling thread
     pollingThread = std::thread(&PowerProfilingPlugin::pollPower, this) ;
   }
@@ -121,9 +133,13 @@ namespace xdp {
     // Stop the polling thread
     keepPolling = false ;
     pollingThread.join() ;
+    sampler->stop() ;
 
     if (VPDatabase::alive())
     {
+      // Pick up the samples taken since the last drain
+      addSamples() ;
+
       for (auto w : writers)
       {
         w->write(false) ;
@@ -133,39 +149,32 @@ namespace xdp {
     }
   }
 
-  void PowerProfilingPlugin::pollPower()
+  void PowerProfilingPlugin::addSamples()
   {
-    while(keepPolling)
-    {
-      // Get timestamp in milliseconds
-      double timestamp = xrt_core::time_ns() / 1.0e6 ;
-      uint64_t index = 0 ;
-      for (const auto& device : filePaths)
+    const size_t numFiles = sizeof(powerFiles) / sizeof(powerFiles[0]) ;
+    std::vector<uint64_t> values(numFiles) ;
+
+    sampler->consume([&](uint64_t timestamp_ns, const uint64_t* sample) {
+      // Timestamp in milliseconds
+      double timestamp = timestamp_ns / 1.0e6 ;
+      for (uint64_t index = 0 ; index < numDevices ; ++index)
       {
-        std::vector<uint64_t> values ;
-        for (const auto& file : device)
-        {
-          std::ifstream fs(file) ;
-          if (!fs)
-          {
-            // When we tried to get the path to this file, we got a bad
-            //  result (like empty string).  So all devices are aligned and
-            //  have the same amount of information we'll just record this
-            //  data element as 0.
-            values.push_back(0) ;
-            continue ;
-          }
-          std::string data ;
-          std::getline(fs, data) ;
-          uint64_t dp = data.empty() ? 0 : std::stoul(data) ;
-          values.push_back(dp) ;
-          fs.close() ;
-        }
+        // Files we could not get a good path for (like an empty string)
+        //  are recorded as 0, so all devices are aligned and have the
+        //  same amount of information.
+        std::copy_n(sample + index * numFiles, numFiles, values.begin()) ;
         (db->getDynamicInfo()).addPowerSample(index, timestamp, values) ;
-        ++index ;	
       }
+    }) ;
+  }
 
-      std::this_thread::sleep_for(std::chrono::milliseconds(pollingInterval)) ;
+  void PowerProfilingPlugin::pollPower()
+  {
+    auto interval = std::max(drainInterval, pollingInterval) ;
+    while(keepPolling)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(interval)) ;
+      addSamples() ;
     }
   }
 
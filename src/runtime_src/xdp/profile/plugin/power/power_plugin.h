@@ -17,10 +17,13 @@
 #ifndef POWER_PROFILING_DOT_H
 #define POWER_PROFILING_DOT_H
 
+#include <memory>
 #include <vector>
 #include <string>
 #include <thread>
 
+#include "core/common/sensor_sampler.h"
+
 #include "xdp/profile/plugin/vp_base/vp_base_plugin.h"
 #include "xdp/config.h"
 
@@ -33,13 +36,19 @@ namespace xdp {
     static const char* powerFiles[] ;
 
   private:
-    std::vector<std::vector<std::string>> filePaths ;
-
-    // Power profiling requires its own thread
+    // The files of all devices are sampled together, device by device
+    //  in the order of powerFiles
+    std::vector<std::string> filePaths ;
+    uint64_t numDevices ;
+    std::unique_ptr<xrt_core::sensor_sampler> sampler ;
+
+    // Power profiling requires its own thread to move samples
+    //  from the sampler into the database
     bool keepPolling ;
     std::thread pollingThread ;
     unsigned int pollingInterval ;
     void pollPower() ;
+    void addSamples() ;
   public:
     PowerProfilingPlugin() ;
     ~PowerProfilingPlugin() ;
@@ -184,21 +184,13 @@ namespace xdp {
   void
   SummaryWriter::writeAPICalls(APIType type)
   {
-    // For each function call, across all of the threads, 
-    //  consolidate all the information into what we need
-    std::map<std::string,
-             std::tuple<uint64_t,
-                        double,
-                        double,
-                        double> > rows ;
-
-    std::map<std::pair<std::string, std::thread::id>,
-             std::vector<std::pair<double, double>>> callCount =
+    // The statistics database has already consolidated each function
+    //  call across all of the threads
+    std::map<std::string, APICallStatistics> callCount =
       (db->getStats()).getCallCount() ;
     
     for (const auto& call : callCount) {
-      auto callAndThread = call.first ;
-      auto APIName = callAndThread.first ;
+      auto APIName = call.first ;
 
       switch (type) {
       case OPENCL:
@@ -215,47 +207,40 @@ namespace xdp {
         break ;
       }
 
-      std::vector<std::pair<double, double>> timesOfCalls = call.second ;
-
-      if (rows.find(APIName) == rows.end()) {
-        std::tuple<uint64_t, double, double, double> blank = 
-          std::make_tuple<uint64_t, double, double, double>(0,0,std::numeric_limits<double>::max(),0) ;
-
-        rows[APIName] = blank ;
-      }
-
-      for (const auto& executionTime : timesOfCalls) {
-        auto timeTaken = executionTime.second - executionTime.first ;
-
-        ++(std::get<0>(rows[APIName])) ;
-        std::get<1>(rows[APIName]) += timeTaken ;
-        if (timeTaken < std::get<2>(rows[APIName]))
-          std::get<2>(rows[APIName]) = timeTaken ;
-        if (timeTaken > std::get<3>(rows[APIName]))
-          std::get<3>(rows[APIName]) = timeTaken ;
-      }
-    }
-
-    for (const auto& row : rows) {
-      auto averageTime = 
-        (double)(std::get<1>(row.second)) / (double)(std::get<0>(row.second)) ;
+      const APICallStatistics& stats = call.second ;
       if (type != OPENCL) fout << "ENTRY:" ;
-      fout << row.first                      << ","     // API Name
-           << std::get<0>(row.second)        << ","     // Number of calls
-           << (std::get<1>(row.second)/one_million) << ","     // Total time
-           << (std::get<2>(row.second)/one_million) << ","     // Minimum time
-           << (averageTime/one_million)             << ","     // Average time
-           << (std::get<3>(row.second)/one_million) << ",\n" ; // Maximum time
+      fout << APIName                              << ","     // API Name
+           << stats.count                          << ","     // Number of calls
+           << (stats.totalTime/one_million)        << ","     // Total time
+           << (stats.minTime/one_million)          << ","     // Minimum time
+           << (stats.averageTime()/one_million)    << ","     // Average time
+           << (stats.maxTime/one_million)          << ","     // Maximum time
+           << (stats.percentile(50)/one_million)   << ","     // Median time
+           << (stats.percentile(90)/one_million)   << ","     // 90th percentile
+           << (stats.percentile(99)/one_million)   << ",\n" ; // 99th percentile
     }
   }
 
+  // The percentiles come from a log-scale histogram and are accurate
+  //  to within 19% of the real execution time
+  void SummaryWriter::writePercentileColumns()
+  {
+    fout << "COLUMN:<html>Median<br>Time (ms)</html>,float,"
+         << "Median execution time (in ms),\n";
+    fout << "COLUMN:<html>90th Percentile<br>Time (ms)</html>,float,"
+         << "90th percentile execution time (in ms),\n";
+    fout << "COLUMN:<html>99th Percentile<br>Time (ms)</html>,float,"
+         << "99th percentile execution time (in ms),\n";
+  }
+
   void SummaryWriter::writeOpenCLAPICalls()
   {
     // Title
     fout << "OpenCL API Calls\n" ;
     // Columns
     fout << "API Name,Number Of Calls,Total Time (ms),Minimum Time (ms),"
-         << "Average Time (ms),Maximum Time (ms),\n" ;
+         << "Average Time (ms),Maximum Time (ms),Median Time (ms),"
+         << "90th Percentile Time (ms),99th Percentile Time (ms),\n" ;
     writeAPICalls(OPENCL) ;
   }
 
@@ -274,6 +259,7 @@ namespace xdp {
          << "Average execution time (in ms),\n";
     fout << "COLUMN:<html>Maximum<br>Time (ms)</html>,float,"
          << "Maximum execution time (in ms),\n";
+    writePercentileColumns() ;
     writeAPICalls(NATIVE) ;
   }
 
@@ -292,6 +278,7 @@ namespace xdp {
          << "Average execution time (in ms),\n";
     fout << "COLUMN:<html>Maximum<br>Time (ms)</html>,float,"
          << "Maximum execution time (in ms),\n";
+    writePercentileColumns() ;
     writeAPICalls(HAL) ;
   }
 
@@ -349,7 +336,8 @@ namespace xdp {
 
     // Column headers
     fout << "Kernel,Number Of Enqueues,Total Time (ms),Minimum Time (ms),"
-         << "Average Time (ms),Maximum Time (ms),\n" ;
+         << "Average Time (ms),Maximum Time (ms),Median Time (ms),"
+         << "90th Percentile Time (ms),99th Percentile Time (ms),\n" ;
 
     for (const auto& execution : kernelExecutions) {
       fout << execution.first                         << ","
@@ -55,6 +55,7 @@ namespace xdp {
     // Generic host tables
     enum APIType { OPENCL, NATIVE, HAL, ALL } ;
     void writeAPICalls(APIType type) ;
+    void writePercentileColumns() ;
 
     // OpenCL specific device tables
     void writeSoftwareEmulationComputeUnitUtilization() ;
@@ -76,17 +76,24 @@ bool
 command_queue::
 queue(event* ev)
 {
-  bool ooo = m_props.test(CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE);
   XOCL_DEBUG(std::cout,"queue(",m_uid,") queues event(",ev->get_uid(),")\n");
 
-  std::lock_guard<std::mutex> lk(m_events_mutex);
-  if (!ooo && m_last_queued_event.get()) {
-    m_last_queued_event->chain(ev);
+  // pre-condition: ev is locked and being queued
 
-    xocl::profile::log_dependency(ev->get_uid(), m_last_queued_event->get_uid()) ;
+  std::lock_guard<std::mutex> lk(m_events_mutex);
+  if (is_in_order()) {
+    // The event depends on its predecessor if the predecessor is
+    // still in the queue.  Since in-order events complete in the
+    // order they are queued, the predecessor is in the queue if and
+    // only if the queue is not empty.
+    ev->m_queue_seq = ++m_queue_seq;
+    if (!m_events.empty()) {
+      ++ev->m_wait_count;
+      m_inorder_pending.push_back(ev);
+      xocl::profile::log_dependency(ev->get_uid(), m_last_queued_uid) ;
+    }
   }
-
-  if (ooo) {
+  else {
     for (auto b: m_barriers) {
       b->chain(ev);
       xocl::profile::log_dependency(ev->get_uid(), b->get_uid()) ;
@@ -97,7 +104,7 @@ queue(event* ev)
   }
 
   m_events.insert(ev);
-  m_last_queued_event = ev;
+  m_last_queued_uid = ev->get_uid();
   ev->retain();
 
   return true;
@@ -131,20 +138,16 @@ submit(event* ev)
   return true;
 }
 
-bool
+void
 command_queue::
-remove(event* ev)
+remove_nolock(event* ev)
 {
-  std::lock_guard<std::mutex> lk(m_events_mutex);
-
   auto it = m_events.find(ev);
   if (it==m_events.end())
     throw xocl::error(CL_INVALID_EVENT,"event " + ev->get_suid() + " never submitted");
   m_events.erase(it);
-  if (m_last_queued_event==ev)
-    m_last_queued_event = nullptr;
 
-  if ((ev->get_command_type()==CL_COMMAND_BARRIER) && (m_props.test(CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)))  {
+  if ((ev->get_command_type()==CL_COMMAND_BARRIER) && !is_in_order()) {
     auto bit = std::find(m_barriers.begin(),m_barriers.end(),ev);
     assert(bit!=m_barriers.end());
     m_barriers.erase(bit);
@@ -162,6 +165,31 @@ remove(event* ev)
     last = now;
   }
 #endif
+}
+
+bool
+command_queue::
+remove(event* ev)
+{
+  ptr<event> successor;
+
+  {
+    std::lock_guard<std::mutex> lk(m_events_mutex);
+
+    // The successor of ev must be popped while the queue is locked
+    // so that it cannot be released twice, but it must be submitted
+    // without the queue lock (see comment in submit)
+    auto seq = ev->m_queue_seq;
+    if (!m_inorder_pending.empty() && m_inorder_pending.front()->m_queue_seq==seq+1) {
+      successor = m_inorder_pending.front();
+      m_inorder_pending.pop_front();
+    }
+
+    remove_nolock(ev);
+  }
+
+  if (successor.get())
+    successor->submit();
 
   return true;
 }
@@ -170,7 +198,15 @@ bool
 command_queue::
 abort(event* ev,bool)
 {
-  return remove(ev);
+  // An aborted event does not release its in-order successor, the
+  // successor is aborted along with the event (see event::abort)
+  std::lock_guard<std::mutex> lk(m_events_mutex);
+  auto pit = std::find(m_inorder_pending.begin(),m_inorder_pending.end(),ev);
+  if (pit!=m_inorder_pending.end())
+    m_inorder_pending.erase(pit);
+
+  remove_nolock(ev);
+  return true;
 }
 
 void
@@ -23,6 +23,7 @@
 #include "xocl/core/property.h"
 
 #include <vector>
+#include <deque>
 #include <set>
 #include <unordered_set>
 #include <mutex>
@@ -102,6 +103,15 @@ public:
     return m_props.test(CL_QUEUE_PROFILING_ENABLE);
   }
 
+  /**
+   * Check if commands in this queue are executed in-order
+   */
+  bool
+  is_in_order() const
+  {
+    return !m_props.test(CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE);
+  }
+
   /**
    * Get range with events that are queued or submitted
    */
@@ -133,6 +143,9 @@ public:
   /**
    * Remove event from queue.
    *
+   * For in-order queues, removal of an event releases the event
+   * queued immediately after it, which is then submitted.
+   *
    * @return
    *   true if successully removed from queue, false otherwise
    */
@@ -197,6 +210,10 @@ public:
   register_destructor_callbacks(commandqueue_callback_type&& aCallback);
 
 private:
+  // Remove event from queue, m_events_mutex must be locked
+  void
+  remove_nolock(event* ev);
+
   unsigned int m_uid = 0;
   ptr<context> m_context;
   ptr<device> m_device;
@@ -205,8 +222,16 @@ private:
   mutable std::condition_variable m_has_events;
   event_queue_type m_events;
   std::vector<event*> m_barriers;
-  ptr<event> m_last_queued_event;
   property_type m_props;
+
+  // In-order queue bookkeeping.  Each queued event is assigned the
+  // next sequence number and waits only on the event with the
+  // preceding sequence number.  Events that cannot submit because
+  // their predecessor is still in the queue are kept in sequence
+  // order in m_inorder_pending and are released by remove().
+  uint64_t m_queue_seq = 0;
+  unsigned int m_last_queued_uid = 0;
+  std::deque<event*> m_inorder_pending;
 };
 
 } // xocl
@@ -350,6 +350,8 @@ bool
 event::
 waits_on(const event* ev) const
 {
+  if (m_queue_seq && m_command_queue==ev->m_command_queue && m_queue_seq==ev->m_queue_seq+1)
+    return true;
   return ev->chains_nolock(this);
 }
 
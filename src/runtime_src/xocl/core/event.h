@@ -30,6 +30,7 @@
 #include <vector>
 #include <functional>
 #include <iostream>
+#include <cstdint>
 
 namespace xocl {
 
@@ -459,7 +460,8 @@ private:
    * @param ev
    *   Event dependency to check for
    * @return
-   *   true if argument event's chain contains this
+   *   true if argument event's chain contains this, or if this
+   *   event immediately follows argument event in an in-order queue
    */
   bool
   waits_on(const event* ev) const;
@@ -560,6 +562,12 @@ private:
   // Number of events this event is waiting on.  This includes
   // explicit event depedencies and events that chain this
   unsigned int m_wait_count = 0;
+
+  // Position of this event in an in-order command queue.  In-order
+  // queues track the implicit dependency on the previously queued
+  // event by sequence number rather than by chaining the events.
+  // Zero if the event was not queued on an in-order queue.
+  uint64_t m_queue_seq = 0;
 };
 
 /**
@@ -23,6 +23,7 @@
 #include "xocl/core/command_queue.h"
 
 #include <thread>
+#include <memory>
 #include <iostream>
 
 namespace {
@@ -69,6 +70,37 @@ BOOST_AUTO_TEST_CASE( test_event_in_order_submit )
   }
 }
 
+BOOST_AUTO_TEST_CASE( test_event_in_order_sequence )
+{
+  xocl::context c(nullptr,0,nullptr);
+  xocl::command_queue q(&c,nullptr,0); // in order queue
+
+  {
+    // In-order events are released by sequence number, each event
+    // submits only when its predecessor is complete
+    std::vector<std::unique_ptr<xocl::event>> events;
+    for (int i=0; i<16; ++i) {
+      events.emplace_back(std::make_unique<xocl::event>(&q,&c,0));
+      events.back()->set_enqueue_action([](xocl::event*){});
+    }
+
+    for (auto& ev : events)
+      ev->queue();
+
+    BOOST_CHECK(events[0]->get_status()==CL_SUBMITTED);
+    for (size_t i=1; i<events.size(); ++i)
+      BOOST_CHECK(events[i]->get_status()==CL_QUEUED);
+
+    for (size_t i=0; i<events.size(); ++i) {
+      events[i]->set_status(CL_COMPLETE);
+      if (i+1<events.size())
+        BOOST_CHECK(events[i+1]->get_status()==CL_SUBMITTED);
+    }
+
+    q.flush();
+  }
+}
+
 BOOST_AUTO_TEST_CASE( test_event_out_order_submit )
 {
   xocl::context c(nullptr,0,nullptr);
@@ -0,0 +1,154 @@
+#!/usr/bin/python3
+
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#
+
+# Test of the pyxrt calls that release the GIL: start_async, sync_async,
+# map_array, read_into, start_runs and wait_runs.  Runs the hello
+# kernel of verify.xclbin, so it runs in the emulation flows too.
+
+import asyncio
+import re
+import sys
+import threading
+
+import numpy
+
+# found in PYTHONPATH
+import pyxrt
+
+# utils_binding.py
+sys.path.append('../')
+from utils_binding import *
+
+GOLDEN = b'Hello World'
+NUM_RUNS = 4
+
+
+def getKernel(opt):
+    d = pyxrt.device(opt.index)
+    xbin = pyxrt.xclbin(opt.bitstreamFile)
+    uuid = d.load_xclbin(xbin)
+
+    rule = re.compile("hello*")
+    kernel = list(filter(lambda val: rule.match(val.get_name()), xbin.get_kernels()))[0]
+    hello = pyxrt.kernel(d, uuid, kernel.get_name(), pyxrt.kernel.shared)
+    return d, hello
+
+
+def makeBuffers(d, hello, opt):
+    bos = [pyxrt.bo(d, opt.DATA_SIZE, pyxrt.bo.normal, hello.group_id(0)) for i in range(NUM_RUNS)]
+    for bo in bos:
+        # Zero copy view, writes go straight to the mapped buffer
+        view = bo.map_array(numpy.uint32)
+        assert(view.size == opt.DATA_SIZE // 4), "Incorrect map_array() size"
+        view[:] = 0
+    return bos
+
+
+def makeRuns(hello, bos):
+    runs = []
+    for bo in bos:
+        run = pyxrt.run(hello)
+        run.set_arg(0, bo)
+        runs.append(run)
+    return runs
+
+
+def checkResult(bo, opt):
+    result = bytearray(opt.DATA_SIZE)
+    bo.read_into(result, 0)
+    assert(result[:len(GOLDEN)] == GOLDEN), "Incorrect output from kernel"
+    assert(bo.map_array()[:len(GOLDEN)].tobytes() == GOLDEN), "Incorrect map_array() data"
+
+
+async def runAsync(hello, bos, opt):
+    to_device = pyxrt.xclBOSyncDirection.XCL_BO_SYNC_BO_TO_DEVICE
+    from_device = pyxrt.xclBOSyncDirection.XCL_BO_SYNC_BO_FROM_DEVICE
+
+    await asyncio.gather(*[bo.sync_async(to_device, opt.DATA_SIZE, 0) for bo in bos])
+
+    # Start every run twice, the second start reuses the completion
+    # callback registered by the first
+    runs = makeRuns(hello, bos)
+    for i in range(2):
+        print("Issue %d asynchronous kernel start requests" % len(runs))
+        states = await asyncio.gather(*[run.start_async() for run in runs])
+        for state in states:
+            assert(state == pyxrt.ert_cmd_state.ERT_CMD_STATE_COMPLETED), "Incorrect run state " + str(state)
+
+    await asyncio.gather(*[bo.sync_async(from_device, opt.DATA_SIZE, 0) for bo in bos])
+    for bo in bos:
+        checkResult(bo, opt)
+
+
+def runConcurrent(hello, bos, opt):
+    # Python threads keep running while the runs execute
+    to_device = pyxrt.xclBOSyncDirection.XCL_BO_SYNC_BO_TO_DEVICE
+    from_device = pyxrt.xclBOSyncDirection.XCL_BO_SYNC_BO_FROM_DEVICE
+    for bo in bos:
+        bo.map_array()[:] = 0
+        bo.sync(to_device, opt.DATA_SIZE, 0)
+
+    ticks = []
+    done = threading.Event()
+
+    def ticker():
+        while not done.is_set():
+            ticks.append(1)
+            done.wait(0.001)
+
+    thread = threading.Thread(target=ticker)
+    thread.start()
+    try:
+        runs = makeRuns(hello, bos)
+        print("Issue a batch of %d kernel start requests" % len(runs))
+        pyxrt.start_runs(runs)
+        states = pyxrt.wait_runs(runs, 0)
+    finally:
+        done.set()
+        thread.join()
+
+    assert(len(states) == len(runs)), "Incorrect number of run states"
+    for state in states:
+        assert(state == pyxrt.ert_cmd_state.ERT_CMD_STATE_COMPLETED), "Incorrect run state " + str(state)
+    assert(ticks), "Python thread did not run while waiting for the kernels"
+
+    for bo in bos:
+        bo.sync(from_device, opt.DATA_SIZE, 0)
+        checkResult(bo, opt)
+
+
+def main(args):
+    opt = Options()
+    b_file = "verify.xclbin"
+    Options.getOptions(opt, args, b_file)
+
+    try:
+        d, hello = getKernel(opt)
+        bos = makeBuffers(d, hello, opt)
+        asyncio.run(runAsync(hello, bos, opt))
+        runConcurrent(hello, bos, opt)
+        print("PASSED TEST")
+        return 0
+
+    except OSError as o:
+        print(o)
+        print("FAILED TEST")
+        return -o.errno
+
+    except AssertionError as a:
+        print(a)
+        print("FAILED TEST")
+        return -1
+    except Exception as e:
+        print(e)
+        print("FAILED TEST")
+        return -1
+
+if __name__ == "__main__":
+    result = main(sys.argv)
+    sys.exit(result)